@@ -0,0 +1,54 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#ifndef TEST_ARDUINO_DEBUG_UTILS_H_
+#define TEST_ARDUINO_DEBUG_UTILS_H_
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include <stddef.h>
+
+/******************************************************************************
+  DEFINES
+ ******************************************************************************/
+
+#define DBG_NONE    -1
+#define DBG_ERROR    0
+#define DBG_WARNING  1
+#define DBG_INFO     2
+#define DBG_DEBUG    3
+#define DBG_VERBOSE  4
+
+/******************************************************************************
+  CLASS DECLARATION
+ ******************************************************************************/
+
+/* Counts the messages printed per debug level instead of printing them */
+class Arduino_DebugUtils
+{
+public:
+  void print(int const debug_level, char const * fmt, ...);
+
+  size_t count(int const debug_level) const;
+  void   reset();
+
+private:
+  size_t _count[DBG_VERBOSE + 1];
+};
+
+/******************************************************************************
+  EXTERN DECLARATION
+ ******************************************************************************/
+
+extern Arduino_DebugUtils Debug;
+
+#endif /* TEST_ARDUINO_DEBUG_UTILS_H_ */
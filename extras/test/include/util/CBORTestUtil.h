@@ -30,7 +30,7 @@ namespace cbor
   PROTOTYPES
  ******************************************************************************/
 
-std::vector<uint8_t> encode(PropertyContainer & property_container, bool lightPayload = false);
+std::vector<uint8_t> encode(PropertyContainer & property_container, bool lightPayload = false, bool compactPayload = false);
 void print(std::vector<uint8_t> const & vect);
 
 } /* cbor */
@@ -0,0 +1,138 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#ifndef INCLUDE_MQTT_CLIENT_MOCK_H_
+#define INCLUDE_MQTT_CLIENT_MOCK_H_
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include <Arduino.h>
+
+#undef max
+#undef min
+#include <deque>
+#include <vector>
+#include <string.h>
+
+/******************************************************************************
+  CLASS DECLARATION
+ ******************************************************************************/
+
+/* Minimal stand-in for ArduinoMqttClient's MqttClient. Incoming payload bytes
+ * are queued with push() and handed out by read() in chunks of at most
+ * 'max_chunk' bytes, mimicking a network stack which delivers partial reads.
+ * Outgoing messages are recorded in 'published', once 'publish_limit' messages
+ * have been published the client behaves as if the link had dropped.
+ */
+class MqttClientMock
+{
+public:
+
+  MqttClientMock(size_t const max_chunk = 1460)
+  : _max_chunk(max_chunk)
+  , _tx_expected(0)
+  , _tx_qos(0)
+  , _tx_dup(false)
+  , read_calls(0)
+  , publish_limit(static_cast<size_t>(-1))
+  { }
+
+  void push(String const & topic, std::vector<uint8_t> const & payload)
+  {
+    _topic = topic;
+    _rx.insert(_rx.end(), payload.begin(), payload.end());
+  }
+
+  String messageTopic() const { return _topic; }
+  int    available()    const { return static_cast<int>(_rx.size()); }
+
+  int read()
+  {
+    read_calls++;
+    if (_rx.empty())
+      return -1;
+    uint8_t const b = _rx.front();
+    _rx.pop_front();
+    return b;
+  }
+
+  int read(uint8_t * buf, size_t size)
+  {
+    read_calls++;
+    if (_rx.empty())
+      return -1;
+    size_t n = size;
+    if (n > _max_chunk)  n = _max_chunk;
+    if (n > _rx.size())  n = _rx.size();
+    for (size_t i = 0; i < n; i++) {
+      buf[i] = _rx.front();
+      _rx.pop_front();
+    }
+    return static_cast<int>(n);
+  }
+
+  int beginMessage(String const & topic, unsigned long size, bool /* retain */ = false, uint8_t qos = 0, bool dup = false)
+  {
+    if (published.size() >= publish_limit)
+      return 0;
+    published_topic = topic;
+    _tx_qos = qos;
+    _tx_dup = dup;
+    _tx.clear();
+    _tx_expected = size;
+    return 1;
+  }
+
+  size_t write(uint8_t const * buf, size_t size)
+  {
+    _tx.insert(_tx.end(), buf, buf + size);
+    return size;
+  }
+
+  int endMessage()
+  {
+    if (_tx.size() != _tx_expected)
+      return 0;
+    published.push_back(_tx);
+    published_qos.push_back(_tx_qos);
+    published_dup.push_back(_tx_dup);
+    return 1;
+  }
+
+  void clearPublished()
+  {
+    published.clear();
+    published_qos.clear();
+    published_dup.clear();
+  }
+
+private:
+
+  size_t              _max_chunk;
+  String              _topic;
+  std::deque<uint8_t> _rx;
+  std::vector<uint8_t> _tx;
+  unsigned long        _tx_expected;
+  uint8_t              _tx_qos;
+  bool                 _tx_dup;
+
+public:
+
+  unsigned int read_calls;
+  size_t       publish_limit;
+  String       published_topic;
+  std::vector<std::vector<uint8_t>> published;
+  std::vector<uint8_t>              published_qos;
+  std::vector<bool>                 published_dup;
+};
+
+#endif /* INCLUDE_MQTT_CLIENT_MOCK_H_ */
@@ -0,0 +1,75 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#ifndef INCLUDE_OFFLINE_LOG_FILE_STORAGE_H_
+#define INCLUDE_OFFLINE_LOG_FILE_STORAGE_H_
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include <stdio.h>
+
+#include <string>
+
+#include <utility/offline/OfflineLogStorage.h>
+
+/******************************************************************************
+  CLASS DECLARATION
+ ******************************************************************************/
+
+/* Keeps the records of an OfflineLog in an append-only file of at most
+ * 'max_size' bytes. The file starts with a header holding the offsets of the
+ * oldest record which has not been replayed yet and of the end of the log, so
+ * the log survives the storage being closed and opened again. The file is
+ * rewritten from the start once all the records have been replayed.
+ */
+class OfflineLogFileStorage : public OfflineLogStorage
+{
+
+public:
+
+  OfflineLogFileStorage();
+  virtual ~OfflineLogFileStorage();
+
+  /* Opens the log stored in 'path', creating it if it does not exist */
+  bool begin(std::string const & path, size_t const max_size);
+  void end();
+
+  virtual bool   append(uint8_t const * record, size_t const length) override;
+  virtual size_t front(uint8_t * buffer, size_t const size) override;
+  virtual void   pop() override;
+  virtual void   clear() override;
+
+  virtual size_t count() const override { return _count; }
+  virtual size_t available() const override;
+
+
+private:
+
+  OfflineLogFileStorage(OfflineLogFileStorage const &) = delete;
+  OfflineLogFileStorage & operator = (OfflineLogFileStorage const &) = delete;
+
+  static size_t const FILE_HEADER_SIZE = 16;
+  static size_t const RECORD_HEADER_SIZE = 2;
+
+  FILE * _file;
+  size_t _max_size;
+  size_t _read_offset;
+  size_t _write_offset;
+  size_t _count;
+
+  bool readHeader();
+  bool writeHeader();
+  size_t frontLength();
+
+};
+
+#endif /* INCLUDE_OFFLINE_LOG_FILE_STORAGE_H_ */
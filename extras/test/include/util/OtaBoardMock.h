@@ -0,0 +1,103 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#ifndef INCLUDE_OTA_BOARD_MOCK_H_
+#define INCLUDE_OTA_BOARD_MOCK_H_
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include <stdint.h>
+
+#include <vector>
+
+#include <util/OtaHttpServerMock.h>
+
+#include <ota/utility/OtaCheckpoint.h>
+#include <ota/utility/OtaFlashWriteBuffer.h>
+#include <ota/utility/OtaHttpRangePipeline.h>
+#include <ota/utility/OtaLzssDecoder.h>
+#include <ota/utility/OtaSha256.h>
+
+/******************************************************************************
+  CLASS DECLARATION
+ ******************************************************************************/
+
+/* Update file on the file system of the board, reopened at an offset to resume a download */
+struct OtaUpdateFile
+{
+  std::vector<uint8_t> data;
+  size_t position = 0;
+
+  int write(uint8_t * const buffer, size_t len);
+};
+
+/* Checkpoint storage surviving a reboot, which holds the record as bytes */
+class OtaCheckpointStorageMock : public OtaCheckpointStorage
+{
+public:
+  virtual bool store(OtaCheckpoint const & checkpoint) override;
+  virtual bool load(OtaCheckpoint & checkpoint) override;
+  virtual void clear() override;
+
+  std::vector<uint8_t> record;
+  size_t stores = 0;
+};
+
+/* One boot of a board downloading an OTA, mirrors what OTADefaultCloudProcessInterface
+ * does in startOTA(), fetch() and parseOta() with the PipelinedDownload policy: the
+ * download is resumed from the checkpoint in 'storage' if it belongs to the OTA 'id',
+ * a checkpoint is committed every 'checkpoint_interval' bytes and the image is
+ * verified against the CRC32 of the .ota file and 'final_sha256'.
+ */
+class OtaBoardMock
+{
+public:
+
+  enum class Result
+  {
+    Interrupted,
+    Completed,
+    CrcMismatch,
+    Sha256Mismatch
+  };
+
+  OtaBoardMock(OtaUpdateFile & file, OtaCheckpointStorage & storage, uint8_t const * id, uint8_t const * final_sha256, uint32_t const checkpoint_interval = 16 * 1024);
+
+  /* Downloads until the file is complete or 'drop_at' bytes of it have been received */
+  Result fetch(OtaHttpServerMock & server, size_t const drop_at = SIZE_MAX);
+
+  bool     write_error;
+  uint32_t resumed_from;
+  size_t   received;
+
+private:
+
+  OtaUpdateFile &        _file;
+  OtaCheckpointStorage & _storage;
+  uint8_t const *        _id;
+  uint8_t const *        _final_sha256;
+  uint32_t const         _checkpoint_interval;
+  OtaHttpRangePipeline   _pipeline;
+  OtaLzssDecoder         _decoder;
+  OtaFlashWriteBuffer    _flash;
+  OtaSha256              _sha256;
+  uint8_t                _header[OtaCheckpoint::HEADER_SIZE];
+  size_t                 _header_size;
+  uint32_t               _crc32;
+  uint32_t               _downloaded;
+  uint32_t               _checkpoint;
+
+  void parse(uint8_t const * data, size_t len);
+  void commit();
+};
+
+#endif /* INCLUDE_OTA_BOARD_MOCK_H_ */
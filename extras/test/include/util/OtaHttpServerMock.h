@@ -0,0 +1,95 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#ifndef INCLUDE_OTA_HTTP_SERVER_MOCK_H_
+#define INCLUDE_OTA_HTTP_SERVER_MOCK_H_
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include <Arduino.h>
+
+#undef max
+#undef min
+#include <deque>
+#include <string>
+#include <vector>
+
+/******************************************************************************
+  CLASS DECLARATION
+ ******************************************************************************/
+
+/* Local stand-in for the HTTP server hosting an .ota file, seen through the
+ * Arduino Client interface of the connection to it. Requests written to the
+ * client are answered with "200 OK" or, if they carry a Range header, with
+ * "206 Partial Content".
+ *
+ * The link is simulated on the millis() clock: connect() takes 'handshake_ms',
+ * the first byte of a response arrives 'rtt_ms' after its request has been
+ * sent and the responses are then sent back to back at 'bytes_per_ms'.
+ */
+class OtaHttpServerMock
+{
+public:
+
+  struct Link
+  {
+    unsigned long handshake_ms;
+    unsigned long rtt_ms;
+    unsigned long bytes_per_ms;
+  };
+
+  OtaHttpServerMock(std::vector<uint8_t> const & file, Link const link);
+
+  /* Client */
+  int     connect(char const * host, uint16_t const port);
+  uint8_t connected();
+  void    stop();
+  size_t  write(uint8_t const * buf, size_t const size);
+  int     available();
+  int     read();
+  int     read(uint8_t * buf, size_t const size);
+
+  /* Server behaviour: the connection is closed with "Connection: close" after
+   * that many responses, 0 keeps it open. Without range support the whole file
+   * is sent with every response.
+   */
+  size_t requests_per_connection;
+  bool   range_support;
+
+  unsigned int connections;
+  unsigned int requests;
+  std::string  last_request;
+
+private:
+
+  struct Segment
+  {
+    unsigned long        ready_ms;
+    std::vector<uint8_t> data;
+  };
+
+  std::vector<uint8_t> const _file;
+  Link const                 _link;
+
+  bool                _connected;
+  bool                _closing;
+  size_t              _responses;
+  unsigned long       _link_free_ms;
+  std::string         _rx;
+  std::deque<Segment> _tx;
+
+  void respond(std::string const & request);
+  void send(std::vector<uint8_t> const & response);
+  size_t ready() const;
+};
+
+#endif /* INCLUDE_OTA_HTTP_SERVER_MOCK_H_ */
@@ -0,0 +1,49 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#ifndef INCLUDE_OTA_TEST_UTIL_H_
+#define INCLUDE_OTA_TEST_UTIL_H_
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <vector>
+
+/******************************************************************************
+  FUNCTION DECLARATION
+ ******************************************************************************/
+
+/* Pseudo random firmware, the same 'seed' always yields the same bytes */
+std::vector<uint8_t> firmware(size_t const size, uint32_t const seed = 1);
+
+/* Firmware made of a few pseudo random words repeated in a pseudo random
+ * order, which compresses like program code does
+ */
+std::vector<uint8_t> compressibleFirmware(size_t const size, uint32_t const seed = 1);
+
+/* LZSS encoding of 'data' as done by extras/tools/lzss.py before it is uploaded */
+std::vector<uint8_t> lzss(std::vector<uint8_t> const & data);
+
+/* .ota file as served by the cloud: a 20 bytes header holding the length of
+ * the rest of the file, its CRC32, the magic number of the board and the
+ * header version, followed by the (compressed) firmware 'payload'.
+ */
+std::vector<uint8_t> otaFile(std::vector<uint8_t> const & payload, uint32_t const magic_number = 0x2341025B);
+
+uint32_t crc32(uint8_t const * data, size_t const length, uint32_t crc = 0);
+
+/* SHA-256 of 'data', as sent by the cloud in the finalSha256 of an OTA */
+std::vector<uint8_t> sha256(std::vector<uint8_t> const & data);
+
+#endif /* INCLUDE_OTA_TEST_UTIL_H_ */
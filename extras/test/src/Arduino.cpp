@@ -13,6 +13,7 @@
  ******************************************************************************/
 
 #include <Arduino.h>
+#include <Arduino_DebugUtils.h>
 
 /******************************************************************************
   GLOBAL VARIABLES
@@ -20,6 +21,8 @@
 
 static unsigned long current_millis = 0;
 
+Arduino_DebugUtils Debug;
+
 /******************************************************************************
   PUBLIC FUNCTIONS
  ******************************************************************************/
@@ -33,3 +36,21 @@ unsigned long millis()
 {
   return current_millis;
 }
+
+void Arduino_DebugUtils::print(int const debug_level, char const * fmt, ...)
+{
+  (void)fmt;
+  if (debug_level >= DBG_ERROR && debug_level <= DBG_VERBOSE)
+    _count[debug_level]++;
+}
+
+size_t Arduino_DebugUtils::count(int const debug_level) const
+{
+  return _count[debug_level];
+}
+
+void Arduino_DebugUtils::reset()
+{
+  for (size_t & c : _count)
+    c = 0;
+}
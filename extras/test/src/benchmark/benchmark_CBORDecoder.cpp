@@ -0,0 +1,81 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <cstdio>
+#include <vector>
+
+#include <utility/memory/HeapStats.h>
+
+#include <CBORDecoder.h>
+#include <PropertyContainer.h>
+#include "types/automation/CloudTelevision.h"
+
+/******************************************************************************
+  INTERNAL FUNCTION DEFINITION
+ ******************************************************************************/
+
+static void benchmarkDecode(char const * title, PropertyContainer & property_container, std::vector<uint8_t> const & payload)
+{
+  size_t const iterations = 100;
+  size_t const allocations_before = heap_stats_get().total.allocations;
+  for (size_t i = 0; i < iterations; i++)
+    CBORDecoder::decode(property_container, payload.data(), payload.size());
+  size_t const allocations = (heap_stats_get().total.allocations - allocations_before) / iterations;
+
+  std::printf("%s: %zu heap allocations per decode\n", title, allocations);
+
+  BENCHMARK(title)
+  {
+    CBORDecoder::decode(property_container, payload.data(), payload.size());
+  };
+
+  /* Records are staged in the decoder arena, a property update does not touch the heap */
+  CHECK(allocations == 0);
+}
+
+/******************************************************************************
+  BENCHMARK CODE
+ ******************************************************************************/
+
+TEST_CASE("CBOR decoding of a CloudTelevision update", "[CBORDecoder][benchmark]")
+{
+  PropertyContainer property_container;
+  CloudTelevision tv;
+  addPropertyToContainer(property_container, tv, "test", Permission::ReadWrite);
+
+  /* [{0: "test:swi", 4: true},{0: "test:vol", 2: 50},{0: "test:mut", 2: false},{0: "test:pbc", 2: 3},{0: "test:inp", 2: 55},{0: "test:cha", 2: 7}] */
+  std::vector<uint8_t> const payload = {0x9F, 0xA2, 0x00, 0x68, 0x74, 0x65, 0x73, 0x74, 0x3A, 0x73, 0x77, 0x69, 0x04, 0xF5, 0xA2, 0x00, 0x68, 0x74, 0x65, 0x73, 0x74, 0x3A, 0x76, 0x6F, 0x6C, 0x02, 0x18, 0x32, 0xA2, 0x00, 0x68, 0x74, 0x65, 0x73, 0x74, 0x3A, 0x6D, 0x75, 0x74, 0x04, 0xF4, 0xA2, 0x00, 0x68, 0x74, 0x65, 0x73, 0x74, 0x3A, 0x70, 0x62, 0x63, 0x02, 0x03, 0xA2, 0x00, 0x68, 0x74, 0x65, 0x73, 0x74, 0x3A, 0x69, 0x6E, 0x70, 0x02, 0x18, 0x37, 0xA2, 0x00, 0x68, 0x74, 0x65, 0x73, 0x74, 0x3A, 0x63, 0x68, 0x61, 0x02, 0x07, 0xFF};
+
+  benchmarkDecode("decode CloudTelevision", property_container, payload);
+}
+
+TEST_CASE("CBOR decoding of an update of multiple primitive properties", "[CBORDecoder][benchmark]")
+{
+  PropertyContainer property_container;
+  CloudBool  bool_test = false;
+  CloudInt   int_test = 1;
+  CloudFloat float_test = 2.0f;
+
+  addPropertyToContainer(property_container, bool_test,  "bool_test",  Permission::ReadWrite);
+  addPropertyToContainer(property_container, int_test,   "int_test",   Permission::ReadWrite);
+  addPropertyToContainer(property_container, float_test, "float_test", Permission::ReadWrite);
+
+  /* [{0: "bool_test", 4: true}, {0: "int_test", 2: 10}, {0: "float_test", 2: 20.0}] */
+  std::vector<uint8_t> const payload = {0x83, 0xA2, 0x00, 0x69, 0x62, 0x6F, 0x6F, 0x6C, 0x5F, 0x74, 0x65, 0x73, 0x74, 0x04, 0xF5, 0xA2, 0x00, 0x68, 0x69, 0x6E, 0x74, 0x5F, 0x74, 0x65, 0x73, 0x74, 0x02, 0x0A, 0xA2, 0x00, 0x6A, 0x66, 0x6C, 0x6F, 0x61, 0x74, 0x5F, 0x74, 0x65, 0x73, 0x74, 0x02, 0xF9, 0x4D, 0x00};
+
+  benchmarkDecode("decode 3 primitive properties", property_container, payload);
+}
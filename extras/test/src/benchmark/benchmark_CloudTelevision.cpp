@@ -0,0 +1,95 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include <utility/memory/HeapStats.h>
+
+#include <CBORDecoder.h>
+#include <CBOREncoder.h>
+#include <PropertyContainer.h>
+#include <types/automation/CloudTelevision.h>
+
+/******************************************************************************
+  INTERNAL FUNCTION DEFINITION
+ ******************************************************************************/
+
+static size_t const TELEVISION_ATTRIBUTES = 6;
+
+static size_t encode(PropertyContainer & property_container, std::vector<uint8_t> & buf, bool const light_payload)
+{
+  for (Property * property : property_container)
+    property->provideEcho();
+
+  int bytes_encoded = 0;
+  unsigned int current_property_index = 0;
+  CBOREncoder::encode(property_container, buf.data(), buf.size(), bytes_encoded, current_property_index, light_payload);
+  return bytes_encoded;
+}
+
+template <typename Op>
+static void report(char const * title, Op op)
+{
+  size_t const iterations = 10000;
+
+  size_t const allocations_before = heap_stats_get().total.allocations;
+  auto const start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; i++)
+    op();
+  auto const stop = std::chrono::steady_clock::now();
+  size_t const allocations = heap_stats_get().total.allocations - allocations_before;
+
+  double const attributes = static_cast<double>(iterations * TELEVISION_ATTRIBUTES);
+  double const ns = std::chrono::duration<double, std::nano>(stop - start).count();
+  std::printf("%-45s %8.1f ns/attribute %6.2f allocs/attribute\n", title, ns / attributes, allocations / attributes);
+
+  BENCHMARK(title)
+  {
+    return op();
+  };
+}
+
+/******************************************************************************
+  BENCHMARK CODE
+ ******************************************************************************/
+
+TEST_CASE("Encoding and decoding of a CloudTelevision", "[CloudTelevision][benchmark]")
+{
+  PropertyContainer property_container;
+  CloudTelevision tv = CloudTelevision(true, 50, false, PlaybackCommands::Play, InputValue::TV, 7);
+  addPropertyToContainer(property_container, tv, "living_room_television", Permission::ReadWrite, 1);
+
+  std::vector<uint8_t> buf(256);
+
+  report("CloudTelevision encode", [&]() {
+    return encode(property_container, buf, false);
+  });
+
+  report("CloudTelevision light payload encode", [&]() {
+    return encode(property_container, buf, true);
+  });
+
+  std::vector<uint8_t> payload(buf.begin(), buf.begin() + encode(property_container, buf, false));
+  REQUIRE(payload.size() > 0);
+
+  report("CloudTelevision decode", [&]() {
+    CBORDecoder::decode(property_container, payload.data(), payload.size());
+    return payload.size();
+  });
+}
@@ -0,0 +1,79 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <CBOREncoder.h>
+#include <PropertyContainer.h>
+#include <types/CloudFloat.h>
+
+/******************************************************************************
+  INTERNAL FUNCTION DEFINITION
+ ******************************************************************************/
+
+/* Encodes all the properties of the container into messages of 'frame_size'
+ * bytes and reports the number of messages and the bytes per message.
+ */
+static void report(char const * title, PropertyContainer & property_container, size_t const frame_size, bool const light_payload, bool const compact_payload)
+{
+  for (Property * property : property_container)
+    property->provideEcho();
+
+  std::vector<uint8_t> frame(frame_size);
+  unsigned int current_property_index = 0;
+  size_t messages = 0;
+  size_t bytes = 0;
+  for (;;)
+  {
+    int bytes_encoded = 0;
+    REQUIRE(CBOREncoder::encode(property_container, frame.data(), frame.size(), bytes_encoded, current_property_index, light_payload, compact_payload) == CborNoError);
+    if (bytes_encoded <= 0)
+      break;
+    messages++;
+    bytes += bytes_encoded;
+  }
+
+  std::printf("%-32s %5zu bytes %3zu messages %6.1f bytes/message %5.2f bytes/property\n",
+              title, bytes, messages, static_cast<double>(bytes) / messages, static_cast<double>(bytes) / property_container.size());
+}
+
+/******************************************************************************
+  BENCHMARK CODE
+ ******************************************************************************/
+
+TEST_CASE("Size of the messages of a thing of 100 floats", "[CompactPayload][benchmark]")
+{
+  size_t const num_properties = 100;
+  size_t const frame_size = 256;
+
+  /* Sensor readings with two decimals published with a minimum delta of 0.01 */
+  std::vector<CloudFloat> properties(num_properties, CloudFloat(0.0f));
+  std::vector<std::string> names;
+  PropertyContainer property_container;
+  for (size_t i = 0; i < num_properties; i++)
+  {
+    names.push_back("sensor_" + std::to_string(i));
+    properties[i] = 200.0f + static_cast<float>((i * 37) % 500) / 100.0f;
+    addPropertyToContainer(property_container, properties[i], names[i].c_str(), Permission::ReadWrite, i + 1).publishOnChange(0.01f);
+  }
+
+  report("Default", property_container, frame_size, false, false);
+  report("Compact", property_container, frame_size, false, true);
+  report("Light payload", property_container, frame_size, true, false);
+  report("Light payload, compact", property_container, frame_size, true, true);
+}
@@ -0,0 +1,110 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <cstdio>
+#include <vector>
+
+#include <util/MqttClientMock.h>
+
+#include <utility/mqtt/MqttPropertyUplink.h>
+#include <PropertyContainer.h>
+#include <types/CloudInt.h>
+
+/******************************************************************************
+  CONSTANTS
+ ******************************************************************************/
+
+/* Simulated duration of a sketch loop() iteration calling ArduinoCloud.update() */
+static unsigned long const LOOP_PERIOD_ms = 10;
+
+/******************************************************************************
+  INTERNAL FUNCTION DEFINITION
+ ******************************************************************************/
+
+struct FlushResult
+{
+  size_t ticks;
+  size_t frames;
+  size_t bytes;
+};
+
+static FlushResult flush(PropertyContainer & property_container, std::vector<CloudInt> & props, MqttPropertyUplink & uplink, MqttClientMock & client, int const value)
+{
+  for (CloudInt & p : props)
+    p = value;
+
+  client.clearPublished();
+  unsigned int current_property_index = 0;
+  FlushResult result{0, 0, 0};
+
+  for (;;)
+  {
+    size_t const frames = uplink.send(property_container, current_property_index,
+      [&client](uint8_t const * frame, size_t const length)
+      {
+        return client.beginMessage("/a/t/thing/e/o", length, false, 0) &&
+               client.write(frame, length) &&
+               client.endMessage();
+      });
+    if (frames == 0)
+      break;
+    result.ticks++;
+    result.frames += frames;
+    set_millis(millis() + LOOP_PERIOD_ms);
+  }
+
+  for (std::vector<uint8_t> const & frame : client.published)
+    result.bytes += frame.size();
+
+  return result;
+}
+
+static void benchmarkFlush(char const * title, size_t const frame_size, size_t const bytes_per_tick)
+{
+  PropertyContainer property_container;
+  std::vector<CloudInt> props(100, CloudInt(0));
+  for (size_t i = 0; i < props.size(); i++)
+    addPropertyToContainer(property_container, props[i], String("property_") + std::to_string(i), Permission::ReadWrite).publishOnChange(0, 0);
+
+  MqttClientMock client;
+  MqttPropertyUplink uplink;
+  REQUIRE(uplink.begin(frame_size, bytes_per_tick, 1000));
+
+  set_millis(0);
+  FlushResult const result = flush(property_container, props, uplink, client, 1);
+
+  std::printf("%s: %zu ticks (%lu ms at %lu ms per loop), %zu frames, %zu bytes to flush 100 properties\n",
+              title, result.ticks, result.ticks * LOOP_PERIOD_ms, LOOP_PERIOD_ms, result.frames, result.bytes);
+
+  int value = 2;
+  BENCHMARK(title)
+  {
+    return flush(property_container, props, uplink, client, value++).frames;
+  };
+}
+
+/******************************************************************************
+  BENCHMARK CODE
+ ******************************************************************************/
+
+TEST_CASE("Time to flush 100 pending properties", "[MqttPropertyUplink][benchmark]")
+{
+  benchmarkFlush("one 256 byte frame per tick",  256,  0);
+  benchmarkFlush("256 byte frames, 1 KiB per tick", 256,  1024);
+  benchmarkFlush("256 byte frames, 4 KiB per tick", 256,  4096);
+  benchmarkFlush("1 KiB frames, 4 KiB per tick",   1024, 4096);
+}
@@ -0,0 +1,118 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include <Arduino.h>
+
+#include <utility/memory/HeapStats.h>
+#include <utility/mqtt/MqttTopics.h>
+
+/******************************************************************************
+  INTERNAL FUNCTION DEFINITION
+ ******************************************************************************/
+
+/* Stands in for MqttClient, whose String overload of beginMessage() forwards to the char const * one */
+class CountingMqttClient
+{
+public:
+  int beginMessage(char const * topic, unsigned long size, bool /* retain */ = false, uint8_t /* qos */ = 0, bool /* dup */ = false)
+  {
+    topic_length = strlen(topic);
+    expected = size;
+    written = 0;
+    return 1;
+  }
+  int beginMessage(String const & topic, unsigned long size, bool retain = false, uint8_t qos = 0, bool dup = false)
+  {
+    return beginMessage(topic.c_str(), size, retain, qos, dup);
+  }
+  size_t write(uint8_t const * /* buf */, size_t size) { written += size; return size; }
+  int endMessage() { messages++; return written == expected; }
+
+  size_t topic_length = 0;
+  unsigned long expected = 0;
+  size_t written = 0;
+  size_t messages = 0;
+};
+
+/* The publish path before the topics were precomputed: the topic String is
+ * passed by value to sendPropertyContainerToCloud() and to write()
+ */
+static int writeString(CountingMqttClient & client, String const topic, uint8_t const * data, int const length)
+{
+  return client.beginMessage(topic, length, false, 1, false) && client.write(data, length) && client.endMessage();
+}
+
+static void sendString(CountingMqttClient & client, String const topic, uint8_t const * data, int const length)
+{
+  writeString(client, topic, data, length);
+}
+
+static int writeTopic(CountingMqttClient & client, char const * topic, uint8_t const * data, int const length)
+{
+  return client.beginMessage(topic, length, false, 1, false) && client.write(data, length) && client.endMessage();
+}
+
+static void sendTopic(CountingMqttClient & client, char const * topic, uint8_t const * data, int const length)
+{
+  writeTopic(client, topic, data, length);
+}
+
+template <typename PublishFunc>
+static void report(char const * method, size_t const num_publish, PublishFunc publish)
+{
+  size_t const allocations_before = heap_stats_get().total.allocations;
+  auto const start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < num_publish; i++)
+    publish();
+  auto const elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+  size_t const allocations = heap_stats_get().total.allocations - allocations_before;
+
+  std::printf("%-24s %8.1f ns/publish %6.2f allocations/publish\n",
+              method, static_cast<double>(elapsed.count()) / num_publish, static_cast<double>(allocations) / num_publish);
+}
+
+/******************************************************************************
+  BENCHMARK CODE
+ ******************************************************************************/
+
+TEST_CASE("Overhead of publishing a property frame", "[MqttPublish][benchmark]")
+{
+  size_t const num_publish = 100000;
+  char const * thing_id = "d1f7e0a2-3b4c-4d5e-8f90-a1b2c3d4e5f6";
+  std::vector<uint8_t> const frame(64, 0xA5);
+  CountingMqttClient client;
+
+  String const data_topic_out = String("/a/t/") + thing_id + "/e/o";
+  report("String topic", num_publish, [&]()
+  {
+    sendString(client, data_topic_out, frame.data(), static_cast<int>(frame.size()));
+  });
+
+  MqttTopics topics;
+  topics.begin("8b10b5a8-a6c8-4a6e-8fca-e8a9b4b1b2c3");
+  topics.attachThing(thing_id);
+  report("precomputed topic", num_publish, [&]()
+  {
+    sendTopic(client, topics.dataOut(), frame.data(), static_cast<int>(frame.size()));
+  });
+
+  REQUIRE(client.messages == 2 * num_publish);
+}
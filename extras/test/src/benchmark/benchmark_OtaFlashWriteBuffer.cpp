@@ -0,0 +1,90 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+#include <util/OtaTestUtil.h>
+
+#include <ota/utility/OtaFlashWriteBuffer.h>
+
+/******************************************************************************
+  INTERNAL FUNCTION DEFINITION
+ ******************************************************************************/
+
+/* Stands in for writeFlash(), appending to the update file like fwrite() on the
+ * boards storing the update in a file system
+ */
+class FlashFileMock
+{
+public:
+  int write(uint8_t * const buffer, size_t len)
+  {
+    calls++;
+    file.insert(file.end(), buffer, buffer + len);
+    return static_cast<int>(len);
+  }
+
+  std::vector<uint8_t> file;
+  size_t calls = 0;
+};
+
+/* Feeds the image through the putc callback of the LZSS decoder */
+static void report(char const * method, std::vector<uint8_t> const & image, FlashFileMock & flash, std::function<void(uint8_t)> putc, std::function<void()> end)
+{
+  auto const start = std::chrono::steady_clock::now();
+  for (uint8_t const c : image)
+    putc(c);
+  end();
+  auto const elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+  double const mb = static_cast<double>(image.size()) / (1024 * 1024);
+  std::printf("%-24s %8.1f ms/MB %8.0f writeFlash calls/MB\n",
+              method, static_cast<double>(elapsed.count()) / 1000 / mb, flash.calls / mb);
+}
+
+/******************************************************************************
+  BENCHMARK CODE
+ ******************************************************************************/
+
+TEST_CASE("Writing the decompressed firmware to the update storage", "[OtaFlashWriteBuffer][benchmark]")
+{
+  std::vector<uint8_t> const image = firmware(4 * 1024 * 1024);
+  bool write_error = false;
+
+  FlashFileMock bytewise;
+  report("byte-wise writeFlash", image, bytewise, [&](uint8_t c)
+  {
+    if (bytewise.write(&c, 1) != 1)
+      write_error = true;
+  }, []() { });
+
+  FlashFileMock paged;
+  OtaFlashWriteBuffer buffer([&](uint8_t * const data, size_t len) { return paged.write(data, len); });
+  buffer.begin(4096);
+  report("4KB page writeFlash", image, paged, [&](uint8_t c)
+  {
+    if (!buffer.put(c))
+      write_error = true;
+  }, [&]() { write_error = !buffer.flush() || write_error; });
+
+  REQUIRE_FALSE(write_error);
+  REQUIRE(bytewise.file == image);
+  REQUIRE(paged.file == image);
+  REQUIRE(paged.calls == image.size() / 4096);
+}
@@ -0,0 +1,107 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <list>
+#include <vector>
+#include <algorithm>
+
+#include <PropertyContainer.h>
+#include <CBOREncoder.h>
+#include <types/CloudInt.h>
+
+/******************************************************************************
+  INTERNAL FUNCTION DEFINITION
+ ******************************************************************************/
+
+/* Lookup as it was done when the container was a plain std::list, kept as a reference */
+static Property * linearLookup(std::list<Property *> & prop_list, String const & name)
+{
+  auto iter = std::find_if(prop_list.begin(), prop_list.end(), [&name](Property * p) { return p->name() == name; });
+  return (iter == prop_list.end()) ? nullptr : *iter;
+}
+
+static void benchmarkLookup(size_t const num_properties)
+{
+  PropertyContainer property_container;
+  std::list<Property *> property_list;
+  std::vector<CloudInt> props(num_properties);
+  std::vector<String> names;
+
+  for (size_t i = 0; i < num_properties; i++)
+  {
+    names.push_back(String("property_") + std::to_string(i));
+    addPropertyToContainer(property_container, props[i], names[i], Permission::ReadWrite);
+    property_list.push_back(&props[i]);
+  }
+
+  BENCHMARK("linear lookup by name, " + std::to_string(num_properties) + " properties")
+  {
+    size_t found = 0;
+    for (String const & name : names)
+      found += (linearLookup(property_list, name) != nullptr);
+    return found;
+  };
+
+  BENCHMARK("hashed lookup by name, " + std::to_string(num_properties) + " properties")
+  {
+    size_t found = 0;
+    for (String const & name : names)
+      found += (getProperty(property_container, name) != nullptr);
+    return found;
+  };
+
+  BENCHMARK("direct lookup by identifier, " + std::to_string(num_properties) + " properties")
+  {
+    size_t found = 0;
+    for (size_t i = 1; i <= num_properties; i++)
+      found += (getProperty(property_container, static_cast<int>(i)) != nullptr);
+    return found;
+  };
+}
+
+/******************************************************************************
+  BENCHMARK CODE
+ ******************************************************************************/
+
+TEST_CASE("Property lookup, full sync of all properties", "[PropertyContainer][benchmark]")
+{
+  SECTION("10 properties")   { benchmarkLookup(10); }
+  SECTION("100 properties")  { benchmarkLookup(100); }
+  SECTION("1000 properties") { benchmarkLookup(1000); }
+}
+
+TEST_CASE("Encoder idle loop, no property modified", "[PropertyContainer][benchmark]")
+{
+  PropertyContainer property_container;
+  std::vector<CloudInt> props(200);
+  uint8_t data[256];
+  int bytes_encoded = 0;
+  unsigned int current_property_index = 0;
+
+  for (size_t i = 0; i < props.size(); i++)
+    addPropertyToContainer(property_container, props[i], String("property_") + std::to_string(i), Permission::ReadWrite);
+
+  do {
+    CBOREncoder::encode(property_container, data, sizeof(data), bytes_encoded, current_property_index, false);
+  } while (bytes_encoded > 0);
+
+  BENCHMARK("encode, 200 unchanged properties")
+  {
+    CBOREncoder::encode(property_container, data, sizeof(data), bytes_encoded, current_property_index, false);
+    return bytes_encoded;
+  };
+}
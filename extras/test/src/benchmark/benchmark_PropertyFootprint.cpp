@@ -0,0 +1,72 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <utility/memory/HeapStats.h>
+
+#include <PropertyContainer.h>
+#include <PropertyNameTable.h>
+#include <types/CloudWrapperInt.h>
+#include <types/automation/CloudTelevision.h>
+
+/******************************************************************************
+  INTERNAL FUNCTION DEFINITION
+ ******************************************************************************/
+
+/* Adds 'num_properties' properties of type T to a container and reports the
+ * size of the object and the heap memory charged to every property.
+ */
+template <typename T, typename... Args>
+static void report(char const * type, size_t const num_properties, Args... args)
+{
+  std::vector<T> properties(num_properties, T(args...));
+  PropertyContainer property_container;
+
+  size_t const heap_before = heap_stats_get()[HeapSubsystem::Property].current_bytes;
+  size_t const table_before = PropertyNameTable::capacity();
+  for (size_t i = 0; i < num_properties; i++)
+    addPropertyToContainer(property_container, properties[i], String("property_") + std::to_string(i), Permission::ReadWrite);
+  size_t const heap = heap_stats_get()[HeapSubsystem::Property].current_bytes - heap_before;
+  size_t const table = PropertyNameTable::capacity() - table_before;
+
+  std::printf("%-20s %6zu bytes/object %8.1f heap bytes/property, container included (%5.1f in the name table)\n",
+              type, sizeof(T), static_cast<double>(heap) / num_properties, static_cast<double>(table) / num_properties);
+}
+
+/******************************************************************************
+  BENCHMARK CODE
+ ******************************************************************************/
+
+TEST_CASE("Memory footprint of the properties", "[PropertyFootprint][benchmark]")
+{
+  int value = 0;
+  size_t const num_properties = 200;
+
+  std::printf("%-20s %6zu bytes/object\n", "Property", sizeof(Property));
+  report<CloudBool>("CloudBool", num_properties, false);
+  report<CloudInt>("CloudInt", num_properties, 0);
+  report<CloudFloat>("CloudFloat", num_properties, 0.0f);
+  report<CloudString>("CloudString", num_properties, "");
+  report<CloudWrapperInt>("CloudWrapperInt", num_properties, std::ref(value));
+  report<CloudLocation>("CloudLocation", num_properties, 0.0f, 0.0f);
+  report<CloudColor>("CloudColor", num_properties, 0.0f, 0.0f, 0.0f);
+  report<CloudSchedule>("CloudSchedule", num_properties, 0, 0, 0, 0);
+  report<CloudTelevision>("CloudTelevision", num_properties, false, 0, false, PlaybackCommands::Play, InputValue::TV, 0);
+}
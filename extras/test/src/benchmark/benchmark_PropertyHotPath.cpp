@@ -0,0 +1,170 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <utility/memory/HeapStats.h>
+
+#include <AIoTC_Config.h>
+#include <CBORDecoder.h>
+#include <CBOREncoder.h>
+#include <PropertyContainer.h>
+#include <types/CloudFloat.h>
+#include <types/CloudString.h>
+#include <types/CloudColor.h>
+#include <types/CloudLocation.h>
+#include <types/CloudSchedule.h>
+
+/******************************************************************************
+  INTERNAL FUNCTION DEFINITION
+ ******************************************************************************/
+
+/* Thing made of an even mix of CloudFloat, CloudString, CloudColor, CloudLocation and CloudSchedule */
+class MixedThing
+{
+public:
+
+  MixedThing(size_t const num_properties)
+  : _floats   (num_properties / 5 + 1, CloudFloat(1.5f))
+  , _strings  (num_properties / 5 + 1, CloudString("hello world"))
+  , _colors   (num_properties / 5 + 1, CloudColor(120.0f, 50.0f, 80.0f))
+  , _locations(num_properties / 5 + 1, CloudLocation(45.46f, 9.19f))
+  , _schedules(num_properties / 5 + 1, CloudSchedule(1633305600, 1633651200, 600, 1140850708))
+  {
+    for (size_t i = 0; i < num_properties; i++)
+    {
+      String const name = String("property_") + std::to_string(i);
+      switch (i % 5)
+      {
+        case 0: addPropertyToContainer(property_container, _floats   [i / 5], name, Permission::ReadWrite); break;
+        case 1: addPropertyToContainer(property_container, _strings  [i / 5], name, Permission::ReadWrite); break;
+        case 2: addPropertyToContainer(property_container, _colors   [i / 5], name, Permission::ReadWrite); break;
+        case 3: addPropertyToContainer(property_container, _locations[i / 5], name, Permission::ReadWrite); break;
+        case 4: addPropertyToContainer(property_container, _schedules[i / 5], name, Permission::ReadWrite); break;
+      }
+    }
+  }
+
+  PropertyContainer property_container;
+
+private:
+
+  std::vector<CloudFloat>    _floats;
+  std::vector<CloudString>   _strings;
+  std::vector<CloudColor>    _colors;
+  std::vector<CloudLocation> _locations;
+  std::vector<CloudSchedule> _schedules;
+};
+
+/* Encodes every property of the thing into MQTT frames, returns the number of encoded bytes */
+static size_t encodeAll(PropertyContainer & property_container, std::vector<uint8_t> & frame, bool const light_payload)
+{
+  for (Property * property : property_container)
+    property->provideEcho();
+
+  size_t bytes = 0;
+  unsigned int current_property_index = 0;
+  for (;;)
+  {
+    int bytes_encoded = 0;
+    if (CBOREncoder::encode(property_container, frame.data(), frame.size(), bytes_encoded, current_property_index, light_payload) != CborNoError || bytes_encoded == 0)
+      break;
+    bytes += bytes_encoded;
+  }
+  return bytes;
+}
+
+/* Encodes every property of the thing into a single message as sent by the cloud */
+static std::vector<uint8_t> encodeSingleMessage(PropertyContainer & property_container)
+{
+  for (Property * property : property_container)
+    property->provideEcho();
+
+  std::vector<uint8_t> payload(256 * 1024);
+  int bytes_encoded = 0;
+  unsigned int current_property_index = 0;
+  REQUIRE(CBOREncoder::encode(property_container, payload.data(), payload.size(), bytes_encoded, current_property_index, false) == CborNoError);
+  payload.resize(bytes_encoded);
+  return payload;
+}
+
+template <typename Op>
+static void report(std::string const & title, Op op)
+{
+  size_t const iterations = 100;
+  size_t bytes = 0;
+
+  size_t const allocations_before = heap_stats_get().total.allocations;
+  auto const start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; i++)
+    bytes += op();
+  auto const stop = std::chrono::steady_clock::now();
+  size_t const allocations = heap_stats_get().total.allocations - allocations_before;
+
+  double const ns = std::chrono::duration<double, std::nano>(stop - start).count();
+  std::printf("%-45s %12.0f ns/op %8zu bytes/op %8.1f allocs/op\n",
+              title.c_str(), ns / iterations, bytes / iterations, static_cast<double>(allocations) / iterations);
+
+  BENCHMARK(title.c_str())
+  {
+    return op();
+  };
+}
+
+static void benchmarkHotPath(size_t const num_properties)
+{
+  MixedThing thing(num_properties);
+  PropertyContainer & property_container = thing.property_container;
+  std::string const suffix = ", " + std::to_string(num_properties) + " mixed properties";
+  std::vector<uint8_t> frame(AIOT_CONFIG_MQTT_TX_BUFFER_SIZE);
+
+  report("encode" + suffix, [&]() {
+    return encodeAll(property_container, frame, false);
+  });
+
+  report("light payload encode" + suffix, [&]() {
+    return encodeAll(property_container, frame, true);
+  });
+
+  std::vector<uint8_t> const payload = encodeSingleMessage(property_container);
+  CBORDecoder decoder(property_container);
+  REQUIRE(decoder.feed(payload.data(), payload.size()) == CBORDecoder::Status::Complete);
+
+  report("decode" + suffix, [&]() {
+    CBORDecoder::decode(property_container, payload.data(), payload.size());
+    return payload.size();
+  });
+
+  report("sync decode" + suffix, [&]() {
+    CBORDecoder::decode(property_container, payload.data(), payload.size(), true);
+    return payload.size();
+  });
+}
+
+/******************************************************************************
+  BENCHMARK CODE
+ ******************************************************************************/
+
+TEST_CASE("Encoding and decoding of mixed things", "[PropertyHotPath][benchmark]")
+{
+  benchmarkHotPath(10);
+  benchmarkHotPath(100);
+  benchmarkHotPath(1000);
+}
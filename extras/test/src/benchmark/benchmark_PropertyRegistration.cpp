@@ -0,0 +1,89 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <utility/memory/HeapStats.h>
+
+#include <PropertyContainer.h>
+#include <types/CloudWrapperInt.h>
+
+/******************************************************************************
+  INTERNAL FUNCTION DEFINITION
+ ******************************************************************************/
+
+static void report(char const * method, size_t const num_properties, std::chrono::nanoseconds const elapsed, size_t const allocations)
+{
+  std::printf("%-28s %5zu properties %10.1f us %8.1f ns/property %6zu allocations\n",
+              method, num_properties, elapsed.count() / 1000.0, static_cast<double>(elapsed.count()) / num_properties, allocations);
+}
+
+/******************************************************************************
+  BENCHMARK CODE
+ ******************************************************************************/
+
+TEST_CASE("Startup time of a thing of 500 properties", "[PropertyRegistration][benchmark]")
+{
+  size_t const num_properties = 500;
+  std::vector<int> values(num_properties, 0);
+  std::vector<String> names;
+  for (size_t i = 0; i < num_properties; i++)
+    names.push_back(String("property_") + std::to_string(i));
+
+  SECTION("Properties added one by one")
+  {
+    /* The same as ArduinoIoTCloudClass::addPropertyReal() does for primitive variables */
+    std::vector<std::unique_ptr<CloudWrapperInt>> wrappers;
+    PropertyContainer property_container;
+
+    size_t const allocations_before = heap_stats_get().total.allocations;
+    auto const start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < num_properties; i++) {
+      CloudWrapperInt * p = new CloudWrapperInt(values[i]);
+      addPropertyToContainer(property_container, *p, names[i], Permission::ReadWrite).publishOnChange(0.0f);
+      wrappers.emplace_back(p);
+    }
+    auto const elapsed = std::chrono::steady_clock::now() - start;
+    size_t const allocations = heap_stats_get().total.allocations - allocations_before;
+
+    report("addPropertyToContainer", num_properties, elapsed, allocations);
+  }
+
+  SECTION("Properties added from a descriptor table")
+  {
+    /* Stands in for the statically allocated wrappers and constexpr table of a sketch */
+    std::vector<CloudWrapperInt> wrappers;
+    wrappers.reserve(num_properties);
+    std::vector<PropertyDescriptor> descriptors;
+    for (size_t i = 0; i < num_properties; i++) {
+      wrappers.emplace_back(values[i]);
+      descriptors.push_back(propertyDescriptor(wrappers[i], names[i].c_str(), Permission::ReadWrite).publishOnChange(0.0f));
+    }
+    PropertyContainer property_container;
+
+    size_t const allocations_before = heap_stats_get().total.allocations;
+    auto const start = std::chrono::steady_clock::now();
+    addPropertiesToContainer(property_container, descriptors.data(), descriptors.size());
+    auto const elapsed = std::chrono::steady_clock::now() - start;
+    size_t const allocations = heap_stats_get().total.allocations - allocations_before;
+
+    report("addPropertiesToContainer", num_properties, elapsed, allocations);
+  }
+}
@@ -0,0 +1,70 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <utility/memory/BumpArena.h>
+
+/******************************************************************************
+  TEST CODE
+ ******************************************************************************/
+
+SCENARIO("Memory is handed out sequentially by the arena", "[BumpArena]")
+{
+  BumpArena<64> arena;
+
+  WHEN("Allocations fit into the inline storage")
+  {
+    uint8_t * a = static_cast<uint8_t *>(arena.allocate(3, 1));
+    double * b = arena.create<double>();
+
+    THEN("They are served from the inline storage with the requested alignment") {
+      REQUIRE(a != nullptr);
+      REQUIRE(b != nullptr);
+      REQUIRE(reinterpret_cast<uintptr_t>(b) % alignof(double) == 0);
+      REQUIRE(arena.used() == 8 + sizeof(double));
+      REQUIRE(arena.overflowAllocations() == 0);
+    }
+  }
+
+  WHEN("An allocation does not fit into the inline storage")
+  {
+    arena.allocate(60, 1);
+    uint8_t * big = static_cast<uint8_t *>(arena.allocate(100, 1));
+
+    THEN("It is served from the heap and released on reset") {
+      REQUIRE(big != nullptr);
+      big[99] = 0xAA;
+      REQUIRE(arena.overflowAllocations() == 1);
+      REQUIRE(arena.used() == 60);
+      arena.reset();
+      REQUIRE(arena.used() == 0);
+      REQUIRE(arena.allocate(64, 1) != nullptr);
+      REQUIRE(arena.overflowAllocations() == 1);
+    }
+  }
+
+  WHEN("The arena is rewound to a mark")
+  {
+    arena.allocate(10, 1);
+    BumpArena<64>::Mark const m = arena.mark();
+    arena.allocate(20, 1);
+    arena.allocate(100, 1);
+    arena.rewind(m);
+
+    THEN("Everything allocated after the mark is released") {
+      REQUIRE(arena.used() == 10);
+    }
+  }
+}
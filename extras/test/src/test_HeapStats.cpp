@@ -0,0 +1,275 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+#include <util/CBORTestUtil.h>
+#include <util/MqttClientMock.h>
+
+#include <utility/memory/HeapStats.h>
+#include <utility/memory/ObjectPool.h>
+#include <utility/mqtt/MqttOutboundQueue.h>
+#include <utility/mqtt/MqttPropertyUplink.h>
+#include <CBORDecoder.h>
+#include <PropertyContainer.h>
+#include <types/CloudBool.h>
+#include <types/CloudInt.h>
+#include <types/CloudFloat.h>
+#include <types/CloudLocation.h>
+#include <types/automation/CloudTelevision.h>
+
+/******************************************************************************
+  TEST CODE
+ ******************************************************************************/
+
+SCENARIO("Heap allocations are charged to the active subsystem", "[HeapStats]")
+{
+  heap_stats_reset();
+
+  WHEN("An object is allocated within a scope")
+  {
+    HeapStats const before = heap_stats_get();
+    int * value = nullptr;
+    {
+      AIOT_HEAP_STATS_SCOPE(Cbor);
+      value = new int(42);
+    }
+    HeapStats const allocated = heap_stats_get();
+    delete value;
+    HeapStats const released = heap_stats_get();
+
+    THEN("The allocation and the release are charged to this subsystem") {
+      REQUIRE(allocated[HeapSubsystem::Cbor].allocations == before[HeapSubsystem::Cbor].allocations + 1);
+      REQUIRE(allocated[HeapSubsystem::Cbor].allocated_bytes == before[HeapSubsystem::Cbor].allocated_bytes + sizeof(int));
+      REQUIRE(allocated[HeapSubsystem::Cbor].current_bytes == before[HeapSubsystem::Cbor].current_bytes + sizeof(int));
+      REQUIRE(allocated[HeapSubsystem::Cbor].peak_bytes >= allocated[HeapSubsystem::Cbor].current_bytes);
+      REQUIRE(allocated[HeapSubsystem::Mqtt].allocations == before[HeapSubsystem::Mqtt].allocations);
+
+      REQUIRE(released[HeapSubsystem::Cbor].deallocations == before[HeapSubsystem::Cbor].deallocations + 1);
+      REQUIRE(released[HeapSubsystem::Cbor].current_bytes == before[HeapSubsystem::Cbor].current_bytes);
+      REQUIRE(released[HeapSubsystem::Cbor].peak_bytes == allocated[HeapSubsystem::Cbor].peak_bytes);
+    }
+  }
+
+  WHEN("Scopes are nested")
+  {
+    HeapStats const before = heap_stats_get();
+    {
+      AIOT_HEAP_STATS_SCOPE(Mqtt);
+      {
+        AIOT_HEAP_STATS_SCOPE(Ota);
+        delete new int(1);
+      }
+      delete new int(2);
+    }
+
+    THEN("The innermost scope is charged and the outer one is restored on exit") {
+      HeapStats const after = heap_stats_get();
+      REQUIRE(after[HeapSubsystem::Ota].allocations  == before[HeapSubsystem::Ota].allocations  + 1);
+      REQUIRE(after[HeapSubsystem::Mqtt].allocations == before[HeapSubsystem::Mqtt].allocations + 1);
+    }
+  }
+
+#if !defined(__SANITIZE_ADDRESS__)
+  WHEN("Memory is allocated with malloc()")
+  {
+    HeapStats const before = heap_stats_get();
+    void * ptr = nullptr;
+    {
+      AIOT_HEAP_STATS_SCOPE(Ota);
+      ptr = malloc(100);
+    }
+    HeapStats const allocated = heap_stats_get();
+    free(ptr);
+    HeapStats const released = heap_stats_get();
+
+    THEN("It is accounted like operator new") {
+      REQUIRE(allocated[HeapSubsystem::Ota].allocations == before[HeapSubsystem::Ota].allocations + 1);
+      REQUIRE(allocated[HeapSubsystem::Ota].current_bytes == before[HeapSubsystem::Ota].current_bytes + 100);
+      REQUIRE(released[HeapSubsystem::Ota].current_bytes == before[HeapSubsystem::Ota].current_bytes);
+    }
+  }
+#endif
+
+  WHEN("The statistics are reset")
+  {
+    std::vector<int> * live = nullptr;
+    {
+      AIOT_HEAP_STATS_SCOPE(Property);
+      live = new std::vector<int>(16);
+    }
+    heap_stats_reset();
+    HeapStats const after_reset = heap_stats_get();
+    delete live;
+
+    THEN("Counters restart while the currently allocated bytes are kept") {
+      REQUIRE(after_reset[HeapSubsystem::Property].allocations == 0);
+      REQUIRE(after_reset[HeapSubsystem::Property].allocated_bytes == 0);
+      REQUIRE(after_reset[HeapSubsystem::Property].current_bytes >= 16 * sizeof(int));
+      REQUIRE(after_reset[HeapSubsystem::Property].peak_bytes == after_reset[HeapSubsystem::Property].current_bytes);
+      REQUIRE(heap_stats_get()[HeapSubsystem::Property].current_bytes < after_reset[HeapSubsystem::Property].current_bytes);
+    }
+  }
+}
+
+SCENARIO("Library code runs within its subsystem scope", "[HeapStats]")
+{
+  PropertyContainer property_container;
+  CloudLocation location_test(2.0f, 3.0f);
+
+  WHEN("A multi value property is added to the container")
+  {
+    HeapStats const before = heap_stats_get();
+    addPropertyToContainer(property_container, location_test, "a_location_with_a_long_name", Permission::ReadWrite);
+
+    THEN("The precomputed attribute names are charged to the property subsystem") {
+      HeapStats const after = heap_stats_get();
+      REQUIRE(after[HeapSubsystem::Property].allocations > before[HeapSubsystem::Property].allocations);
+    }
+  }
+}
+
+SCENARIO("The property hot path does not allocate in steady state", "[HeapStats]")
+{
+  PropertyContainer property_container;
+  CloudBool  bool_test = false;
+  CloudInt   int_test = 1;
+  CloudFloat float_test = 2.0f;
+
+  addPropertyToContainer(property_container, bool_test,  "bool_test",  Permission::ReadWrite).publishOnChange(0, 0);
+  addPropertyToContainer(property_container, int_test,   "int_test",   Permission::ReadWrite).publishOnChange(0, 0);
+  addPropertyToContainer(property_container, float_test, "float_test", Permission::ReadWrite).publishOnChange(0, 0);
+
+  /* Initial synchronisation */
+  while (cbor::encode(property_container).size() != 0) { }
+
+  WHEN("Property updates are received from the cloud")
+  {
+    /* [{0: "bool_test", 4: true}, {0: "int_test", 2: 10}, {0: "float_test", 2: 20.0}] */
+    std::vector<uint8_t> const payload = {0x83, 0xA2, 0x00, 0x69, 0x62, 0x6F, 0x6F, 0x6C, 0x5F, 0x74, 0x65, 0x73, 0x74, 0x04, 0xF5, 0xA2, 0x00, 0x68, 0x69, 0x6E, 0x74, 0x5F, 0x74, 0x65, 0x73, 0x74, 0x02, 0x0A, 0xA2, 0x00, 0x6A, 0x66, 0x6C, 0x6F, 0x61, 0x74, 0x5F, 0x74, 0x65, 0x73, 0x74, 0x02, 0xF9, 0x4D, 0x00};
+    CBORDecoder::decode(property_container, payload.data(), payload.size());
+
+    size_t const allocations_before = heap_stats_get().total.allocations;
+    for (int i = 0; i < 10; i++)
+      CBORDecoder::decode(property_container, payload.data(), payload.size());
+    size_t const allocations = heap_stats_get().total.allocations - allocations_before;
+
+    THEN("Decoding does not touch the heap") {
+      REQUIRE(allocations == 0);
+      REQUIRE(int_test == 10);
+    }
+  }
+
+  WHEN("The uplink runs with nothing pending")
+  {
+    MqttClientMock client;
+    MqttPropertyUplink uplink;
+    MqttOutboundQueue queue;
+    unsigned int current_property_index = 0;
+    REQUIRE(uplink.begin(256, 1024, 20));
+    REQUIRE(queue.begin(4, 256, MqttOutboundQueue::Policy::OverwriteOldest));
+
+    size_t const allocations_before = heap_stats_get().total.allocations;
+    size_t frames = 0;
+    for (int i = 0; i < 10; i++)
+      frames += uplink.send(property_container, current_property_index,
+        [&queue](uint8_t const * frame, size_t const length) { return queue.push(frame, length); });
+    size_t const allocations = heap_stats_get().total.allocations - allocations_before;
+
+    THEN("No frame is published and the heap is not touched") {
+      REQUIRE(frames == 0);
+      REQUIRE(allocations == 0);
+    }
+  }
+
+  WHEN("Frames go through the outbound queue")
+  {
+    MqttOutboundQueue queue;
+    REQUIRE(queue.begin(4, 64, MqttOutboundQueue::Policy::OverwriteOldest));
+    std::vector<uint8_t> const frame(32, 0xAA);
+
+    size_t const allocations_before = heap_stats_get().total.allocations;
+    for (int i = 0; i < 10; i++) {
+      queue.push(frame.data(), frame.size());
+      queue.deliver([](uint8_t const *, size_t, uint16_t, bool) { return true; });
+    }
+    size_t const allocations = heap_stats_get().total.allocations - allocations_before;
+
+    THEN("Queueing, publishing and acknowledging does not touch the heap") {
+      REQUIRE(queue.empty());
+      REQUIRE(allocations == 0);
+    }
+  }
+}
+
+SCENARIO("Objects created in a pool share a single allocation", "[HeapStats]")
+{
+  ObjectPool<sizeof(double) * 2, 3> pool;
+
+  size_t const allocations_before = heap_stats_get().total.allocations;
+  pool.create<int>(1);
+  pool.create<double>(2.0);
+  pool.create<char>('c');
+  size_t const allocations = heap_stats_get().total.allocations - allocations_before;
+
+  THEN("The slots are allocated as one block") {
+    REQUIRE(allocations == 1);
+  }
+}
+
+SCENARIO("Property names are encoded without heap allocations", "[HeapStats]")
+{
+  PropertyContainer property_container;
+  CloudTelevision tv_test = CloudTelevision(true, 50, false, PlaybackCommands::Play, InputValue::TV, 7);
+  addPropertyToContainer(property_container, tv_test, "a_television_with_a_long_name", Permission::ReadWrite);
+
+  WHEN("A multi value property is encoded")
+  {
+    HeapStats const before = heap_stats_get();
+    std::vector<uint8_t> const encoded = cbor::encode(property_container);
+    HeapStats const after = heap_stats_get();
+
+    THEN("No allocation is charged to the property subsystem") {
+      REQUIRE(encoded.size() > 0);
+      REQUIRE(after[HeapSubsystem::Property].allocations == before[HeapSubsystem::Property].allocations);
+    }
+  }
+}
+
+SCENARIO("A large table of property descriptors is registered with few allocations", "[HeapStats]")
+{
+  size_t const num_properties = 500;
+  std::vector<CloudInt> props(num_properties, CloudInt(0));
+  std::vector<std::string> names;
+  std::vector<PropertyDescriptor> descriptors;
+  for (size_t i = 0; i < num_properties; i++)
+    names.push_back("property_" + std::to_string(i));
+  for (size_t i = 0; i < num_properties; i++)
+    descriptors.push_back(propertyDescriptor(props[i], names[i].c_str(), Permission::ReadWrite));
+
+  PropertyContainer property_container;
+  size_t const allocations_before = heap_stats_get().total.allocations;
+  addPropertiesToContainer(property_container, descriptors.data(), descriptors.size());
+  size_t const allocations = heap_stats_get().total.allocations - allocations_before;
+
+  THEN("The properties do not allocate memory one by one") {
+    REQUIRE(property_container.size() == num_properties);
+    /* Only the container indices and the chunks of the name table are allocated */
+    REQUIRE(allocations < num_properties / 5);
+  }
+}
@@ -0,0 +1,264 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <util/MqttClientMock.h>
+
+#include <utility/mqtt/MqttDispatcher.h>
+#include <utility/mqtt/MqttTopics.h>
+
+/******************************************************************************
+  TEST HELPER
+ ******************************************************************************/
+
+class FakeProcess : public CloudProcess
+{
+public:
+  FakeProcess(MessageStream * stream) : CloudProcess(stream) { }
+  virtual void handleMessage(Message * m) override { received.push_back(m->id); }
+  virtual void update() override { }
+  std::vector<MessageId> received;
+};
+
+/******************************************************************************
+  TEST CODE
+ ******************************************************************************/
+
+SCENARIO("Incoming MQTT messages are routed by topic", "[MqttDispatcher]")
+{
+  MqttClientMock client(16);
+  MqttTopics topics;
+  MqttDispatcher dispatcher;
+  REQUIRE(topics.begin("2c5dc5ef-4b5b-4c6a-8c7a-1fa4e85b2b6e"));
+  REQUIRE(topics.attachThing("d1134ac4-0cbb-4c5d-8f5e-4e0e9d3f5a21"));
+
+  std::vector<uint8_t> message_in_payload;
+  std::vector<uint8_t> data_in_payload;
+  auto reader = [&client](std::vector<uint8_t> & payload)
+  {
+    return [&client, &payload](int length)
+    {
+      payload.resize(static_cast<size_t>(length));
+      size_t received = 0;
+      while (received < payload.size())
+        received += static_cast<size_t>(client.read(payload.data() + received, payload.size() - received));
+    };
+  };
+  REQUIRE(dispatcher.addTopic(topics.messageIn(), reader(message_in_payload)));
+  REQUIRE(dispatcher.addTopic(topics.dataIn(), reader(data_in_payload)));
+
+  WHEN("A message arrives on a registered topic")
+  {
+    std::vector<uint8_t> const payload = {0x9F, 0xA2, 0x00, 0x64, 0x74, 0x65, 0x73, 0x74, 0x02, 0x01, 0xFF};
+    client.push(topics.dataIn(), payload);
+
+    THEN("Its handler reads the payload from the client") {
+      REQUIRE(dispatcher.dispatch(client.messageTopic().c_str(), static_cast<int>(payload.size())));
+      REQUIRE(data_in_payload == payload);
+      REQUIRE(message_in_payload.empty());
+      REQUIRE(client.available() == 0);
+    }
+  }
+
+  WHEN("A message arrives on a topic which is not registered")
+  {
+    THEN("It is not dispatched") {
+      REQUIRE_FALSE(dispatcher.dispatch("/a/t/d1134ac4-0cbb-4c5d-8f5e-4e0e9d3f5a21/shadow/i", 1));
+      REQUIRE_FALSE(dispatcher.dispatch("", 1));
+    }
+  }
+
+  WHEN("A topic is removed")
+  {
+    dispatcher.removeTopic(topics.dataIn());
+
+    THEN("Its messages are not dispatched anymore") {
+      REQUIRE_FALSE(dispatcher.dispatch(topics.dataIn(), 1));
+    }
+    THEN("The other topics are still dispatched") {
+      client.push(topics.messageIn(), {0x01});
+      REQUIRE(dispatcher.dispatch(topics.messageIn(), 1));
+      REQUIRE(message_in_payload.size() == 1);
+    }
+    THEN("The topic of the next thing can be added") {
+      REQUIRE(topics.attachThing("a4c0f3c7-7e35-4a42-8d4a-09c6a7f2e0b1"));
+      REQUIRE(dispatcher.addTopic(topics.dataIn(), reader(data_in_payload)));
+      REQUIRE(dispatcher.dispatch(topics.dataIn(), 0));
+    }
+  }
+
+  WHEN("A topic is added twice")
+  {
+    THEN("It is rejected") {
+      REQUIRE_FALSE(dispatcher.addTopic(topics.dataIn(), [](int) { }));
+    }
+  }
+
+  WHEN("Additional command topics are added")
+  {
+    std::vector<std::string> extra;
+    for (int i = 0; i < 10; i++)
+      extra.push_back("/a/d/extra/" + std::to_string(i));
+    size_t added = 0;
+    for (std::string const & topic : extra)
+      if (dispatcher.addTopic(topic.c_str(), [](int) { }))
+        added++;
+
+    THEN("They are added until the table is full") {
+      REQUIRE(added == 6);
+      for (size_t i = 0; i < added; i++)
+        REQUIRE(dispatcher.dispatch(extra[i].c_str(), 0));
+      REQUIRE(dispatcher.dispatch(topics.dataIn(), 0));
+    }
+  }
+}
+
+SCENARIO("Topics with the same hash are told apart by their name", "[MqttDispatcher]")
+{
+  /* FNV-1a collides on these names */
+  MqttDispatcher dispatcher;
+  int routed_to = 0;
+  REQUIRE(dispatcher.addTopic("costarring", [&routed_to](int) { routed_to = 1; }));
+
+  WHEN("A message arrives on a topic whose hash collides with a registered one")
+  {
+    THEN("It is not dispatched") {
+      REQUIRE_FALSE(dispatcher.dispatch("liquid", 0));
+      REQUIRE(routed_to == 0);
+    }
+  }
+
+  WHEN("Both topics are registered")
+  {
+    REQUIRE(dispatcher.addTopic("liquid", [&routed_to](int) { routed_to = 2; }));
+
+    THEN("Each message is routed to the handler of its own topic") {
+      REQUIRE(dispatcher.dispatch("liquid", 0));
+      REQUIRE(routed_to == 2);
+      REQUIRE(dispatcher.dispatch("costarring", 0));
+      REQUIRE(routed_to == 1);
+    }
+    THEN("Removing one topic keeps the other one") {
+      dispatcher.removeTopic("costarring");
+      REQUIRE_FALSE(dispatcher.dispatch("costarring", 0));
+      REQUIRE(dispatcher.dispatch("liquid", 0));
+      REQUIRE(routed_to == 2);
+    }
+  }
+}
+
+SCENARIO("The dispatcher is cleared", "[MqttDispatcher]")
+{
+  MessageStream stream([](Message *) { });
+  FakeProcess thing(&stream);
+  MqttDispatcher dispatcher;
+  MqttTopics topics;
+  REQUIRE(topics.begin("2c5dc5ef-4b5b-4c6a-8c7a-1fa4e85b2b6e"));
+
+  /* As on every call to ArduinoIoTCloudTCP::begin() */
+  int topic_calls = 0;
+  for (int i = 0; i < 3; i++)
+  {
+    dispatcher.clear();
+    REQUIRE(dispatcher.addTopic(topics.messageIn(), [&topic_calls](int) { topic_calls++; }));
+    REQUIRE(dispatcher.subscribe(CommandId::TimezoneCommandDownId, thing));
+  }
+
+  THEN("The topics and commands registered again are delivered once") {
+    REQUIRE(dispatcher.dispatch(topics.messageIn(), 0));
+    REQUIRE(topic_calls == 1);
+    Command command = { TimezoneCommandDownId };
+    REQUIRE(dispatcher.dispatch(&command) == 1);
+    REQUIRE(thing.received == std::vector<MessageId>{TimezoneCommandDownId});
+  }
+  THEN("All the subscription slots are available again") {
+    size_t subscribed = 0;
+    while (dispatcher.subscribe(CommandId::ResetCmdId, thing))
+      subscribed++;
+    REQUIRE(subscribed == 7);
+  }
+}
+
+SCENARIO("Commands are routed to their subscribers by id", "[MqttDispatcher]")
+{
+  MessageStream stream([](Message *) { });
+  FakeProcess thing(&stream);
+  FakeProcess ota(&stream);
+  MqttDispatcher dispatcher;
+
+  REQUIRE(dispatcher.subscribe(CommandId::TimezoneCommandDownId, thing));
+  REQUIRE(dispatcher.subscribe(CommandId::LastValuesUpdateCmdId, thing));
+  REQUIRE(dispatcher.subscribe(CommandId::OtaUpdateCmdDownId, ota));
+
+  WHEN("A command with a subscriber is dispatched")
+  {
+    Command command = { OtaUpdateCmdDownId };
+
+    THEN("Only its subscriber receives it") {
+      REQUIRE(dispatcher.dispatch(&command) == 1);
+      REQUIRE(ota.received == std::vector<MessageId>{OtaUpdateCmdDownId});
+      REQUIRE(thing.received.empty());
+    }
+  }
+
+  WHEN("A command has several subscribers")
+  {
+    std::vector<int> order;
+    REQUIRE(dispatcher.subscribe(CommandId::ThingUpdateCmdId, [&order](Command *) { order.push_back(1); }));
+    REQUIRE(dispatcher.subscribe(CommandId::ThingUpdateCmdId, [&order](Command *) { order.push_back(2); }));
+    Command command = { ThingUpdateCmdId };
+
+    THEN("They receive it in the order they have subscribed in") {
+      REQUIRE(dispatcher.dispatch(&command) == 2);
+      REQUIRE(order == std::vector<int>{1, 2});
+    }
+  }
+
+  WHEN("A command without subscribers is dispatched")
+  {
+    Command command = { ThingDetachCmdId };
+
+    THEN("Nobody receives it") {
+      REQUIRE(dispatcher.dispatch(&command) == 0);
+      REQUIRE(thing.received.empty());
+      REQUIRE(ota.received.empty());
+    }
+  }
+
+  WHEN("A command with an unknown id is dispatched")
+  {
+    Command command = { UnknownCmdId };
+    Command standard = { ArduinoIOTCloudStartMessageId - 1 };
+
+    THEN("It is ignored") {
+      REQUIRE(dispatcher.dispatch(&command) == 0);
+      REQUIRE(dispatcher.dispatch(&standard) == 0);
+      REQUIRE_FALSE(dispatcher.subscribe(CommandId::UnknownCmdId, thing));
+    }
+  }
+
+  WHEN("All the subscription slots are taken")
+  {
+    size_t subscribed = 0;
+    while (dispatcher.subscribe(CommandId::ResetCmdId, thing))
+      subscribed++;
+
+    THEN("Further subscriptions are rejected") {
+      REQUIRE(subscribed == 5);
+      Command command = { ResetCmdId };
+      REQUIRE(dispatcher.dispatch(&command) == 5);
+    }
+  }
+}
@@ -0,0 +1,388 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include <util/CBORTestUtil.h>
+#include <util/MqttClientMock.h>
+
+#include <utility/mqtt/MqttOutboundQueue.h>
+#include <utility/mqtt/MqttPropertyUplink.h>
+#include <PropertyContainer.h>
+#include <types/CloudInt.h>
+
+/******************************************************************************
+  TEST HELPER
+ ******************************************************************************/
+
+static std::vector<uint8_t> frame(uint8_t const id, size_t const length = 16)
+{
+  return std::vector<uint8_t>(length, id);
+}
+
+/* Publishes the queued frames with QoS 1 the way ArduinoIoTCloudTCP::write() does,
+ * the packet ids are recorded so the test can acknowledge them.
+ */
+static size_t transmit(MqttOutboundQueue & queue, MqttClientMock & client, std::vector<uint16_t> & packet_ids)
+{
+  return queue.transmit(
+    [&client, &packet_ids](uint8_t const * data, size_t const length, uint16_t const packet_id, bool const dup)
+    {
+      if (client.beginMessage("/a/t/thing/e/o", length, false, 1, dup) &&
+          client.write(data, length) &&
+          client.endMessage())
+      {
+        packet_ids.push_back(packet_id);
+        return true;
+      }
+      return false;
+    });
+}
+
+/* Publishes the queued frames the way ArduinoIoTCloudTCP::transmitOutboundQueue() does */
+static size_t deliver(MqttOutboundQueue & queue, MqttClientMock & client, std::vector<uint16_t> & packet_ids)
+{
+  return queue.deliver(
+    [&client, &packet_ids](uint8_t const * data, size_t const length, uint16_t const packet_id, bool const dup)
+    {
+      if (client.beginMessage("/a/t/thing/e/o", length, false, 1, dup) &&
+          client.write(data, length) &&
+          client.endMessage())
+      {
+        packet_ids.push_back(packet_id);
+        return true;
+      }
+      return false;
+    });
+}
+
+/******************************************************************************
+  TEST CODE
+ ******************************************************************************/
+
+SCENARIO("Outbound frames are kept until acknowledged", "[MqttOutboundQueue]")
+{
+  MqttOutboundQueue queue;
+  MqttClientMock client;
+  std::vector<uint16_t> packet_ids;
+
+  WHEN("The queue has not been started")
+  {
+    THEN("Frames are rejected") {
+      REQUIRE_FALSE(queue.push(frame(1).data(), 16));
+      REQUIRE(transmit(queue, client, packet_ids) == 0);
+    }
+  }
+
+  WHEN("The queue is started with a zero capacity")
+  {
+    THEN("begin() fails") {
+      REQUIRE_FALSE(queue.begin(0, 256, MqttOutboundQueue::Policy::Block));
+      REQUIRE_FALSE(queue.begin(4, 0, MqttOutboundQueue::Policy::Block));
+    }
+  }
+
+  REQUIRE(queue.begin(4, 32, MqttOutboundQueue::Policy::Block));
+
+  WHEN("A frame larger than a slot is pushed")
+  {
+    THEN("It is rejected") {
+      REQUIRE_FALSE(queue.push(frame(1, 33).data(), 33));
+      REQUIRE(queue.empty());
+    }
+  }
+
+  WHEN("Frames are published")
+  {
+    for (uint8_t i = 1; i <= 3; i++)
+      REQUIRE(queue.push(frame(i).data(), 16));
+    REQUIRE(transmit(queue, client, packet_ids) == 3);
+
+    THEN("They are published in order with QoS 1 and distinct packet ids") {
+      REQUIRE(client.published.size() == 3);
+      for (uint8_t i = 0; i < 3; i++) {
+        REQUIRE(client.published[i] == frame(i + 1));
+        REQUIRE(client.published_qos[i] == 1);
+        REQUIRE_FALSE(client.published_dup[i]);
+      }
+      REQUIRE(std::set<uint16_t>(packet_ids.begin(), packet_ids.end()).size() == 3);
+      REQUIRE(std::set<uint16_t>(packet_ids.begin(), packet_ids.end()).count(0) == 0);
+    }
+    THEN("They occupy their slot until the PUBACK is received") {
+      REQUIRE(queue.size() == 3);
+      REQUIRE(queue.inFlight() == 3);
+      REQUIRE(queue.queued() == 0);
+      REQUIRE(transmit(queue, client, packet_ids) == 0);
+
+      REQUIRE(queue.acknowledge(packet_ids[0]));
+      REQUIRE(queue.size() == 2);
+      REQUIRE_FALSE(queue.acknowledge(packet_ids[0]));
+    }
+    THEN("Out of order acknowledgements release the slots once the oldest frame is acknowledged") {
+      REQUIRE(queue.acknowledge(packet_ids[2]));
+      REQUIRE(queue.acknowledge(packet_ids[1]));
+      REQUIRE(queue.size() == 3);
+      REQUIRE(queue.inFlight() == 1);
+      REQUIRE(queue.acknowledge(packet_ids[0]));
+      REQUIRE(queue.empty());
+    }
+    THEN("An unknown packet id is ignored") {
+      REQUIRE_FALSE(queue.acknowledge(0x1234));
+      REQUIRE(queue.size() == 3);
+    }
+  }
+
+  WHEN("The link drops in the middle of a burst")
+  {
+    for (uint8_t i = 1; i <= 4; i++)
+      REQUIRE(queue.push(frame(i).data(), 16));
+    client.publish_limit = 2;
+    REQUIRE(transmit(queue, client, packet_ids) == 2);
+    REQUIRE(queue.inFlight() == 2);
+    REQUIRE(queue.queued() == 2);
+
+    /* The connection is re-established, the PUBACKs of the first two frames are lost */
+    client.clearPublished();
+    client.publish_limit = static_cast<size_t>(-1);
+    queue.requeue();
+    std::vector<uint16_t> replayed_packet_ids;
+    REQUIRE(transmit(queue, client, replayed_packet_ids) == 4);
+
+    THEN("All the unacknowledged frames are replayed in their original order") {
+      REQUIRE(client.published.size() == 4);
+      for (uint8_t i = 0; i < 4; i++)
+        REQUIRE(client.published[i] == frame(i + 1));
+    }
+    THEN("Replayed frames keep their packet id and are flagged as duplicates") {
+      REQUIRE(replayed_packet_ids[0] == packet_ids[0]);
+      REQUIRE(replayed_packet_ids[1] == packet_ids[1]);
+      REQUIRE(client.published_dup[0]);
+      REQUIRE(client.published_dup[1]);
+      REQUIRE_FALSE(client.published_dup[2]);
+      REQUIRE_FALSE(client.published_dup[3]);
+    }
+    THEN("The slots are released once all frames are acknowledged") {
+      for (uint16_t const packet_id : replayed_packet_ids)
+        REQUIRE(queue.acknowledge(packet_id));
+      REQUIRE(queue.empty());
+    }
+  }
+
+  WHEN("The link drops repeatedly")
+  {
+    for (uint8_t i = 1; i <= 4; i++)
+      REQUIRE(queue.push(frame(i).data(), 16));
+
+    for (size_t published = 0; published < 4; published++) {
+      client.clearPublished();
+      client.publish_limit = 1;
+      queue.requeue();
+      REQUIRE(transmit(queue, client, packet_ids) == 1);
+      /* Only the PUBACK of the oldest frame makes it through before the next drop */
+      REQUIRE(queue.acknowledge(packet_ids.back()));
+    }
+
+    THEN("Every frame is eventually delivered exactly once") {
+      REQUIRE(queue.empty());
+      REQUIRE(std::set<uint16_t>(packet_ids.begin(), packet_ids.end()).size() == 4);
+    }
+  }
+
+  WHEN("The queue is full and the policy is Block")
+  {
+    for (uint8_t i = 1; i <= 4; i++)
+      REQUIRE(queue.push(frame(i).data(), 16));
+
+    THEN("New frames are rejected until a slot is released") {
+      REQUIRE(queue.full());
+      REQUIRE(queue.blocked());
+      REQUIRE_FALSE(queue.push(frame(5).data(), 16));
+
+      REQUIRE(transmit(queue, client, packet_ids) == 4);
+      REQUIRE(queue.acknowledge(packet_ids[0]));
+      REQUIRE_FALSE(queue.blocked());
+      REQUIRE(queue.push(frame(5).data(), 16));
+      REQUIRE(queue.overwritten() == 0);
+    }
+  }
+}
+
+SCENARIO("Frames delivered within publish are released right away", "[MqttOutboundQueue]")
+{
+  MqttOutboundQueue queue;
+  MqttClientMock client;
+  std::vector<uint16_t> packet_ids;
+
+  REQUIRE(queue.begin(4, 32, MqttOutboundQueue::Policy::Block));
+  for (uint8_t i = 1; i <= 4; i++)
+    REQUIRE(queue.push(frame(i).data(), 16));
+
+  WHEN("All frames are published")
+  {
+    THEN("Every slot is released") {
+      REQUIRE(deliver(queue, client, packet_ids) == 4);
+      REQUIRE(queue.empty());
+      REQUIRE(queue.inFlight() == 0);
+      for (uint8_t i = 0; i < 4; i++)
+        REQUIRE(client.published[i] == frame(i + 1));
+    }
+  }
+
+  WHEN("The link drops after two frames")
+  {
+    client.publish_limit = 2;
+
+    THEN("The remaining frames stay queued and are retransmitted in order") {
+      REQUIRE(deliver(queue, client, packet_ids) == 2);
+      REQUIRE(queue.size() == 2);
+      REQUIRE(queue.queued() == 2);
+      REQUIRE(queue.push(frame(5).data(), 16));
+
+      client.publish_limit = static_cast<size_t>(-1);
+      REQUIRE(deliver(queue, client, packet_ids) == 3);
+      REQUIRE(queue.empty());
+      REQUIRE(client.published.size() == 5);
+      for (uint8_t i = 0; i < 5; i++)
+        REQUIRE(client.published[i] == frame(i + 1));
+    }
+  }
+
+  WHEN("Frames behind in-flight frames are delivered")
+  {
+    client.publish_limit = 2;
+    REQUIRE(transmit(queue, client, packet_ids) == 2);
+    client.publish_limit = static_cast<size_t>(-1);
+    REQUIRE(deliver(queue, client, packet_ids) == 2);
+
+    THEN("Their slots are released once the in-flight frames are acknowledged") {
+      REQUIRE(queue.size() == 4);
+      REQUIRE(queue.queued() == 0);
+      REQUIRE(queue.inFlight() == 2);
+      REQUIRE(queue.acknowledge(packet_ids[1]));
+      REQUIRE(queue.size() == 4);
+      REQUIRE(queue.acknowledge(packet_ids[0]));
+      REQUIRE(queue.empty());
+    }
+  }
+}
+
+SCENARIO("The oldest outbound frame is overwritten when the queue is full", "[MqttOutboundQueue]")
+{
+  MqttOutboundQueue queue;
+  MqttClientMock client;
+  std::vector<uint16_t> packet_ids;
+
+  REQUIRE(queue.begin(4, 32, MqttOutboundQueue::Policy::OverwriteOldest));
+
+  WHEN("More frames than slots are queued while the link is down")
+  {
+    for (uint8_t i = 1; i <= 6; i++)
+      REQUIRE(queue.push(frame(i).data(), 16));
+
+    THEN("The newest frames are kept") {
+      REQUIRE(queue.size() == 4);
+      REQUIRE(queue.overwritten() == 2);
+      REQUIRE_FALSE(queue.blocked());
+      REQUIRE(transmit(queue, client, packet_ids) == 4);
+      for (uint8_t i = 0; i < 4; i++)
+        REQUIRE(client.published[i] == frame(i + 3));
+    }
+  }
+
+  WHEN("An in-flight frame is overwritten")
+  {
+    REQUIRE(queue.push(frame(1).data(), 16));
+    REQUIRE(transmit(queue, client, packet_ids) == 1);
+    for (uint8_t i = 2; i <= 5; i++)
+      REQUIRE(queue.push(frame(i).data(), 16));
+
+    THEN("Its late acknowledgement is ignored") {
+      REQUIRE(queue.inFlight() == 0);
+      REQUIRE(queue.queued() == 4);
+      REQUIRE_FALSE(queue.acknowledge(packet_ids[0]));
+      REQUIRE(queue.size() == 4);
+    }
+  }
+}
+
+SCENARIO("Property updates survive a link drop during a batched uplink", "[MqttOutboundQueue]")
+{
+  PropertyContainer property_container;
+  std::vector<CloudInt> props(100, CloudInt(0));
+  for (size_t i = 0; i < props.size(); i++)
+    addPropertyToContainer(property_container, props[i], String("property_") + std::to_string(i), Permission::ReadWrite).publishOnChange(0, 0);
+
+  MqttClientMock client;
+  MqttPropertyUplink uplink;
+  MqttOutboundQueue queue;
+  unsigned int current_property_index = 0;
+  std::vector<uint16_t> packet_ids;
+
+  REQUIRE(uplink.begin(256, 64 * 1024, 1000));
+  REQUIRE(queue.begin(4, 256, MqttOutboundQueue::Policy::Block));
+
+  /* Mirrors ArduinoIoTCloudTCP::transmitOutboundQueue, MqttClient completes
+   * the QoS 1 handshake within endMessage().
+   */
+  auto transmit_queue = [&]() {
+    deliver(queue, client, packet_ids);
+    return queue.queued() == 0;
+  };
+  auto send_properties = [&]() {
+    if (queue.blocked())
+      return;
+    uplink.send(property_container, current_property_index,
+      [&](uint8_t const * data, size_t const length) {
+        if (!queue.push(data, length))
+          return false;
+        return transmit_queue() && !queue.blocked();
+      });
+  };
+
+  WHEN("The link drops after two frames and is re-established")
+  {
+    client.publish_limit = 2;
+    send_properties();
+    REQUIRE(client.published.size() == 2);
+    REQUIRE(queue.queued() == 1);
+
+    /* Further ticks while the link is down queue at most one frame each until the queue is full */
+    for (int tick = 0; tick < 10; tick++)
+      send_properties();
+    REQUIRE(queue.full());
+    REQUIRE(queue.overwritten() == 0);
+
+    client.publish_limit = static_cast<size_t>(-1);
+    queue.requeue();
+    transmit_queue();
+    while (uplink.send(property_container, current_property_index,
+             [&](uint8_t const * data, size_t const length) {
+               return queue.push(data, length) && transmit_queue();
+             }) > 0) { }
+
+    THEN("Every property is delivered") {
+      std::string payload;
+      for (std::vector<uint8_t> const & f : client.published)
+        payload.append(f.begin(), f.end());
+      for (size_t i = 0; i < props.size(); i++)
+        REQUIRE(payload.find("property_" + std::to_string(i) + "\x02") != std::string::npos);
+      REQUIRE(queue.empty());
+      REQUIRE(cbor::encode(property_container).size() == 0);
+    }
+  }
+}
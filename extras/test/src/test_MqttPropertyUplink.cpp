@@ -0,0 +1,198 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <vector>
+
+#include <util/CBORTestUtil.h>
+#include <util/MqttClientMock.h>
+
+#include <utility/mqtt/MqttPropertyUplink.h>
+#include <PropertyContainer.h>
+#include <types/CloudInt.h>
+
+/******************************************************************************
+  TEST HELPER
+ ******************************************************************************/
+
+/* Mirrors ArduinoIoTCloudTCP::write() */
+static bool publish(MqttClientMock & client, uint8_t const * frame, size_t const length)
+{
+  if (client.beginMessage("/a/t/thing/e/o", length, false, 0)) {
+    if (client.write(frame, length)) {
+      if (client.endMessage()) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+static size_t publishedBytes(MqttClientMock const & client, size_t const frames)
+{
+  size_t bytes = 0;
+  for (size_t i = 0; i < frames; i++)
+    bytes += client.published[i].size();
+  return bytes;
+}
+
+/******************************************************************************
+  TEST CODE
+ ******************************************************************************/
+
+SCENARIO("Pending properties are published in multiple frames per tick", "[MqttPropertyUplink]")
+{
+  PropertyContainer property_container;
+  std::vector<CloudInt> props(100, CloudInt(0));
+
+  for (size_t i = 0; i < props.size(); i++)
+    addPropertyToContainer(property_container, props[i], String("property_") + std::to_string(i), Permission::ReadWrite).publishOnChange(0, 0);
+
+  MqttClientMock client;
+  MqttPropertyUplink uplink;
+  unsigned int current_property_index = 0;
+  auto publisher = [&client](uint8_t const * frame, size_t const length) { return publish(client, frame, length); };
+
+  set_millis(1000);
+
+  WHEN("The uplink has not been started")
+  {
+    THEN("Nothing is published") {
+      REQUIRE(uplink.send(property_container, current_property_index, publisher) == 0);
+      REQUIRE(client.published.empty());
+    }
+  }
+
+  WHEN("The uplink is started with an empty frame")
+  {
+    THEN("begin() fails") {
+      REQUIRE_FALSE(uplink.begin(0, 1024, 20));
+    }
+  }
+
+  WHEN("The budget allows to publish all pending properties")
+  {
+    REQUIRE(uplink.begin(256, 64 * 1024, 1000));
+    size_t const frames = uplink.send(property_container, current_property_index, publisher);
+
+    THEN("All properties are flushed within a single tick") {
+      REQUIRE(frames > 1);
+      REQUIRE(client.published.size() == frames);
+      REQUIRE(cbor::encode(property_container).size() == 0);
+      REQUIRE(uplink.send(property_container, current_property_index, publisher) == 0);
+    }
+    THEN("No frame exceeds the configured frame size") {
+      for (std::vector<uint8_t> const & frame : client.published)
+        REQUIRE(frame.size() <= 256);
+    }
+  }
+
+  WHEN("The frame size is increased at runtime")
+  {
+    REQUIRE(uplink.begin(1024, 64 * 1024, 1000));
+    size_t const frames = uplink.send(property_container, current_property_index, publisher);
+
+    THEN("Fewer frames are needed") {
+      REQUIRE(uplink.frameSize() == 1024);
+      REQUIRE(frames >= 1);
+      for (std::vector<uint8_t> const & frame : client.published)
+        REQUIRE(frame.size() <= 1024);
+      REQUIRE(cbor::encode(property_container).size() == 0);
+
+      MqttClientMock small_frames_client;
+      for (CloudInt & p : props)
+        p = 1;
+      REQUIRE(uplink.begin(256, 64 * 1024, 1000));
+      uplink.send(property_container, current_property_index,
+        [&small_frames_client](uint8_t const * frame, size_t const length) { return publish(small_frames_client, frame, length); });
+      REQUIRE(small_frames_client.published.size() > frames);
+    }
+  }
+
+  WHEN("The byte budget is 0")
+  {
+    REQUIRE(uplink.begin(256, 0, 1000));
+
+    THEN("A single frame is published per tick") {
+      size_t ticks = 0;
+      while (uplink.send(property_container, current_property_index, publisher) > 0) {
+        ticks++;
+        REQUIRE(client.published.size() == ticks);
+      }
+      REQUIRE(ticks > 1);
+      REQUIRE(cbor::encode(property_container).size() == 0);
+    }
+  }
+
+  WHEN("The byte budget is used up")
+  {
+    size_t const bytes_per_tick = 600;
+    REQUIRE(uplink.begin(256, bytes_per_tick, 1000));
+    size_t const frames = uplink.send(property_container, current_property_index, publisher);
+
+    THEN("Publishing stops with the frame which reaches the budget") {
+      REQUIRE(frames == client.published.size());
+      REQUIRE(publishedBytes(client, frames - 1) < bytes_per_tick);
+      REQUIRE(publishedBytes(client, frames) >= bytes_per_tick);
+      REQUIRE(cbor::encode(property_container).size() > 0);
+    }
+    THEN("The next tick resumes where the previous one stopped") {
+      while (uplink.send(property_container, current_property_index, publisher) > 0) { }
+      REQUIRE(cbor::encode(property_container).size() == 0);
+    }
+  }
+
+  WHEN("The time budget is used up")
+  {
+    REQUIRE(uplink.begin(256, 64 * 1024, 25));
+    size_t const frames = uplink.send(property_container, current_property_index,
+      [&client](uint8_t const * frame, size_t const length)
+      {
+        set_millis(millis() + 10);
+        return publish(client, frame, length);
+      });
+
+    THEN("Publishing stops once the budget has elapsed") {
+      REQUIRE(frames == 3);
+      REQUIRE(cbor::encode(property_container).size() > 0);
+    }
+  }
+
+  WHEN("Publishing a frame fails")
+  {
+    REQUIRE(uplink.begin(256, 64 * 1024, 1000));
+    client.publish_limit = 2;
+    size_t const frames = uplink.send(property_container, current_property_index, publisher);
+
+    THEN("Publishing stops at the failed frame") {
+      REQUIRE(frames == 2);
+      REQUIRE(client.published.size() == 2);
+    }
+  }
+
+  WHEN("A property before the round-robin position is modified")
+  {
+    REQUIRE(uplink.begin(256, 0, 1000));
+    REQUIRE(uplink.send(property_container, current_property_index, publisher) == 1);
+    REQUIRE(current_property_index > 0);
+    props[0] = 42;
+
+    THEN("The uplink wraps around and publishes it within the same tick") {
+      REQUIRE(uplink.begin(256, 64 * 1024, 1000));
+      uplink.send(property_container, current_property_index, publisher);
+      REQUIRE(cbor::encode(property_container).size() == 0);
+    }
+  }
+}
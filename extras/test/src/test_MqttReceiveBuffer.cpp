@@ -0,0 +1,150 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <vector>
+
+#include <util/MqttClientMock.h>
+
+#include <utility/mqtt/MqttReceiveBuffer.h>
+#include <CBORDecoder.h>
+#include <PropertyContainer.h>
+#include <types/CloudString.h>
+
+/******************************************************************************
+  TEST HELPER
+ ******************************************************************************/
+
+static std::vector<uint8_t> makePayload(size_t const length)
+{
+  std::vector<uint8_t> payload(length);
+  for (size_t i = 0; i < length; i++)
+    payload[i] = static_cast<uint8_t>(i * 7 + 3);
+  return payload;
+}
+
+/******************************************************************************
+  TEST CODE
+ ******************************************************************************/
+
+SCENARIO("MQTT payloads are received into a preallocated buffer", "[MqttReceiveBuffer]")
+{
+  MqttClientMock client(1460);
+  MqttReceiveBuffer<4096> rx_buffer;
+
+  WHEN("A 4 KB payload is received")
+  {
+    std::vector<uint8_t> const payload = makePayload(4096);
+    client.push("/a/t/thing/e/i", payload);
+
+    THEN("It is read with a few bulk reads") {
+      REQUIRE(rx_buffer.receive(client, payload.size()) == MqttReceiveBuffer<4096>::Status::Complete);
+      REQUIRE(rx_buffer.length() == payload.size());
+      REQUIRE(std::vector<uint8_t>(rx_buffer.data(), rx_buffer.data() + rx_buffer.length()) == payload);
+      REQUIRE(client.read_calls == 3);
+    }
+  }
+
+  WHEN("A 4 KB property update is received")
+  {
+    PropertyContainer property_container;
+    CloudString str;
+    addPropertyToContainer(property_container, str, "test", Permission::ReadWrite);
+
+    /* [{0: "test", 3: "xxx...x" (4000 characters)}] */
+    std::vector<uint8_t> payload = {0x81, 0xA2, 0x00, 0x64, 0x74, 0x65, 0x73, 0x74, 0x03, 0x79, 0x0F, 0xA0};
+    payload.insert(payload.end(), 4000, 'x');
+    client.push("/a/t/thing/e/i", payload);
+
+    THEN("It is decoded in place from the receive buffer") {
+      REQUIRE(rx_buffer.receive(client, payload.size()) == MqttReceiveBuffer<4096>::Status::Complete);
+      CBORDecoder::decode(property_container, rx_buffer.data(), rx_buffer.length());
+      REQUIRE(String(str) == String(4000, 'x'));
+    }
+  }
+
+  WHEN("A payload larger than the buffer is received")
+  {
+    MqttReceiveBuffer<1024> small_rx_buffer;
+    std::vector<uint8_t> const large_payload = makePayload(4096);
+    std::vector<uint8_t> const next_payload = {0xDE, 0xAD, 0xBE, 0xEF};
+    client.push("/a/t/thing/e/i", large_payload);
+    client.push("/a/t/thing/e/i", next_payload);
+
+    THEN("It is rejected and the following message is received correctly") {
+      REQUIRE(small_rx_buffer.receive(client, large_payload.size()) == MqttReceiveBuffer<1024>::Status::Oversize);
+      REQUIRE(small_rx_buffer.length() == 0);
+      REQUIRE(small_rx_buffer.receive(client, next_payload.size()) == MqttReceiveBuffer<1024>::Status::Complete);
+      REQUIRE(std::vector<uint8_t>(small_rx_buffer.data(), small_rx_buffer.data() + small_rx_buffer.length()) == next_payload);
+      REQUIRE(client.available() == 0);
+    }
+  }
+
+  WHEN("The rest of a payload is appended to its header")
+  {
+    std::vector<uint8_t> const payload = makePayload(100);
+    client.push("/a/t/thing/e/i", payload);
+
+    THEN("The whole payload is stored in the buffer") {
+      REQUIRE(rx_buffer.receive(client, 19) == MqttReceiveBuffer<4096>::Status::Complete);
+      REQUIRE(rx_buffer.append(client, payload.size() - 19) == MqttReceiveBuffer<4096>::Status::Complete);
+      REQUIRE(std::vector<uint8_t>(rx_buffer.data(), rx_buffer.data() + rx_buffer.length()) == payload);
+    }
+  }
+
+  WHEN("A last values update larger than the buffer is received")
+  {
+    MqttReceiveBuffer<1024> small_rx_buffer;
+    PropertyContainer property_container;
+    CloudString str;
+    addPropertyToContainer(property_container, str, "test", Permission::ReadWrite).onSync(CLOUD_WINS);
+
+    /* 1(0x010600) [h'[{0: "test", 3: "xxx...x" (4000 characters)}]'] */
+    std::vector<uint8_t> const last_values_header = {0x81, 0xA2, 0x00, 0x64, 0x74, 0x65, 0x73, 0x74, 0x03, 0x79, 0x0F, 0xA0};
+    size_t const last_values_length = last_values_header.size() + 4000;
+    std::vector<uint8_t> payload = {0xDA, 0x00, 0x01, 0x06, 0x00, 0x81, 0x59,
+                                    static_cast<uint8_t>(last_values_length >> 8), static_cast<uint8_t>(last_values_length)};
+    payload.insert(payload.end(), last_values_header.begin(), last_values_header.end());
+    payload.insert(payload.end(), 4000, 'x');
+    client.push("/a/t/thing/c/d", payload);
+
+    THEN("The last values are streamed from the header into the decoder") {
+      size_t const header_length = CBORDecoder::COMMAND_HEADER_MAX_LENGTH;
+      REQUIRE(small_rx_buffer.receive(client, header_length) == MqttReceiveBuffer<1024>::Status::Complete);
+
+      size_t payload_offset = 0;
+      size_t payload_length = 0;
+      REQUIRE(CBORDecoder::findCommandPayload(small_rx_buffer.data(), header_length, 0x010600, payload_offset, payload_length));
+      REQUIRE(payload_offset + payload_length == payload.size());
+
+      CBORDecoder decoder(property_container, true);
+      decoder.feed(small_rx_buffer.data() + payload_offset, header_length - payload_offset);
+      REQUIRE(small_rx_buffer.stream(client, payload.size() - header_length,
+        [&decoder](uint8_t const * chunk, size_t const chunk_length) { decoder.feed(chunk, chunk_length); })
+        == MqttReceiveBuffer<1024>::Status::Complete);
+      REQUIRE(decoder.status() == CBORDecoder::Status::Complete);
+      REQUIRE(String(str) == String(4000, 'x'));
+    }
+  }
+
+  WHEN("The client runs out of data before the end of the payload")
+  {
+    client.push("/a/t/thing/e/i", makePayload(100));
+
+    THEN("The message is reported as incomplete") {
+      REQUIRE(rx_buffer.receive(client, 200) == MqttReceiveBuffer<4096>::Status::Incomplete);
+    }
+  }
+}
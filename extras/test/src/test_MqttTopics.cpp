@@ -0,0 +1,65 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <string>
+
+#include <utility/mqtt/MqttTopics.h>
+
+/******************************************************************************
+  TEST CODE
+ ******************************************************************************/
+
+SCENARIO("The MQTT topics are computed once", "[MqttTopics]")
+{
+  MqttTopics topics;
+  REQUIRE(topics.begin("8b10b5a8-a6c8-4a6e-8fca-e8a9b4b1b2c3"));
+
+  WHEN("No thing is attached")
+  {
+    THEN("Only the device topics are set") {
+      REQUIRE(std::string(topics.messageOut()) == "/a/d/8b10b5a8-a6c8-4a6e-8fca-e8a9b4b1b2c3/c/up");
+      REQUIRE(std::string(topics.messageIn()) == "/a/d/8b10b5a8-a6c8-4a6e-8fca-e8a9b4b1b2c3/c/dw");
+      REQUIRE(std::string(topics.dataOut()).empty());
+      REQUIRE(std::string(topics.dataIn()).empty());
+    }
+  }
+
+  WHEN("A thing is attached")
+  {
+    REQUIRE(topics.attachThing("d1f7e0a2-3b4c-4d5e-8f90-a1b2c3d4e5f6"));
+
+    THEN("The thing topics are set") {
+      REQUIRE(std::string(topics.dataOut()) == "/a/t/d1f7e0a2-3b4c-4d5e-8f90-a1b2c3d4e5f6/e/o");
+      REQUIRE(std::string(topics.dataIn()) == "/a/t/d1f7e0a2-3b4c-4d5e-8f90-a1b2c3d4e5f6/e/i");
+    }
+    THEN("The thing topics are cleared once it is detached") {
+      topics.detachThing();
+      REQUIRE(std::string(topics.dataIn()).empty());
+      REQUIRE(std::string(topics.dataOut()).empty());
+    }
+  }
+
+  WHEN("The thing id does not fit into a topic")
+  {
+    std::string const thing_id(64, 'x');
+
+    THEN("The thing is not attached") {
+      REQUIRE_FALSE(topics.attachThing(thing_id.c_str()));
+      REQUIRE(std::string(topics.dataOut()).empty());
+      REQUIRE(std::string(topics.dataIn()).empty());
+    }
+  }
+}
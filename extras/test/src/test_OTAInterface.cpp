@@ -0,0 +1,127 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <string.h>
+
+#include <vector>
+
+#include <util/OtaTestUtil.h>
+
+#include <ota/interface/OTAInterface.h>
+
+/******************************************************************************
+  TEST HELPER
+ ******************************************************************************/
+
+/* Board running the application 'app', every step of an actual download is recorded */
+class OTACloudProcessMock : public OTACloudProcessInterface
+{
+public:
+  OTACloudProcessMock(MessageStream * ms, std::vector<uint8_t> const & app)
+  : OTACloudProcessInterface(ms)
+  , app(app)
+  , download_started(false)
+  { }
+
+  virtual bool isOtaCapable() override { return true; }
+
+  std::vector<uint8_t> app;
+  bool download_started;
+
+protected:
+  virtual State resume(Message *) override { return OtaBegin; }
+  virtual State startOTA() override { download_started = true; return Fetch; }
+  virtual State fetch() override { return FlashOTA; }
+  virtual State flashOTA() override { return Reboot; }
+  virtual State reboot() override { return Idle; }
+  virtual void reset() override { }
+
+  virtual void* appStartAddress() override { return app.data(); }
+  virtual uint32_t appSize() override { return app.size(); }
+  virtual bool appFlashOpen() override { return true; }
+  virtual bool appFlashClose() override { return true; }
+};
+
+/* Messages sent upstream by the OTA process, as their id and the reported state */
+struct UpstreamMessage
+{
+  MessageId id;
+  uint8_t   state;
+};
+
+/******************************************************************************
+  TEST CODE
+ ******************************************************************************/
+
+SCENARIO("An OTA of the firmware which is already running is not downloaded", "[OTACloudProcessInterface]")
+{
+  std::vector<UpstreamMessage> upstream;
+  MessageStream stream([&upstream](Message * msg) {
+    uint8_t const state = (msg->id == OtaProgressCmdUpId) ? reinterpret_cast<OtaProgressCmdUp *>(msg)->params.state : 0;
+    upstream.push_back(UpstreamMessage{msg->id, state});
+  });
+
+  std::vector<uint8_t> const app = firmware(4096, 7);
+  OTACloudProcessMock ota(&stream, app);
+
+  /* The board reports the sha256 of its firmware at boot */
+  ota.update();
+  ota.update();
+  REQUIRE(ota.getState() == OTACloudProcessInterface::Idle);
+  REQUIRE(upstream.size() == 1);
+  REQUIRE(upstream[0].id == OtaBeginUpId);
+  upstream.clear();
+
+  OtaUpdateCmdDown cmd;
+  memset(&cmd, 0, sizeof(cmd));
+  cmd.c.id = OtaUpdateCmdDownId;
+  memset(cmd.params.id, 0xA5, ID_SIZE);
+  strcpy(cmd.params.url, "https://example.com/ota.bin");
+
+  WHEN("The final sha256 of the OTA is the one of the running firmware")
+  {
+    std::vector<uint8_t> const app_sha256 = sha256(app);
+    memcpy(cmd.params.finalSha256, app_sha256.data(), SHA256_SIZE);
+
+    ota.handleMessage(reinterpret_cast<Message *>(&cmd));
+    while (ota.getState() != OTACloudProcessInterface::Idle)
+      ota.update();
+
+    THEN("The OTA is reported as already installed and the sha256 is sent again") {
+      REQUIRE_FALSE(ota.download_started);
+      REQUIRE(upstream.size() == 2);
+      REQUIRE(upstream[0].id == OtaProgressCmdUpId);
+      REQUIRE(upstream[0].state == OTACloudProcessInterface::OtaAlreadyInstalled);
+      REQUIRE(upstream[1].id == OtaBeginUpId);
+    }
+  }
+
+  WHEN("The final sha256 of the OTA is another one")
+  {
+    memset(cmd.params.finalSha256, 0x5A, SHA256_SIZE);
+
+    ota.handleMessage(reinterpret_cast<Message *>(&cmd));
+    ota.update();
+    ota.update();
+
+    THEN("The OTA is downloaded") {
+      REQUIRE(ota.download_started);
+      REQUIRE(upstream.size() == 2);
+      REQUIRE(upstream[0].id == OtaProgressCmdUpId);
+      REQUIRE(upstream[0].state == OTACloudProcessInterface::OtaAvailable);
+    }
+  }
+}
@@ -0,0 +1,107 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <util/CBORTestUtil.h>
+
+#include <utility/memory/ObjectPool.h>
+#include <PropertyContainer.h>
+#include <CloudWrapperPool.h>
+
+/******************************************************************************
+  TEST CODE
+ ******************************************************************************/
+
+SCENARIO("Objects are placed into the slots of the pool", "[ObjectPool]")
+{
+  ObjectPool<sizeof(double) * 2, 3> pool;
+
+  WHEN("No object has been created yet")
+  {
+    THEN("No memory is allocated") {
+      REQUIRE(pool.size() == 0);
+      REQUIRE(pool.capacity() == 3);
+      REQUIRE_FALSE(pool.owns(&pool));
+    }
+  }
+
+  WHEN("Objects of different types are created")
+  {
+    int * a = pool.create<int>(1);
+    double * b = pool.create<double>(2.0);
+    char * c = pool.create<char>('c');
+
+    THEN("They are constructed into one contiguous block") {
+      REQUIRE(*a == 1);
+      REQUIRE(*b == 2.0);
+      REQUIRE(*c == 'c');
+      REQUIRE(reinterpret_cast<uint8_t *>(b) - reinterpret_cast<uint8_t *>(a) == sizeof(double) * 2);
+      REQUIRE(reinterpret_cast<uintptr_t>(b) % alignof(double) == 0);
+      REQUIRE(pool.owns(a));
+      REQUIRE(pool.owns(c));
+      REQUIRE(pool.size() == 3);
+    }
+  }
+
+  WHEN("The pool is exhausted")
+  {
+    pool.create<int>(1);
+    pool.create<int>(2);
+    int * c = pool.create<int>(3);
+    int * d = pool.create<int>(4);
+
+    THEN("No further objects are created") {
+      REQUIRE(c != nullptr);
+      REQUIRE(d == nullptr);
+      REQUIRE(pool.size() == 3);
+    }
+  }
+}
+
+SCENARIO("Wrappers for primitive variables are taken from the pool", "[CloudWrapperPool]")
+{
+  PropertyContainer property_container;
+  int value = 5;
+  size_t const size_before = CloudWrapperPool::size();
+
+  WHEN("A wrapper is created")
+  {
+    Property * p = CloudWrapperPool::create<CloudWrapperInt>(value);
+    addPropertyToContainer(property_container, *p, "test", Permission::ReadWrite);
+
+    THEN("It is bound to the variable") {
+      if (size_before < CloudWrapperPool::capacity()) {
+        REQUIRE(CloudWrapperPool::size() == size_before + 1);
+      }
+      /* [{0: "test", 2: 5}] = 9F A2 00 64 74 65 73 74 02 05 FF */
+      std::vector<uint8_t> const expected = {0x9F, 0xA2, 0x00, 0x64, 0x74, 0x65, 0x73, 0x74, 0x02, 0x05, 0xFF};
+      REQUIRE(cbor::encode(property_container) == expected);
+    }
+  }
+
+  WHEN("More wrappers than the pool holds are created")
+  {
+    String s;
+    for (size_t i = CloudWrapperPool::size(); i < CloudWrapperPool::capacity(); i++)
+      CloudWrapperPool::create<CloudWrapperString>(s);
+    Property * p = CloudWrapperPool::create<CloudWrapperString>(s);
+
+    THEN("They are allocated from the heap") {
+      REQUIRE(p != nullptr);
+      REQUIRE(CloudWrapperPool::size() == CloudWrapperPool::capacity());
+    }
+    delete p;
+  }
+}
@@ -0,0 +1,351 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+
+#include <util/CBORTestUtil.h>
+#include <util/OfflineLogFileStorage.h>
+
+#include <PropertyContainer.h>
+#include <CBORDecoder.h>
+#include <types/CloudInt.h>
+#include <utility/offline/OfflineLog.h>
+#include <utility/offline/OfflineLogRamStorage.h>
+
+/******************************************************************************
+  TEST HELPER
+ ******************************************************************************/
+
+static std::vector<uint8_t> frontRecord(OfflineLogStorage & storage)
+{
+  std::vector<uint8_t> record(256);
+  record.resize(storage.front(record.data(), record.size()));
+  return record;
+}
+
+/* Returns the BaseTime of the first record of a message, 0 if there is none */
+static unsigned long baseTime(std::vector<uint8_t> const & message)
+{
+  CborParser parser;
+  CborValue array, map;
+  if (cbor_parser_init(message.data(), message.size(), 0, &parser, &array) != CborNoError ||
+      cbor_value_enter_container(&array, &map) != CborNoError ||
+      !cbor_value_is_map(&map))
+    return 0;
+
+  CborValue value;
+  if (cbor_value_enter_container(&map, &value) != CborNoError)
+    return 0;
+  while (!cbor_value_at_end(&value)) {
+    int key = 0;
+    cbor_value_get_int(&value, &key);
+    cbor_value_advance(&value);
+    if (key == static_cast<int>(CborIntegerMapKey::BaseTime)) {
+      uint64_t time = 0;
+      cbor_value_get_uint64(&value, &time);
+      return static_cast<unsigned long>(time);
+    }
+    cbor_value_advance(&value);
+  }
+  return 0;
+}
+
+/******************************************************************************
+  TEST CODE
+ ******************************************************************************/
+
+SCENARIO("Records are kept in RAM", "[OfflineLog]")
+{
+  OfflineLogRamStorage storage;
+  REQUIRE(storage.begin(16));
+
+  WHEN("Records are appended")
+  {
+    std::vector<uint8_t> const first = {1, 2, 3};
+    std::vector<uint8_t> const second = {4, 5, 6, 7};
+    REQUIRE(storage.append(first.data(), first.size()));
+    REQUIRE(storage.append(second.data(), second.size()));
+
+    THEN("They are read back oldest-first") {
+      REQUIRE(storage.count() == 2);
+      REQUIRE(frontRecord(storage) == first);
+      storage.pop();
+      REQUIRE(frontRecord(storage) == second);
+      storage.pop();
+      REQUIRE(storage.count() == 0);
+      REQUIRE(frontRecord(storage).empty());
+    }
+    THEN("A record which does not fit is rejected") {
+      std::vector<uint8_t> const third = {8, 9, 10, 11};
+      REQUIRE(storage.available() == 3);
+      REQUIRE_FALSE(storage.append(third.data(), third.size()));
+      REQUIRE(storage.count() == 2);
+    }
+  }
+
+  WHEN("Records wrap around the end of the ring")
+  {
+    std::vector<uint8_t> const filler = {0, 0, 0, 0, 0, 0, 0, 0};
+    std::vector<uint8_t> const record = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+    REQUIRE(storage.append(filler.data(), filler.size()));
+    REQUIRE(storage.append(record.data(), 3));
+    storage.pop();
+    REQUIRE(storage.append(record.data(), record.size()));
+
+    THEN("They are read back unchanged") {
+      storage.pop();
+      REQUIRE(frontRecord(storage) == record);
+    }
+  }
+}
+
+SCENARIO("Records are kept in a file", "[OfflineLog]")
+{
+  std::string const path = "test_OfflineLog.bin";
+  remove(path.c_str());
+
+  OfflineLogFileStorage storage;
+  REQUIRE(storage.begin(path, 64));
+
+  std::vector<uint8_t> const first = {1, 2, 3};
+  std::vector<uint8_t> const second = {4, 5, 6, 7};
+  REQUIRE(storage.append(first.data(), first.size()));
+  REQUIRE(storage.append(second.data(), second.size()));
+
+  WHEN("The file is opened again")
+  {
+    storage.pop();
+    storage.end();
+    OfflineLogFileStorage reopened;
+    REQUIRE(reopened.begin(path, 64));
+
+    THEN("The records which have not been removed are still there") {
+      REQUIRE(reopened.count() == 1);
+      REQUIRE(frontRecord(reopened) == second);
+    }
+  }
+
+  WHEN("All the records have been removed")
+  {
+    storage.pop();
+    storage.pop();
+
+    THEN("The whole file is available again") {
+      REQUIRE(storage.count() == 0);
+      REQUIRE(storage.available() == 64 - 16 - 2);
+    }
+  }
+
+  WHEN("The file is full")
+  {
+    std::vector<uint8_t> const large(40, 0xAA);
+
+    THEN("Further records are rejected") {
+      REQUIRE_FALSE(storage.append(large.data(), large.size()));
+      REQUIRE(storage.count() == 2);
+    }
+  }
+
+  storage.end();
+  remove(path.c_str());
+}
+
+SCENARIO("Property updates are recorded while offline", "[OfflineLog]")
+{
+  PropertyContainer property_container;
+  unsigned int current_property_index = 0;
+  CloudInt int_test_1 = 1;
+  CloudInt int_test_2 = 2;
+  addPropertyToContainer(property_container, int_test_1, "test", Permission::ReadWrite).publishOnChange(0, 0);
+  addPropertyToContainer(property_container, int_test_2, "b", Permission::ReadWrite).publishOnChange(0, 0);
+
+  OfflineLogRamStorage storage;
+  OfflineLog offline_log;
+  REQUIRE(storage.begin(1024));
+  REQUIRE(offline_log.begin(64, 0));
+  offline_log.setStorage(&storage);
+
+  WHEN("The pending properties are recorded")
+  {
+    REQUIRE(offline_log.record(property_container, current_property_index, 1550138809) == 1);
+
+    /* [{-3: 1550138809, 0: "test", 2: 1}, {0: "b", 2: 2}] */
+    std::vector<uint8_t> const expected = {0x9F, 0xA3, 0x22, 0x1A, 0x5C, 0x65, 0x3D, 0xB9, 0x00, 0x64, 0x74, 0x65, 0x73, 0x74, 0x02, 0x01,
+                                           0xA2, 0x00, 0x61, 0x62, 0x02, 0x02, 0xFF};
+    THEN("They are reported at the time they have been recorded at") {
+      REQUIRE(frontRecord(storage) == expected);
+    }
+    THEN("They are not pending anymore") {
+      REQUIRE(cbor::encode(property_container).size() == 0);
+    }
+  }
+
+  WHEN("A property has a timestamp of its own")
+  {
+    CloudInt int_test_3 = 3;
+    addPropertyToContainer(property_container, int_test_3, "c", Permission::ReadWrite).publishOnChange(0, 0).encodeTimestamp();
+    int_test_3.setTimestamp(1550138800);
+    offline_log.record(property_container, current_property_index, 1550138809);
+
+    /* [{-3: 1550138809, 0: "test", 2: 1}, {0: "b", 2: 2}, {0: "c", 2: 3, 6: -9}] */
+    std::vector<uint8_t> const expected = {0x9F, 0xA3, 0x22, 0x1A, 0x5C, 0x65, 0x3D, 0xB9, 0x00, 0x64, 0x74, 0x65, 0x73, 0x74, 0x02, 0x01,
+                                           0xA2, 0x00, 0x61, 0x62, 0x02, 0x02,
+                                           0xA3, 0x00, 0x61, 0x63, 0x02, 0x03, 0x06, 0x28, 0xFF};
+    THEN("Its timestamp is relative to the time of the message") {
+      REQUIRE(frontRecord(storage) == expected);
+    }
+  }
+
+  WHEN("The storage can not hold a full frame")
+  {
+    OfflineLogRamStorage small_storage;
+    REQUIRE(small_storage.begin(32));
+    offline_log.setStorage(&small_storage);
+
+    THEN("Nothing is recorded and the properties stay pending") {
+      REQUIRE(offline_log.record(property_container, current_property_index, 1550138809) == 0);
+      REQUIRE(small_storage.count() == 0);
+      REQUIRE(cbor::encode(property_container).size() != 0);
+    }
+  }
+}
+
+SCENARIO("The offline log is replayed", "[OfflineLog]")
+{
+  PropertyContainer property_container;
+  unsigned int current_property_index = 0;
+  CloudInt int_test = 0;
+  addPropertyToContainer(property_container, int_test, "test", Permission::ReadWrite).publishOnChange(0, 0);
+
+  std::string const path = "test_OfflineLog_replay.bin";
+  remove(path.c_str());
+  OfflineLogFileStorage storage;
+  OfflineLog offline_log;
+  REQUIRE(storage.begin(path, 4096));
+  REQUIRE(offline_log.begin(64, 0));
+  offline_log.setStorage(&storage);
+
+  /* The value changes every minute while the connection is down */
+  for (unsigned long i = 0; i < 10; i++) {
+    int_test = static_cast<int>(i);
+    offline_log.record(property_container, current_property_index, 1550138809 + i * 60);
+  }
+  REQUIRE(offline_log.size() == 10);
+
+  /* The board is reset before the connection has been re-established */
+  storage.end();
+  REQUIRE(storage.begin(path, 4096));
+
+  WHEN("The connection has been re-established")
+  {
+    std::vector<std::vector<uint8_t>> published;
+    auto publish = [&published](uint8_t const * frame, size_t const length)
+    {
+      published.emplace_back(frame, frame + length);
+      return true;
+    };
+
+    THEN("A single frame is replayed per call with a budget of 0") {
+      REQUIRE(offline_log.replay(publish) == 1);
+      REQUIRE(offline_log.size() == 9);
+    }
+    THEN("All the updates are replayed oldest-first") {
+      while (offline_log.replay(publish) > 0) { }
+      REQUIRE(published.size() == 10);
+      for (unsigned long i = 0; i < published.size(); i++)
+        REQUIRE(baseTime(published[i]) == 1550138809 + i * 60);
+      REQUIRE(offline_log.empty());
+    }
+  }
+
+  WHEN("A frame can not be published")
+  {
+    auto publish = [](uint8_t const *, size_t const) { return false; };
+
+    THEN("It is kept in the log") {
+      REQUIRE(offline_log.replay(publish) == 0);
+      REQUIRE(offline_log.size() == 10);
+    }
+  }
+
+  WHEN("The replay budget is larger than a frame")
+  {
+    OfflineLog budget_log;
+    REQUIRE(budget_log.begin(64, 60));
+    budget_log.setStorage(&storage);
+    size_t bytes = 0;
+    auto publish = [&bytes](uint8_t const *, size_t const length) { bytes += length; return true; };
+
+    THEN("Frames are replayed until the budget has been used up") {
+      size_t const frames = budget_log.replay(publish);
+      REQUIRE(frames > 1);
+      REQUIRE(frames < 10);
+      REQUIRE(bytes >= 60);
+    }
+  }
+
+  storage.end();
+  remove(path.c_str());
+}
+
+SCENARIO("The offline log is replayed before the last values are applied", "[OfflineLog]")
+{
+  /* Mirrors ArduinoIoTCloudTCP::handle_Connected(): the log is replayed to the
+   * cloud first, which keeps the value it received last, the last values are
+   * requested once the log is empty.
+   */
+  PropertyContainer device_container, cloud_container;
+  unsigned int current_property_index = 0;
+  CloudInt device_value = 0, cloud_value = 0;
+  addPropertyToContainer(device_container, device_value, "test", Permission::ReadWrite).publishOnChange(0, 0).onSync(CLOUD_WINS);
+  addPropertyToContainer(cloud_container, cloud_value, "test", Permission::ReadWrite);
+
+  OfflineLogRamStorage storage;
+  OfflineLog offline_log;
+  REQUIRE(storage.begin(1024));
+  REQUIRE(offline_log.begin(64, 0));
+  offline_log.setStorage(&storage);
+
+  /* The value changes on the board while the connection is down */
+  device_value = 5;
+  offline_log.record(device_container, current_property_index, 1550138809);
+  device_value = 7;
+  offline_log.record(device_container, current_property_index, 1550138869);
+  /* and on a dashboard in the meantime */
+  cloud_value = 9;
+
+  WHEN("The thing is attached again")
+  {
+    auto publish = [&cloud_container](uint8_t const * frame, size_t const length)
+    {
+      CBORDecoder::decode(cloud_container, frame, length);
+      return true;
+    };
+    while (offline_log.replay(publish) > 0) { }
+
+    requestUpdateForAllProperties(cloud_container);
+    std::vector<uint8_t> const last_values = cbor::encode(cloud_container);
+    CBORDecoder::decode(device_container, last_values.data(), last_values.size(), true);
+
+    THEN("The board and the cloud agree on the value") {
+      REQUIRE(cloud_value == 7);
+      REQUIRE(device_value == cloud_value);
+    }
+  }
+}
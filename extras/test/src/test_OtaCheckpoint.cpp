@@ -0,0 +1,252 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+
+#include <util/OtaBoardMock.h>
+#include <util/OtaHttpServerMock.h>
+#include <util/OtaTestUtil.h>
+
+#include <ota/utility/OtaCheckpoint.h>
+
+/******************************************************************************
+  TEST HELPER
+ ******************************************************************************/
+
+static OtaHttpServerMock::Link const WIFI = {100, 20, 1000};
+static uint8_t const OTA_ID[OtaCheckpoint::ID_SIZE] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x10};
+static uint8_t const OTHER_OTA_ID[OtaCheckpoint::ID_SIZE] = {0xFF};
+static uint32_t const CHECKPOINT_INTERVAL = 16 * 1024;
+
+/******************************************************************************
+  TEST CODE
+ ******************************************************************************/
+
+SCENARIO("A checkpoint is validated before a download is resumed from it", "[OtaCheckpoint]")
+{
+  OtaCheckpoint checkpoint;
+  memset(&checkpoint, 0xA5, sizeof(checkpoint));
+  memcpy(checkpoint.id, OTA_ID, sizeof(checkpoint.id));
+  checkpoint.contentLength = 100000;
+  checkpoint.downloadedSize = 50000;
+  checkpoint.seal();
+
+  THEN("A sealed checkpoint of the OTA is valid") {
+    REQUIRE(checkpoint.valid(OTA_ID));
+  }
+  THEN("The checkpoint of another OTA is not") {
+    REQUIRE_FALSE(checkpoint.valid(OTHER_OTA_ID));
+  }
+  WHEN("A byte of the record has not been stored")
+  {
+    checkpoint.decoder.window[1000] ^= 0x01;
+
+    THEN("The checkpoint is not valid") {
+      REQUIRE_FALSE(checkpoint.valid(OTA_ID));
+    }
+  }
+  WHEN("The record has been sealed with an offset beyond the end of the file")
+  {
+    checkpoint.downloadedSize = 100001;
+    checkpoint.seal();
+
+    THEN("The checkpoint is not valid") {
+      REQUIRE_FALSE(checkpoint.valid(OTA_ID));
+    }
+  }
+}
+
+SCENARIO("A checkpoint is kept in RAM", "[OtaCheckpoint]")
+{
+  OtaCheckpointRamStorage storage;
+  OtaCheckpoint checkpoint;
+  memset(&checkpoint, 0, sizeof(checkpoint));
+  memcpy(checkpoint.id, OTA_ID, sizeof(checkpoint.id));
+  checkpoint.downloadedSize = 20;
+  checkpoint.contentLength = 20;
+  checkpoint.seal();
+
+  OtaCheckpoint loaded;
+  REQUIRE_FALSE(storage.load(loaded));
+
+  REQUIRE(storage.store(checkpoint));
+  REQUIRE(storage.load(loaded));
+  REQUIRE(memcmp(&loaded, &checkpoint, sizeof(checkpoint)) == 0);
+  REQUIRE(loaded.valid(OTA_ID));
+
+  storage.clear();
+  REQUIRE_FALSE(storage.load(loaded));
+}
+
+SCENARIO("A checkpoint is kept in a file", "[OtaCheckpoint]")
+{
+  char const * const path = "OtaCheckpointFileStorage.bin";
+  remove(path);
+
+  OtaCheckpoint checkpoint;
+  memset(&checkpoint, 0, sizeof(checkpoint));
+  memcpy(checkpoint.id, OTA_ID, sizeof(checkpoint.id));
+  checkpoint.downloadedSize = 20;
+  checkpoint.contentLength = 20;
+  checkpoint.seal();
+
+  OtaCheckpoint loaded;
+  OtaCheckpointFileStorage storage(path);
+  REQUIRE_FALSE(storage.load(loaded));
+  REQUIRE(storage.store(checkpoint));
+
+  WHEN("The board reboots")
+  {
+    OtaCheckpointFileStorage rebooted(path);
+
+    THEN("The checkpoint is loaded from the file") {
+      REQUIRE(rebooted.load(loaded));
+      REQUIRE(memcmp(&loaded, &checkpoint, sizeof(checkpoint)) == 0);
+      REQUIRE(loaded.valid(OTA_ID));
+    }
+  }
+
+  WHEN("The record has only partially been written")
+  {
+    FILE * file = fopen(path, "wb");
+    REQUIRE(file != nullptr);
+    fwrite(&checkpoint, sizeof(checkpoint) / 2, 1, file);
+    fclose(file);
+
+    THEN("It is not loaded") {
+      REQUIRE_FALSE(storage.load(loaded));
+    }
+  }
+
+  WHEN("The checkpoint is cleared")
+  {
+    storage.clear();
+
+    THEN("The file is removed") {
+      REQUIRE_FALSE(storage.load(loaded));
+      REQUIRE(fopen(path, "rb") == nullptr);
+    }
+  }
+
+  remove(path);
+}
+
+SCENARIO("A download interrupted at random offsets is resumed from its checkpoints", "[OtaCheckpoint]")
+{
+  set_millis(0);
+  std::vector<uint8_t> const image = compressibleFirmware(300 * 1024);
+  std::vector<uint8_t> const file = otaFile(lzss(image));
+  std::vector<uint8_t> const final_sha256 = sha256(image);
+  OtaHttpServerMock server(file, WIFI);
+  OtaUpdateFile update_file;
+  OtaCheckpointStorageMock storage;
+
+  std::mt19937 random(0x2341);
+  std::uniform_int_distribution<size_t> offset(0, file.size() - 1);
+
+  WHEN("The connection drops and the board reboots a few times")
+  {
+    size_t drops = 0;
+    size_t received = 0;
+    std::vector<uint32_t> resumed_from;
+    OtaBoardMock::Result result = OtaBoardMock::Result::Interrupted;
+    std::unique_ptr<OtaBoardMock> board;
+
+    while (result == OtaBoardMock::Result::Interrupted && drops < 20)
+    {
+      board.reset(new OtaBoardMock(update_file, storage, OTA_ID, final_sha256.data(), CHECKPOINT_INTERVAL));
+      resumed_from.push_back(board->resumed_from);
+
+      /* Drops happen after the checkpoint the board resumed from */
+      size_t const drop_at = drops < 8 ? std::max<size_t>(offset(random), board->resumed_from + 1) : SIZE_MAX;
+      result = board->fetch(server, drop_at);
+      received += board->received;
+
+      if (result == OtaBoardMock::Result::Interrupted) {
+        /* The bytes buffered for the update file are lost with the reboot */
+        server.stop();
+        drops++;
+      }
+    }
+
+    THEN("The image is complete and matches the CRC of the file and its SHA-256") {
+      REQUIRE(result == OtaBoardMock::Result::Completed);
+      REQUIRE(drops == 8);
+      REQUIRE_FALSE(board->write_error);
+      REQUIRE(update_file.data == image);
+    }
+    THEN("Every retry resumed from the last checkpoint before the drop") {
+      REQUIRE(storage.stores > 0);
+      REQUIRE(received < file.size() + drops * (CHECKPOINT_INTERVAL + 1460));
+      REQUIRE(*std::max_element(resumed_from.begin(), resumed_from.end()) > 0);
+    }
+    THEN("The checkpoint is cleared once the download is complete") {
+      REQUIRE(storage.record.empty());
+    }
+  }
+
+  WHEN("A download has been interrupted")
+  {
+    OtaBoardMock interrupted(update_file, storage, OTA_ID, final_sha256.data());
+    REQUIRE(interrupted.fetch(server, file.size() / 2) == OtaBoardMock::Result::Interrupted);
+    server.stop();
+    REQUIRE_FALSE(storage.record.empty());
+
+    AND_WHEN("The next OTA is a different one")
+    {
+      std::vector<uint8_t> const other_image = compressibleFirmware(100 * 1024, 7);
+      std::vector<uint8_t> const other_sha256 = sha256(other_image);
+      OtaHttpServerMock other_server(otaFile(lzss(other_image)), WIFI);
+      OtaBoardMock board(update_file, storage, OTHER_OTA_ID, other_sha256.data());
+
+      THEN("The download starts from the first byte") {
+        REQUIRE(board.resumed_from == 0);
+        REQUIRE(board.fetch(other_server) == OtaBoardMock::Result::Completed);
+        REQUIRE(update_file.data == other_image);
+      }
+    }
+
+    AND_WHEN("The update file is shorter than the checkpoint")
+    {
+      update_file.data.resize(update_file.data.size() / 2);
+      OtaBoardMock board(update_file, storage, OTA_ID, final_sha256.data());
+
+      THEN("The checkpoint is discarded and the download starts from the first byte") {
+        REQUIRE(board.resumed_from == 0);
+        REQUIRE(storage.record.empty());
+        REQUIRE(board.fetch(server) == OtaBoardMock::Result::Completed);
+        REQUIRE(update_file.data == image);
+      }
+    }
+
+    AND_WHEN("The checkpoint has only partially been stored")
+    {
+      storage.record[100] ^= 0xFF;
+      OtaBoardMock board(update_file, storage, OTA_ID, final_sha256.data());
+
+      THEN("The download starts from the first byte") {
+        REQUIRE(board.resumed_from == 0);
+        REQUIRE(board.fetch(server) == OtaBoardMock::Result::Completed);
+        REQUIRE(update_file.data == image);
+      }
+    }
+  }
+}
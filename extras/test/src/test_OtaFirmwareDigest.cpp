@@ -0,0 +1,265 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <util/OtaTestUtil.h>
+
+#include <ota/utility/OtaFirmwareDigest.h>
+
+/******************************************************************************
+  TEST HELPER
+ ******************************************************************************/
+
+/* Flash region holding the application, which is read whenever it is hashed */
+struct AppFlashMock
+{
+  std::vector<uint8_t> app;
+  bool has_build_id = true;
+  size_t hashes = 0;
+
+  /* Computed over the whole image when the application is linked, as the ESP32 ELF SHA-256 */
+  bool buildId(uint8_t build_id[OtaFirmwareDigest::BUILD_ID_SIZE])
+  {
+    std::vector<uint8_t> const id = sha256(app);
+    std::copy(id.begin(), id.end(), build_id);
+    return has_build_id;
+  }
+
+  std::vector<uint8_t> calculateSHA256()
+  {
+    hashes++;
+    return sha256(app);
+  }
+};
+
+/* Slot of a key value store surviving a reboot, which holds the record as bytes */
+class OtaFirmwareDigestStorageMock : public OtaFirmwareDigestStorage
+{
+public:
+  virtual bool store(OtaFirmwareDigest const & digest) override
+  {
+    uint8_t const * bytes = reinterpret_cast<uint8_t const *>(&digest);
+    record.assign(bytes, bytes + sizeof(OtaFirmwareDigest));
+    return true;
+  }
+  virtual bool load(OtaFirmwareDigest & digest) override
+  {
+    if (record.size() != sizeof(OtaFirmwareDigest))
+      return false;
+    memcpy(&digest, record.data(), sizeof(OtaFirmwareDigest));
+    return true;
+  }
+  virtual void clear() override
+  {
+    record.clear();
+  }
+
+  std::vector<uint8_t> record;
+};
+
+/* Mirrors what OTACloudProcessInterface::otaBegin() does at every boot */
+static std::vector<uint8_t> bootSha256(AppFlashMock & flash, OtaFirmwareDigestStorage * storage)
+{
+  OtaFirmwareDigestCache cache;
+  cache.setStorage(storage);
+
+  uint32_t const app_size = flash.app.size();
+  uint8_t build_id[OtaFirmwareDigest::BUILD_ID_SIZE];
+  bool const has_build_id = flash.buildId(build_id);
+  std::vector<uint8_t> sha(OtaSha256::HASH_SIZE);
+  if (!has_build_id || !cache.lookup(app_size, build_id, sha.data()))
+  {
+    sha = flash.calculateSHA256();
+    if (has_build_id)
+      cache.store(app_size, build_id, sha.data());
+  }
+  return sha;
+}
+
+/******************************************************************************
+  TEST CODE
+ ******************************************************************************/
+
+SCENARIO("The SHA-256 of the application is cached across reboots", "[OtaFirmwareDigest]")
+{
+  AppFlashMock flash;
+  flash.app = firmware(256 * 1024);
+  OtaFirmwareDigestStorageMock storage;
+
+  WHEN("The board boots for the first time")
+  {
+    std::vector<uint8_t> const sha = bootSha256(flash, &storage);
+
+    THEN("The application is hashed and its SHA-256 is stored") {
+      REQUIRE(sha == sha256(flash.app));
+      REQUIRE(flash.hashes == 1);
+      REQUIRE(storage.record.size() == sizeof(OtaFirmwareDigest));
+    }
+  }
+
+  WHEN("The board reboots")
+  {
+    bootSha256(flash, &storage);
+    std::vector<uint8_t> const sha = bootSha256(flash, &storage);
+
+    THEN("The SHA-256 comes from the storage") {
+      REQUIRE(sha == sha256(flash.app));
+      REQUIRE(flash.hashes == 1);
+    }
+  }
+
+  WHEN("Another application is flashed")
+  {
+    bootSha256(flash, &storage);
+    flash.app = firmware(200 * 1024, 2);
+    std::vector<uint8_t> const sha = bootSha256(flash, &storage);
+
+    THEN("The new application is hashed") {
+      REQUIRE(sha == sha256(flash.app));
+      REQUIRE(flash.hashes == 2);
+    }
+  }
+
+  WHEN("An application of the same size with another vector table is flashed")
+  {
+    bootSha256(flash, &storage);
+    flash.app[8] ^= 0xFF;
+    std::vector<uint8_t> const sha = bootSha256(flash, &storage);
+
+    THEN("The new application is hashed") {
+      REQUIRE(sha == sha256(flash.app));
+      REQUIRE(flash.hashes == 2);
+    }
+  }
+
+  WHEN("An application which only differs in the middle of the image is flashed")
+  {
+    bootSha256(flash, &storage);
+    flash.app[flash.app.size() / 2] ^= 0x01;
+    std::vector<uint8_t> const sha = bootSha256(flash, &storage);
+
+    THEN("The new application is hashed") {
+      REQUIRE(sha == sha256(flash.app));
+      REQUIRE(flash.hashes == 2);
+    }
+  }
+
+  WHEN("The record has only partially been stored")
+  {
+    bootSha256(flash, &storage);
+    storage.record[10] ^= 0x01;
+    std::vector<uint8_t> const sha = bootSha256(flash, &storage);
+
+    THEN("The application is hashed again") {
+      REQUIRE(sha == sha256(flash.app));
+      REQUIRE(flash.hashes == 2);
+    }
+  }
+
+  WHEN("The cache has been invalidated by a completed download")
+  {
+    bootSha256(flash, &storage);
+    OtaFirmwareDigestCache cache;
+    cache.setStorage(&storage);
+    cache.invalidate();
+    std::vector<uint8_t> const sha = bootSha256(flash, &storage);
+
+    THEN("The application is hashed again") {
+      REQUIRE(sha == sha256(flash.app));
+      REQUIRE(flash.hashes == 2);
+    }
+  }
+
+  WHEN("The board does not provide a build id")
+  {
+    flash.has_build_id = false;
+    bootSha256(flash, &storage);
+    std::vector<uint8_t> const sha = bootSha256(flash, &storage);
+
+    THEN("The application is hashed at every boot and nothing is cached") {
+      REQUIRE(sha == sha256(flash.app));
+      REQUIRE(flash.hashes == 2);
+      REQUIRE(storage.record.empty());
+    }
+  }
+
+  WHEN("No storage has been set")
+  {
+    bootSha256(flash, nullptr);
+    std::vector<uint8_t> const sha = bootSha256(flash, nullptr);
+
+    THEN("The application is hashed at every boot") {
+      REQUIRE(sha == sha256(flash.app));
+      REQUIRE(flash.hashes == 2);
+    }
+  }
+}
+
+SCENARIO("The SHA-256 of the application is cached in a file", "[OtaFirmwareDigest]")
+{
+  char const * const path = "OtaFirmwareDigestFileStorage.bin";
+  remove(path);
+
+  AppFlashMock flash;
+  flash.app = firmware(64 * 1024);
+  OtaFirmwareDigestFileStorage storage(path);
+  bootSha256(flash, &storage);
+
+  WHEN("The board reboots")
+  {
+    OtaFirmwareDigestFileStorage rebooted(path);
+    std::vector<uint8_t> const sha = bootSha256(flash, &rebooted);
+
+    THEN("The SHA-256 comes from the file") {
+      REQUIRE(sha == sha256(flash.app));
+      REQUIRE(flash.hashes == 1);
+    }
+  }
+
+  WHEN("The file has only partially been written")
+  {
+    OtaFirmwareDigest digest;
+    REQUIRE(storage.load(digest));
+    FILE * file = fopen(path, "wb");
+    REQUIRE(file != nullptr);
+    fwrite(&digest, sizeof(digest) / 2, 1, file);
+    fclose(file);
+    std::vector<uint8_t> const sha = bootSha256(flash, &storage);
+
+    THEN("The application is hashed again") {
+      REQUIRE(sha == sha256(flash.app));
+      REQUIRE(flash.hashes == 2);
+    }
+  }
+
+  WHEN("The cache has been invalidated")
+  {
+    OtaFirmwareDigestCache cache;
+    cache.setStorage(&storage);
+    cache.invalidate();
+
+    THEN("The file is removed") {
+      REQUIRE(fopen(path, "rb") == nullptr);
+    }
+  }
+
+  remove(path);
+}
@@ -0,0 +1,204 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <util/OtaTestUtil.h>
+
+#include <ota/utility/OtaFlashWriteBuffer.h>
+
+/******************************************************************************
+  TEST HELPER
+ ******************************************************************************/
+
+/* Stands in for OTADefaultCloudProcessInterface::writeFlash(), the storage is
+ * full once 'capacity' bytes have been written
+ */
+struct FlashMock
+{
+  std::vector<uint8_t> data;
+  std::vector<size_t>  writes;
+  size_t               capacity = SIZE_MAX;
+
+  int write(uint8_t * const buffer, size_t len)
+  {
+    writes.push_back(len);
+    size_t const written = std::min(len, capacity - data.size());
+    data.insert(data.end(), buffer, buffer + written);
+    return static_cast<int>(written);
+  }
+
+  OtaFlashWriteBuffer::WriteFunc func()
+  {
+    return [this](uint8_t * const buffer, size_t len) { return write(buffer, len); };
+  }
+};
+
+/******************************************************************************
+  TEST CODE
+ ******************************************************************************/
+
+SCENARIO("The decompressed firmware is written one page at a time", "[OtaFlashWriteBuffer]")
+{
+  std::vector<uint8_t> const image = firmware(10000);
+  FlashMock flash;
+  OtaFlashWriteBuffer buffer(flash.func());
+
+  WHEN("The bytes are written one by one")
+  {
+    buffer.begin(4096);
+    bool ok = true;
+    for (uint8_t const c : image)
+      ok = buffer.put(c) && ok;
+
+    THEN("Only whole pages are written before the end of the download") {
+      REQUIRE(ok);
+      REQUIRE(flash.writes == std::vector<size_t>{4096, 4096});
+    }
+
+    AND_WHEN("The buffer is flushed at the end of the download")
+    {
+      REQUIRE(buffer.flush());
+
+      THEN("The last page is written partially filled") {
+        REQUIRE(flash.writes == std::vector<size_t>{4096, 4096, 1808});
+        REQUIRE(flash.data == image);
+      }
+      THEN("Flushing again writes nothing") {
+        REQUIRE(buffer.flush());
+        REQUIRE(flash.writes.size() == 3);
+      }
+    }
+  }
+
+  WHEN("The bytes are written in blocks which are not page aligned")
+  {
+    buffer.begin(4096);
+    REQUIRE(buffer.write(image.data(), 1000));
+    REQUIRE(buffer.write(image.data() + 1000, 9000));
+    REQUIRE(buffer.flush());
+
+    THEN("The storage is still written in pages") {
+      REQUIRE(flash.writes == std::vector<size_t>{4096, 4096, 1808});
+      REQUIRE(flash.data == image);
+    }
+  }
+
+  WHEN("The writing starts in the middle of a page")
+  {
+    buffer.begin(4096, 5000);
+    REQUIRE(buffer.write(image.data(), image.size()));
+    REQUIRE(buffer.flush());
+
+    THEN("The first write fills up that page and the next ones are aligned to page boundaries") {
+      REQUIRE(flash.writes == std::vector<size_t>{3192, 4096, 2712});
+      REQUIRE(flash.data == image);
+    }
+  }
+
+  WHEN("The buffer is flushed in the middle of a page")
+  {
+    buffer.begin(4096);
+    REQUIRE(buffer.write(image.data(), 1000));
+    REQUIRE(buffer.flush());
+    REQUIRE(buffer.offset() == 1000);
+    REQUIRE(buffer.write(image.data() + 1000, 9000));
+    REQUIRE(buffer.flush());
+
+    THEN("The next write only fills up that page") {
+      REQUIRE(flash.writes == std::vector<size_t>{1000, 3096, 4096, 1808});
+      REQUIRE(flash.data == image);
+      REQUIRE(buffer.offset() == image.size());
+    }
+  }
+
+  WHEN("The page size is 1")
+  {
+    buffer.begin(1);
+    for (uint8_t const c : image)
+      buffer.put(c);
+
+    THEN("Every byte is written on its own") {
+      REQUIRE(flash.writes.size() == image.size());
+      REQUIRE(flash.data == image);
+    }
+  }
+
+  WHEN("The buffer is started again")
+  {
+    buffer.begin(4096);
+    buffer.write(image.data(), 100);
+    buffer.begin(256);
+    REQUIRE(buffer.write(image.data(), 1000));
+    REQUIRE(buffer.flush());
+
+    THEN("The bytes buffered before are dropped and the new page size is used") {
+      REQUIRE(buffer.pageSize() == 256);
+      REQUIRE(flash.writes == std::vector<size_t>{256, 256, 256, 232});
+      REQUIRE(flash.data == std::vector<uint8_t>(image.begin(), image.begin() + 1000));
+    }
+  }
+}
+
+SCENARIO("A failing write to the storage is reported", "[OtaFlashWriteBuffer]")
+{
+  std::vector<uint8_t> const image = firmware(10000);
+  FlashMock flash;
+  OtaFlashWriteBuffer buffer(flash.func());
+  buffer.begin(4096);
+
+  WHEN("The storage is full while a page is written")
+  {
+    flash.capacity = 6000;
+    size_t failed_at = 0;
+    for (size_t i = 0; i < image.size() && failed_at == 0; i++) {
+      if (!buffer.put(image[i]))
+        failed_at = i + 1;
+    }
+
+    THEN("The byte completing that page fails and the error stays set") {
+      REQUIRE(failed_at == 8192);
+      REQUIRE(buffer.error());
+      REQUIRE_FALSE(buffer.put(0));
+      REQUIRE_FALSE(buffer.flush());
+    }
+  }
+
+  WHEN("The storage is full when the last page is written")
+  {
+    flash.capacity = 9000;
+    REQUIRE(buffer.write(image.data(), image.size()));
+
+    THEN("Flushing at the end of the download fails") {
+      REQUIRE_FALSE(buffer.flush());
+      REQUIRE(buffer.error());
+    }
+  }
+
+  WHEN("The buffer is started again")
+  {
+    flash.capacity = 0;
+    REQUIRE_FALSE(buffer.write(image.data(), image.size()));
+    buffer.begin(4096);
+
+    THEN("The error is cleared") {
+      REQUIRE_FALSE(buffer.error());
+    }
+  }
+}
@@ -0,0 +1,191 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <util/OtaHttpServerMock.h>
+#include <util/OtaTestUtil.h>
+
+#include <ota/utility/OtaHttpRangePipeline.h>
+
+/******************************************************************************
+  TEST HELPER
+ ******************************************************************************/
+
+/* LTE-M: TLS handshake, round trip time and ~320 kbit/s */
+static OtaHttpServerMock::Link const LTE_M = {1500, 150, 40};
+
+struct Download
+{
+  std::vector<uint8_t> data;
+  int error;
+  unsigned long duration_ms;
+};
+
+/* Drives the pipeline like OTADefaultCloudProcessInterface::fetch(), which yields for 1 ms when no data is available */
+static Download download(OtaHttpRangePipeline & pipeline, OtaHttpServerMock & server, size_t const buffer_size = 1460)
+{
+  Download result = {{}, 0, 0};
+  std::vector<uint8_t> buffer(buffer_size);
+  unsigned long const start_ms = millis();
+
+  while (!pipeline.completed() && millis() - start_ms < 600000UL)
+  {
+    int const bytes_read = pipeline.read(server, buffer.data(), buffer.size());
+    if (bytes_read < 0) {
+      result.error = bytes_read;
+      break;
+    }
+    if (bytes_read == 0)
+      set_millis(millis() + 1);
+    result.data.insert(result.data.end(), buffer.begin(), buffer.begin() + bytes_read);
+  }
+
+  result.duration_ms = millis() - start_ms;
+  return result;
+}
+
+/******************************************************************************
+  TEST CODE
+ ******************************************************************************/
+
+SCENARIO("An .ota file is downloaded with pipelined Range requests", "[OtaHttpRangePipeline]")
+{
+  set_millis(0);
+  std::vector<uint8_t> const file = otaFile(firmware(256 * 1024));
+  OtaHttpServerMock server(file, LTE_M);
+  OtaHttpRangePipeline pipeline(10 * 1024, 2);
+  pipeline.begin("downloads.arduino.cc", 443, "/ota/firmware.ota");
+
+  WHEN("The server keeps the connection alive")
+  {
+    Download const result = download(pipeline, server);
+
+    THEN("The whole file is received over a single connection") {
+      REQUIRE(result.error == 0);
+      REQUIRE(result.data == file);
+      REQUIRE(pipeline.contentLength() == file.size());
+      REQUIRE(server.connections == 1);
+      REQUIRE(server.requests == (file.size() + 10 * 1024 - 1) / (10 * 1024));
+    }
+  }
+
+  WHEN("The server closes the connection every 8 requests")
+  {
+    server.requests_per_connection = 8;
+    Download const result = download(pipeline, server);
+
+    THEN("The requests which have been lost are sent again on a new connection") {
+      REQUIRE(result.error == 0);
+      REQUIRE(result.data == file);
+      REQUIRE(server.connections == 4);
+    }
+  }
+
+  WHEN("The server does not support Range requests")
+  {
+    server.range_support = false;
+    Download const result = download(pipeline, server);
+
+    THEN("The whole file is received with the first response") {
+      REQUIRE(result.error == 0);
+      REQUIRE(result.data == file);
+      REQUIRE(server.requests == 1);
+    }
+  }
+
+  WHEN("The download starts at an offset")
+  {
+    OtaHttpRangePipeline resumed(10 * 1024, 2);
+    resumed.begin("downloads.arduino.cc", 443, "/ota/firmware.ota", 100000);
+    Download const result = download(resumed, server);
+
+    THEN("Only the rest of the file is received") {
+      REQUIRE(result.error == 0);
+      REQUIRE(result.data == std::vector<uint8_t>(file.begin() + 100000, file.end()));
+      REQUIRE(resumed.offset() == file.size());
+    }
+  }
+
+  WHEN("The server requires authentication")
+  {
+    pipeline.setAuthentication("user", "pass");
+    download(pipeline, server);
+
+    THEN("Every request carries the credentials") {
+      REQUIRE(server.last_request.find("Authorization: Basic dXNlcjpwYXNz\r\n") != std::string::npos);
+    }
+  }
+}
+
+SCENARIO("Pipelined Range requests save a handshake and a round trip per range", "[OtaHttpRangePipeline]")
+{
+  set_millis(0);
+  std::vector<uint8_t> const file = otaFile(firmware(256 * 1024));
+
+  /* ChunkDownload: every 10 KB range is requested on a new connection */
+  OtaHttpServerMock chunked_server(file, LTE_M);
+  chunked_server.requests_per_connection = 1;
+  OtaHttpRangePipeline chunked(10 * 1024, 1);
+  chunked.begin("downloads.arduino.cc", 443, "/ota/firmware.ota");
+  Download const chunked_result = download(chunked, chunked_server);
+
+  OtaHttpServerMock pipelined_server(file, LTE_M);
+  OtaHttpRangePipeline pipelined(10 * 1024, 2);
+  pipelined.begin("downloads.arduino.cc", 443, "/ota/firmware.ota");
+  Download const pipelined_result = download(pipelined, pipelined_server);
+
+  THEN("Both deliver the same file") {
+    REQUIRE(chunked_result.data == file);
+    REQUIRE(pipelined_result.data == file);
+    REQUIRE(chunked_server.connections == chunked_server.requests);
+    REQUIRE(pipelined_server.connections == 1);
+  }
+  THEN("The pipelined download is only bound by the bandwidth of the link") {
+    unsigned long const transfer_ms = file.size() / LTE_M.bytes_per_ms;
+    REQUIRE(pipelined_result.duration_ms < LTE_M.handshake_ms + 2 * LTE_M.rtt_ms + transfer_ms + transfer_ms / 50);
+    REQUIRE(pipelined_result.duration_ms * 5 < chunked_result.duration_ms);
+  }
+}
+
+SCENARIO("Unexpected responses stop the download", "[OtaHttpRangePipeline]")
+{
+  set_millis(0);
+  std::vector<uint8_t> const file = otaFile(firmware(4096));
+  OtaHttpServerMock server(file, LTE_M);
+  OtaHttpRangePipeline pipeline(1024, 2);
+
+  WHEN("A download is resumed from a server without Range support")
+  {
+    server.range_support = false;
+    pipeline.begin("downloads.arduino.cc", 443, "/ota/firmware.ota", 1024);
+    Download const result = download(pipeline, server);
+
+    THEN("The response is rejected") {
+      REQUIRE(result.error == OtaHttpRangePipeline::ResponseError);
+    }
+  }
+
+  WHEN("The path does not fit into a request")
+  {
+    std::string const path = "/" + std::string(600, 'x');
+    pipeline.begin("downloads.arduino.cc", 443, path.c_str());
+    Download const result = download(pipeline, server);
+
+    THEN("No request is sent") {
+      REQUIRE(result.error == OtaHttpRangePipeline::RequestError);
+      REQUIRE(server.requests == 0);
+    }
+  }
+}
@@ -0,0 +1,119 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <vector>
+
+#include <util/OtaTestUtil.h>
+
+#include <ota/utility/OtaLzssDecoder.h>
+
+/******************************************************************************
+  TEST CODE
+ ******************************************************************************/
+
+SCENARIO("The LZSS payload of an .ota file is decompressed", "[OtaLzssDecoder]")
+{
+  std::vector<uint8_t> output;
+  OtaLzssDecoder decoder([&output](uint8_t c) { output.push_back(c); });
+
+  WHEN("Program code is decompressed at once")
+  {
+    std::vector<uint8_t> const image = compressibleFirmware(64 * 1024);
+    std::vector<uint8_t> const compressed = lzss(image);
+    decoder.decompress(compressed.data(), compressed.size());
+
+    THEN("The original image is restored") {
+      REQUIRE(compressed.size() < image.size() / 2);
+      REQUIRE(output == image);
+    }
+  }
+
+  WHEN("Data which does not compress is decompressed")
+  {
+    std::vector<uint8_t> const image = firmware(16 * 1024);
+    std::vector<uint8_t> const compressed = lzss(image);
+    decoder.decompress(compressed.data(), compressed.size());
+
+    THEN("The original image is restored") {
+      REQUIRE(output == image);
+    }
+  }
+
+  WHEN("The stream is decompressed in blocks of any size")
+  {
+    std::vector<uint8_t> const image = compressibleFirmware(64 * 1024);
+    std::vector<uint8_t> const compressed = lzss(image);
+    for (size_t i = 0, block = 1; i < compressed.size(); i += block, block = block % 1500 + 7)
+      decoder.decompress(compressed.data() + i, std::min(block, compressed.size() - i));
+
+    THEN("The original image is restored") {
+      REQUIRE(output == image);
+    }
+  }
+
+  WHEN("The decoder is started again")
+  {
+    std::vector<uint8_t> const first = lzss(compressibleFirmware(4096, 3));
+    decoder.decompress(first.data(), first.size() / 2);
+    output.clear();
+
+    std::vector<uint8_t> const image = compressibleFirmware(8192);
+    std::vector<uint8_t> const compressed = lzss(image);
+    decoder.begin();
+    decoder.decompress(compressed.data(), compressed.size());
+
+    THEN("Nothing of the previous stream is left") {
+      REQUIRE(output == image);
+    }
+  }
+}
+
+SCENARIO("The state of the LZSS decoder is saved and restored", "[OtaLzssDecoder]")
+{
+  std::vector<uint8_t> const image = compressibleFirmware(64 * 1024);
+  std::vector<uint8_t> const compressed = lzss(image);
+  size_t const split = 12345;
+
+  std::vector<uint8_t> output;
+  OtaLzssDecoder decoder([&output](uint8_t c) { output.push_back(c); });
+  decoder.decompress(compressed.data(), split);
+  OtaLzssDecoder::State const state = decoder.state();
+  size_t const decompressed = output.size();
+
+  WHEN("Another decoder continues from the saved state")
+  {
+    OtaLzssDecoder resumed([&output](uint8_t c) { output.push_back(c); });
+    resumed.restore(state);
+    resumed.decompress(compressed.data() + split, compressed.size() - split);
+
+    THEN("The rest of the image is decompressed") {
+      REQUIRE(output == image);
+    }
+  }
+
+  WHEN("The same decoder goes on and is then rolled back to the saved state")
+  {
+    decoder.decompress(compressed.data() + split, 1000);
+    output.resize(decompressed);
+    decoder.restore(state);
+    decoder.decompress(compressed.data() + split, compressed.size() - split);
+
+    THEN("The image is decompressed as if it had not gone on") {
+      REQUIRE(output == image);
+    }
+  }
+}
@@ -0,0 +1,182 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <util/OtaBoardMock.h>
+#include <util/OtaHttpServerMock.h>
+#include <util/OtaTestUtil.h>
+
+#include <ota/utility/OtaSha256.h>
+
+/******************************************************************************
+  TEST HELPER
+ ******************************************************************************/
+
+static OtaHttpServerMock::Link const WIFI = {100, 20, 1000};
+static uint8_t const OTA_ID[OtaCheckpoint::ID_SIZE] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x10};
+
+static std::string hex(std::vector<uint8_t> const & bytes)
+{
+  static char const digits[] = "0123456789abcdef";
+  std::string str;
+  for (uint8_t const b : bytes) {
+    str += digits[b >> 4];
+    str += digits[b & 0x0F];
+  }
+  return str;
+}
+
+static std::string sha256(std::string const & message)
+{
+  return hex(sha256(std::vector<uint8_t>(message.begin(), message.end())));
+}
+
+/******************************************************************************
+  TEST CODE
+ ******************************************************************************/
+
+SCENARIO("The SHA-256 of a message is computed", "[OtaSha256]")
+{
+  THEN("The digests match the FIPS 180-4 examples") {
+    REQUIRE(sha256("") == "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+    REQUIRE(sha256("abc") == "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+    REQUIRE(sha256("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq") == "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+    REQUIRE(sha256(std::string(1000000, 'a')) == "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+  }
+
+  WHEN("The message is hashed in blocks of any size")
+  {
+    std::vector<uint8_t> const image = firmware(20000);
+    OtaSha256 sha;
+    for (size_t i = 0, block = 1; i < image.size(); i += block, block = block % 300 + 1)
+      sha.update(image.data() + i, std::min(block, image.size() - i));
+    std::vector<uint8_t> digest(OtaSha256::HASH_SIZE);
+    sha.finalize(digest.data());
+
+    THEN("The digest is the one of the whole message") {
+      REQUIRE(digest == sha256(image));
+    }
+  }
+
+  WHEN("Empty updates are interleaved")
+  {
+    OtaSha256 sha;
+    sha.update(nullptr, 0);
+    sha.update(reinterpret_cast<uint8_t const *>("ab"), 2);
+    sha.update(nullptr, 0);
+    sha.update(reinterpret_cast<uint8_t const *>("c"), 1);
+    std::vector<uint8_t> digest(OtaSha256::HASH_SIZE);
+    sha.finalize(digest.data());
+
+    THEN("They do not change the digest") {
+      REQUIRE(hex(digest) == sha256("abc"));
+    }
+  }
+
+  WHEN("The state is restored into another instance")
+  {
+    std::vector<uint8_t> const image = firmware(20000);
+    OtaSha256 sha;
+    sha.update(image.data(), 12345);
+    OtaSha256 resumed;
+    resumed.restore(sha.state());
+    resumed.update(image.data() + 12345, image.size() - 12345);
+    std::vector<uint8_t> digest(OtaSha256::HASH_SIZE);
+    resumed.finalize(digest.data());
+
+    THEN("The digest is the one of the whole message") {
+      REQUIRE(digest == sha256(image));
+    }
+  }
+}
+
+SCENARIO("The image downloaded from the server is verified against the finalSha256 of the OTA", "[OtaSha256]")
+{
+  set_millis(0);
+  std::vector<uint8_t> const image = compressibleFirmware(200 * 1024);
+  std::vector<uint8_t> const final_sha256 = sha256(image);
+  OtaUpdateFile update_file;
+  OtaCheckpointStorageMock storage;
+
+  WHEN("The server sends the image of the OTA")
+  {
+    OtaHttpServerMock server(otaFile(lzss(image)), WIFI);
+    OtaBoardMock board(update_file, storage, OTA_ID, final_sha256.data());
+
+    THEN("The image is accepted") {
+      REQUIRE(board.fetch(server) == OtaBoardMock::Result::Completed);
+      REQUIRE(update_file.data == image);
+    }
+  }
+
+  WHEN("The download of the image is resumed")
+  {
+    std::vector<uint8_t> const file = otaFile(lzss(image));
+    OtaHttpServerMock server(file, WIFI);
+    OtaBoardMock interrupted(update_file, storage, OTA_ID, final_sha256.data());
+    REQUIRE(interrupted.fetch(server, file.size() * 3 / 4) == OtaBoardMock::Result::Interrupted);
+    server.stop();
+    OtaBoardMock board(update_file, storage, OTA_ID, final_sha256.data());
+
+    THEN("The image is accepted") {
+      REQUIRE(board.resumed_from > 0);
+      REQUIRE(board.fetch(server) == OtaBoardMock::Result::Completed);
+      REQUIRE(update_file.data == image);
+    }
+  }
+
+  WHEN("The server sends a file with a valid CRC but another image")
+  {
+    std::vector<uint8_t> other_image = image;
+    other_image[150000] ^= 0x01;
+    OtaHttpServerMock server(otaFile(lzss(other_image)), WIFI);
+    OtaBoardMock board(update_file, storage, OTA_ID, final_sha256.data());
+
+    THEN("The image is rejected") {
+      REQUIRE(board.fetch(server) == OtaBoardMock::Result::Sha256Mismatch);
+      REQUIRE(storage.record.empty());
+    }
+  }
+
+  WHEN("The OTA does not carry a finalSha256")
+  {
+    std::vector<uint8_t> const unknown_sha256(OtaSha256::HASH_SIZE, 0);
+    OtaHttpServerMock server(otaFile(lzss(image)), WIFI);
+    OtaBoardMock board(update_file, storage, OTA_ID, unknown_sha256.data());
+
+    THEN("The image is accepted") {
+      REQUIRE(board.fetch(server) == OtaBoardMock::Result::Completed);
+      REQUIRE(update_file.data == image);
+    }
+  }
+
+  WHEN("The file is corrupted on the server")
+  {
+    std::vector<uint8_t> file = otaFile(lzss(image));
+    file[file.size() / 2] ^= 0x01;
+    OtaHttpServerMock server(file, WIFI);
+    OtaBoardMock board(update_file, storage, OTA_ID, final_sha256.data());
+
+    THEN("The CRC check rejects the file first") {
+      REQUIRE(board.fetch(server) == OtaBoardMock::Result::CrcMismatch);
+    }
+  }
+}
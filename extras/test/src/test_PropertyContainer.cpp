@@ -0,0 +1,94 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <vector>
+
+#include <PropertyContainer.h>
+#include <types/CloudInt.h>
+
+/******************************************************************************
+  TEST CODE
+ ******************************************************************************/
+
+SCENARIO("Properties are looked up by name and identifier", "[PropertyContainer]")
+{
+  WHEN("A large number of properties is added to the container")
+  {
+    PropertyContainer property_container;
+    std::vector<CloudInt> props(1000);
+
+    for (size_t i = 0; i < props.size(); i++)
+      addPropertyToContainer(property_container, props[i], String("prop_") + std::to_string(i), Permission::ReadWrite);
+
+    THEN("Every property can be retrieved by its name and its identifier") {
+      REQUIRE(property_container.size() == props.size());
+      for (size_t i = 0; i < props.size(); i++)
+      {
+        REQUIRE(getProperty(property_container, String("prop_") + std::to_string(i)) == &props[i]);
+        REQUIRE(getProperty(property_container, static_cast<int>(i + 1)) == &props[i]);
+      }
+    }
+    THEN("The insertion order is preserved") {
+      size_t i = 0;
+      for (Property * p : property_container)
+        REQUIRE(p == &props[i++]);
+    }
+    THEN("Unknown names and identifiers are not found") {
+      REQUIRE(getProperty(property_container, "prop_1000") == nullptr);
+      REQUIRE(getProperty(property_container, "") == nullptr);
+      REQUIRE(getProperty(property_container, 0) == nullptr);
+      REQUIRE(getProperty(property_container, 1001) == nullptr);
+      REQUIRE(getProperty(property_container, -1) == nullptr);
+    }
+  }
+
+  WHEN("Properties are added with explicit identifiers")
+  {
+    PropertyContainer property_container;
+    CloudInt small_id, large_id, duplicated_id;
+
+    addPropertyToContainer(property_container, small_id, "small_id", Permission::ReadWrite, 3);
+    addPropertyToContainer(property_container, large_id, "large_id", Permission::ReadWrite, 100000);
+    addPropertyToContainer(property_container, duplicated_id, "duplicated_id", Permission::ReadWrite, 3);
+
+    THEN("Identifiers outside of the direct lookup table are still found") {
+      REQUIRE(getProperty(property_container, 100000) == &large_id);
+    }
+    THEN("The first property registered with an identifier is returned") {
+      REQUIRE(getProperty(property_container, 3) == &small_id);
+      REQUIRE(getPropertyNameByIdentifier(property_container, 3) == "small_id");
+    }
+  }
+
+  WHEN("A sparse identifier is added before the container has grown past it")
+  {
+    PropertyContainer property_container;
+    CloudInt sparse_id, same_sparse_id;
+    std::vector<CloudInt> props(20);
+
+    addPropertyToContainer(property_container, sparse_id, "sparse_id", Permission::ReadWrite, 12);
+    for (size_t i = 0; i < props.size(); i++)
+      addPropertyToContainer(property_container, props[i], String("prop_") + std::to_string(i), Permission::ReadWrite, 100 + i);
+    addPropertyToContainer(property_container, same_sparse_id, "same_sparse_id", Permission::ReadWrite, 12);
+
+    THEN("It is found although it lies within the bounds of the direct table by now") {
+      REQUIRE(getProperty(property_container, 12) == &sparse_id);
+      REQUIRE(getProperty(property_container, 100) == &props[0]);
+      REQUIRE(getProperty(property_container, 119) == &props[19]);
+      REQUIRE(getProperty(property_container, 13) == nullptr);
+    }
+  }
+}
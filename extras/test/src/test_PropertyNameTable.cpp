@@ -0,0 +1,122 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <string.h>
+#include <string>
+
+#include <util/CBORTestUtil.h>
+
+#include <AIoTC_Config.h>
+#include <PropertyContainer.h>
+#include <PropertyNameTable.h>
+#include <types/CloudInt.h>
+
+/******************************************************************************
+  TEST CODE
+ ******************************************************************************/
+
+SCENARIO("Strings are stored in the property name table", "[PropertyNameTable]")
+{
+  WHEN("A string is stored")
+  {
+    size_t const size_before = PropertyNameTable::size();
+    char const * stored = PropertyNameTable::store("temperature", 11);
+
+    THEN("A zero terminated copy is returned") {
+      REQUIRE(stored != nullptr);
+      REQUIRE(strcmp(stored, "temperature") == 0);
+      REQUIRE(PropertyNameTable::size() == size_before + 12);
+    }
+  }
+
+  WHEN("A string larger than a chunk is stored")
+  {
+    std::string const long_name(AIOT_CONFIG_PROPERTY_NAME_TABLE_CHUNK_SIZE * 2, 'x');
+    char const * stored = PropertyNameTable::store(long_name.c_str(), long_name.length());
+
+    THEN("It gets a chunk of its own") {
+      REQUIRE(stored != nullptr);
+      REQUIRE(long_name == stored);
+      REQUIRE(PropertyNameTable::capacity() >= PropertyNameTable::size());
+    }
+  }
+}
+
+SCENARIO("Property names are kept in the property name table", "[PropertyNameTable]")
+{
+  PropertyContainer property_container;
+  CloudInt int_test = 1;
+
+  WHEN("The name the property has been added with goes out of scope")
+  {
+    {
+      String name("a_property_with_a_long_name");
+      addPropertyToContainer(property_container, int_test, name, Permission::ReadWrite);
+      name = "something_else_entirely_and_longer";
+    }
+
+    THEN("The property keeps its name") {
+      REQUIRE(strcmp(int_test.nameCStr(), "a_property_with_a_long_name") == 0);
+      REQUIRE(int_test.name() == "a_property_with_a_long_name");
+      REQUIRE(int_test.nameLength() == strlen("a_property_with_a_long_name"));
+      REQUIRE(getProperty(property_container, "a_property_with_a_long_name") == &int_test);
+    }
+  }
+}
+
+SCENARIO("Rarely used fields are allocated on first use", "[PropertyNameTable]")
+{
+  PropertyContainer property_container;
+  CloudInt int_test = 1;
+  addPropertyToContainer(property_container, int_test, "test", Permission::ReadWrite);
+
+  WHEN("The property has no sync callback")
+  {
+    int_test.setLastLocalChangeTimestamp(1550138809);
+    int_test.setLastCloudChangeTimestamp(1550138810);
+
+    THEN("Only the local change timestamp is tracked") {
+      REQUIRE(int_test.getLastLocalChangeTimestamp() == 1550138809);
+      REQUIRE(int_test.getLastCloudChangeTimestamp() == 0);
+    }
+  }
+
+  WHEN("A property without sync callback is changed locally")
+  {
+    CloudInt int_timed = 1;
+    addPropertyToContainer(property_container, int_timed, "timed", Permission::ReadWrite, -1,
+                           []() -> unsigned long { return 1550138811; });
+    int_timed = 2;
+    int_timed.updateLocalTimestamp();
+
+    THEN("The local change timestamp is recorded") {
+      REQUIRE(int_timed.getLastLocalChangeTimestamp() == 1550138811);
+    }
+  }
+
+  WHEN("A property with a sync callback is copied")
+  {
+    int_test.onSync(CLOUD_WINS);
+    int_test.setLastLocalChangeTimestamp(1550138809);
+    CloudInt copy(int_test);
+    int_test.setLastLocalChangeTimestamp(1550138810);
+
+    THEN("The copy owns its own sync data") {
+      REQUIRE(copy.getLastLocalChangeTimestamp() == 1550138809);
+      REQUIRE(int_test.getLastLocalChangeTimestamp() == 1550138810);
+    }
+  }
+}
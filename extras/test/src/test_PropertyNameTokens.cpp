@@ -0,0 +1,116 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <util/CBORTestUtil.h>
+
+#include <PropertyContainer.h>
+#include <types/CloudLocation.h>
+#include <types/CloudSchedule.h>
+#include <types/automation/CloudColoredLight.h>
+#include <types/automation/CloudTelevision.h>
+
+/******************************************************************************
+  TEST HELPER
+ ******************************************************************************/
+
+/* Property whose attribute list depends on its value */
+class CloudOptionalAttribute : public Property
+{
+public:
+  CloudOptionalAttribute() : _value{1}, _extended{false} { }
+
+  int  _value;
+  bool _extended;
+
+  virtual bool isDifferentFromCloud() { return true; }
+  virtual void fromCloudToLocal() { }
+  virtual void fromLocalToCloud() { }
+  virtual CborError appendAttributesToCloud(CborEncoder *encoder) {
+    CHECK_CBOR_MULTI(appendAttribute(_value, "val", encoder));
+    if (_extended) {
+      CHECK_CBOR_MULTI(appendAttribute(_value, "ext", encoder));
+    }
+    CHECK_CBOR_MULTI(appendAttribute(_value, "end", encoder));
+    return CborNoError;
+  }
+  virtual void setAttributesFromCloud() { }
+};
+
+/******************************************************************************
+  TEST CODE
+ ******************************************************************************/
+
+SCENARIO("Property names are encoded from precomputed tokens", "[Property::prepareNameTokens]")
+{
+  PropertyContainer property_container;
+
+  WHEN("A 'Location' property is added")
+  {
+    CloudLocation location_test = CloudLocation(2.0f, 3.0f);
+    addPropertyToContainer(property_container, location_test, "test", Permission::ReadWrite);
+
+    THEN("The encoded message is the same as the one built from the name strings") {
+      std::vector<uint8_t> const expected = { 0x9F, 0xA2, 0x00, 0x68, 0x74, 0x65, 0x73, 0x74, 0x3A, 0x6C, 0x61, 0x74, 0x02, 0xFA, 0x40, 0x00, 0x00, 0x00, 0xA2, 0x00, 0x68, 0x74, 0x65, 0x73, 0x74, 0x3A, 0x6C, 0x6F, 0x6E, 0x02, 0xFA, 0x40, 0x40, 0x00, 0x00, 0xFF };
+      REQUIRE(cbor::encode(property_container) == expected);
+    }
+  }
+
+  WHEN("A 'ColoredLight' property is added")
+  {
+    CloudColoredLight color_test = CloudColoredLight(true, 2.0, 2.0, 2.0);
+    addPropertyToContainer(property_container, color_test, "test", Permission::ReadWrite);
+
+    THEN("The encoded message is the same as the one built from the name strings") {
+      std::vector<uint8_t> const expected = {0x9F, 0xA2, 0x00, 0x68, 0x74, 0x65, 0x73, 0x74, 0x3A, 0x73, 0x77, 0x69, 0x04, 0xF5, 0xA2, 0x00, 0x68, 0x74, 0x65, 0x73, 0x74, 0x3A, 0x68, 0x75, 0x65, 0x02, 0xFA, 0x40, 0x00, 0x00, 0x00, 0xA2, 0x00, 0x68, 0x74, 0x65, 0x73, 0x74, 0x3A, 0x73, 0x61, 0x74, 0x02, 0xFA, 0x40, 0x00, 0x00, 0x00, 0xA2, 0x00, 0x68, 0x74, 0x65, 0x73, 0x74, 0x3A, 0x62, 0x72, 0x69, 0x02, 0xFA, 0x40, 0x00, 0x00, 0x00, 0xFF };
+      REQUIRE(cbor::encode(property_container) == expected);
+    }
+  }
+
+  WHEN("A 'Television' property is added")
+  {
+    CloudTelevision tv_test = CloudTelevision(true, 50, false, PlaybackCommands::Play, InputValue::TV, 7);
+    addPropertyToContainer(property_container, tv_test, "test", Permission::ReadWrite);
+
+    THEN("The encoded message is the same as the one built from the name strings") {
+      std::vector<uint8_t> const expected = {0x9F, 0xA2, 0x00, 0x68, 0x74, 0x65, 0x73, 0x74, 0x3A, 0x73, 0x77, 0x69, 0x04, 0xF5, 0xA2, 0x00, 0x68, 0x74, 0x65, 0x73, 0x74, 0x3A, 0x76, 0x6F, 0x6C, 0x02, 0x18, 0x32, 0xA2, 0x00, 0x68, 0x74, 0x65, 0x73, 0x74, 0x3A, 0x6D, 0x75, 0x74, 0x04, 0xF4, 0xA2, 0x00, 0x68, 0x74, 0x65, 0x73, 0x74, 0x3A, 0x70, 0x62, 0x63, 0x02, 0x03, 0xA2, 0x00, 0x68, 0x74, 0x65, 0x73, 0x74, 0x3A, 0x69, 0x6E, 0x70, 0x02, 0x18, 0x37, 0xA2, 0x00, 0x68, 0x74, 0x65, 0x73, 0x74, 0x3A, 0x63, 0x68, 0x61, 0x02, 0x07, 0xFF};
+      REQUIRE(cbor::encode(property_container) == expected);
+    }
+  }
+
+  WHEN("A 'Schedule' property is added")
+  {
+    CloudSchedule schedule_test = CloudSchedule(1633305600, 1633651200, 600, 1140850708);
+    addPropertyToContainer(property_container, schedule_test, "test", Permission::ReadWrite);
+
+    THEN("The encoded message is the same as the one built from the name strings") {
+      std::vector<uint8_t> const expected = {0x9F, 0xA2, 0x00, 0x68, 0x74, 0x65, 0x73, 0x74, 0x3A, 0x66, 0x72, 0x6D, 0x02, 0x1A, 0x61, 0x5A, 0x44, 0x00, 0xA2, 0x00, 0x67, 0x74, 0x65, 0x73, 0x74, 0x3A, 0x74, 0x6F, 0x02, 0x1A, 0x61, 0x5F, 0x8A, 0x00, 0xA2, 0x00, 0x68, 0x74, 0x65, 0x73, 0x74, 0x3A, 0x6C, 0x65, 0x6E, 0x02, 0x19, 0x02, 0x58, 0xA2, 0x00, 0x68, 0x74, 0x65, 0x73, 0x74, 0x3A, 0x6D, 0x73, 0x6B, 0x02, 0x1A, 0x44, 0x00, 0x00, 0x14, 0xFF };
+      REQUIRE(cbor::encode(property_container) == expected);
+    }
+  }
+
+  WHEN("The attribute list differs from the one recorded when the property was added")
+  {
+    CloudOptionalAttribute optional_test;
+    addPropertyToContainer(property_container, optional_test, "test", Permission::ReadWrite);
+    optional_test._extended = true;
+
+    THEN("The names which do not match are built from the name strings") {
+      /* [{0: "test:val", 2: 1}, {0: "test:ext", 2: 1}, {0: "test:end", 2: 1}] */
+      std::vector<uint8_t> const expected = {0x9F, 0xA2, 0x00, 0x68, 0x74, 0x65, 0x73, 0x74, 0x3A, 0x76, 0x61, 0x6C, 0x02, 0x01, 0xA2, 0x00, 0x68, 0x74, 0x65, 0x73, 0x74, 0x3A, 0x65, 0x78, 0x74, 0x02, 0x01, 0xA2, 0x00, 0x68, 0x74, 0x65, 0x73, 0x74, 0x3A, 0x65, 0x6E, 0x64, 0x02, 0x01, 0xFF};
+      REQUIRE(cbor::encode(property_container) == expected);
+    }
+  }
+}
@@ -0,0 +1,278 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <util/CBORTestUtil.h>
+#include <util/PropertyTestUtil.h>
+
+#include <CBORDecoder.h>
+#include <CBOREncoder.h>
+#include <PropertyContainer.h>
+#include <PropertySeries.h>
+#include <types/CloudFloat.h>
+#include <types/CloudInt.h>
+#include <types/CloudWrapperInt.h>
+
+/******************************************************************************
+  TEST HELPER
+ ******************************************************************************/
+
+/* Encodes the container into messages of 'size' bytes until nothing is left to send */
+static std::vector<std::vector<uint8_t>> encodeMessages(PropertyContainer & property_container, size_t const size)
+{
+  std::vector<std::vector<uint8_t>> messages;
+  unsigned int current_property_index = 0;
+  for (int i = 0; i < 32; i++) {
+    std::vector<uint8_t> buf(size);
+    int bytes_encoded = 0;
+    if (CBOREncoder::encode(property_container, buf.data(), buf.size(), bytes_encoded, current_property_index) != CborNoError || bytes_encoded == 0)
+      break;
+    buf.resize(bytes_encoded);
+    messages.push_back(buf);
+  }
+  return messages;
+}
+
+/* Number of records of a message, every record is a map */
+static size_t countRecords(std::vector<uint8_t> const & message)
+{
+  size_t records = 0;
+  CborParser parser;
+  CborValue array, record;
+  if (cbor_parser_init(message.data(), message.size(), 0, &parser, &array) != CborNoError || cbor_value_enter_container(&array, &record) != CborNoError)
+    return 0;
+  while (!cbor_value_at_end(&record)) {
+    records++;
+    if (cbor_value_advance(&record) != CborNoError)
+      break;
+  }
+  return records;
+}
+
+/******************************************************************************
+  TEST CODE
+ ******************************************************************************/
+
+SCENARIO("Samples are stored in a ring buffer", "[PropertySeries]")
+{
+  PropertySeries series;
+  REQUIRE(series.reserve(3));
+
+  WHEN("More samples than the capacity are pushed")
+  {
+    for (uint32_t i = 0; i < 5; i++)
+      series.push(i * 100, static_cast<float>(i));
+
+    THEN("The oldest samples are overwritten") {
+      REQUIRE(series.size() == 3);
+      REQUIRE(series.overwritten() == 2);
+      REQUIRE(series[0].millis == 200);
+      REQUIRE(series[0].value == 2.0f);
+      REQUIRE(series[2].millis == 400);
+      REQUIRE(series[2].value == 4.0f);
+    }
+  }
+
+  WHEN("Only part of the samples has been appended to a message")
+  {
+    for (uint32_t i = 0; i < 3; i++)
+      series.push(i * 100, static_cast<float>(i));
+    series.markAppended(2);
+    series.appendCompleted();
+
+    THEN("The remaining samples are kept as backlog") {
+      REQUIRE(series.size() == 1);
+      REQUIRE(series[0].value == 2.0f);
+      REQUIRE(series.backlog());
+    }
+    THEN("The backlog is cleared once the remaining samples have been sent") {
+      series.markAppended(1);
+      series.appendCompleted();
+      REQUIRE(series.empty());
+      REQUIRE_FALSE(series.backlog());
+    }
+  }
+
+  WHEN("A sample is overwritten while the series is being sent")
+  {
+    for (uint32_t i = 0; i < 3; i++)
+      series.push(i * 100, static_cast<float>(i));
+    series.markAppended(3);
+    series.push(300, 3.0f);
+    series.appendCompleted();
+
+    THEN("The sample taken in the meantime is kept") {
+      REQUIRE(series.size() == 1);
+      REQUIRE(series[0].value == 3.0f);
+    }
+  }
+}
+
+SCENARIO("Buffered samples are encoded as a SenML pack", "[PropertySeries]")
+{
+  PropertyContainer property_container;
+  CloudInt int_test = 0;
+  addPropertyToContainer(property_container, int_test, "test", Permission::ReadWrite).publishOnChange(0, 0).bufferSamples(8);
+
+  WHEN("Samples have been taken")
+  {
+    set_millis(1000);
+    int_test = 1;
+    set_millis(1500);
+    int_test = 2;
+    set_millis(2000);
+    int_test = 3;
+
+    /* Without a valid time the samples are timed relative to the reception of the message
+     * [{-2: "test", 2: 1, 6: -1}, {2: 2, 6: -0.5}, {2: 3, 6: 0}]
+     * = 9F A3 21 64 74 65 73 74 02 01 06 20 A2 02 02 06 FA BF 00 00 00 A2 02 03 06 00 FF
+     */
+    std::vector<uint8_t> const expected = {0x9F, 0xA3, 0x21, 0x64, 0x74, 0x65, 0x73, 0x74, 0x02, 0x01, 0x06, 0x20,
+                                           0xA2, 0x02, 0x02, 0x06, 0xFA, 0xBF, 0x00, 0x00, 0x00,
+                                           0xA2, 0x02, 0x03, 0x06, 0x00, 0xFF};
+    std::vector<uint8_t> const actual = cbor::encode(property_container);
+    THEN("They are encoded with the base name and a relative time") {
+      REQUIRE(actual == expected);
+      REQUIRE(int_test.series()->empty());
+    }
+  }
+
+  WHEN("A property follows the series")
+  {
+    CloudInt other_test = 4;
+    addPropertyToContainer(property_container, other_test, "b", Permission::ReadWrite);
+    set_millis(1000);
+    int_test = 1;
+
+    /* [{-2: "test", 2: 1, 6: 0}, {-2: "", 0: "b", 2: 4}] */
+    std::vector<uint8_t> const expected = {0x9F, 0xA3, 0x21, 0x64, 0x74, 0x65, 0x73, 0x74, 0x02, 0x01, 0x06, 0x00,
+                                           0xA3, 0x21, 0x60, 0x00, 0x61, 0x62, 0x02, 0x04, 0xFF};
+    std::vector<uint8_t> const actual = cbor::encode(property_container);
+    THEN("The base name is reset") {
+      REQUIRE(actual == expected);
+    }
+  }
+
+  WHEN("Light payload is requested")
+  {
+    set_millis(1000);
+    int_test = 1;
+    set_millis(2000);
+    int_test = 2;
+
+    /* [{0: 1, 2: 1, 6: -1}, {0: 1, 2: 2, 6: 0}] */
+    std::vector<uint8_t> const expected = {0x9F, 0xA3, 0x00, 0x01, 0x02, 0x01, 0x06, 0x20,
+                                           0xA3, 0x00, 0x01, 0x02, 0x02, 0x06, 0x00, 0xFF};
+    std::vector<uint8_t> const actual = cbor::encode(property_container, true);
+    THEN("Every record carries the identifier of the property") {
+      REQUIRE(actual == expected);
+    }
+  }
+
+  WHEN("Compact payload is requested")
+  {
+    set_millis(1000);
+    int_test = 1000;
+    set_millis(2000);
+    int_test = 1001;
+
+    /* [{-2: "test", -5: 1000, 2: 0, 6: -1}, {2: 1, 6: 0}] */
+    std::vector<uint8_t> const expected = {0x9F, 0xA4, 0x21, 0x64, 0x74, 0x65, 0x73, 0x74, 0x24, 0x19, 0x03, 0xE8, 0x02, 0x00, 0x06, 0x20,
+                                           0xA2, 0x02, 0x01, 0x06, 0x00, 0xFF};
+    std::vector<uint8_t> const actual = cbor::encode(property_container, false, true);
+    THEN("The values are encoded relative to the base value") {
+      REQUIRE(actual == expected);
+    }
+  }
+}
+
+SCENARIO("A series does not fit into a single message", "[PropertySeries]")
+{
+  PropertyContainer property_container;
+  CloudFloat float_test = 0.0f;
+  addPropertyToContainer(property_container, float_test, "temperature", Permission::ReadWrite).publishOnChange(0, 0).bufferSamples(16);
+
+  for (unsigned long i = 0; i < 16; i++) {
+    set_millis(1000 + i * 250);
+    float_test = 20.0f + i * 0.1f;
+  }
+
+  WHEN("The samples are encoded into small messages")
+  {
+    std::vector<std::vector<uint8_t>> const messages = encodeMessages(property_container, 64);
+
+    THEN("They are spread over multiple messages without losing any") {
+      REQUIRE(messages.size() > 1);
+      size_t records = 0;
+      for (auto const & message : messages) {
+        REQUIRE(message.size() <= 64);
+        records += countRecords(message);
+      }
+      REQUIRE(records == 16);
+      REQUIRE(float_test.series()->empty());
+      REQUIRE_FALSE(float_test.series()->backlog());
+    }
+  }
+
+  WHEN("Only the first message is sent")
+  {
+    std::vector<uint8_t> buf(64);
+    int bytes_encoded = 0;
+    unsigned int current_property_index = 0;
+    CBOREncoder::encode(property_container, buf.data(), buf.size(), bytes_encoded, current_property_index);
+
+    THEN("The property stays pending until the remaining samples are sent") {
+      REQUIRE(bytes_encoded > 0);
+      REQUIRE_FALSE(float_test.series()->empty());
+      REQUIRE(float_test.series()->backlog());
+      REQUIRE(float_test.shouldBeUpdated());
+    }
+  }
+}
+
+SCENARIO("Samples of a primitive variable are buffered", "[PropertySeries]")
+{
+  PropertyContainer property_container;
+  int counter = 0;
+  CloudWrapperInt counter_property(counter);
+  addPropertyToContainer(property_container, counter_property, "counter", Permission::ReadWrite).publishOnChange(0, 0).bufferSamples(4);
+
+  WHEN("The variable is changed without recording a sample")
+  {
+    counter = 5;
+
+    THEN("No sample is taken") {
+      REQUIRE(counter_property.series()->empty());
+    }
+  }
+
+  WHEN("A sample is recorded after each change")
+  {
+    set_millis(1000);
+    counter = 5;
+    counter_property.recordSample();
+    set_millis(2000);
+    counter = 7;
+    counter_property.recordSample();
+
+    /* [{-2: "counter", 2: 5, 6: -1}, {2: 7, 6: 0}] */
+    std::vector<uint8_t> const expected = {0x9F, 0xA3, 0x21, 0x67, 0x63, 0x6F, 0x75, 0x6E, 0x74, 0x65, 0x72, 0x02, 0x05, 0x06, 0x20,
+                                           0xA2, 0x02, 0x07, 0x06, 0x00, 0xFF};
+    std::vector<uint8_t> const actual = cbor::encode(property_container);
+    THEN("The samples are encoded as a series") {
+      REQUIRE(actual == expected);
+    }
+  }
+}
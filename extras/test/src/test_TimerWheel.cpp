@@ -0,0 +1,202 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <random>
+#include <vector>
+
+#include <util/CBORTestUtil.h>
+
+#include <TimerWheel.h>
+#include <PropertyContainer.h>
+#include <types/CloudInt.h>
+
+/******************************************************************************
+  TEST HELPER
+ ******************************************************************************/
+
+/* Runs the wheel from 'start' for 'duration' ms in steps of 'step' ms. Every
+ * timer is periodic and gets rescheduled on expiration. Checks that timers
+ * neither expire before their deadline nor later than the first step past it.
+ */
+static void runPeriodicTimers(uint32_t const start, uint64_t const duration, uint32_t const step, std::vector<uint32_t> const & period, size_t & expirations)
+{
+  TimerWheel wheel;
+  std::vector<uint32_t> deadline(period.size());
+
+  wheel.resize(period.size());
+  wheel.expire(start, [](size_t) { });
+  for (size_t id = 0; id < period.size(); id++) {
+    deadline[id] = start + period[id];
+    wheel.schedule(id, deadline[id]);
+  }
+
+  expirations = 0;
+  bool on_time = true;
+  uint32_t now = start;
+  for (uint64_t elapsed = step; elapsed <= duration; elapsed += step)
+  {
+    uint32_t const previous = now;
+    now = static_cast<uint32_t>(start + elapsed);
+    wheel.expire(now, [&](size_t const id)
+    {
+      /* due: previous < deadline <= now, computed modulo 2^32 */
+      bool const due = static_cast<int32_t>(now - deadline[id]) >= 0;
+      bool const not_late = static_cast<int32_t>(deadline[id] - previous) > 0;
+      if (!due || !not_late)
+        on_time = false;
+      deadline[id] += period[id];
+      wheel.schedule(id, deadline[id]);
+      expirations++;
+    });
+  }
+
+  /* No timer may have been left behind */
+  for (size_t id = 0; id < period.size(); id++) {
+    if (static_cast<int32_t>(now - deadline[id]) >= 0)
+      on_time = false;
+  }
+
+  REQUIRE(on_time);
+  REQUIRE(wheel.scheduledCount() == period.size());
+}
+
+/******************************************************************************
+  TEST CODE
+ ******************************************************************************/
+
+SCENARIO("Timers expire exactly when their deadline is reached", "[TimerWheel]")
+{
+  TimerWheel wheel;
+  std::vector<size_t> expired;
+  auto collect = [&expired](size_t const id) { expired.push_back(id); };
+
+  wheel.resize(4);
+  wheel.expire(1000, collect);
+  wheel.schedule(0, 1001);        /* level 0 */
+  wheel.schedule(1, 1000 + 500);  /* level 1 */
+  wheel.schedule(2, 1000 + 60000);/* level 2 */
+  wheel.schedule(3, 1000 + 10UL * 3600 * 1000); /* beyond the range of the wheel */
+
+  WHEN("Time advances up to one ms before each deadline")
+  {
+    wheel.expire(1000, collect);
+    wheel.expire(1499, collect);
+    REQUIRE(expired == std::vector<size_t>{0});
+    wheel.expire(1500, collect);
+    REQUIRE(expired == std::vector<size_t>{0, 1});
+    wheel.expire(60999, collect);
+    REQUIRE(expired.size() == 2);
+    wheel.expire(61000, collect);
+    REQUIRE(expired == std::vector<size_t>{0, 1, 2});
+    wheel.expire(1000 + 10UL * 3600 * 1000 - 1, collect);
+    REQUIRE(expired.size() == 3);
+    wheel.expire(1000 + 10UL * 3600 * 1000, collect);
+    REQUIRE(expired == std::vector<size_t>{0, 1, 2, 3});
+    REQUIRE(wheel.scheduledCount() == 0);
+  }
+
+  WHEN("A timer is scheduled in the past or at the current time")
+  {
+    wheel.schedule(0, 999);
+    wheel.schedule(1, 1000);
+    wheel.expire(1000, collect);
+    THEN("It expires with the next call to expire") {
+      REQUIRE(expired.size() == 2);
+    }
+  }
+
+  WHEN("A timer is cancelled")
+  {
+    wheel.cancel(1);
+    wheel.expire(2000, collect);
+    THEN("It never expires") {
+      REQUIRE(expired == std::vector<size_t>{0});
+      REQUIRE(wheel.isScheduled(1) == false);
+      REQUIRE(wheel.isScheduled(2) == true);
+    }
+  }
+
+  WHEN("Time jumps far beyond all deadlines")
+  {
+    wheel.expire(1000 + 11UL * 3600 * 1000, collect);
+    THEN("All timers expire at once") {
+      REQUIRE(expired.size() == 4);
+    }
+  }
+}
+
+SCENARIO("Thousands of periodic timers are serviced across the millis() rollover", "[TimerWheel]")
+{
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<uint32_t> short_period(1, 600 * 1000);
+  std::vector<uint32_t> period(2000);
+  for (uint32_t & p : period)
+    p = short_period(rng);
+
+  size_t expirations = 0;
+
+  WHEN("The wheel runs for two hours around the rollover, serviced every 7 ms")
+  {
+    runPeriodicTimers(0xFFFFFFFFUL - 3600UL * 1000, 2 * 3600UL * 1000, 7, period, expirations);
+    THEN("All expirations happened on time") {
+      REQUIRE(expirations > period.size());
+    }
+  }
+
+  WHEN("The wheel runs for two hours around the rollover, serviced every 1234 ms")
+  {
+    runPeriodicTimers(0xFFFFFFFFUL - 3600UL * 1000, 2 * 3600UL * 1000, 1234, period, expirations);
+    THEN("All expirations happened on time") {
+      REQUIRE(expirations > period.size());
+    }
+  }
+}
+
+SCENARIO("Long periodic timers survive a full 49 day millis() cycle", "[TimerWheel]")
+{
+  std::mt19937 rng(7);
+  std::uniform_int_distribution<uint32_t> long_period(3600UL * 1000, 24UL * 3600 * 1000);
+  std::vector<uint32_t> period(1000);
+  for (uint32_t & p : period)
+    p = long_period(rng);
+
+  size_t expirations = 0;
+
+  /* 50 days with one call per minute, starting 1 hour before the rollover */
+  runPeriodicTimers(0xFFFFFFFFUL - 3600UL * 1000, 50ULL * 24 * 3600 * 1000, 60UL * 1000, period, expirations);
+  REQUIRE(expirations > period.size() * 50);
+}
+
+SCENARIO("A property published every 10 s keeps its pace across the millis() rollover", "[TimerWheel]")
+{
+  PropertyContainer property_container;
+  CloudInt test = 0;
+  unsigned long const start = 0xFFFFFFFFUL - 15000;
+
+  set_millis(start);
+  addPropertyToContainer(property_container, test, "test", Permission::ReadWrite).publishEvery(10);
+  REQUIRE(cbor::encode(property_container).size() != 0);
+
+  std::vector<unsigned long> sent_at;
+  for (unsigned long t = 1; t <= 40000; t += 100)
+  {
+    set_millis(static_cast<uint32_t>(start + t));
+    if (cbor::encode(property_container).size() != 0)
+      sent_at.push_back(t);
+  }
+
+  REQUIRE(sent_at == std::vector<unsigned long>{10001, 20001, 30001});
+}
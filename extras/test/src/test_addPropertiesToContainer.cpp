@@ -0,0 +1,159 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <string>
+#include <vector>
+
+#include <util/CBORTestUtil.h>
+
+#include <Arduino_DebugUtils.h>
+
+#include <CBORDecoder.h>
+
+#include <PropertyContainer.h>
+#include <types/CloudWrapperInt.h>
+
+/******************************************************************************
+  TEST HELPER
+ ******************************************************************************/
+
+static int counter = 7;
+static CloudWrapperInt counter_property(counter);
+static CloudBool switch_property = true;
+static CloudFloat temperature_property = 21.5f;
+static bool counter_changed = false;
+
+static void onCounterChange()
+{
+  counter_changed = true;
+}
+
+static constexpr PropertyDescriptor properties[] = {
+  propertyDescriptor(counter_property, "counter", Permission::ReadWrite).onUpdate(onCounterChange),
+  propertyDescriptor(switch_property, "switch", Permission::ReadWrite, 10),
+  propertyDescriptor(temperature_property, "temperature", Permission::Read).publishEvery(10),
+};
+
+static_assert(properties[1].identifier == 10, "The descriptor table is built at compile time");
+
+/******************************************************************************
+  TEST CODE
+ ******************************************************************************/
+
+SCENARIO("A table of property descriptors is registered", "[addPropertiesToContainer]")
+{
+  PropertyContainer property_container;
+  set_millis(0);
+  addPropertiesToContainer(property_container, properties);
+
+  WHEN("The table has been registered")
+  {
+    THEN("Every property can be found by name and identifier") {
+      REQUIRE(property_container.size() == 3);
+      REQUIRE(getProperty(property_container, "counter") == &counter_property);
+      REQUIRE(getProperty(property_container, "switch") == &switch_property);
+      REQUIRE(getProperty(property_container, "temperature") == &temperature_property);
+      REQUIRE(getProperty(property_container, 1) == &counter_property);
+      REQUIRE(getProperty(property_container, 10) == &switch_property);
+      REQUIRE(getProperty(property_container, 3) == &temperature_property);
+    }
+    THEN("The properties are encoded like the ones added one by one") {
+      PropertyContainer expected_container;
+      int expected_counter = 7;
+      CloudWrapperInt expected_counter_property(expected_counter);
+      CloudBool expected_switch = true;
+      CloudFloat expected_temperature = 21.5f;
+      addPropertyToContainer(expected_container, expected_counter_property, "counter", Permission::ReadWrite);
+      addPropertyToContainer(expected_container, expected_switch, "switch", Permission::ReadWrite, 10);
+      addPropertyToContainer(expected_container, expected_temperature, "temperature", Permission::Read).publishEvery(10);
+
+      REQUIRE(cbor::encode(property_container) == cbor::encode(expected_container));
+      REQUIRE(cbor::encode(property_container, true) == cbor::encode(expected_container, true));
+    }
+    THEN("The permissions are applied") {
+      REQUIRE(counter_property.isWriteableByCloud());
+      REQUIRE_FALSE(temperature_property.isWriteableByCloud());
+    }
+  }
+
+  WHEN("A value is received from the cloud")
+  {
+    counter_changed = false;
+    /* [{0: "counter", 2: 12}] */
+    std::vector<uint8_t> const payload = {0x81, 0xA2, 0x00, 0x67, 0x63, 0x6F, 0x75, 0x6E, 0x74, 0x65, 0x72, 0x02, 0x0C};
+    cbor::encode(property_container);
+    CBORDecoder::decode(property_container, payload.data(), payload.size());
+
+    THEN("The update callback is called") {
+      REQUIRE(counter == 12);
+      REQUIRE(counter_changed);
+    }
+  }
+
+  WHEN("The update interval has not elapsed")
+  {
+    cbor::encode(property_container);
+    set_millis(9999);
+    temperature_property = 22.0f;
+
+    THEN("The periodic property is not published") {
+      REQUIRE(cbor::encode(property_container).size() == 0);
+      set_millis(10000);
+      REQUIRE(cbor::encode(property_container).size() != 0);
+    }
+  }
+}
+
+SCENARIO("A table of property descriptors with a duplicated name is registered", "[addPropertiesToContainer]")
+{
+  PropertyContainer property_container;
+  CloudInt first = 1, duplicate = 2, other = 3;
+  PropertyDescriptor const descriptors[] = {
+    propertyDescriptor(first, "value", Permission::ReadWrite),
+    propertyDescriptor(duplicate, "value", Permission::ReadWrite),
+    propertyDescriptor(other, "other", Permission::ReadWrite),
+  };
+  Debug.reset();
+  addPropertiesToContainer(property_container, descriptors);
+
+  THEN("The duplicate is reported and skipped") {
+    REQUIRE(Debug.count(DBG_ERROR) == 1);
+    REQUIRE(property_container.size() == 2);
+    REQUIRE(getProperty(property_container, "value") == &first);
+    REQUIRE(getProperty(property_container, "other") == &other);
+  }
+}
+
+SCENARIO("A large table of property descriptors is registered", "[addPropertiesToContainer]")
+{
+  size_t const num_properties = 500;
+  std::vector<CloudInt> props(num_properties, CloudInt(0));
+  std::vector<std::string> names;
+  std::vector<PropertyDescriptor> descriptors;
+  for (size_t i = 0; i < num_properties; i++)
+    names.push_back("property_" + std::to_string(i));
+  for (size_t i = 0; i < num_properties; i++)
+    descriptors.push_back(propertyDescriptor(props[i], names[i].c_str(), Permission::ReadWrite));
+
+  PropertyContainer property_container;
+  addPropertiesToContainer(property_container, descriptors.data(), descriptors.size());
+
+  THEN("Every property is registered") {
+    REQUIRE(property_container.size() == num_properties);
+    for (size_t i = 0; i < num_properties; i++)
+      REQUIRE(getProperty(property_container, names[i]) == &props[i]);
+  }
+}
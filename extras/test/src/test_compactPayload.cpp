@@ -0,0 +1,237 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <math.h>
+
+#include <util/CBORTestUtil.h>
+
+#include <CBORDecoder.h>
+#include <CBOREncoder.h>
+#include <PropertyContainer.h>
+#include <types/CloudFloat.h>
+#include <types/CloudInt.h>
+#include <types/CloudLocation.h>
+
+/******************************************************************************
+  TEST HELPER
+ ******************************************************************************/
+
+/* Property which encodes another container in the middle of its own attributes */
+class CloudNestedEncode : public Property
+{
+public:
+  CloudNestedEncode(PropertyContainer * nested) : _nested{nested} { }
+
+  virtual bool isDifferentFromCloud() { return true; }
+  virtual void fromCloudToLocal() { }
+  virtual void fromLocalToCloud() { }
+  virtual CborError appendAttributesToCloud(CborEncoder *encoder) {
+    CHECK_CBOR_MULTI(appendAttribute(1000, "a", encoder));
+    if (_nested && encoder) {
+      cbor::encode(*_nested, false, true);
+    }
+    CHECK_CBOR_MULTI(appendAttribute(1000, "b", encoder));
+    return CborNoError;
+  }
+  virtual void setAttributesFromCloud() { }
+
+private:
+  PropertyContainer * _nested;
+};
+
+/******************************************************************************
+  TEST CODE
+ ******************************************************************************/
+
+SCENARIO("Floats are converted to half floats", "[compactPayload]")
+{
+  WHEN("Values are exactly representable")
+  {
+    THEN("They are converted exactly") {
+      REQUIRE(CBOREncoder::convertFloatToHalf(0.0f) == 0x0000);
+      REQUIRE(CBOREncoder::convertFloatToHalf(-0.0f) == 0x8000);
+      REQUIRE(CBOREncoder::convertFloatToHalf(1.0f) == 0x3C00);
+      REQUIRE(CBOREncoder::convertFloatToHalf(-2.0f) == 0xC000);
+      REQUIRE(CBOREncoder::convertFloatToHalf(65504.0f) == 0x7BFF);
+      REQUIRE(CBOREncoder::convertFloatToHalf(ldexpf(1.0f, -24)) == 0x0001);
+    }
+  }
+
+  WHEN("Values are not representable")
+  {
+    THEN("They are rounded to the nearest half float") {
+      REQUIRE(CBOREncoder::convertFloatToHalf(0.1f) == 0x2E66);
+      REQUIRE(CBOREncoder::convertFloatToHalf(65520.0f) == 0x7C00);
+      REQUIRE(CBOREncoder::convertFloatToHalf(ldexpf(1.0f, -26)) == 0x0000);
+      REQUIRE(CBOREncoder::convertFloatToHalf(INFINITY) == 0x7C00);
+      REQUIRE((CBOREncoder::convertFloatToHalf(NAN) & 0x7E00) == 0x7E00);
+    }
+  }
+
+  WHEN("All the finite half floats are converted back and forth")
+  {
+    bool all_match = true;
+    for (uint32_t h = 0; h <= 0xFFFF; h++) {
+      if ((h & 0x7C00) == 0x7C00)
+        continue;
+      float const f = static_cast<float>(CBORDecoder::convertCborHalfFloatToDouble(static_cast<uint16_t>(h)));
+      all_match &= (CBOREncoder::convertFloatToHalf(f) == h);
+    }
+
+    THEN("The conversion is lossless") {
+      REQUIRE(all_match);
+    }
+  }
+}
+
+SCENARIO("Properties are encoded in compact mode", "[compactPayload]")
+{
+  PropertyContainer property_container;
+
+  WHEN("A float round-trips as half float within the minimum delta")
+  {
+    CloudFloat float_test = 121.5f;
+    addPropertyToContainer(property_container, float_test, "test", Permission::ReadWrite).publishOnChange(0.1f);
+
+    /* [{-5: 122, 0: "test", 2: -0.5}] = 9F A3 24 18 7A 00 64 74 65 73 74 02 F9 B8 00 FF */
+    std::vector<uint8_t> const expected = {0x9F, 0xA3, 0x24, 0x18, 0x7A, 0x00, 0x64, 0x74, 0x65, 0x73, 0x74, 0x02, 0xF9, 0xB8, 0x00, 0xFF};
+    std::vector<uint8_t> const actual = cbor::encode(property_container, false, true);
+    THEN("It is encoded as half float relative to the base value") {
+      REQUIRE(actual == expected);
+    }
+  }
+
+  WHEN("A float close to zero is encoded")
+  {
+    CloudFloat float_test = 21.5f;
+    addPropertyToContainer(property_container, float_test, "test", Permission::ReadWrite);
+
+    /* [{0: "test", 2: 21.5}] = 9F A2 00 64 74 65 73 74 02 F9 4D 60 FF */
+    std::vector<uint8_t> const expected = {0x9F, 0xA2, 0x00, 0x64, 0x74, 0x65, 0x73, 0x74, 0x02, 0xF9, 0x4D, 0x60, 0xFF};
+    std::vector<uint8_t> const actual = cbor::encode(property_container, false, true);
+    THEN("No base value is encoded as it would not save any byte") {
+      REQUIRE(actual == expected);
+    }
+  }
+
+  WHEN("A float does not round-trip as half float")
+  {
+    CloudFloat float_test = 0.1f;
+    addPropertyToContainer(property_container, float_test, "test", Permission::ReadWrite);
+
+    /* [{0: "test", 2: 0.1}] = 9F A2 00 64 74 65 73 74 02 FA 3D CC CC CD FF */
+    std::vector<uint8_t> const expected = {0x9F, 0xA2, 0x00, 0x64, 0x74, 0x65, 0x73, 0x74, 0x02, 0xFA, 0x3D, 0xCC, 0xCC, 0xCD, 0xFF};
+    std::vector<uint8_t> const actual = cbor::encode(property_container, false, true);
+    THEN("It is encoded as single precision float without base value") {
+      REQUIRE(actual == expected);
+    }
+  }
+
+  WHEN("Ints are encoded")
+  {
+    CloudInt int_test_1 = 1000;
+    CloudInt int_test_2 = 1003;
+    addPropertyToContainer(property_container, int_test_1, "a", Permission::ReadWrite);
+    addPropertyToContainer(property_container, int_test_2, "b", Permission::ReadWrite);
+
+    /* [{-5: 1000, 0: "a", 2: 0}, {0: "b", 2: 3}] = 9F A3 24 19 03 E8 00 61 61 02 00 A2 00 61 62 02 03 FF */
+    std::vector<uint8_t> const expected = {0x9F, 0xA3, 0x24, 0x19, 0x03, 0xE8, 0x00, 0x61, 0x61, 0x02, 0x00, 0xA2, 0x00, 0x61, 0x62, 0x02, 0x03, 0xFF};
+    std::vector<uint8_t> const actual = cbor::encode(property_container, false, true);
+    THEN("They are encoded relative to the base value") {
+      REQUIRE(actual == expected);
+    }
+  }
+
+  WHEN("Timestamps are encoded")
+  {
+    CloudInt int_test_1 = 1;
+    CloudInt int_test_2 = 2;
+    addPropertyToContainer(property_container, int_test_1, "a", Permission::ReadWrite).encodeTimestamp();
+    addPropertyToContainer(property_container, int_test_2, "b", Permission::ReadWrite).encodeTimestamp();
+    int_test_1.setTimestamp(1550138809);
+    int_test_2.setTimestamp(1550138800);
+
+    /* [{-3: 1550138809, 0: "a", 2: 1, 6: 0}, {0: "b", 2: 2, 6: -9}]
+     * = 9F A4 22 1A 5C 65 3D B9 00 61 61 02 01 06 00 A3 00 61 62 02 02 06 28 FF
+     */
+    std::vector<uint8_t> const expected = {0x9F, 0xA4, 0x22, 0x1A, 0x5C, 0x65, 0x3D, 0xB9, 0x00, 0x61, 0x61, 0x02, 0x01, 0x06, 0x00,
+                                           0xA3, 0x00, 0x61, 0x62, 0x02, 0x02, 0x06, 0x28, 0xFF};
+    std::vector<uint8_t> const actual = cbor::encode(property_container, false, true);
+    THEN("They are encoded relative to the base time") {
+      REQUIRE(actual == expected);
+    }
+  }
+}
+
+SCENARIO("A compact payload is decoded", "[compactPayload]")
+{
+  PropertyContainer sender, receiver;
+
+  CloudFloat temperature_out = 21.37f, temperature_in = 0.0f;
+  CloudFloat pressure_out = 1013.25f, pressure_in = 0.0f;
+  CloudFloat large_out = 1.0e10f, large_in = 0.0f;
+  CloudInt counter_out = 1234, counter_in = 0;
+  CloudLocation location_out(45.07f, 7.69f), location_in(0.0f, 0.0f);
+
+  addPropertyToContainer(sender, temperature_out, "temperature", Permission::ReadWrite).publishOnChange(0.01f);
+  addPropertyToContainer(sender, pressure_out, "pressure", Permission::ReadWrite).publishOnChange(0.1f);
+  addPropertyToContainer(sender, large_out, "large", Permission::ReadWrite);
+  addPropertyToContainer(sender, counter_out, "counter", Permission::ReadWrite);
+  addPropertyToContainer(sender, location_out, "location", Permission::ReadWrite);
+
+  addPropertyToContainer(receiver, temperature_in, "temperature", Permission::ReadWrite);
+  addPropertyToContainer(receiver, pressure_in, "pressure", Permission::ReadWrite);
+  addPropertyToContainer(receiver, large_in, "large", Permission::ReadWrite);
+  addPropertyToContainer(receiver, counter_in, "counter", Permission::ReadWrite);
+  addPropertyToContainer(receiver, location_in, "location", Permission::ReadWrite);
+
+  std::vector<uint8_t> const compact = cbor::encode(sender, false, true);
+  cbor::encode(receiver);
+  CBORDecoder::decode(receiver, compact.data(), compact.size());
+
+  WHEN("The payload has been decoded")
+  {
+    THEN("The values are within the minimum delta of their property") {
+      REQUIRE(fabsf(temperature_in - 21.37f) <= 0.01f);
+      REQUIRE(fabsf(pressure_in - 1013.25f) <= 0.1f);
+      REQUIRE(large_in == 1.0e10f);
+      REQUIRE(counter_in == 1234);
+      REQUIRE(location_in.getValue().lat == 45.07f);
+      REQUIRE(location_in.getValue().lon == 7.69f);
+    }
+  }
+}
+
+SCENARIO("A property is encoded while another message is being encoded", "[compactPayload]")
+{
+  PropertyContainer nested_container;
+  CloudInt nested_test = 5000;
+  addPropertyToContainer(nested_container, nested_test, "nested", Permission::ReadWrite);
+
+  PropertyContainer property_container;
+  CloudNestedEncode plain_test(nullptr);
+  addPropertyToContainer(property_container, plain_test, "test", Permission::ReadWrite);
+  std::vector<uint8_t> const expected = cbor::encode(property_container, false, true);
+
+  PropertyContainer reentrant_container;
+  CloudNestedEncode reentrant_test(&nested_container);
+  addPropertyToContainer(reentrant_container, reentrant_test, "test", Permission::ReadWrite);
+
+  THEN("The base fields of the outer message are not affected") {
+    REQUIRE(expected.size() > 0);
+    REQUIRE(cbor::encode(reentrant_container, false, true) == expected);
+  }
+}
@@ -148,6 +148,23 @@ SCENARIO("Arduino Cloud Properties are decoded", "[ArduinoCloudThing::decode]")
     REQUIRE(value_location_test.lon == location_compare.lon);
   }
 
+  WHEN("A Location property attribute is received twice via CBOR message")
+  {
+    PropertyContainer property_container;
+
+    CloudLocation location_test = CloudLocation(0, 1);
+    addPropertyToContainer(property_container, location_test, "test", Permission::ReadWrite);
+
+    /* [{0: "test:lat", 2: 2},{0: "test:lon", 2: 3},{0: "test:lat", 2: 4}] = 83 A2 00 68 74 65 73 74 3A 6C 61 74 02 02 A2 00 68 74 65 73 74 3A 6C 6F 6E 02 03 A2 00 68 74 65 73 74 3A 6C 61 74 02 04 */
+    uint8_t const payload[] = { 0x83, 0xA2, 0x00, 0x68, 0x74, 0x65, 0x73, 0x74, 0x3A, 0x6C, 0x61, 0x74, 0x02, 0x02, 0xA2, 0x00, 0x68, 0x74, 0x65, 0x73, 0x74, 0x3A, 0x6C, 0x6F, 0x6E, 0x02, 0x03, 0xA2, 0x00, 0x68, 0x74, 0x65, 0x73, 0x74, 0x3A, 0x6C, 0x61, 0x74, 0x02, 0x04 };
+    CBORDecoder::decode(property_container, payload, sizeof(payload) / sizeof(uint8_t));
+
+    /* The last received value of an attribute wins */
+    Location value_location_test = location_test.getValue();
+    REQUIRE(value_location_test.lat == 4);
+    REQUIRE(value_location_test.lon == 3);
+  }
+
   WHEN("A Color property is changed via CBOR message")
   {
     PropertyContainer property_container;
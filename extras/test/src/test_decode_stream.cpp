@@ -0,0 +1,344 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <vector>
+
+#include <util/CBORTestUtil.h>
+
+#include <CBORDecoder.h>
+#include <PropertyContainer.h>
+#include "types/automation/CloudDimmedLight.h"
+#include "types/automation/CloudTelevision.h"
+#include "types/CloudLocation.h"
+#include "types/CloudSchedule.h"
+
+/******************************************************************************
+  TEST HELPER
+ ******************************************************************************/
+
+/* Feed the payload to a streaming decoder, splitting it at the given offsets */
+static CBORDecoder::Status decodeFragmented(PropertyContainer & property_container, std::vector<uint8_t> const & payload, std::vector<size_t> const & split_points)
+{
+  CBORDecoder decoder(property_container);
+  size_t start = 0;
+  for (size_t split : split_points) {
+    decoder.feed(payload.data() + start, split - start);
+    start = split;
+  }
+  return decoder.feed(payload.data() + start, payload.size() - start);
+}
+
+/* Decode into a single property called "test" and return the resulting property state encoded as CBOR */
+template <typename T, typename... Args>
+static std::vector<uint8_t> decodeSingleProperty(std::vector<uint8_t> const & payload, std::vector<size_t> const & split_points, int const identifier, Args... args)
+{
+  PropertyContainer property_container;
+  T test(args...);
+  addPropertyToContainer(property_container, test, "test", Permission::ReadWrite, identifier);
+  decodeFragmented(property_container, payload, split_points);
+  return cbor::encode(property_container);
+}
+
+/* Decode into a set of properties of different types and return the resulting property state encoded as CBOR */
+static std::vector<uint8_t> decodeMultipleProperties(std::vector<uint8_t> const & payload, std::vector<size_t> const & split_points)
+{
+  PropertyContainer property_container;
+  CloudBool   bool_test = false;
+  CloudInt    int_test = 1;
+  CloudFloat  float_test = 2.0f;
+  CloudString str_test;
+  str_test = ("str_test");
+
+  addPropertyToContainer(property_container, bool_test,  "bool_test",  Permission::ReadWrite);
+  addPropertyToContainer(property_container, int_test,   "int_test",   Permission::ReadWrite);
+  addPropertyToContainer(property_container, float_test, "float_test", Permission::ReadWrite);
+  addPropertyToContainer(property_container, str_test,   "str_test",   Permission::ReadWrite);
+  decodeFragmented(property_container, payload, split_points);
+  return cbor::encode(property_container);
+}
+
+/* Check that every way of fragmenting the payload yields the same result as the one shot decode */
+template <typename DecodeFunc>
+static void checkAllFragmentations(std::vector<uint8_t> const & payload, DecodeFunc decode)
+{
+  std::vector<uint8_t> const untouched = decode(std::vector<uint8_t>{}, std::vector<size_t>{});
+  std::vector<uint8_t> const expected  = decode(payload, std::vector<size_t>{});
+
+  /* Make sure the vector actually changes the property */
+  REQUIRE(expected != untouched);
+
+  /* Two fragments, split at every byte boundary */
+  for (size_t i = 0; i <= payload.size(); i++)
+    REQUIRE(decode(payload, std::vector<size_t>{i}) == expected);
+
+  /* Three fragments, split at every pair of byte boundaries */
+  for (size_t i = 1; i < payload.size(); i++)
+    for (size_t j = i; j < payload.size(); j++)
+      REQUIRE(decode(payload, std::vector<size_t>{i, j}) == expected);
+
+  /* One byte at a time */
+  std::vector<size_t> every_byte;
+  for (size_t i = 1; i < payload.size(); i++)
+    every_byte.push_back(i);
+  REQUIRE(decode(payload, every_byte) == expected);
+}
+
+/* The property is constructed with args before every decode */
+template <typename T, typename... Args>
+static void checkAllFragmentations(std::vector<uint8_t> const & payload, int const identifier, Args... args)
+{
+  checkAllFragmentations(payload, [identifier, args...](std::vector<uint8_t> const & p, std::vector<size_t> const & s) {
+    return decodeSingleProperty<T>(p, s, identifier, args...);
+  });
+}
+
+/******************************************************************************
+  TEST CODE
+ ******************************************************************************/
+
+SCENARIO("Fragmented CBOR payloads are decoded like the whole payload", "[CBORDecoder::feed]")
+{
+  WHEN("A boolean property is changed")
+  {
+    /* [{0: "test", 4: true}] = 81 A2 00 64 74 65 73 74 04 F5 */
+    checkAllFragmentations<CloudBool>({0x81, 0xA2, 0x00, 0x64, 0x74, 0x65, 0x73, 0x74, 0x04, 0xF5}, -1, false);
+  }
+
+  WHEN("A boolean property is changed - light payload")
+  {
+    /* [{0: 1, 4: true}] = 81 A2 00 01 04 F5 */
+    checkAllFragmentations<CloudBool>({0x81, 0xA2, 0x00, 0x01, 0x04, 0xF5}, 1, false);
+  }
+
+  WHEN("A negative int property is changed")
+  {
+    /* [{0: "test", 2: -7}] = 81 A2 00 64 74 65 73 74 02 26 */
+    checkAllFragmentations<CloudInt>({0x81, 0xA2, 0x00, 0x64, 0x74, 0x65, 0x73, 0x74, 0x02, 0x26}, -1, 0);
+  }
+
+  WHEN("A float property is changed")
+  {
+    /* [{0: "test", 2: 3.1459}] = 81 A2 00 64 74 65 73 74 02 FB 40 09 2A CD 9E 83 E4 26 */
+    checkAllFragmentations<CloudFloat>({0x81, 0xA2, 0x00, 0x64, 0x74, 0x65, 0x73, 0x74, 0x02, 0xFB, 0x40, 0x09, 0x2A, 0xCD, 0x9E, 0x83, 0xE4, 0x26}, -1, 0.0f);
+  }
+
+  WHEN("A String property is changed")
+  {
+    /* [{0: "test", 3: "testtt"}] = 81 A2 00 64 74 65 73 74 03 66 74 65 73 74 74 74 */
+    checkAllFragmentations<CloudString>({0x81, 0xA2, 0x00, 0x64, 0x74, 0x65, 0x73, 0x74, 0x03, 0x66, 0x74, 0x65, 0x73, 0x74, 0x74, 0x74}, -1, "hello");
+  }
+
+  WHEN("A Location property is changed")
+  {
+    /* [{0: "test:lat", 2: 2},{0: "test:lon", 2: 3}] = 82 A2 00 68 74 65 73 74 3A 6C 61 74 02 02 A2 00 68 74 65 73 74 3A 6C 6F 6E 02 03 */
+    checkAllFragmentations<CloudLocation>({0x82, 0xA2, 0x00, 0x68, 0x74, 0x65, 0x73, 0x74, 0x3A, 0x6C, 0x61, 0x74, 0x02, 0x02, 0xA2, 0x00, 0x68, 0x74, 0x65, 0x73, 0x74, 0x3A, 0x6C, 0x6F, 0x6E, 0x02, 0x03}, -1);
+  }
+
+  WHEN("A Color property is changed - light payload")
+  {
+    /* [{0: 257, 2: 2.0},{0: 513, 2: 2.0},{0: 769, 2: 2.0}] */
+    checkAllFragmentations<CloudColor>({0x83, 0xA2, 0x00, 0x19, 0x01, 0x01, 0x02, 0xFA, 0x40, 0x00, 0x00, 0x00, 0xA2, 0x00, 0x19, 0x02, 0x01, 0x02, 0xFA, 0x40, 0x00, 0x00, 0x00, 0xA2, 0x00, 0x19, 0x03, 0x01, 0x02, 0xFA, 0x40, 0x00, 0x00, 0x00}, 1);
+  }
+
+  WHEN("A Television property is changed with an indefinite length array")
+  {
+    /* [{0: "test:swi", 4: true},{0: "test:vol", 2: 50},{0: "test:mut", 2: false},{0: "test:pbc", 2: 3},{0: "test:inp", 2: 55},{0: "test:cha", 2: 7}] */
+    checkAllFragmentations<CloudTelevision>({0x9F, 0xA2, 0x00, 0x68, 0x74, 0x65, 0x73, 0x74, 0x3A, 0x73, 0x77, 0x69, 0x04, 0xF5, 0xA2, 0x00, 0x68, 0x74, 0x65, 0x73, 0x74, 0x3A, 0x76, 0x6F, 0x6C, 0x02, 0x18, 0x32, 0xA2, 0x00, 0x68, 0x74, 0x65, 0x73, 0x74, 0x3A, 0x6D, 0x75, 0x74, 0x04, 0xF4, 0xA2, 0x00, 0x68, 0x74, 0x65, 0x73, 0x74, 0x3A, 0x70, 0x62, 0x63, 0x02, 0x03, 0xA2, 0x00, 0x68, 0x74, 0x65, 0x73, 0x74, 0x3A, 0x69, 0x6E, 0x70, 0x02, 0x18, 0x37, 0xA2, 0x00, 0x68, 0x74, 0x65, 0x73, 0x74, 0x3A, 0x63, 0x68, 0x61, 0x02, 0x07, 0xFF}, -1);
+  }
+
+  WHEN("A DimmedLight property is changed")
+  {
+    /* [{0: "test:swi", 4: true},{0: "test:bri", 2: 2.0}] */
+    checkAllFragmentations<CloudDimmedLight>({0x82, 0xA2, 0x00, 0x68, 0x74, 0x65, 0x73, 0x74, 0x3A, 0x73, 0x77, 0x69, 0x04, 0xF5, 0xA2, 0x00, 0x68, 0x74, 0x65, 0x73, 0x74, 0x3A, 0x62, 0x72, 0x69, 0x02, 0xFA, 0x40, 0x00, 0x00, 0x00}, -1);
+  }
+
+  WHEN("A Schedule property is changed")
+  {
+    /* [{0: "test:frm", 2: 1633305600}, {0: "test:to", 2: 1633651200}, {0: "test:len", 2: 600}, {0: "test:msk", 2: 1140850708}] */
+    checkAllFragmentations<CloudSchedule>({0x84, 0xA2, 0x00, 0x68, 0x74, 0x65, 0x73, 0x74, 0x3A, 0x66, 0x72, 0x6D, 0x02, 0x1A, 0x61, 0x5A, 0x44, 0x00, 0xA2, 0x00, 0x67, 0x74, 0x65, 0x73, 0x74, 0x3A, 0x74, 0x6F, 0x02, 0x1A, 0x61, 0x5F, 0x8A, 0x00, 0xA2, 0x00, 0x68, 0x74, 0x65, 0x73, 0x74, 0x3A, 0x6C, 0x65, 0x6E, 0x02, 0x19, 0x02, 0x58, 0xA2, 0x00, 0x68, 0x74, 0x65, 0x73, 0x74, 0x3A, 0x6D, 0x73, 0x6B, 0x02, 0x1A, 0x44, 0x00, 0x00, 0x14}, -1);
+  }
+
+  WHEN("A payload containing a CBOR BaseName, BaseTime and Time is parsed")
+  {
+    /* [{-2: "base-name", -3: 654.321, 6: 123.456, 0: "test", 2: 1}] */
+    checkAllFragmentations<CloudInt>({0x81, 0xA5, 0x21, 0x69, 0x62, 0x61, 0x73, 0x65, 0x2D, 0x6E, 0x61, 0x6D, 0x65, 0x22, 0xFB, 0x40, 0x84, 0x72, 0x91, 0x68, 0x72, 0xB0, 0x21, 0x06, 0xFB, 0x40, 0x5E, 0xDD, 0x2F, 0x1A, 0x9F, 0xBE, 0x77, 0x00, 0x64, 0x74, 0x65, 0x73, 0x74, 0x02, 0x01}, -1, 0);
+  }
+
+  WHEN("A payload containing a invalid CBOR key is parsed")
+  {
+    /* [{123: 123, 0: "test", 2: 1}] = 81 A3 18 7B 18 7B 00 64 74 65 73 74 02 01 */
+    checkAllFragmentations<CloudInt>({0x81, 0xA3, 0x18, 0x7B, 0x18, 0x7B, 0x00, 0x64, 0x74, 0x65, 0x73, 0x74, 0x02, 0x01}, -1, 0);
+  }
+
+  WHEN("Multiple properties of different type are changed")
+  {
+    /* [{0: "bool_test", 4: true}, {0: "int_test", 2: 10}, {0: "float_test", 2: 20.0}, {0: "str_test", 3: "hello arduino"}] */
+    checkAllFragmentations({0x84, 0xA2, 0x00, 0x69, 0x62, 0x6F, 0x6F, 0x6C, 0x5F, 0x74, 0x65, 0x73, 0x74, 0x04, 0xF5, 0xA2, 0x00, 0x68, 0x69, 0x6E, 0x74, 0x5F, 0x74, 0x65, 0x73, 0x74, 0x02, 0x0A, 0xA2, 0x00, 0x6A, 0x66, 0x6C, 0x6F, 0x61, 0x74, 0x5F, 0x74, 0x65, 0x73, 0x74, 0x02, 0xF9, 0x4D, 0x00, 0xA2, 0x00, 0x68, 0x73, 0x74, 0x72, 0x5F, 0x74, 0x65, 0x73, 0x74, 0x03, 0x6D, 0x68, 0x65, 0x6C, 0x6C, 0x6F, 0x20, 0x61, 0x72, 0x64, 0x75, 0x69, 0x6E, 0x6F},
+                           decodeMultipleProperties);
+  }
+}
+
+SCENARIO("The streaming decoder reports its progress", "[CBORDecoder::feed]")
+{
+  PropertyContainer property_container;
+  CloudInt test = 0;
+  addPropertyToContainer(property_container, test, "test", Permission::ReadWrite);
+
+  WHEN("A payload is fed in two fragments")
+  {
+    /* [{0: "test", 2: 7}] = 81 A2 00 64 74 65 73 74 02 07 */
+    uint8_t const payload[] = {0x81, 0xA2, 0x00, 0x64, 0x74, 0x65, 0x73, 0x74, 0x02, 0x07};
+    CBORDecoder decoder(property_container);
+
+    THEN("The property is updated once the whole payload has been received") {
+      REQUIRE(decoder.feed(payload, 5) == CBORDecoder::Status::InProgress);
+      REQUIRE(test == 0);
+      REQUIRE(decoder.feed(payload + 5, sizeof(payload) - 5) == CBORDecoder::Status::Complete);
+      REQUIRE(test == 7);
+    }
+  }
+
+  WHEN("The payload is not a CBOR array")
+  {
+    /* {0: "test", 2: 7} = A2 00 64 74 65 73 74 02 07 */
+    uint8_t const payload[] = {0xA2, 0x00, 0x64, 0x74, 0x65, 0x73, 0x74, 0x02, 0x07};
+    CBORDecoder decoder(property_container);
+
+    THEN("An error is reported and the property is not updated") {
+      REQUIRE(decoder.feed(payload, sizeof(payload)) == CBORDecoder::Status::Error);
+      REQUIRE(test == 0);
+    }
+  }
+
+  WHEN("A record is not a CBOR map")
+  {
+    /* [7] = 81 07 */
+    uint8_t const payload[] = {0x81, 0x07};
+    CBORDecoder decoder(property_container);
+
+    THEN("An error is reported") {
+      REQUIRE(decoder.feed(payload, sizeof(payload)) == CBORDecoder::Status::Error);
+    }
+  }
+
+  WHEN("The records of a property are followed by the records of another property")
+  {
+    CloudInt other = 0;
+    addPropertyToContainer(property_container, other, "other", Permission::ReadWrite);
+    /* [_ {0: "test", 2: 7}, {0: "other", 2: 8}] = 9F A2 00 64 74 65 73 74 02 07 A2 00 65 6F 74 68 65 72 02 08 FF */
+    uint8_t const payload[] = {0x9F, 0xA2, 0x00, 0x64, 0x74, 0x65, 0x73, 0x74, 0x02, 0x07, 0xA2, 0x00, 0x65, 0x6F, 0x74, 0x68, 0x65, 0x72, 0x02, 0x08, 0xFF};
+    CBORDecoder decoder(property_container);
+
+    THEN("The update of the first property is applied before the end of the array") {
+      REQUIRE(decoder.feed(payload, sizeof(payload) - 1) == CBORDecoder::Status::InProgress);
+      REQUIRE(test == 7);
+      REQUIRE(other == 0);
+      REQUIRE(decoder.feed(payload + sizeof(payload) - 1, 1) == CBORDecoder::Status::Complete);
+      REQUIRE(other == 8);
+    }
+  }
+
+  WHEN("The decoder is reused after a truncated and an invalid payload")
+  {
+    /* [{0: "test", 2: 7}] = 81 A2 00 64 74 65 73 74 02 07 */
+    uint8_t const payload[] = {0x81, 0xA2, 0x00, 0x64, 0x74, 0x65, 0x73, 0x74, 0x02, 0x07};
+    uint8_t const invalid_payload[] = {0x81, 0x07};
+    CBORDecoder decoder(property_container);
+
+    THEN("Every payload is decoded from a clean state") {
+      REQUIRE(decoder.feed(payload, 7) == CBORDecoder::Status::InProgress);
+      decoder.begin(property_container);
+      REQUIRE(decoder.feed(invalid_payload, sizeof(invalid_payload)) == CBORDecoder::Status::Error);
+      decoder.begin(property_container);
+      REQUIRE(decoder.feed(payload, sizeof(payload)) == CBORDecoder::Status::Complete);
+      REQUIRE(test == 7);
+    }
+  }
+}
+
+SCENARIO("The SenML payload of a command is located in its header", "[CBORDecoder::findCommandPayload]")
+{
+  size_t payload_offset = 0;
+  size_t payload_length = 0;
+
+  WHEN("The header of a last values update with a short byte string is parsed")
+  {
+    /* 1(0x010600) [h'81A2...'] = DA 00 01 06 00 81 4A ... */
+    uint8_t const header[] = {0xDA, 0x00, 0x01, 0x06, 0x00, 0x81, 0x4A, 0x81, 0xA2};
+
+    THEN("The byte string follows the header") {
+      REQUIRE(CBORDecoder::findCommandPayload(header, sizeof(header), 0x010600, payload_offset, payload_length));
+      REQUIRE(payload_offset == 7);
+      REQUIRE(payload_length == 10);
+    }
+  }
+
+  WHEN("The header of a last values update with a long byte string is parsed")
+  {
+    /* 1(0x010600) [h'...' (70000 bytes)] = DA 00 01 06 00 81 5A 00 01 11 70 */
+    uint8_t const header[] = {0xDA, 0x00, 0x01, 0x06, 0x00, 0x81, 0x5A, 0x00, 0x01, 0x11, 0x70};
+
+    THEN("The length of the byte string is decoded") {
+      REQUIRE(CBORDecoder::findCommandPayload(header, sizeof(header), 0x010600, payload_offset, payload_length));
+      REQUIRE(payload_offset == 11);
+      REQUIRE(payload_length == 70000);
+    }
+  }
+
+  WHEN("The header of a different command is parsed")
+  {
+    /* 1(0x010400) ["thing"] = DA 00 01 04 00 81 65 ... */
+    uint8_t const header[] = {0xDA, 0x00, 0x01, 0x04, 0x00, 0x81, 0x65, 0x74, 0x68};
+
+    THEN("No payload is found") {
+      REQUIRE_FALSE(CBORDecoder::findCommandPayload(header, sizeof(header), 0x010600, payload_offset, payload_length));
+    }
+  }
+
+  WHEN("The byte string has an indefinite length")
+  {
+    uint8_t const header[] = {0xDA, 0x00, 0x01, 0x06, 0x00, 0x81, 0x5F, 0x41, 0x81};
+
+    THEN("No payload is found") {
+      REQUIRE_FALSE(CBORDecoder::findCommandPayload(header, sizeof(header), 0x010600, payload_offset, payload_length));
+    }
+  }
+
+  WHEN("The header is truncated")
+  {
+    uint8_t const header[] = {0xDA, 0x00, 0x01, 0x06, 0x00, 0x81, 0x5A, 0x00};
+
+    THEN("No payload is found") {
+      REQUIRE_FALSE(CBORDecoder::findCommandPayload(header, sizeof(header), 0x010600, payload_offset, payload_length));
+    }
+  }
+}
+
+SCENARIO("One shot decodes are bound to the container of each call", "[CBORDecoder::decode]")
+{
+  PropertyContainer first_container, second_container;
+  CloudInt first = 0, second = 0;
+  addPropertyToContainer(first_container,  first,  "test", Permission::ReadWrite);
+  addPropertyToContainer(second_container, second, "test", Permission::ReadWrite);
+
+  /* [{0: "test", 2: 7}] = 81 A2 00 64 74 65 73 74 02 07 */
+  uint8_t const payload[] = {0x81, 0xA2, 0x00, 0x64, 0x74, 0x65, 0x73, 0x74, 0x02, 0x07};
+  CBORDecoder::decode(first_container, payload, sizeof(payload));
+  CBORDecoder::decode(second_container, payload, sizeof(payload));
+
+  REQUIRE(first == 7);
+  REQUIRE(second == 7);
+}
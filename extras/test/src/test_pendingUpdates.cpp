@@ -0,0 +1,217 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include <util/CBORTestUtil.h>
+
+#include <PropertyContainer.h>
+#include <types/CloudInt.h>
+#include <types/CloudWrapperInt.h>
+#include <types/automation/CloudColoredLight.h>
+#include <types/automation/CloudDimmedLight.h>
+#include <types/automation/CloudTelevision.h>
+
+/******************************************************************************
+  TEST HELPER
+ ******************************************************************************/
+
+/* CloudInt which counts how often the encoder compares it against the cloud value */
+class CountingCloudInt : public CloudInt
+{
+public:
+  CountingCloudInt() : CloudInt(0), comparisons(0) { }
+  CountingCloudInt & operator=(int v) { CloudInt::operator=(v); return *this; }
+  virtual bool isDifferentFromCloud() {
+    comparisons++;
+    return CloudInt::isDifferentFromCloud();
+  }
+  unsigned int comparisons;
+};
+
+/* User defined property which changes its value without notifying the container */
+class CustomProperty : public Property
+{
+public:
+  CustomProperty() : value(0), _cloud_value(0) { }
+  virtual bool isDifferentFromCloud() { return value != _cloud_value; }
+  virtual void fromCloudToLocal() { value = _cloud_value; }
+  virtual void fromLocalToCloud() { _cloud_value = value; }
+  virtual CborError appendAttributesToCloud(CborEncoder *encoder) { return appendAttribute(value, "", encoder); }
+  virtual void setAttributesFromCloud() { setAttribute(_cloud_value, ""); }
+  int value;
+private:
+  int _cloud_value;
+};
+
+/******************************************************************************
+  TEST CODE
+ ******************************************************************************/
+
+SCENARIO("Only properties with a pending update are checked by the encoder", "[PropertyContainer::pending]")
+{
+  PropertyContainer property_container;
+  std::vector<CountingCloudInt> props(200);
+
+  for (size_t i = 0; i < props.size(); i++)
+    addPropertyToContainer(property_container, props[i], String("p") + std::to_string(i), Permission::ReadWrite).publishOnChange(0, 0);
+
+  /* Initial synchronisation sends every property */
+  while (cbor::encode(property_container).size() != 0) { }
+
+  auto total_comparisons = [&props]() {
+    unsigned int sum = 0;
+    for (CountingCloudInt const & p : props)
+      sum += p.comparisons;
+    return sum;
+  };
+
+  WHEN("No property is modified")
+  {
+    unsigned int const comparisons_before = total_comparisons();
+    for (int i = 0; i < 10; i++)
+      REQUIRE(cbor::encode(property_container).size() == 0);
+
+    THEN("No property is checked") {
+      REQUIRE(total_comparisons() == comparisons_before);
+    }
+  }
+
+  WHEN("A single property is modified")
+  {
+    unsigned int const comparisons_before = total_comparisons();
+    unsigned int const prop_comparisons_before = props[123].comparisons;
+    props[123] = 7;
+
+    THEN("Only the modified property is checked and encoded") {
+      /* [{0: "p123", 2: 7}] = 9F A2 00 64 70 31 32 33 02 07 FF */
+      std::vector<uint8_t> const expected = {0x9F, 0xA2, 0x00, 0x64, 0x70, 0x31, 0x32, 0x33, 0x02, 0x07, 0xFF};
+      REQUIRE(cbor::encode(property_container) == expected);
+      REQUIRE(props[123].comparisons > prop_comparisons_before);
+      REQUIRE(total_comparisons() - comparisons_before == props[123].comparisons - prop_comparisons_before);
+      REQUIRE(cbor::encode(property_container).size() == 0);
+    }
+  }
+}
+
+SCENARIO("An on demand property is encoded once an update is requested", "[PropertyContainer::pending]")
+{
+  PropertyContainer property_container;
+  CloudInt prop = 1;
+
+  addPropertyToContainer(property_container, prop, "test", Permission::ReadWrite).publishOnDemand();
+  REQUIRE(cbor::encode(property_container).size() != 0);
+  REQUIRE(cbor::encode(property_container).size() == 0);
+
+  WHEN("An update is requested for all properties")
+  {
+    requestUpdateForAllProperties(property_container);
+    THEN("The property is encoded exactly once") {
+      REQUIRE(cbor::encode(property_container).size() != 0);
+      REQUIRE(cbor::encode(property_container).size() == 0);
+    }
+  }
+}
+
+SCENARIO("Changes of wrapped primitives are detected by polling", "[PropertyContainer::pending]")
+{
+  PropertyContainer property_container;
+  int value = 1;
+  CloudWrapperInt prop(value);
+
+  addPropertyToContainer(property_container, prop, "test", Permission::ReadWrite).publishOnChange(0, 0);
+  REQUIRE(cbor::encode(property_container).size() != 0);
+  REQUIRE(cbor::encode(property_container).size() == 0);
+
+  WHEN("The wrapped primitive is modified")
+  {
+    value = 2;
+    THEN("The property is encoded") {
+      /* [{0: "test", 2: 2}] = 9F A2 00 64 74 65 73 74 02 02 FF */
+      std::vector<uint8_t> const expected = {0x9F, 0xA2, 0x00, 0x64, 0x74, 0x65, 0x73, 0x74, 0x02, 0x02, 0xFF};
+      REQUIRE(cbor::encode(property_container) == expected);
+    }
+  }
+}
+
+SCENARIO("Changes of user defined properties are detected by polling", "[PropertyContainer::pending]")
+{
+  PropertyContainer property_container;
+  CustomProperty prop;
+
+  addPropertyToContainer(property_container, prop, "test", Permission::ReadWrite).publishOnChange(0, 0);
+  REQUIRE(cbor::encode(property_container).size() != 0);
+  REQUIRE(cbor::encode(property_container).size() == 0);
+
+  WHEN("The value is modified without updating the local timestamp")
+  {
+    prop.value = 2;
+    THEN("The property is encoded") {
+      /* [{0: "test", 2: 2}] = 9F A2 00 64 74 65 73 74 02 02 FF */
+      std::vector<uint8_t> const expected = {0x9F, 0xA2, 0x00, 0x64, 0x74, 0x65, 0x73, 0x74, 0x02, 0x02, 0xFF};
+      REQUIRE(cbor::encode(property_container) == expected);
+      REQUIRE(cbor::encode(property_container).size() == 0);
+    }
+  }
+}
+
+SCENARIO("Properties modified through their setters are encoded", "[PropertyContainer::pending]")
+{
+  PropertyContainer property_container;
+  CloudDimmedLight dimmed_light;
+  CloudColoredLight colored_light;
+  CloudTelevision television;
+  CloudString string;
+  CloudInt integer;
+  CloudFloat floating;
+
+  addPropertyToContainer(property_container, dimmed_light, "dimmed_light", Permission::ReadWrite).publishOnChange(0, 0);
+  addPropertyToContainer(property_container, colored_light, "colored_light", Permission::ReadWrite).publishOnChange(0, 0);
+  addPropertyToContainer(property_container, television, "television", Permission::ReadWrite).publishOnChange(0, 0);
+  addPropertyToContainer(property_container, string, "string", Permission::ReadWrite).publishOnChange(0, 0);
+  addPropertyToContainer(property_container, integer, "integer", Permission::ReadWrite).publishOnChange(0, 0);
+  addPropertyToContainer(property_container, floating, "floating", Permission::ReadWrite).publishOnChange(0, 0);
+
+  std::vector<std::pair<char const *, std::function<void()>>> const setters = {
+    {"CloudDimmedLight::setBrightness",   [&]() { dimmed_light.setBrightness(42.0f); }},
+    {"CloudDimmedLight::setSwitch",       [&]() { dimmed_light.setSwitch(!dimmed_light.getSwitch()); }},
+    {"CloudColoredLight::setSwitch",      [&]() { colored_light.setSwitch(!colored_light.getSwitch()); }},
+    {"CloudColoredLight::setHue",         [&]() { colored_light.setHue(colored_light.getHue() + 1.0f); }},
+    {"CloudColoredLight::setSaturation",  [&]() { colored_light.setSaturation(colored_light.getSaturation() + 1.0f); }},
+    {"CloudColoredLight::setBrightness",  [&]() { colored_light.setBrightness(colored_light.getBrightness() + 1.0f); }},
+    {"CloudTelevision::setSwitch",        [&]() { television.setSwitch(!television.getSwitch()); }},
+    {"CloudTelevision::setVolume",        [&]() { television.setVolume(television.getVolume() + 1); }},
+    {"CloudTelevision::setMute",          [&]() { television.setMute(!television.getMute()); }},
+    {"CloudString::operator+=",           [&]() { string += "a"; }},
+    {"CloudString::clear",                [&]() { string.clear(); }},
+    {"CloudInt::operator+=",              [&]() { integer += 2; }},
+    {"CloudInt::operator++",              [&]() { integer++; }},
+    {"CloudFloat::operator*=",            [&]() { floating = 1.0f; floating *= 3.0f; }},
+  };
+
+  /* Initial synchronisation sends every property */
+  while (cbor::encode(property_container).size() != 0) { }
+
+  for (auto const & setter : setters)
+  {
+    INFO(setter.first);
+    setter.second();
+    REQUIRE(cbor::encode(property_container).size() != 0);
+    while (cbor::encode(property_container).size() != 0) { }
+  }
+}
@@ -0,0 +1,190 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include <util/OfflineLogFileStorage.h>
+
+/******************************************************************************
+  INTERNAL FUNCTION DEFINITION
+ ******************************************************************************/
+
+static uint32_t const FILE_MAGIC = 0x474F4C4F; /* "OLOG" */
+
+static void putUint32(uint8_t * buf, uint32_t const value)
+{
+  for (size_t i = 0; i < 4; i++)
+    buf[i] = static_cast<uint8_t>(value >> (8 * i));
+}
+
+static uint32_t getUint32(uint8_t const * buf)
+{
+  uint32_t value = 0;
+  for (size_t i = 0; i < 4; i++)
+    value |= static_cast<uint32_t>(buf[i]) << (8 * i);
+  return value;
+}
+
+/******************************************************************************
+  CTOR/DTOR
+ ******************************************************************************/
+
+OfflineLogFileStorage::OfflineLogFileStorage()
+: _file{nullptr}
+, _max_size{0}
+, _read_offset{FILE_HEADER_SIZE}
+, _write_offset{FILE_HEADER_SIZE}
+, _count{0}
+{
+
+}
+
+OfflineLogFileStorage::~OfflineLogFileStorage()
+{
+  end();
+}
+
+/******************************************************************************
+  PUBLIC MEMBER FUNCTIONS
+ ******************************************************************************/
+
+bool OfflineLogFileStorage::begin(std::string const & path, size_t const max_size)
+{
+  end();
+  _max_size = max_size;
+
+  _file = fopen(path.c_str(), "r+b");
+  if (_file != nullptr && readHeader())
+    return true;
+
+  if (_file != nullptr)
+    fclose(_file);
+  _file = fopen(path.c_str(), "w+b");
+  if (_file == nullptr)
+    return false;
+
+  clear();
+  return true;
+}
+
+void OfflineLogFileStorage::end()
+{
+  if (_file != nullptr)
+    fclose(_file);
+  _file = nullptr;
+}
+
+bool OfflineLogFileStorage::append(uint8_t const * record, size_t const length)
+{
+  if (_file == nullptr || length == 0 || length > 0xFFFF || length > available())
+    return false;
+
+  uint8_t const header[RECORD_HEADER_SIZE] = {static_cast<uint8_t>(length & 0xFF), static_cast<uint8_t>(length >> 8)};
+  if (fseek(_file, static_cast<long>(_write_offset), SEEK_SET) != 0 ||
+      fwrite(header, 1, RECORD_HEADER_SIZE, _file) != RECORD_HEADER_SIZE ||
+      fwrite(record, 1, length, _file) != length)
+    return false;
+
+  _write_offset += RECORD_HEADER_SIZE + length;
+  _count++;
+  return writeHeader();
+}
+
+size_t OfflineLogFileStorage::front(uint8_t * buffer, size_t const size)
+{
+  size_t const length = frontLength();
+  if (length == 0 || length > size)
+    return length;
+
+  if (fread(buffer, 1, length, _file) != length)
+    return 0;
+  return length;
+}
+
+void OfflineLogFileStorage::pop()
+{
+  if (_count == 0)
+    return;
+
+  _read_offset += RECORD_HEADER_SIZE + frontLength();
+  _count--;
+
+  if (_count == 0)
+    clear();
+  else
+    writeHeader();
+}
+
+void OfflineLogFileStorage::clear()
+{
+  _read_offset = FILE_HEADER_SIZE;
+  _write_offset = FILE_HEADER_SIZE;
+  _count = 0;
+
+  /* The records left in the file are overwritten by the following ones */
+  writeHeader();
+}
+
+size_t OfflineLogFileStorage::available() const
+{
+  size_t const used = _write_offset + RECORD_HEADER_SIZE;
+  return (_file != nullptr && _max_size > used) ? (_max_size - used) : 0;
+}
+
+/******************************************************************************
+  PRIVATE MEMBER FUNCTIONS
+ ******************************************************************************/
+
+bool OfflineLogFileStorage::readHeader()
+{
+  uint8_t header[FILE_HEADER_SIZE];
+  if (fseek(_file, 0, SEEK_SET) != 0 || fread(header, 1, FILE_HEADER_SIZE, _file) != FILE_HEADER_SIZE)
+    return false;
+  if (getUint32(header) != FILE_MAGIC)
+    return false;
+  if (fseek(_file, 0, SEEK_END) != 0)
+    return false;
+
+  /* Records written after the last header update are dropped, e.g. after a power loss */
+  size_t const file_size = static_cast<size_t>(ftell(_file));
+  _read_offset = getUint32(header + 4);
+  _write_offset = getUint32(header + 8);
+  _count = getUint32(header + 12);
+  return (_read_offset >= FILE_HEADER_SIZE) && (_read_offset <= _write_offset) && (_write_offset <= file_size);
+}
+
+bool OfflineLogFileStorage::writeHeader()
+{
+  if (_file == nullptr)
+    return false;
+
+  uint8_t header[FILE_HEADER_SIZE];
+  putUint32(header, FILE_MAGIC);
+  putUint32(header + 4, static_cast<uint32_t>(_read_offset));
+  putUint32(header + 8, static_cast<uint32_t>(_write_offset));
+  putUint32(header + 12, static_cast<uint32_t>(_count));
+  return fseek(_file, 0, SEEK_SET) == 0 &&
+         fwrite(header, 1, FILE_HEADER_SIZE, _file) == FILE_HEADER_SIZE &&
+         fflush(_file) == 0;
+}
+
+size_t OfflineLogFileStorage::frontLength()
+{
+  if (_file == nullptr || _count == 0)
+    return 0;
+
+  uint8_t header[RECORD_HEADER_SIZE];
+  if (fseek(_file, static_cast<long>(_read_offset), SEEK_SET) != 0 ||
+      fread(header, 1, RECORD_HEADER_SIZE, _file) != RECORD_HEADER_SIZE)
+    return 0;
+  return static_cast<size_t>(header[0]) | (static_cast<size_t>(header[1]) << 8);
+}
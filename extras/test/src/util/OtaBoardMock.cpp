@@ -0,0 +1,179 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include <util/OtaBoardMock.h>
+
+#include <string.h>
+
+#include <algorithm>
+
+#include <util/OtaTestUtil.h>
+
+/******************************************************************************
+  CTOR/DTOR
+ ******************************************************************************/
+
+OtaBoardMock::OtaBoardMock(OtaUpdateFile & file, OtaCheckpointStorage & storage, uint8_t const * id, uint8_t const * final_sha256, uint32_t const checkpoint_interval)
+: write_error{false}
+, resumed_from{0}
+, received{0}
+, _file(file)
+, _storage(storage)
+, _id{id}
+, _final_sha256{final_sha256}
+, _checkpoint_interval{checkpoint_interval}
+, _pipeline(10 * 1024, 2)
+, _decoder([this](uint8_t c) { if (!_flash.put(c)) write_error = true; })
+, _flash([this](uint8_t * const buffer, size_t len) { _sha256.update(buffer, len); return _file.write(buffer, len); })
+, _sha256()
+, _header{0}
+, _header_size{0}
+, _crc32{0}
+, _downloaded{0}
+, _checkpoint{0}
+{
+  /* The implementation reopens the update file at the offset of the checkpoint, if the
+   * file still holds all the bytes the checkpoint refers to
+   */
+  OtaCheckpoint checkpoint;
+  if (_storage.load(checkpoint) && checkpoint.valid(_id) && _file.data.size() >= checkpoint.flashOffset)
+  {
+    _file.position = checkpoint.flashOffset;
+    memcpy(_header, checkpoint.header, sizeof(_header));
+    _header_size = sizeof(_header);
+    _crc32 = checkpoint.calculatedCrc32;
+    _downloaded = checkpoint.downloadedSize;
+    _checkpoint = checkpoint.downloadedSize;
+    _decoder.restore(checkpoint.decoder);
+    _sha256.restore(checkpoint.sha256);
+    _flash.begin(4096, checkpoint.flashOffset);
+  }
+  else
+  {
+    _storage.clear();
+    _file.data.clear();
+    _file.position = 0;
+    _flash.begin(4096);
+  }
+  resumed_from = _downloaded;
+  _pipeline.begin("downloads.arduino.cc", 443, "/ota/firmware.ota", _downloaded);
+}
+
+/******************************************************************************
+  PUBLIC MEMBER FUNCTIONS
+ ******************************************************************************/
+
+int OtaUpdateFile::write(uint8_t * const buffer, size_t len)
+{
+  if (position + len > data.size())
+    data.resize(position + len);
+  std::copy(buffer, buffer + len, data.begin() + position);
+  position += len;
+  return static_cast<int>(len);
+}
+
+bool OtaCheckpointStorageMock::store(OtaCheckpoint const & checkpoint)
+{
+  uint8_t const * bytes = reinterpret_cast<uint8_t const *>(&checkpoint);
+  record.assign(bytes, bytes + sizeof(OtaCheckpoint));
+  stores++;
+  return true;
+}
+
+bool OtaCheckpointStorageMock::load(OtaCheckpoint & checkpoint)
+{
+  if (record.size() != sizeof(OtaCheckpoint))
+    return false;
+  memcpy(&checkpoint, record.data(), sizeof(OtaCheckpoint));
+  return true;
+}
+
+void OtaCheckpointStorageMock::clear()
+{
+  record.clear();
+}
+
+OtaBoardMock::Result OtaBoardMock::fetch(OtaHttpServerMock & server, size_t const drop_at)
+{
+  uint8_t buffer[1460];
+  while (!_pipeline.completed() && _downloaded < drop_at)
+  {
+    size_t const size = std::min(sizeof(buffer), drop_at - _downloaded);
+    int const bytes_read = _pipeline.read(server, buffer, size);
+    if (bytes_read < 0)
+      return Result::Interrupted;
+    if (bytes_read == 0) {
+      set_millis(millis() + 1);
+      continue;
+    }
+    received += bytes_read;
+    parse(buffer, bytes_read);
+
+    if (_downloaded - _checkpoint >= _checkpoint_interval)
+      commit();
+  }
+
+  if (!_pipeline.completed())
+    return Result::Interrupted;
+
+  /* Any outcome but an interrupted download discards the checkpoint */
+  _flash.flush();
+  _storage.clear();
+
+  uint32_t const header_crc32 = _header[4] | (_header[5] << 8) | (_header[6] << 16) | (static_cast<uint32_t>(_header[7]) << 24);
+  if (_crc32 != header_crc32)
+    return Result::CrcMismatch;
+
+  if (!_sha256.verify(_final_sha256))
+    return Result::Sha256Mismatch;
+
+  return Result::Completed;
+}
+
+/******************************************************************************
+  PRIVATE MEMBER FUNCTIONS
+ ******************************************************************************/
+
+void OtaBoardMock::parse(uint8_t const * data, size_t len)
+{
+  while (len > 0 && _header_size < sizeof(_header))
+  {
+    _header[_header_size++] = *data++;
+    len--;
+    _downloaded++;
+    if (_header_size == sizeof(_header))
+      _crc32 = crc32(_header + 8, sizeof(_header) - 8);
+  }
+  _decoder.decompress(data, len);
+  _crc32 = crc32(data, len, _crc32);
+  _downloaded += len;
+}
+
+void OtaBoardMock::commit()
+{
+  _flash.flush();
+  _checkpoint = _downloaded;
+
+  OtaCheckpoint checkpoint;
+  memcpy(checkpoint.id, _id, sizeof(checkpoint.id));
+  memcpy(checkpoint.header, _header, sizeof(checkpoint.header));
+  checkpoint.contentLength = _pipeline.contentLength();
+  checkpoint.downloadedSize = _downloaded;
+  checkpoint.calculatedCrc32 = _crc32;
+  checkpoint.flashOffset = _flash.offset();
+  checkpoint.decoder = _decoder.state();
+  checkpoint.sha256 = _sha256.state();
+  checkpoint.seal();
+  _storage.store(checkpoint);
+}
@@ -0,0 +1,180 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include <util/OtaHttpServerMock.h>
+
+#include <stdlib.h>
+
+#include <algorithm>
+
+/******************************************************************************
+  CONSTANTS
+ ******************************************************************************/
+
+static size_t const SEGMENT_SIZE = 256;
+
+/******************************************************************************
+  CTOR/DTOR
+ ******************************************************************************/
+
+OtaHttpServerMock::OtaHttpServerMock(std::vector<uint8_t> const & file, Link const link)
+: requests_per_connection{0}
+, range_support{true}
+, connections{0}
+, requests{0}
+, _file(file)
+, _link(link)
+, _connected{false}
+, _closing{false}
+, _responses{0}
+, _link_free_ms{0}
+{
+
+}
+
+/******************************************************************************
+  PUBLIC MEMBER FUNCTIONS
+ ******************************************************************************/
+
+int OtaHttpServerMock::connect(char const * /* host */, uint16_t const /* port */)
+{
+  stop();
+  set_millis(millis() + _link.handshake_ms);
+  _connected = true;
+  connections++;
+  return 1;
+}
+
+uint8_t OtaHttpServerMock::connected()
+{
+  /* Like a network client, data received before the server closed the connection can still be read */
+  return _connected && !(_closing && _tx.empty());
+}
+
+void OtaHttpServerMock::stop()
+{
+  _connected = false;
+  _closing = false;
+  _responses = 0;
+  _link_free_ms = 0;
+  _rx.clear();
+  _tx.clear();
+}
+
+size_t OtaHttpServerMock::write(uint8_t const * buf, size_t const size)
+{
+  if (!_connected)
+    return 0;
+
+  _rx.append(reinterpret_cast<char const *>(buf), size);
+  for (size_t end = _rx.find("\r\n\r\n"); end != std::string::npos; end = _rx.find("\r\n\r\n"))
+  {
+    std::string const request = _rx.substr(0, end + 4);
+    _rx.erase(0, end + 4);
+    /* Requests which arrive after the server has decided to close the connection are lost */
+    if (!_closing)
+      respond(request);
+  }
+  return size;
+}
+
+int OtaHttpServerMock::available()
+{
+  return static_cast<int>(ready());
+}
+
+int OtaHttpServerMock::read()
+{
+  uint8_t b = 0;
+  return (read(&b, 1) == 1) ? b : -1;
+}
+
+int OtaHttpServerMock::read(uint8_t * buf, size_t const size)
+{
+  size_t n = 0;
+  while (n < size && !_tx.empty() && _tx.front().ready_ms <= millis())
+  {
+    Segment & segment = _tx.front();
+    size_t const chunk = std::min(size - n, segment.data.size());
+    std::copy(segment.data.begin(), segment.data.begin() + chunk, buf + n);
+    segment.data.erase(segment.data.begin(), segment.data.begin() + chunk);
+    n += chunk;
+    if (segment.data.empty())
+      _tx.pop_front();
+  }
+  return (n > 0) ? static_cast<int>(n) : -1;
+}
+
+/******************************************************************************
+  PRIVATE MEMBER FUNCTIONS
+ ******************************************************************************/
+
+void OtaHttpServerMock::respond(std::string const & request)
+{
+  requests++;
+  last_request = request;
+
+  size_t first = 0;
+  size_t last = _file.size() - 1;
+  size_t const range = request.find("Range: bytes=");
+  bool const partial = range_support && range != std::string::npos;
+  if (partial)
+  {
+    char * end = nullptr;
+    first = strtoul(request.c_str() + range + 13, &end, 10);
+    last = std::min<size_t>(strtoul(end + 1, nullptr, 10), _file.size() - 1);
+  }
+
+  _closing = requests_per_connection > 0 && ++_responses >= requests_per_connection;
+
+  std::string header = partial ? "HTTP/1.1 206 Partial Content\r\n" : "HTTP/1.1 200 OK\r\n";
+  if (partial)
+    header += "Content-Range: bytes " + std::to_string(first) + "-" + std::to_string(last) + "/" + std::to_string(_file.size()) + "\r\n";
+  header += "Content-Length: " + std::to_string(last - first + 1) + "\r\n";
+  header += "Content-Type: application/octet-stream\r\n";
+  if (_closing)
+    header += "Connection: close\r\n";
+  header += "\r\n";
+
+  std::vector<uint8_t> response(header.begin(), header.end());
+  response.insert(response.end(), _file.begin() + first, _file.begin() + last + 1);
+  send(response);
+}
+
+void OtaHttpServerMock::send(std::vector<uint8_t> const & response)
+{
+  /* The response leaves after the round trip of its request, once the previous ones have been sent */
+  unsigned long const start_ms = std::max(millis() + _link.rtt_ms, _link_free_ms);
+  for (size_t sent = 0; sent < response.size(); sent += SEGMENT_SIZE)
+  {
+    size_t const length = std::min(SEGMENT_SIZE, response.size() - sent);
+    Segment segment;
+    segment.ready_ms = start_ms + (sent + length) / _link.bytes_per_ms;
+    segment.data.assign(response.begin() + sent, response.begin() + sent + length);
+    _tx.push_back(segment);
+  }
+  _link_free_ms = start_ms + response.size() / _link.bytes_per_ms;
+}
+
+size_t OtaHttpServerMock::ready() const
+{
+  size_t bytes = 0;
+  for (Segment const & segment : _tx)
+  {
+    if (segment.ready_ms > millis())
+      break;
+    bytes += segment.data.size();
+  }
+  return bytes;
+}
@@ -0,0 +1,166 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include <util/OtaTestUtil.h>
+
+#include <ota/utility/OtaSha256.h>
+
+/******************************************************************************
+  INTERNAL FUNCTION DEFINITION
+ ******************************************************************************/
+
+static void putUint32(std::vector<uint8_t> & buf, uint32_t const value)
+{
+  for (size_t i = 0; i < 4; i++)
+    buf.push_back(static_cast<uint8_t>(value >> (8 * i)));
+}
+
+/******************************************************************************
+  FUNCTION DEFINITION
+ ******************************************************************************/
+
+std::vector<uint8_t> firmware(size_t const size, uint32_t const seed)
+{
+  std::vector<uint8_t> bytes(size);
+  uint32_t state = seed;
+  for (size_t i = 0; i < size; i++) {
+    /* xorshift32 */
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    bytes[i] = static_cast<uint8_t>(state);
+  }
+  return bytes;
+}
+
+std::vector<uint8_t> compressibleFirmware(size_t const size, uint32_t const seed)
+{
+  std::vector<uint8_t> const words = firmware(64 * 4, seed);
+  std::vector<uint8_t> const order = firmware(size / 4 + 1, seed + 1);
+  std::vector<uint8_t> bytes;
+  for (size_t i = 0; bytes.size() < size; i++) {
+    size_t const word = (order[i] % 64) * 4;
+    for (size_t b = 0; b < 4 && bytes.size() < size; b++)
+      bytes.push_back(words[word + b]);
+  }
+  return bytes;
+}
+
+std::vector<uint8_t> lzss(std::vector<uint8_t> const & data)
+{
+  /* Port of encode() in extras/tools/lzss.c */
+  int const EI = 11, EJ = 4, P = 1, N = 1 << EI, F = (1 << EJ) + 1;
+
+  std::vector<uint8_t> out;
+  int bit_buffer = 0, bit_mask = 128;
+  auto putbit = [&](bool const bit) {
+    if (bit)
+      bit_buffer |= bit_mask;
+    if ((bit_mask >>= 1) == 0) {
+      out.push_back(static_cast<uint8_t>(bit_buffer));
+      bit_buffer = 0;
+      bit_mask = 128;
+    }
+  };
+  auto putbits = [&](int const value, int const bits) {
+    for (int mask = 1 << (bits - 1); mask != 0; mask >>= 1)
+      putbit((value & mask) != 0);
+  };
+
+  std::vector<uint8_t> buffer(N * 2, 0);
+  size_t next = 0;
+  int i;
+  for (i = 0; i < N - F; i++)
+    buffer[i] = ' ';
+  for (i = N - F; i < N * 2 && next < data.size(); i++)
+    buffer[i] = data[next++];
+
+  int bufferend = i, r = N - F, s = 0;
+  while (r < bufferend) {
+    int const f1 = (F <= bufferend - r) ? F : bufferend - r;
+    int x = 0, y = 1;
+    uint8_t const c = buffer[r];
+    for (i = r - 1; i >= s; i--) {
+      if (buffer[i] == c) {
+        int j;
+        for (j = 1; j < f1; j++)
+          if (buffer[i + j] != buffer[r + j])
+            break;
+        if (j > y) {
+          x = i;
+          y = j;
+        }
+      }
+    }
+    if (y <= P) {
+      y = 1;
+      putbit(true);
+      putbits(c, 8);
+    } else {
+      putbit(false);
+      putbits(x & (N - 1), EI);
+      putbits(y - 2, EJ);
+    }
+    r += y;
+    s += y;
+    if (r >= N * 2 - F) {
+      for (i = 0; i < N; i++)
+        buffer[i] = buffer[i + N];
+      bufferend -= N;
+      r -= N;
+      s -= N;
+      while (bufferend < N * 2 && next < data.size())
+        buffer[bufferend++] = data[next++];
+    }
+  }
+  if (bit_mask != 128)
+    out.push_back(static_cast<uint8_t>(bit_buffer));
+  return out;
+}
+
+std::vector<uint8_t> otaFile(std::vector<uint8_t> const & payload, uint32_t const magic_number)
+{
+  /* The CRC covers the magic number, the header version, which flags a compressed payload, and the payload */
+  std::vector<uint8_t> covered;
+  putUint32(covered, magic_number);
+  uint8_t const version[8] = {0x40, 0, 0, 0, 0, 0, 0, 0};
+  covered.insert(covered.end(), version, version + sizeof(version));
+  covered.insert(covered.end(), payload.begin(), payload.end());
+
+  std::vector<uint8_t> file;
+  putUint32(file, static_cast<uint32_t>(covered.size()));
+  putUint32(file, crc32(covered.data(), covered.size()));
+  file.insert(file.end(), covered.begin(), covered.end());
+  return file;
+}
+
+uint32_t crc32(uint8_t const * data, size_t const length, uint32_t crc)
+{
+  crc = ~crc;
+  for (size_t i = 0; i < length; i++) {
+    crc ^= data[i];
+    for (int b = 0; b < 8; b++)
+      crc = (crc >> 1) ^ (0xEDB88320UL & (0U - (crc & 1U)));
+  }
+  return ~crc;
+}
+
+std::vector<uint8_t> sha256(std::vector<uint8_t> const & data)
+{
+  std::vector<uint8_t> hash(OtaSha256::HASH_SIZE);
+  OtaSha256 sha;
+  sha.update(data.data(), data.size());
+  sha.finalize(hash.data());
+  return hash;
+}
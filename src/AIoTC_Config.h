@@ -21,6 +21,29 @@
   #define NTP_USE_RANDOM_PORT     (1)
 #endif
 
+/* Count heap allocations per subsystem, see ArduinoIoTCloudClass::getStats() */
+#ifndef AIOT_CONFIG_HEAP_STATS
+  #define AIOT_CONFIG_HEAP_STATS  (0)
+#endif
+
+/* Size of the blocks the property names are stored in, see PropertyNameTable */
+#ifndef AIOT_CONFIG_PROPERTY_NAME_TABLE_CHUNK_SIZE
+  #define AIOT_CONFIG_PROPERTY_NAME_TABLE_CHUNK_SIZE  (256UL)
+#endif
+
+/* Encode numeric values relative to a SenML base value, as half floats when
+ * they round-trip within the minimum delta of their property, and timestamps
+ * relative to a SenML base time. See CBOREncoder::encode()
+ */
+#ifndef AIOT_CONFIG_COMPACT_PAYLOAD
+  #define AIOT_CONFIG_COMPACT_PAYLOAD  (0)
+#endif
+
+/* Number of wrappers for primitive variables stored in one block, see CloudWrapperPool */
+#ifndef AIOT_CONFIG_CLOUD_WRAPPER_POOL_SIZE
+  #define AIOT_CONFIG_CLOUD_WRAPPER_POOL_SIZE  (16UL)
+#endif
+
 #ifndef DEBUG_ERROR
   #define DEBUG_ERROR(fmt, ...) Debug.print(DBG_ERROR, fmt, ## __VA_ARGS__)
 #endif
@@ -153,6 +176,17 @@
   CONSTANTS
  ******************************************************************************/
 
+/* Inline storage of the arena staging the decoded records of a property, larger updates spill over to the heap.
+ * The decoder is a member of the cloud client, so this is static RAM.
+ */
+#ifndef AIOT_CONFIG_CBOR_DECODER_ARENA_SIZE
+  #if defined(ARDUINO_ARCH_SAMD)
+    #define AIOT_CONFIG_CBOR_DECODER_ARENA_SIZE                     (256UL)
+  #else
+    #define AIOT_CONFIG_CBOR_DECODER_ARENA_SIZE                    (1024UL)
+  #endif
+#endif
+
 #if defined(HAS_LORA)
   #define AIOT_CONFIG_LPWAN_UPDATE_RETRY_DELAY_ms                 (10000UL)
 #endif
@@ -170,6 +204,81 @@
 
   #define AIOT_CONFIG_TIMEOUT_FOR_LASTVALUES_SYNC_ms              (30000UL)
   #define AIOT_CONFIG_LASTVALUES_SYNC_MAX_RETRY_CNT                  (10UL)
+
+  /* Size of the static buffer holding an incoming MQTT command, larger commands are discarded.
+   * Property updates and last values are streamed through it, they are not limited by its size.
+   */
+  #ifndef AIOT_CONFIG_MQTT_RX_BUFFER_SIZE
+    #if defined(ARDUINO_ARCH_SAMD)
+      #define AIOT_CONFIG_MQTT_RX_BUFFER_SIZE                       (512UL)
+    #else
+      #define AIOT_CONFIG_MQTT_RX_BUFFER_SIZE                      (4096UL)
+    #endif
+  #endif
+
+  /* Default size of an outgoing property frame, can be changed at runtime via begin().
+   * One frame buffer is allocated from the heap, plus one per slot of the outbound queue.
+   */
+  #ifndef AIOT_CONFIG_MQTT_TX_BUFFER_SIZE
+    #define AIOT_CONFIG_MQTT_TX_BUFFER_SIZE                         (256UL)
+  #endif
+
+  /* Budget for publishing property frames within a single call to update(), 0 sends one frame per call */
+  #ifndef AIOT_CONFIG_MQTT_TX_BYTES_PER_TICK
+    #define AIOT_CONFIG_MQTT_TX_BYTES_PER_TICK                     (1024UL)
+  #endif
+  #ifndef AIOT_CONFIG_MQTT_TX_TIME_PER_TICK_ms
+    #define AIOT_CONFIG_MQTT_TX_TIME_PER_TICK_ms                     (20UL)
+  #endif
+
+  /* QoS of the property frames. MqttClient does not report the PUBACKs, whatever the QoS a frame is
+   * released from the outbound queue once it has been written to the connection. Only the frames which
+   * could not be written are retransmitted after a reconnection, with the DUP flag set at QoS 1, a frame
+   * written shortly before the connection is lost is not. Delivery is not at-least-once.
+   */
+  #ifndef AIOT_CONFIG_MQTT_TX_QOS
+    #define AIOT_CONFIG_MQTT_TX_QOS                                     (0)
+  #endif
+  /* Property frames which could not be published are kept in the outbound queue and retransmitted after a
+   * reconnection. Every slot takes a frame of AIOT_CONFIG_MQTT_TX_BUFFER_SIZE bytes from the heap.
+   */
+  #ifndef AIOT_CONFIG_MQTT_TX_QUEUE_LENGTH
+    #if defined(ARDUINO_ARCH_SAMD)
+      #define AIOT_CONFIG_MQTT_TX_QUEUE_LENGTH                        (1UL)
+    #else
+      #define AIOT_CONFIG_MQTT_TX_QUEUE_LENGTH                        (4UL)
+    #endif
+  #endif
+  /* When the outbound queue is full: 0 overwrites the oldest frame, 1 stops encoding new frames */
+  #ifndef AIOT_CONFIG_MQTT_TX_QUEUE_BLOCK_WHEN_FULL
+    #define AIOT_CONFIG_MQTT_TX_QUEUE_BLOCK_WHEN_FULL                   (0)
+  #endif
+
+  /* Bytes of RAM keeping the property updates which happen while not connected, see OfflineLog.
+   * 0 disables the log unless a storage is provided by ArduinoIoTCloudTCP::setOfflineLogStorage()
+   */
+  #ifndef AIOT_CONFIG_OFFLINE_LOG_RAM_SIZE
+    #define AIOT_CONFIG_OFFLINE_LOG_RAM_SIZE                            (0UL)
+  #endif
+  /* Budget for replaying the offline log within a single call to update(), 0 replays one frame per call */
+  #ifndef AIOT_CONFIG_OFFLINE_LOG_BYTES_PER_TICK
+    #define AIOT_CONFIG_OFFLINE_LOG_BYTES_PER_TICK                    (512UL)
+  #endif
+#endif
+
+#if OTA_ENABLED
+  /* Bytes read from the OTA download connection at a time, the payload of a TCP segment over a 1500 bytes MTU */
+  #ifndef AIOT_CONFIG_OTA_DOWNLOAD_BUFFER_SIZE
+    #define AIOT_CONFIG_OTA_DOWNLOAD_BUFFER_SIZE                   (1460UL)
+  #endif
+  /* Range requests in flight on the download connection, see ArduinoIoTCloudTCP::setOTAPipelinedMode() */
+  #ifndef AIOT_CONFIG_OTA_PIPELINE_DEPTH
+    #define AIOT_CONFIG_OTA_PIPELINE_DEPTH                            (2UL)
+  #endif
+  /* Bytes of the OTA file downloaded between two checkpoints a failed download can be resumed from */
+  #ifndef AIOT_CONFIG_OTA_CHECKPOINT_INTERVAL
+    #define AIOT_CONFIG_OTA_CHECKPOINT_INTERVAL                   (32768UL)
+  #endif
 #endif
 
 #define AIOT_CONFIG_LIB_VERSION "2.9.0"
@@ -87,27 +87,32 @@ Property& ArduinoIoTCloudClass::addPropertyReal(Property& property, String name,
 /* The following methods are used for both LoRa and non-Lora boards */
 Property& ArduinoIoTCloudClass::addPropertyReal(bool& property, String name, int tag, Permission const permission)
 {
-  Property* p = new CloudWrapperBool(property);
+  AIOT_HEAP_STATS_SCOPE(Property);
+  Property* p = CloudWrapperPool::create<CloudWrapperBool>(property);
   return addPropertyReal(*p, name, tag, permission);
 }
 Property& ArduinoIoTCloudClass::addPropertyReal(float& property, String name, int tag, Permission const permission)
 {
-  Property* p = new CloudWrapperFloat(property);
+  AIOT_HEAP_STATS_SCOPE(Property);
+  Property* p = CloudWrapperPool::create<CloudWrapperFloat>(property);
   return addPropertyReal(*p, name, tag, permission);
 }
 Property& ArduinoIoTCloudClass::addPropertyReal(int& property, String name, int tag, Permission const permission)
 {
-  Property* p = new CloudWrapperInt(property);
+  AIOT_HEAP_STATS_SCOPE(Property);
+  Property* p = CloudWrapperPool::create<CloudWrapperInt>(property);
   return addPropertyReal(*p, name, tag, permission);
 }
 Property& ArduinoIoTCloudClass::addPropertyReal(unsigned int& property, String name, int tag, Permission const permission)
 {
-  Property* p = new CloudWrapperUnsignedInt(property);
+  AIOT_HEAP_STATS_SCOPE(Property);
+  Property* p = CloudWrapperPool::create<CloudWrapperUnsignedInt>(property);
   return addPropertyReal(*p, name, tag, permission);
 }
 Property& ArduinoIoTCloudClass::addPropertyReal(String& property, String name, int tag, Permission const permission)
 {
-  Property* p = new CloudWrapperString(property);
+  AIOT_HEAP_STATS_SCOPE(Property);
+  Property* p = CloudWrapperPool::create<CloudWrapperString>(property);
   return addPropertyReal(*p, name, tag, permission);
 }
 Property& ArduinoIoTCloudClass::addPropertyReal(Property& property, String name, int tag, Permission const permission)
@@ -118,27 +123,32 @@ Property& ArduinoIoTCloudClass::addPropertyReal(Property& property, String name,
 /* The following methods are deprecated but still used for non-LoRa boards */
 void ArduinoIoTCloudClass::addPropertyReal(bool& property, String name, permissionType permission_type, long seconds, void(*fn)(void), float minDelta, void(*synFn)(Property & property))
 {
-  Property* p = new CloudWrapperBool(property);
+  AIOT_HEAP_STATS_SCOPE(Property);
+  Property* p = CloudWrapperPool::create<CloudWrapperBool>(property);
   addPropertyRealInternal(*p, name, -1, permission_type, seconds, fn, minDelta, synFn);
 }
 void ArduinoIoTCloudClass::addPropertyReal(float& property, String name, permissionType permission_type, long seconds, void(*fn)(void), float minDelta, void(*synFn)(Property & property))
 {
-  Property* p = new CloudWrapperFloat(property);
+  AIOT_HEAP_STATS_SCOPE(Property);
+  Property* p = CloudWrapperPool::create<CloudWrapperFloat>(property);
   addPropertyRealInternal(*p, name, -1, permission_type, seconds, fn, minDelta, synFn);
 }
 void ArduinoIoTCloudClass::addPropertyReal(int& property, String name, permissionType permission_type, long seconds, void(*fn)(void), float minDelta, void(*synFn)(Property & property))
 {
-  Property* p = new CloudWrapperInt(property);
+  AIOT_HEAP_STATS_SCOPE(Property);
+  Property* p = CloudWrapperPool::create<CloudWrapperInt>(property);
   addPropertyRealInternal(*p, name, -1, permission_type, seconds, fn, minDelta, synFn);
 }
 void ArduinoIoTCloudClass::addPropertyReal(unsigned int& property, String name, permissionType permission_type, long seconds, void(*fn)(void), float minDelta, void(*synFn)(Property & property))
 {
-  Property* p = new CloudWrapperUnsignedInt(property);
+  AIOT_HEAP_STATS_SCOPE(Property);
+  Property* p = CloudWrapperPool::create<CloudWrapperUnsignedInt>(property);
   addPropertyRealInternal(*p, name, -1, permission_type, seconds, fn, minDelta, synFn);
 }
 void ArduinoIoTCloudClass::addPropertyReal(String& property, String name, permissionType permission_type, long seconds, void(*fn)(void), float minDelta, void(*synFn)(Property & property))
 {
-  Property* p = new CloudWrapperString(property);
+  AIOT_HEAP_STATS_SCOPE(Property);
+  Property* p = CloudWrapperPool::create<CloudWrapperString>(property);
   addPropertyRealInternal(*p, name, -1, permission_type, seconds, fn, minDelta, synFn);
 }
 void ArduinoIoTCloudClass::addPropertyReal(Property& property, String name, permissionType permission_type, long seconds, void(*fn)(void), float minDelta, void(*synFn)(Property & property))
@@ -149,27 +159,32 @@ void ArduinoIoTCloudClass::addPropertyReal(Property& property, String name, perm
 /* The following methods are deprecated but still used for both LoRa and non-LoRa boards */
 void ArduinoIoTCloudClass::addPropertyReal(bool& property, String name, int tag, permissionType permission_type, long seconds, void(*fn)(void), float minDelta, void(*synFn)(Property & property))
 {
-  Property* p = new CloudWrapperBool(property);
+  AIOT_HEAP_STATS_SCOPE(Property);
+  Property* p = CloudWrapperPool::create<CloudWrapperBool>(property);
   addPropertyRealInternal(*p, name, tag, permission_type, seconds, fn, minDelta, synFn);
 }
 void ArduinoIoTCloudClass::addPropertyReal(float& property, String name, int tag, permissionType permission_type, long seconds, void(*fn)(void), float minDelta, void(*synFn)(Property & property))
 {
-  Property* p = new CloudWrapperFloat(property);
+  AIOT_HEAP_STATS_SCOPE(Property);
+  Property* p = CloudWrapperPool::create<CloudWrapperFloat>(property);
   addPropertyRealInternal(*p, name, tag, permission_type, seconds, fn, minDelta, synFn);
 }
 void ArduinoIoTCloudClass::addPropertyReal(int& property, String name, int tag, permissionType permission_type, long seconds, void(*fn)(void), float minDelta, void(*synFn)(Property & property))
 {
-  Property* p = new CloudWrapperInt(property);
+  AIOT_HEAP_STATS_SCOPE(Property);
+  Property* p = CloudWrapperPool::create<CloudWrapperInt>(property);
   addPropertyRealInternal(*p, name, tag, permission_type, seconds, fn, minDelta, synFn);
 }
 void ArduinoIoTCloudClass::addPropertyReal(unsigned int& property, String name, int tag, permissionType permission_type, long seconds, void(*fn)(void), float minDelta, void(*synFn)(Property & property))
 {
-  Property* p = new CloudWrapperUnsignedInt(property);
+  AIOT_HEAP_STATS_SCOPE(Property);
+  Property* p = CloudWrapperPool::create<CloudWrapperUnsignedInt>(property);
   addPropertyRealInternal(*p, name, tag, permission_type, seconds, fn, minDelta, synFn);
 }
 void ArduinoIoTCloudClass::addPropertyReal(String& property, String name, int tag, permissionType permission_type, long seconds, void(*fn)(void), float minDelta, void(*synFn)(Property & property))
 {
-  Property* p = new CloudWrapperString(property);
+  AIOT_HEAP_STATS_SCOPE(Property);
+  Property* p = CloudWrapperPool::create<CloudWrapperString>(property);
   addPropertyRealInternal(*p, name, tag, permission_type, seconds, fn, minDelta, synFn);
 }
 void ArduinoIoTCloudClass::addPropertyReal(Property& property, String name, int tag, permissionType permission_type, long seconds, void(*fn)(void), float minDelta, void(*synFn)(Property & property))
@@ -37,8 +37,10 @@
 #include "property/types/CloudWrapperInt.h"
 #include "property/types/CloudWrapperUnsignedInt.h"
 #include "property/types/CloudWrapperString.h"
+#include "property/CloudWrapperPool.h"
 
 #include "utility/time/TimeService.h"
+#include "utility/memory/HeapStats.h"
 
 /******************************************************************************
   TYPEDEF
@@ -97,6 +99,12 @@ class ArduinoIoTCloudClass
     inline unsigned long getInternalTime()              { return _time_service.getTime(); }
     inline unsigned long getLocalTime()                 { return _time_service.getLocalTime(); }
 
+    #if AIOT_CONFIG_HEAP_STATS
+    /* Heap allocations, bytes and peak heap usage per subsystem */
+    inline HeapStats getStats() const                   { return heap_stats_get(); }
+    inline void      resetStats()                       { heap_stats_reset(); }
+    #endif
+
     #if NETWORK_CONFIGURATOR_ENABLED
     inline void setConfigurator(NetworkConfiguratorClass & configurator) { _configurator = &configurator; }
     #endif
@@ -104,6 +112,15 @@ class ArduinoIoTCloudClass
 
 #define addProperty( v, ...) addPropertyReal(v, #v, __VA_ARGS__)
 
+    /* Registers a compile time table of property descriptors in a single
+     * pass, see PropertyDescriptor. This is faster than adding the properties
+     * one by one and does not allocate CloudWrapper objects on the heap.
+     */
+    template <size_t N>
+    void addProperties(PropertyDescriptor const (&descriptors)[N]) {
+      addPropertiesToContainer(getThingPropertyContainer(), descriptors, N);
+    }
+
     /* The following methods are used for non-LoRa boards which can use the
      * name of the property to identify a given property within a CBOR message.
      */
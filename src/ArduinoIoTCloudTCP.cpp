@@ -46,9 +46,10 @@ ArduinoIoTCloudTCP::ArduinoIoTCloudTCP()
 , _message_stream(std::bind(&ArduinoIoTCloudTCP::sendMessage, this, std::placeholders::_1))
 , _thing(&_message_stream)
 , _device(&_message_stream)
-, _mqtt_data_buf{0}
-, _mqtt_data_len{0}
-, _mqtt_data_request_retransmit{false}
+, _offline_log_armed{false}
+, _offline_log_time{0}
+, _offline_log_millis{0}
+, _decoder(_thing.getPropertyContainer())
 #ifdef BOARD_HAS_SECRET_KEY
 , _password("")
 #endif
@@ -56,10 +57,8 @@ ArduinoIoTCloudTCP::ArduinoIoTCloudTCP()
 , _writeCertOnConnect(false)
 #endif
 , _mqttClient{nullptr}
-, _messageTopicOut("")
-, _messageTopicIn("")
-, _dataTopicOut("")
-, _dataTopicIn("")
+, _topics()
+, _dispatcher()
 #if OTA_ENABLED
 , _ota(&_message_stream)
 , _get_ota_confirmation{nullptr}
@@ -73,7 +72,7 @@ ArduinoIoTCloudTCP::ArduinoIoTCloudTCP()
   PUBLIC MEMBER FUNCTIONS
  ******************************************************************************/
 
-int ArduinoIoTCloudTCP::begin(ConnectionHandler & connection, bool const enable_watchdog, String brokerAddress, uint16_t brokerPort, bool auto_reconnect)
+int ArduinoIoTCloudTCP::begin(ConnectionHandler & connection, bool const enable_watchdog, String brokerAddress, uint16_t brokerPort, bool auto_reconnect, size_t const mqtt_tx_buffer_size)
 {
   _connection = &connection;
   _brokerAddress = brokerAddress;
@@ -129,16 +128,41 @@ int ArduinoIoTCloudTCP::begin(ConnectionHandler & connection, bool const enable_
 
   /* Setup retry timers */
   _connection_attempt.begin(AIOT_CONFIG_RECONNECTION_RETRY_DELAY_ms, AIOT_CONFIG_MAX_RECONNECTION_RETRY_DELAY_ms);
-  return begin(enable_watchdog, _brokerAddress, _brokerPort, auto_reconnect);
+  return begin(enable_watchdog, _brokerAddress, _brokerPort, auto_reconnect, mqtt_tx_buffer_size);
 }
 
-int ArduinoIoTCloudTCP::begin(bool const enable_watchdog, String brokerAddress, uint16_t brokerPort, bool auto_reconnect)
+int ArduinoIoTCloudTCP::begin(bool const enable_watchdog, String brokerAddress, uint16_t brokerPort, bool auto_reconnect, size_t const mqtt_tx_buffer_size)
 {
   _enable_watchdog = enable_watchdog;
   _brokerAddress = brokerAddress;
   _brokerPort = brokerPort;
   _auto_reconnect = auto_reconnect;
 
+  if (!_property_uplink.begin(mqtt_tx_buffer_size, AIOT_CONFIG_MQTT_TX_BYTES_PER_TICK, AIOT_CONFIG_MQTT_TX_TIME_PER_TICK_ms))
+  {
+    DEBUG_ERROR("ArduinoIoTCloudTCP::%s could not allocate a %d bytes MQTT transmit buffer.", __FUNCTION__, static_cast<int>(mqtt_tx_buffer_size));
+    return 0;
+  }
+
+  MqttOutboundQueue::Policy const queue_policy = AIOT_CONFIG_MQTT_TX_QUEUE_BLOCK_WHEN_FULL ? MqttOutboundQueue::Policy::Block : MqttOutboundQueue::Policy::OverwriteOldest;
+  if (!_outbound_queue.begin(AIOT_CONFIG_MQTT_TX_QUEUE_LENGTH, mqtt_tx_buffer_size, queue_policy))
+  {
+    DEBUG_ERROR("ArduinoIoTCloudTCP::%s could not allocate the MQTT outbound queue.", __FUNCTION__);
+    return 0;
+  }
+
+#if AIOT_CONFIG_OFFLINE_LOG_RAM_SIZE > 0
+  if (_offline_log.storage() == nullptr && _offline_log_ram_storage.begin(AIOT_CONFIG_OFFLINE_LOG_RAM_SIZE))
+  {
+    _offline_log.setStorage(&_offline_log_ram_storage);
+  }
+#endif
+  if (_offline_log.storage() != nullptr && !_offline_log.begin(mqtt_tx_buffer_size, AIOT_CONFIG_OFFLINE_LOG_BYTES_PER_TICK))
+  {
+    DEBUG_ERROR("ArduinoIoTCloudTCP::%s could not allocate the offline log.", __FUNCTION__);
+    return 0;
+  }
+
   _state = State::ConfigPhy;
 
   _mqttClient.setClient(_brokerClient);
@@ -155,8 +179,24 @@ int ArduinoIoTCloudTCP::begin(bool const enable_watchdog, String brokerAddress,
   _mqttClient.setConnectionTimeout(1500);
   _mqttClient.setId(getDeviceId().c_str());
 
-  _messageTopicOut = getTopic_messageout();
-  _messageTopicIn  = getTopic_messagein();
+  if (!_topics.begin(getDeviceId().c_str()))
+  {
+    DEBUG_ERROR("ArduinoIoTCloudTCP::%s device id %s is too long.", __FUNCTION__, getDeviceId().c_str());
+    return 0;
+  }
+
+  /* Route the incoming messages, data in is added once a thing is attached.
+   * The routes of a previous call to begin() are dropped first.
+   */
+  _dispatcher.clear();
+  _dispatcher.addTopic(_topics.messageIn(), [this](int length) { handleCommand(length); });
+  _dispatcher.subscribe(CommandId::ThingUpdateCmdId, [this](Command * command) { handleThingUpdateCmd(command); });
+  _dispatcher.subscribe(CommandId::ThingDetachCmdId, [this](Command * command) { handleThingDetachCmd(command); });
+  _dispatcher.subscribe(CommandId::LastValuesUpdateCmdId, [this](Command * command) { handleLastValuesUpdateCmd(command); });
+  _dispatcher.subscribe(CommandId::TimezoneCommandDownId, _thing);
+#if OTA_ENABLED
+  _dispatcher.subscribe(CommandId::OtaUpdateCmdDownId, _ota);
+#endif
 
   _thing.begin();
   _device.begin();
@@ -221,6 +261,14 @@ void ArduinoIoTCloudTCP::update()
 
   _state = next_state;
 
+  /* Property updates are kept in the offline log until the thing is attached again,
+   * afterwards they stay pending and are published once the thing is synchronized.
+   */
+  if (_offline_log_armed && !(_state == State::Connected && _device.isAttached()))
+  {
+    recordOfflineLog();
+  }
+
   /* This watchdog feed is actually needed only by the RP2040 Connect because its
    * maximum watchdog window is 8389 ms; despite this we feed it for all
    * supported ARCH to keep code aligned.
@@ -383,7 +431,7 @@ ArduinoIoTCloudTCP::State ArduinoIoTCloudTCP::handle_ConnectMqttBroker()
   if (_mqttClient.connect(_brokerAddress.c_str(), _brokerPort))
   {
     /* Subscribe to message topic to receive commands */
-    _mqttClient.subscribe(_messageTopicIn);
+    _mqttClient.subscribe(_topics.messageIn());
 
 #if defined(BOARD_HAS_SECURE_ELEMENT)
     /* A device certificate update was pending */
@@ -396,6 +444,11 @@ ArduinoIoTCloudTCP::State ArduinoIoTCloudTCP::handle_ConnectMqttBroker()
       }
     }
 #endif
+    /* Frames which have not been acknowledged before the connection was lost
+     * are published again once the thing is attached.
+     */
+    _outbound_queue.requeue();
+
     DEBUG_VERBOSE("ArduinoIoTCloudTCP::%s connected to %s:%d", __FUNCTION__, _brokerAddress.c_str(), _brokerPort);
     return State::Connected;
   }
@@ -423,21 +476,33 @@ ArduinoIoTCloudTCP::State ArduinoIoTCloudTCP::handle_Connected()
   /* Check for new data from the MQTT client. */
   _mqttClient.poll();
 
-  /* Retransmit data in case there was a lost transaction due
-   * to phy layer or MQTT connectivity loss.
-   */
-  if (_mqtt_data_request_retransmit && (_mqtt_data_len > 0)) {
-    write(_dataTopicOut, _mqtt_data_buf, _mqtt_data_len);
-    _mqtt_data_request_retransmit = false;
-  }
-
   /* Call CloudDevice process to get configuration */
   _device.update();
 
 
   if (_device.isAttached()) {
+    /* Retransmit data in case there was a lost transaction due
+     * to phy layer or MQTT connectivity loss.
+     */
+    transmitOutboundQueue(_topics.dataOut());
+
+    /* The updates which happened while not connected are published before the
+     * last values are requested. The cloud answers with values which already
+     * take them into account, a replayed update can not overwrite a value the
+     * thing has been synchronized to.
+     */
+    if (!_offline_log.empty()) {
+      replayOfflineLog();
+      return State::Connected;
+    }
+
     /* Call CloudThing process to synchronize properties */
     _thing.update();
+
+    /* Updates are logged from the first synchronization on */
+    if (_thing.synced()) {
+      armOfflineLog();
+    }
   }
 
   return State::Connected;
@@ -475,112 +540,169 @@ void ArduinoIoTCloudTCP::onMessage(int length)
 
 void ArduinoIoTCloudTCP::handleMessage(int length)
 {
-  String topic = _mqttClient.messageTopic();
+  AIOT_HEAP_STATS_SCOPE(Mqtt);
 
-  byte bytes[length];
+  if (length < 0) {
+    return;
+  }
 
-  for (int i = 0; i < length; i++) {
-    bytes[i] = _mqttClient.read();
+  /* MqttClient hands the topic out by value, it is only hashed in place to look up its handler */
+  if (!_dispatcher.dispatch(_mqttClient.messageTopic().c_str(), length)) {
+    DEBUG_VERBOSE("ArduinoIoTCloudTCP::%s [%d] message on unknown topic discarded", __FUNCTION__, millis());
+    _mqtt_rx_buffer.receive(_mqttClient, static_cast<size_t>(length));
   }
+}
 
-  /* Topic for user input data */
-  if (_dataTopicIn == topic) {
-    CBORDecoder::decode(_thing.getPropertyContainer(), (uint8_t*)bytes, length);
+void ArduinoIoTCloudTCP::handlePropertyUpdate(int length)
+{
+  /* Topic for user input data: the payload is decoded incrementally while it is
+   * being read, so property updates are not limited by the receive buffer size
+   */
+  _decoder.begin(_thing.getPropertyContainer());
+  if (_mqtt_rx_buffer.stream(_mqttClient, static_cast<size_t>(length),
+        [this](uint8_t const * chunk, size_t const chunk_length) { _decoder.feed(chunk, chunk_length); })
+      != MqttReceiveBuffer<AIOT_CONFIG_MQTT_RX_BUFFER_SIZE>::Status::Complete) {
+    DEBUG_ERROR("ArduinoIoTCloudTCP::%s property update truncated, expected %d bytes", __FUNCTION__, length);
   }
+}
 
-  /* Topic for device commands */
-  if (_messageTopicIn == topic) {
-    CommandDown command;
-    DEBUG_VERBOSE("ArduinoIoTCloudTCP::%s [%d] received %d bytes", __FUNCTION__, millis(), length);
-    CBORMessageDecoder decoder;
+void ArduinoIoTCloudTCP::handleCommand(int length)
+{
+  size_t const message_length = static_cast<size_t>(length);
+  DEBUG_VERBOSE("ArduinoIoTCloudTCP::%s [%d] received %d bytes", __FUNCTION__, millis(), length);
 
-    size_t buffer_length = length;
-    if (decoder.decode((Message*)&command, bytes, buffer_length) != MessageDecoder::Status::Error) {
-      DEBUG_VERBOSE("ArduinoIoTCloudTCP::%s [%d] received command id %d", __FUNCTION__, millis(), command.c.id);
-      switch (command.c.id)
-      {
-        case CommandId::ThingUpdateCmdId:
-        {
-          DEBUG_VERBOSE("ArduinoIoTCloudTCP::%s [%d] device configuration received", __FUNCTION__, millis());
-          String new_thing_id = String(command.thingUpdateCmd.params.thing_id);
-
-          if (!new_thing_id.length()) {
-            /* Send message to device state machine to inform we have received a null thing-id */
-            _thing_id = "xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx";
-            Message message;
-            message = { DeviceRegisteredCmdId };
-            _device.handleMessage(&message);
-          } else {
-            if (_device.isAttached() && _thing_id != new_thing_id) {
-              detachThing();
-            }
-            if (!_device.isAttached()) {
-              attachThing(new_thing_id);
-            }
-          }
-        }
-        break;
-
-        case CommandId::ThingDetachCmdId:
-        {
-          if (!_device.isAttached() || _thing_id != String(command.thingDetachCmd.params.thing_id)) {
-            DEBUG_VERBOSE("ArduinoIoTCloudTCP::%s [%d] thing detach rejected", __FUNCTION__, millis());
-          }
-
-          DEBUG_VERBOSE("ArduinoIoTCloudTCP::%s [%d] thing detach received", __FUNCTION__, millis());
-          detachThing();
-        }
-        break;
-
-        case CommandId::TimezoneCommandDownId:
-        {
-          DEBUG_VERBOSE("ArduinoIoTCloudTCP::%s [%d] timezone update received", __FUNCTION__, millis());
-          _thing.handleMessage((Message*)&command);
-        }
-        break;
-
-        case CommandId::LastValuesUpdateCmdId:
-        {
-          DEBUG_VERBOSE("ArduinoIoTCloudTCP::%s [%d] last values received", __FUNCTION__, millis());
-          CBORDecoder::decode(_thing.getPropertyContainer(),
-            (uint8_t*)command.lastValuesUpdateCmd.params.last_values,
-            command.lastValuesUpdateCmd.params.length, true);
-          _thing.handleMessage((Message*)&command);
-          execCloudEventCallback(ArduinoIoTCloudEvent::SYNC);
-
-          /*
-           * NOTE: in this current version properties are not properly integrated with the new paradigm of
-           * modeling the messages with C structs. The current CBOR library allocates an array in the heap
-           * thus we need to delete it after decoding it with the old CBORDecoder
-           */
-          free(command.lastValuesUpdateCmd.params.last_values);
-        }
-        break;
+  /* Inspect the header first: the last values are streamed into the property
+   * decoder, so they are not limited by the receive buffer size
+   */
+  size_t header_length = message_length;
+  if (header_length > CBORDecoder::COMMAND_HEADER_MAX_LENGTH) {
+    header_length = CBORDecoder::COMMAND_HEADER_MAX_LENGTH;
+  }
+  if (_mqtt_rx_buffer.receive(_mqttClient, header_length) != MqttReceiveBuffer<AIOT_CONFIG_MQTT_RX_BUFFER_SIZE>::Status::Complete) {
+    DEBUG_ERROR("ArduinoIoTCloudTCP::%s message truncated, received %d of %d bytes", __FUNCTION__, static_cast<int>(_mqtt_rx_buffer.length()), length);
+    return;
+  }
 
-#if OTA_ENABLED
-        case CommandId::OtaUpdateCmdDownId:
-        {
-          DEBUG_VERBOSE("ArduinoIoTCloudTCP::%s [%d] ota update received", __FUNCTION__, millis());
-          _ota.handleMessage((Message*)&command);
-        }
-#endif
+  size_t payload_offset = 0;
+  size_t payload_length = 0;
+  if (CBORDecoder::findCommandPayload(_mqtt_rx_buffer.data(), header_length, CBORLastValuesUpdate, payload_offset, payload_length) &&
+      payload_offset + payload_length == message_length) {
+    streamLastValuesUpdate(payload_offset, payload_length);
+    return;
+  }
 
-        default:
-        break;
-      }
+  /* Read the rest of the payload, the decoders work in place on the receive buffer */
+  switch (_mqtt_rx_buffer.append(_mqttClient, message_length - header_length)) {
+    case MqttReceiveBuffer<AIOT_CONFIG_MQTT_RX_BUFFER_SIZE>::Status::Oversize:
+      DEBUG_ERROR("ArduinoIoTCloudTCP::%s message of %d bytes exceeds receive buffer size of %d bytes, discarded", __FUNCTION__, length, static_cast<int>(_mqtt_rx_buffer.capacity()));
+      return;
+    case MqttReceiveBuffer<AIOT_CONFIG_MQTT_RX_BUFFER_SIZE>::Status::Incomplete:
+      DEBUG_ERROR("ArduinoIoTCloudTCP::%s message truncated, received %d of %d bytes", __FUNCTION__, static_cast<int>(_mqtt_rx_buffer.length()), length);
+      return;
+    case MqttReceiveBuffer<AIOT_CONFIG_MQTT_RX_BUFFER_SIZE>::Status::Complete:
+    default:
+      break;
+  }
+
+  CommandDown command;
+  CBORMessageDecoder decoder;
+
+  size_t buffer_length = length;
+  if (decoder.decode((Message*)&command, _mqtt_rx_buffer.data(), buffer_length) != MessageDecoder::Status::Error) {
+    DEBUG_VERBOSE("ArduinoIoTCloudTCP::%s [%d] received command id %d", __FUNCTION__, millis(), command.c.id);
+    if (_dispatcher.dispatch(&command.c) == 0) {
+      DEBUG_VERBOSE("ArduinoIoTCloudTCP::%s [%d] command id %d has no subscriber", __FUNCTION__, millis(), command.c.id);
     }
   }
 }
 
+void ArduinoIoTCloudTCP::streamLastValuesUpdate(size_t const payload_offset, size_t const payload_length)
+{
+  DEBUG_VERBOSE("ArduinoIoTCloudTCP::%s [%d] last values received, %d bytes", __FUNCTION__, millis(), static_cast<int>(payload_length));
+
+  /* The header may already contain the first bytes of the last values */
+  _decoder.begin(_thing.getPropertyContainer(), true);
+  size_t const received = _mqtt_rx_buffer.length() - payload_offset;
+  _decoder.feed(_mqtt_rx_buffer.data() + payload_offset, received);
+
+  if (_mqtt_rx_buffer.stream(_mqttClient, payload_length - received,
+        [this](uint8_t const * chunk, size_t const chunk_length) { _decoder.feed(chunk, chunk_length); })
+      != MqttReceiveBuffer<AIOT_CONFIG_MQTT_RX_BUFFER_SIZE>::Status::Complete) {
+    DEBUG_ERROR("ArduinoIoTCloudTCP::%s last values truncated, expected %d bytes", __FUNCTION__, static_cast<int>(payload_length));
+    return;
+  }
+  if (_decoder.status() != CBORDecoder::Status::Complete) {
+    DEBUG_ERROR("ArduinoIoTCloudTCP::%s last values could not be decoded", __FUNCTION__);
+  }
+
+  LastValuesUpdateCmd command;
+  command.c.id = LastValuesUpdateCmdId;
+  command.params.last_values = nullptr;
+  command.params.length = payload_length;
+  _thing.handleMessage(&command.c);
+  execCloudEventCallback(ArduinoIoTCloudEvent::SYNC);
+}
+
+void ArduinoIoTCloudTCP::handleThingUpdateCmd(Command * command)
+{
+  DEBUG_VERBOSE("ArduinoIoTCloudTCP::%s [%d] device configuration received", __FUNCTION__, millis());
+  String new_thing_id = String(reinterpret_cast<ThingUpdateCmd *>(command)->params.thing_id);
+
+  if (!new_thing_id.length()) {
+    /* Send message to device state machine to inform we have received a null thing-id */
+    _thing_id = "xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx";
+    Message message;
+    message = { DeviceRegisteredCmdId };
+    _device.handleMessage(&message);
+  } else {
+    if (_device.isAttached() && _thing_id != new_thing_id) {
+      detachThing();
+    }
+    if (!_device.isAttached()) {
+      attachThing(new_thing_id);
+    }
+  }
+}
+
+void ArduinoIoTCloudTCP::handleThingDetachCmd(Command * command)
+{
+  if (!_device.isAttached() || _thing_id != String(reinterpret_cast<ThingDetachCmd *>(command)->params.thing_id)) {
+    DEBUG_VERBOSE("ArduinoIoTCloudTCP::%s [%d] thing detach rejected", __FUNCTION__, millis());
+  }
+
+  DEBUG_VERBOSE("ArduinoIoTCloudTCP::%s [%d] thing detach received", __FUNCTION__, millis());
+  detachThing();
+}
+
+void ArduinoIoTCloudTCP::handleLastValuesUpdateCmd(Command * command)
+{
+  LastValuesUpdateCmd * last_values_update = reinterpret_cast<LastValuesUpdateCmd *>(command);
+
+  DEBUG_VERBOSE("ArduinoIoTCloudTCP::%s [%d] last values received", __FUNCTION__, millis());
+  _decoder.begin(_thing.getPropertyContainer(), true);
+  _decoder.feed(last_values_update->params.last_values, last_values_update->params.length);
+  _thing.handleMessage(command);
+  execCloudEventCallback(ArduinoIoTCloudEvent::SYNC);
+
+  /*
+   * NOTE: in this current version properties are not properly integrated with the new paradigm of
+   * modeling the messages with C structs. The current CBOR library allocates an array in the heap
+   * thus we need to delete it after decoding it with the old CBORDecoder
+   */
+  free(last_values_update->params.last_values);
+}
+
 void ArduinoIoTCloudTCP::sendMessage(Message * msg)
 {
+  AIOT_HEAP_STATS_SCOPE(Mqtt);
+
   uint8_t data[MQTT_TRANSMIT_BUFFER_SIZE];
   size_t bytes_encoded = sizeof(data);
   CBORMessageEncoder encoder;
 
   switch (msg->id) {
     case PropertiesUpdateCmdId:
-      return sendPropertyContainerToCloud(_dataTopicOut,
+      return sendPropertyContainerToCloud(_topics.dataOut(),
                                           _thing.getPropertyContainer(),
                                           _thing.getPropertyContainerIndex());
       break;
@@ -591,41 +713,94 @@ void ArduinoIoTCloudTCP::sendMessage(Message * msg)
 
   if (encoder.encode(msg, data, bytes_encoded) == MessageEncoder::Status::Complete &&
       bytes_encoded > 0) {
-    write(_messageTopicOut, data, bytes_encoded);
+    write(_topics.messageOut(), data, bytes_encoded);
   } else {
     DEBUG_ERROR("error encoding %d", msg->id);
   }
 }
 
-void ArduinoIoTCloudTCP::sendPropertyContainerToCloud(String const topic, PropertyContainer & property_container, unsigned int & current_property_index)
+void ArduinoIoTCloudTCP::sendPropertyContainerToCloud(char const * topic, PropertyContainer & property_container, unsigned int & current_property_index)
 {
-  int bytes_encoded = 0;
-  uint8_t data[MQTT_TRANSMIT_BUFFER_SIZE];
+  if (_outbound_queue.blocked())
+    return;
 
-  if (CBOREncoder::encode(property_container, data, sizeof(data), bytes_encoded, current_property_index, false) == CborNoError)
-  {
-    if (bytes_encoded > 0)
+  /* Publish as many frames as the per-tick budget allows. Every frame goes
+   * through the outbound queue in order to allow retransmission in case of
+   * failure, encoding stops as soon as the queue can not be drained.
+   */
+  _property_uplink.send(property_container, current_property_index,
+    [this, topic](uint8_t const * frame, size_t const length)
     {
-      /* If properties have been encoded store them in the back-up buffer
-       * in order to allow retransmission in case of failure.
-       */
-      _mqtt_data_len = bytes_encoded;
-      memcpy(_mqtt_data_buf, data, _mqtt_data_len);
-      /* Transmit the properties to the MQTT broker */
-      write(topic, _mqtt_data_buf, _mqtt_data_len);
-    }
-  }
+      if (!_outbound_queue.push(frame, length))
+        return false;
+      return transmitOutboundQueue(topic) && !_outbound_queue.blocked();
+    });
+}
+
+bool ArduinoIoTCloudTCP::transmitOutboundQueue(char const * topic)
+{
+  /* MqttClient does not hand out the packet ids nor the PUBACKs, a frame
+   * is therefore released as soon as write() succeeds, also at QoS 1. Only
+   * a frame which fails stays queued and is retransmitted with the DUP flag
+   * set, see AIOT_CONFIG_MQTT_TX_QOS.
+   */
+  _outbound_queue.deliver(
+    [this, topic](uint8_t const * frame, size_t const length, uint16_t const /* packet_id */, bool const dup)
+    {
+      return write(topic, frame, static_cast<int>(length), AIOT_CONFIG_MQTT_TX_QOS, dup) == 1;
+    });
+
+  return _outbound_queue.queued() == 0;
+}
+
+void ArduinoIoTCloudTCP::recordOfflineLog()
+{
+  /* The time service may try to reach a time server, the time is kept going
+   * from the last time read while connected instead.
+   */
+  unsigned long const time = _offline_log_time + (millis() - _offline_log_millis) / 1000;
+
+  /* Wrapped primitive variables are only checked for changes while connected */
+  updateTimestampOnLocallyChangedProperties(_thing.getPropertyContainer());
+  _offline_log.record(_thing.getPropertyContainer(), _thing.getPropertyContainerIndex(), time);
+}
+
+void ArduinoIoTCloudTCP::armOfflineLog()
+{
+  if (_offline_log.storage() == nullptr)
+    return;
+
+  _offline_log_armed = true;
+  _offline_log_time = getInternalTime();
+  _offline_log_millis = millis();
+}
+
+void ArduinoIoTCloudTCP::replayOfflineLog()
+{
+  /* Frames are handed over to the outbound queue one at a time, so that they
+   * are not overwritten in the queue while the link is down.
+   */
+  _offline_log.replay(
+    [this](uint8_t const * frame, size_t const length)
+    {
+      if (_outbound_queue.queued() > 0 || !_outbound_queue.push(frame, length))
+        return false;
+      transmitOutboundQueue(_topics.dataOut());
+      return true;
+    });
 }
 
 void ArduinoIoTCloudTCP::attachThing(String thingId)
 {
   _thing_id = thingId;
 
-  _dataTopicIn    = getTopic_datain();
-  _dataTopicOut   = getTopic_dataout();
-  if (!_mqttClient.subscribe(_dataTopicIn)) {
-    DEBUG_ERROR("ArduinoIoTCloudTCP::%s could not subscribe to %s", __FUNCTION__, _dataTopicIn.c_str());
+  if (!_topics.attachThing(thingId.c_str()) ||
+      !_dispatcher.addTopic(_topics.dataIn(), [this](int length) { handlePropertyUpdate(length); }) ||
+      !_mqttClient.subscribe(_topics.dataIn())) {
+    DEBUG_ERROR("ArduinoIoTCloudTCP::%s could not subscribe to %s", __FUNCTION__, _topics.dataIn());
     DEBUG_ERROR("Check your thing configuration, and press the reset button on your board.");
+    _dispatcher.removeTopic(_topics.dataIn());
+    _topics.detachThing();
     _thing_id = "xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx";
     return;
   }
@@ -641,8 +816,8 @@ void ArduinoIoTCloudTCP::attachThing(String thingId)
 
 void ArduinoIoTCloudTCP::detachThing()
 {
-  if (!_mqttClient.unsubscribe(_dataTopicIn)) {
-    DEBUG_ERROR("ArduinoIoTCloudTCP::%s could not unsubscribe from %s", __FUNCTION__, _dataTopicIn.c_str());
+  if (!_mqttClient.unsubscribe(_topics.dataIn())) {
+    DEBUG_ERROR("ArduinoIoTCloudTCP::%s could not unsubscribe from %s", __FUNCTION__, _topics.dataIn());
     return;
   }
 
@@ -650,14 +825,20 @@ void ArduinoIoTCloudTCP::detachThing()
   message = { DeviceDetachedCmdId };
   _device.handleMessage(&message);
 
+  /* The logged updates belong to the detached thing */
+  _offline_log_armed = false;
+  _offline_log.clear();
+
+  _dispatcher.removeTopic(_topics.dataIn());
+  _topics.detachThing();
   _thing_id = "xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx";
   DEBUG_INFO("Disconnected from Arduino IoT Cloud");
   execCloudEventCallback(ArduinoIoTCloudEvent::DISCONNECT);
 }
 
-int ArduinoIoTCloudTCP::write(String const topic, byte const data[], int const length)
+int ArduinoIoTCloudTCP::write(char const * topic, byte const data[], int const length, uint8_t const qos, bool const dup)
 {
-  if (_mqttClient.beginMessage(topic, length, false, 0)) {
+  if (_mqttClient.beginMessage(topic, length, false, qos, dup)) {
     if (_mqttClient.write(data, length)) {
       if (_mqttClient.endMessage()) {
         return 1;
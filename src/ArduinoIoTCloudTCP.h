@@ -29,6 +29,13 @@
 
 #include <tls/utility/TLSClientMqtt.h>
 #include <tls/utility/TLSClientOta.h>
+#include <utility/mqtt/MqttReceiveBuffer.h>
+#include <utility/mqtt/MqttPropertyUplink.h>
+#include <utility/mqtt/MqttOutboundQueue.h>
+#include <utility/mqtt/MqttTopics.h>
+#include <utility/mqtt/MqttDispatcher.h>
+#include <utility/offline/OfflineLog.h>
+#include <utility/offline/OfflineLogRamStorage.h>
 
 #if OTA_ENABLED
   #include <ota/OTA.h>
@@ -76,8 +83,8 @@ class ArduinoIoTCloudTCP: public ArduinoIoTCloudClass
     virtual void printDebugInfo() override;
     virtual void disconnect    () override;
 
-    int begin(ConnectionHandler & connection, bool const enable_watchdog = true, String brokerAddress = DEFAULT_BROKER_ADDRESS, uint16_t brokerPort = DEFAULT_BROKER_PORT_AUTO, bool auto_reconnect = true);
-    int begin(bool const enable_watchdog = true, String brokerAddress = DEFAULT_BROKER_ADDRESS, uint16_t brokerPort = DEFAULT_BROKER_PORT_AUTO, bool auto_reconnect = true);
+    int begin(ConnectionHandler & connection, bool const enable_watchdog = true, String brokerAddress = DEFAULT_BROKER_ADDRESS, uint16_t brokerPort = DEFAULT_BROKER_PORT_AUTO, bool auto_reconnect = true, size_t const mqtt_tx_buffer_size = AIOT_CONFIG_MQTT_TX_BUFFER_SIZE);
+    int begin(bool const enable_watchdog = true, String brokerAddress = DEFAULT_BROKER_ADDRESS, uint16_t brokerPort = DEFAULT_BROKER_PORT_AUTO, bool auto_reconnect = true, size_t const mqtt_tx_buffer_size = AIOT_CONFIG_MQTT_TX_BUFFER_SIZE);
 
 #if defined(BOARD_HAS_SECURE_ELEMENT)
     int updateCertificate(String authorityKeyIdentifier, String serialNumber, String notBefore, String notAfter, String signature);
@@ -93,6 +100,13 @@ class ArduinoIoTCloudTCP: public ArduinoIoTCloudClass
 
     inline PropertyContainer &getThingPropertyContainer() { return _thing.getPropertyContainer(); }
 
+    /* Keeps the property updates which happen while not connected in 'storage'
+     * and replays them once the thing is attached again, before its last values
+     * are requested. Needs to be called before begin(), replaces the RAM log of
+     * AIOT_CONFIG_OFFLINE_LOG_RAM_SIZE.
+     */
+    inline void setOfflineLogStorage(OfflineLogStorage & storage) { _offline_log.setStorage(&storage); }
+
 #if OTA_ENABLED
     /* The callback is triggered when the OTA is initiated and it gets executed until _ota_req flag is cleared.
      * It should return true when the OTA can be applied or false otherwise.
@@ -116,6 +130,41 @@ class ArduinoIoTCloudTCP: public ArduinoIoTCloudClass
         _ota.disableOtaPolicy(OTACloudProcessInterface::ChunkDownload);
       }
     }
+
+    /* Requests the OTA file range by range over a single keep-alive connection,
+     * asking for the next range before the current one has been received.
+     * Takes precedence over the chunk mode.
+     */
+    void setOTAPipelinedMode(bool enable = true) {
+      if(enable) {
+        _ota.enableOtaPolicy(OTACloudProcessInterface::PipelinedDownload);
+      } else {
+        _ota.disableOtaPolicy(OTACloudProcessInterface::PipelinedDownload);
+      }
+    }
+
+#if !defined(OFFLOADED_DOWNLOAD)
+    /* The progress of the OTA download is committed to this storage every
+     * AIOT_CONFIG_OTA_CHECKPOINT_INTERVAL bytes, so that a download which has
+     * been interrupted is resumed from there. The boards which resume a download
+     * (STM32H7, Nano RP2040) keep the checkpoint in a file next to the update
+     * file by default, which survives a reboot like the update file does.
+     */
+    void setOTACheckpointStorage(OtaCheckpointStorage & storage) {
+      _ota.setCheckpointStorage(&storage);
+    }
+#endif
+
+    /* The SHA256 of the sketch is reported to the cloud at every boot. When it
+     * is cached in this storage the whole sketch is hashed only on the first
+     * boot after it has been flashed, use a storage which survives a reboot.
+     * The cache is keyed on the build id of the sketch, only ESP32 provides one
+     * and keeps the cache in NVS by default. The other boards hash the sketch
+     * at every boot.
+     */
+    void setOTAFirmwareDigestStorage(OtaFirmwareDigestStorage & storage) {
+      _ota.setFirmwareDigestStorage(&storage);
+    }
 #endif
 
   private:
@@ -143,9 +192,17 @@ class ArduinoIoTCloudTCP: public ArduinoIoTCloudClass
     ArduinoIoTAuthenticationMode _authMode;
     String _brokerAddress;
     uint16_t _brokerPort;
-    uint8_t _mqtt_data_buf[MQTT_TRANSMIT_BUFFER_SIZE];
-    int _mqtt_data_len;
-    bool _mqtt_data_request_retransmit;
+    MqttPropertyUplink _property_uplink;
+    MqttOutboundQueue _outbound_queue;
+    OfflineLog _offline_log;
+    OfflineLogRamStorage _offline_log_ram_storage;
+    /* The log is only recorded once the thing has been synchronized */
+    bool _offline_log_armed;
+    unsigned long _offline_log_time;
+    unsigned long _offline_log_millis;
+    MqttReceiveBuffer<AIOT_CONFIG_MQTT_RX_BUFFER_SIZE> _mqtt_rx_buffer;
+    /* Reused for every incoming property update, it embeds the arena staging the decoded records */
+    CBORDecoder _decoder;
     bool _enable_watchdog;
     bool _auto_reconnect;
 
@@ -163,10 +220,8 @@ class ArduinoIoTCloudTCP: public ArduinoIoTCloudClass
     TLSClientMqtt _brokerClient;
     MqttClient _mqttClient;
 
-    String _messageTopicOut;
-    String _messageTopicIn;
-    String _dataTopicOut;
-    String _dataTopicIn;
+    MqttTopics _topics;
+    MqttDispatcher _dispatcher;
 
 #if OTA_ENABLED
     TLSClientOta _otaClient;
@@ -174,12 +229,6 @@ class ArduinoIoTCloudTCP: public ArduinoIoTCloudClass
     onOTARequestCallbackFunc _get_ota_confirmation;
 #endif /* OTA_ENABLED */
 
-    inline String getTopic_messageout() { return String("/a/d/" + getDeviceId() + "/c/up");}
-    inline String getTopic_messagein () { return String("/a/d/" + getDeviceId() + "/c/dw");}
-
-    inline String getTopic_dataout  () { return ( getThingId().length() == 0) ? String("") : String("/a/t/" + getThingId() + "/e/o"); }
-    inline String getTopic_datain   () { return ( getThingId().length() == 0) ? String("") : String("/a/t/" + getThingId() + "/e/i"); }
-
     State handle_ConfigPhy();
     State handle_UpdatePhy();
     State handle_Init();
@@ -191,12 +240,22 @@ class ArduinoIoTCloudTCP: public ArduinoIoTCloudClass
 
     static void onMessage(int length);
     void handleMessage(int length);
+    void handlePropertyUpdate(int length);
+    void handleCommand(int length);
+    void streamLastValuesUpdate(size_t const payload_offset, size_t const payload_length);
+    void handleThingUpdateCmd(Command * command);
+    void handleThingDetachCmd(Command * command);
+    void handleLastValuesUpdateCmd(Command * command);
     void sendMessage(Message * msg);
-    void sendPropertyContainerToCloud(String const topic, PropertyContainer & property_container, unsigned int & current_property_index);
+    void sendPropertyContainerToCloud(char const * topic, PropertyContainer & property_container, unsigned int & current_property_index);
+    bool transmitOutboundQueue(char const * topic);
+    void armOfflineLog();
+    void recordOfflineLog();
+    void replayOfflineLog();
 
     void attachThing(String thingId);
     void detachThing();
-    int write(String const topic, byte const data[], int const length);
+    int write(char const * topic, byte const data[], int const length, uint8_t const qos = 0, bool const dup = false);
 
 };
 
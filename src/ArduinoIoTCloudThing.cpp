@@ -21,6 +21,7 @@
 #include "interfaces/CloudProcess.h"
 #include "property/types/CloudWrapperInt.h"
 #include "property/types/CloudWrapperUnsignedInt.h"
+#include "property/CloudWrapperPool.h"
 
 /******************************************************************************
   CTOR/DTOR
@@ -44,13 +45,13 @@ _utcOffsetExpireTimeProperty(nullptr) {
 void ArduinoCloudThing::begin() {
   Property* property;
 
-  property = new CloudWrapperInt(_utcOffset);
+  property = CloudWrapperPool::create<CloudWrapperInt>(_utcOffset);
   _utcOffsetProperty = &addPropertyToContainer(getPropertyContainer(),
                                                *property,
                                                "tz_offset",
                                                Permission::ReadWrite, -1);
   _utcOffsetProperty->writeOnDemand();
-  property = new CloudWrapperUnsignedInt(_utcOffsetExpireTime);
+  property = CloudWrapperPool::create<CloudWrapperUnsignedInt>(_utcOffsetExpireTime);
   _utcOffsetExpireTimeProperty = &addPropertyToContainer(getPropertyContainer(),
                                                          *property,
                                                          "tz_dst_until",
@@ -33,6 +33,8 @@ public:
 
   virtual void begin();
   virtual int connected();
+  /* The last values have been received and property updates are published */
+  inline bool synced() const { return _state == State::Connected; }
 
   inline PropertyContainer &getPropertyContainer() {
     return _propertyContainer;
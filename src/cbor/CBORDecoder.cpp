@@ -19,28 +19,324 @@
 #include <algorithm>
 
 #include "CBORDecoder.h"
+#include "../utility/memory/HeapStats.h"
+
+/******************************************************************************
+  CTOR/DTOR
+ ******************************************************************************/
+
+CBORDecoder::CBORDecoder(PropertyContainer & property_container, bool const isSyncMessage)
+: _property_container{&property_container}
+, _is_sync_message{isSyncMessage}
+, _status{Status::InProgress}
+, _stream_state{StreamState::ArrayHeader}
+, _array_indefinite{false}
+, _records_remaining{0}
+, _head_length{0}
+, _head_expected{0}
+, _skip_remaining{0}
+, _nesting_depth{0}
+, _current_property{nullptr}
+, _has_current_property{false}
+, _current_property_base_time{0}
+, _current_property_time{0}
+, _has_current_property_time{false}
+{
+
+}
 
 /******************************************************************************
   PUBLIC MEMBER FUNCTIONS
  ******************************************************************************/
 
+void CBORDecoder::begin(PropertyContainer & property_container, bool const isSyncMessage)
+{
+  _property_container = &property_container;
+  _is_sync_message = isSyncMessage;
+  _status = Status::InProgress;
+  _stream_state = StreamState::ArrayHeader;
+  _array_indefinite = false;
+  _records_remaining = 0;
+  _head_expected = 0;
+  resetScanner();
+  _record_buffer.clear();
+  _map_data_list.clear();
+  _arena.reset();
+  _current_property = nullptr;
+  _has_current_property = false;
+  _base_time.reset();
+  _base_value.reset();
+  _time.reset();
+  _current_property_base_time = 0;
+  _current_property_time = 0;
+  _has_current_property_time = false;
+}
+
+CBORDecoder::Status CBORDecoder::feed(uint8_t const * const data, size_t const length)
+{
+  AIOT_HEAP_STATS_SCOPE(Cbor);
+
+  size_t pos = 0;
+  /* A record which is already in progress continues at the beginning of this fragment */
+  size_t record_start = 0;
+
+  while (_status == Status::InProgress && pos < length) {
+
+    switch (_stream_state) {
+      case StreamState::ArrayHeader:
+      {
+        ScanResult const res = readHead(data, length, pos);
+        if (res == ScanResult::Error || (res == ScanResult::ItemComplete && (_head[0] >> 5) != 4)) {
+          _status = Status::Error;
+        } else if (res == ScanResult::ItemComplete) {
+          _array_indefinite  = ((_head[0] & 0x1F) == 31);
+          _records_remaining = _array_indefinite ? 0 : headArgument();
+          _stream_state = StreamState::RecordStart;
+          if (!_array_indefinite && _records_remaining == 0) {
+            finish();
+          }
+        }
+      }
+      break;
+
+      case StreamState::RecordStart:
+      {
+        if (_array_indefinite && data[pos] == 0xFF) {
+          pos++;
+          finish();
+        } else {
+          record_start = pos;
+          _record_buffer.clear();
+          resetScanner();
+          _stream_state = StreamState::Record;
+        }
+      }
+      break;
+
+      case StreamState::Record:
+      {
+        ScanResult const res = scanRecord(data, length, pos);
+        if (res == ScanResult::Error) {
+          _status = Status::Error;
+        } else if (res == ScanResult::NeedMoreData) {
+          /* Keep the first part of the record until the rest of it arrives */
+          _record_buffer.insert(_record_buffer.end(), data + record_start, data + length);
+        } else {
+          bool record_ok = false;
+          if (_record_buffer.empty()) {
+            /* The whole record is contained in this fragment, decode it in place */
+            record_ok = decodeRecord(data + record_start, pos - record_start);
+          } else {
+            _record_buffer.insert(_record_buffer.end(), data + record_start, data + pos);
+            record_ok = decodeRecord(_record_buffer.data(), _record_buffer.size());
+            _record_buffer.clear();
+          }
+
+          if (!record_ok) {
+            _status = Status::Error;
+          } else {
+            _stream_state = StreamState::RecordStart;
+            if (!_array_indefinite && --_records_remaining == 0) {
+              finish();
+            }
+          }
+        }
+      }
+      break;
+    }
+  }
+
+  if (_status != Status::InProgress) {
+    /* Do not hold on to the heap between payloads */
+    std::vector<uint8_t>().swap(_record_buffer);
+  }
+
+  return _status;
+}
+
 void CBORDecoder::decode(PropertyContainer & property_container, uint8_t const * const payload, size_t const length, bool isSyncMessage)
 {
-  CborValue array_iter, map_iter,value_iter;
-  CborParser parser;
-  CborMapData map_data;
-  std::list<CborMapData> map_data_list; /* List of map data that will hold all the attributes of a property */
-  String current_property_name; /* Current property name during decoding: use to look for a new property in the senml value array */
-  unsigned long current_property_base_time{0}, current_property_time{0};
+  /* Keep the decoder and its arena off the stack of the caller. The container
+   * passed to the constructor is only used by the first call, begin() binds
+   * the decoder to the container of every call.
+   */
+  static CBORDecoder decoder(property_container);
+  decoder.begin(property_container, isSyncMessage);
+  decoder.feed(payload, length);
+}
+
+bool CBORDecoder::findCommandPayload(uint8_t const * const header, size_t const length, uint64_t const tag, size_t & payload_offset, size_t & payload_length)
+{
+  size_t pos = 0;
+  uint8_t major_type = 0;
+  uint64_t argument = 0;
+
+  /* Tag of the command */
+  if (!readItemHead(header, length, pos, major_type, argument) || major_type != 6 || argument != tag) {
+    return false;
+  }
+  /* Non empty array of parameters */
+  if (!readItemHead(header, length, pos, major_type, argument) || major_type != 4 || argument == 0) {
+    return false;
+  }
+  /* First parameter: byte string wrapping the SenML payload */
+  if (!readItemHead(header, length, pos, major_type, argument) || major_type != 2 || static_cast<uint64_t>(static_cast<size_t>(argument)) != argument) {
+    return false;
+  }
+
+  payload_offset = pos;
+  payload_length = static_cast<size_t>(argument);
+  return true;
+}
+
+/******************************************************************************
+  PRIVATE MEMBER FUNCTIONS
+ ******************************************************************************/
+
+CBORDecoder::ScanResult CBORDecoder::readHead(uint8_t const * const data, size_t const length, size_t & pos) {
+  while (pos < length) {
+    uint8_t const b = data[pos++];
+
+    if (_head_length == 0) {
+      uint8_t const additional_info = b & 0x1F;
+      if (additional_info < 24 || additional_info == 31) {
+        _head_expected = 1;
+      } else if (additional_info <= 27) {
+        _head_expected = 1 + (1 << (additional_info - 24));
+      } else {
+        return ScanResult::Error;
+      }
+    }
+
+    _head[_head_length++] = b;
+
+    if (_head_length == _head_expected) {
+      _head_length = 0;
+      return ScanResult::ItemComplete;
+    }
+  }
+
+  return ScanResult::NeedMoreData;
+}
+
+uint64_t CBORDecoder::headArgument() const {
+  uint8_t const additional_info = _head[0] & 0x1F;
+  if (additional_info < 24) {
+    return additional_info;
+  }
+
+  uint64_t arg = 0;
+  for (uint8_t i = 1; i < _head_expected; i++) {
+    arg = (arg << 8) | _head[i];
+  }
+  return arg;
+}
+
+void CBORDecoder::resetScanner() {
+  _head_length = 0;
+  _skip_remaining = 0;
+  _nesting_depth = 0;
+}
+
+CBORDecoder::ScanResult CBORDecoder::scanRecord(uint8_t const * const data, size_t const length, size_t & pos) {
+  while (pos < length) {
+
+    /* Skip over string payloads in bulk */
+    if (_skip_remaining > 0) {
+      size_t const available = length - pos;
+      size_t const skip = (_skip_remaining < available) ? static_cast<size_t>(_skip_remaining) : available;
+      pos += skip;
+      _skip_remaining -= skip;
+      if (_skip_remaining == 0 && itemDone()) {
+        return ScanResult::ItemComplete;
+      }
+      continue;
+    }
+
+    ScanResult const res = readHead(data, length, pos);
+    if (res != ScanResult::ItemComplete) {
+      return res;
+    }
+
+    uint8_t const major_type = _head[0] >> 5;
+    bool item_complete = false;
 
-  if (cbor_parser_init(payload, length, 0, &parser, &array_iter) != CborNoError)
-    return;
+    if ((_head[0] & 0x1F) == 31) {
+      if (major_type == 7) {
+        /* Break: closes the innermost indefinite length item */
+        if (_nesting_depth == 0 || !_nesting[_nesting_depth - 1].indefinite) {
+          return ScanResult::Error;
+        }
+        _nesting_depth--;
+        item_complete = itemDone();
+      } else if (major_type >= 2 && major_type <= 5) {
+        if (_nesting_depth == MAX_NESTING_DEPTH) {
+          return ScanResult::Error;
+        }
+        _nesting[_nesting_depth++] = NestingLevel{0, true};
+      } else {
+        return ScanResult::Error;
+      }
+    } else {
+      uint64_t const arg = headArgument();
+      switch (major_type) {
+        case 2: /* byte string */
+        case 3: /* text string */
+          if (arg == 0) {
+            item_complete = itemDone();
+          } else {
+            _skip_remaining = arg;
+          }
+          break;
+        case 4: /* array */
+        case 5: /* map */
+        case 6: /* tag, followed by the tagged item */
+          if (major_type == 6 || arg > 0) {
+            if (_nesting_depth == MAX_NESTING_DEPTH) {
+              return ScanResult::Error;
+            }
+            uint64_t const items = (major_type == 6) ? 1 : ((major_type == 5) ? 2 * arg : arg);
+            _nesting[_nesting_depth++] = NestingLevel{items, false};
+          } else {
+            item_complete = itemDone();
+          }
+          break;
+        default: /* integers and simple values */
+          item_complete = itemDone();
+          break;
+      }
+    }
 
-  if (array_iter.type != CborArrayType)
-    return;
+    if (item_complete) {
+      return ScanResult::ItemComplete;
+    }
+  }
 
-  if (cbor_value_enter_container(&array_iter, &map_iter) != CborNoError)
-    return;
+  return ScanResult::NeedMoreData;
+}
+
+bool CBORDecoder::itemDone() {
+  /* Account the completed item to the enclosing containers, returns true once the outermost item is complete */
+  while (_nesting_depth > 0) {
+    NestingLevel & level = _nesting[_nesting_depth - 1];
+    if (level.indefinite || --level.remaining > 0) {
+      return false;
+    }
+    _nesting_depth--;
+  }
+  return true;
+}
+
+bool CBORDecoder::decodeRecord(uint8_t const * const record, size_t const length) {
+  CborValue map_iter, value_iter;
+  CborParser parser;
+  RecordData record_data;
+  record_data.has_name = false;
+  record_data.property = nullptr;
+  record_data.attribute_name = "";
+
+  if (cbor_parser_init(record, length, 0, &parser, &map_iter) != CborNoError)
+    return false;
 
   MapParserState current_state = MapParserState::EnterMap,
                  next_state = MapParserState::Error;
@@ -51,26 +347,68 @@ void CBORDecoder::decode(PropertyContainer & property_container, uint8_t const *
       case MapParserState::EnterMap     : next_state = handle_EnterMap(&map_iter, &value_iter); break;
       case MapParserState::MapKey       : next_state = handle_MapKey(&value_iter); break;
       case MapParserState::UndefinedKey : next_state = handle_UndefinedKey(&value_iter); break;
-      case MapParserState::BaseVersion  : next_state = handle_BaseVersion(&value_iter, map_data); break;
-      case MapParserState::BaseName     : next_state = handle_BaseName(&value_iter, map_data); break;
-      case MapParserState::BaseTime     : next_state = handle_BaseTime(&value_iter, map_data); break;
-      case MapParserState::Time         : next_state = handle_Time(&value_iter, map_data); break;
-      case MapParserState::Name         : next_state = handle_Name(&value_iter, map_data, property_container); break;
-      case MapParserState::Value        : next_state = handle_Value(&value_iter, map_data); break;
-      case MapParserState::StringValue  : next_state = handle_StringValue(&value_iter, map_data); break;
-      case MapParserState::BooleanValue : next_state = handle_BooleanValue(&value_iter, map_data); break;
-      case MapParserState::LeaveMap     : next_state = handle_LeaveMap(&map_iter, &value_iter, map_data, property_container, current_property_name, current_property_base_time, current_property_time, isSyncMessage, map_data_list); break;
+      case MapParserState::BaseVersion  : next_state = handle_BaseVersion(&value_iter); break;
+      case MapParserState::BaseName     : next_state = handle_BaseName(&value_iter); break;
+      case MapParserState::BaseTime     : next_state = handle_BaseTime(&value_iter); break;
+      case MapParserState::BaseValue    : next_state = handle_BaseValue(&value_iter); break;
+      case MapParserState::Time         : next_state = handle_Time(&value_iter); break;
+      case MapParserState::Name         : next_state = handle_Name(&value_iter, record_data); break;
+      case MapParserState::Value        : next_state = handle_Value(&value_iter, record_data.map_data); break;
+      case MapParserState::StringValue  : next_state = handle_StringValue(&value_iter, record_data); break;
+      case MapParserState::BooleanValue : next_state = handle_BooleanValue(&value_iter, record_data.map_data); break;
+      case MapParserState::LeaveMap     : next_state = handle_LeaveMap(&map_iter, &value_iter, record_data); break;
       case MapParserState::Complete     : /* Nothing to do */ break;
-      case MapParserState::Error        : return; break;
+      case MapParserState::Error        : return false; break;
     }
 
     current_state = next_state;
   }
+
+  return true;
 }
 
-/******************************************************************************
-  PRIVATE MEMBER FUNCTIONS
- ******************************************************************************/
+void CBORDecoder::applyPropertyUpdate() {
+  /* Update the property containers depending on the parsed data */
+  updateProperty(_current_property, _current_property_base_time + _current_property_time, _is_sync_message, &_map_data_list);
+  /* Release the staged records */
+  _map_data_list.clear();
+  _arena.reset();
+}
+
+void CBORDecoder::finish() {
+  applyPropertyUpdate();
+  _status = Status::Complete;
+}
+
+char const * CBORDecoder::copyString(CborValue const * value_iter, CborValue * next) {
+  size_t len = 0;
+  if (cbor_value_calculate_string_length(value_iter, &len) != CborNoError)
+    return nullptr;
+
+  char * str = static_cast<char *>(_arena.allocate(len + 1, 1));
+  if (!str)
+    return nullptr;
+
+  size_t buflen = len + 1;
+  if (cbor_value_copy_text_string(value_iter, str, &buflen, next) != CborNoError)
+    return nullptr;
+
+  return str;
+}
+
+bool CBORDecoder::copyName(RecordData & record, CborValue * next) {
+  // the name of the property to be updated is in the form [property_name]:[attribute_name]
+  CborValue const name_view = record.name_view.get();
+  char const * name = copyString(&name_view, next);
+  if (!name)
+    return false;
+
+  char const * colon = strchr(name, ':');
+  size_t const property_name_length = colon ? static_cast<size_t>(colon - name) : strlen(name);
+  record.property = _property_container->find(name, property_name_length);
+  record.attribute_name = colon ? colon + 1 : "";
+  return true;
+}
 
 CBORDecoder::MapParserState CBORDecoder::handle_EnterMap(CborValue * map_iter, CborValue * value_iter) {
   MapParserState next_state = MapParserState::Error;
@@ -105,6 +443,8 @@ CBORDecoder::MapParserState CBORDecoder::handle_MapKey(CborValue * value_iter) {
           next_state = MapParserState::BaseName;
         } else if (val == static_cast<int>(CborIntegerMapKey::BaseTime)) {
           next_state = MapParserState::BaseTime;
+        } else if (val == static_cast<int>(CborIntegerMapKey::BaseValue)) {
+          next_state = MapParserState::BaseValue;
         } else if (val == static_cast<int>(CborIntegerMapKey::Value)) {
           next_state = MapParserState::Value;
         } else if (val == static_cast<int>(CborIntegerMapKey::StringValue)) {
@@ -133,32 +473,23 @@ CBORDecoder::MapParserState CBORDecoder::handle_UndefinedKey(CborValue * value_i
   return next_state;
 }
 
-CBORDecoder::MapParserState CBORDecoder::handle_BaseVersion(CborValue * value_iter, CborMapData & map_data) {
+CBORDecoder::MapParserState CBORDecoder::handle_BaseVersion(CborValue * value_iter) {
   MapParserState next_state = MapParserState::Error;
 
   if (cbor_value_is_integer(value_iter)) {
-    int val = 0;
-    if (cbor_value_get_int(value_iter, &val) == CborNoError) {
-      map_data.base_version.set(val);
-
-      if (cbor_value_advance(value_iter) == CborNoError) {
-        next_state = MapParserState::MapKey;
-      }
+    if (cbor_value_advance(value_iter) == CborNoError) {
+      next_state = MapParserState::MapKey;
     }
   }
 
   return next_state;
 }
 
-CBORDecoder::MapParserState CBORDecoder::handle_BaseName(CborValue * value_iter, CborMapData & map_data) {
+CBORDecoder::MapParserState CBORDecoder::handle_BaseName(CborValue * value_iter) {
   MapParserState next_state = MapParserState::Error;
 
   if (cbor_value_is_text_string(value_iter)) {
-    char * val      = 0;
-    size_t val_size = 0;
-    if (cbor_value_dup_text_string(value_iter, &val, &val_size, value_iter) == CborNoError) {
-      map_data.base_name.set(String(val));
-      free(val);
+    if (cbor_value_advance(value_iter) == CborNoError) {
       next_state = MapParserState::MapKey;
     }
   }
@@ -166,12 +497,12 @@ CBORDecoder::MapParserState CBORDecoder::handle_BaseName(CborValue * value_iter,
   return next_state;
 }
 
-CBORDecoder::MapParserState CBORDecoder::handle_BaseTime(CborValue * value_iter, CborMapData & map_data) {
+CBORDecoder::MapParserState CBORDecoder::handle_BaseTime(CborValue * value_iter) {
   MapParserState next_state = MapParserState::Error;
 
   double val = 0.0;
   if (ifNumericConvertToDouble(value_iter, &val)) {
-    map_data.base_time.set(val);
+    _base_time.set(val);
 
     if (cbor_value_advance(value_iter) == CborNoError) {
       next_state = MapParserState::MapKey;
@@ -181,36 +512,39 @@ CBORDecoder::MapParserState CBORDecoder::handle_BaseTime(CborValue * value_iter,
   return next_state;
 }
 
-CBORDecoder::MapParserState CBORDecoder::handle_Name(CborValue * value_iter, CborMapData & map_data, PropertyContainer & property_container) {
+CBORDecoder::MapParserState CBORDecoder::handle_BaseValue(CborValue * value_iter) {
+  MapParserState next_state = MapParserState::Error;
+
+  double val = 0.0;
+  if (ifNumericConvertToDouble(value_iter, &val)) {
+    _base_value.set(val);
+
+    if (cbor_value_advance(value_iter) == CborNoError) {
+      next_state = MapParserState::MapKey;
+    }
+  }
+
+  return next_state;
+}
+
+CBORDecoder::MapParserState CBORDecoder::handle_Name(CborValue * value_iter, RecordData & record) {
   MapParserState next_state = MapParserState::Error;
 
   if (cbor_value_is_text_string(value_iter)) {
     // if the value in the cbor message is a string, it corresponds to the name of the property to be updated (int the form [property_name]:[attribute_name])
-    char * val      = nullptr;
-    size_t val_size = 0;
-    if (cbor_value_dup_text_string(value_iter, &val, &val_size, value_iter) == CborNoError) {
-      String name = val;
-      free(val);
-      map_data.name.set(name);
-      int colonPos = name.indexOf(":");
-      String attribute_name = "";
-      if (colonPos != -1) {
-        attribute_name = name.substring(colonPos + 1);
-      }
-      map_data.attribute_name.set(attribute_name);
+    record.name_view.set(*value_iter);
+    if (copyName(record, value_iter)) {
+      record.has_name = true;
       next_state = MapParserState::MapKey;
     }
   } else if (cbor_value_is_integer(value_iter)) {
     // if the value in the cbor message is an integer, a light payload has been used and an integer identifier should be decode in order to retrieve the corresponding property and attribute name to be updated
     int val = 0;
     if (cbor_value_get_int(value_iter, &val) == CborNoError) {
-      map_data.light_payload.set(true);
-      map_data.name_identifier.set(val & 255);
-      map_data.attribute_identifier.set(val >> 8);
-      map_data.light_payload.set(true);
-      String name = getPropertyNameByIdentifier(property_container, val);
-      map_data.name.set(name);
-
+      record.map_data.light_payload.set(true);
+      record.map_data.attribute_identifier.set(val >> 8);
+      record.property = _property_container->find((val > 255) ? (val & 255) : val);
+      record.has_name = true;
 
       if (cbor_value_advance(value_iter) == CborNoError) {
         next_state = MapParserState::MapKey;
@@ -218,8 +552,6 @@ CBORDecoder::MapParserState CBORDecoder::handle_Name(CborValue * value_iter, Cbo
     }
   }
 
-
-
   return next_state;
 }
 
@@ -228,7 +560,8 @@ CBORDecoder::MapParserState CBORDecoder::handle_Value(CborValue * value_iter, Cb
 
   double val = 0.0;
   if (ifNumericConvertToDouble(value_iter, &val)) {
-    map_data.val.set(val);
+    /* The value of a record is relative to the base value of the pack */
+    map_data.val.set(_base_value.isSet() ? (_base_value.get() + val) : val);
 
     if (cbor_value_advance(value_iter) == CborNoError) {
       next_state = MapParserState::MapKey;
@@ -238,15 +571,13 @@ CBORDecoder::MapParserState CBORDecoder::handle_Value(CborValue * value_iter, Cb
   return next_state;
 }
 
-CBORDecoder::MapParserState CBORDecoder::handle_StringValue(CborValue * value_iter, CborMapData & map_data) {
+CBORDecoder::MapParserState CBORDecoder::handle_StringValue(CborValue * value_iter, RecordData & record) {
   MapParserState next_state = MapParserState::Error;
 
   if (cbor_value_is_text_string(value_iter)) {
-    char * val      = 0;
-    size_t val_size = 0;
-    if (cbor_value_dup_text_string(value_iter, &val, &val_size, value_iter) == CborNoError) {
-      map_data.str_val.set(String(val));
-      free(val);
+    /* The string is copied into the arena once the record is staged */
+    record.str_val_view.set(*value_iter);
+    if (cbor_value_advance(value_iter) == CborNoError) {
       next_state = MapParserState::MapKey;
     }
   }
@@ -269,12 +600,12 @@ CBORDecoder::MapParserState CBORDecoder::handle_BooleanValue(CborValue * value_i
   return next_state;
 }
 
-CBORDecoder::MapParserState CBORDecoder::handle_Time(CborValue * value_iter, CborMapData & map_data) {
+CBORDecoder::MapParserState CBORDecoder::handle_Time(CborValue * value_iter) {
   MapParserState next_state = MapParserState::Error;
 
   double val = 0.0;
   if (ifNumericConvertToDouble(value_iter, &val)) {
-    map_data.time.set(val);
+    _time.set(val);
 
     if (cbor_value_advance(value_iter) == CborNoError) {
       next_state = MapParserState::MapKey;
@@ -284,47 +615,56 @@ CBORDecoder::MapParserState CBORDecoder::handle_Time(CborValue * value_iter, Cbo
   return next_state;
 }
 
-CBORDecoder::MapParserState CBORDecoder::handle_LeaveMap(CborValue * map_iter, CborValue * value_iter, CborMapData & map_data, PropertyContainer & property_container, String & current_property_name, unsigned long & current_property_base_time, unsigned long & current_property_time, bool const is_sync_message, std::list<CborMapData> & map_data_list) {
+CBORDecoder::MapParserState CBORDecoder::handle_LeaveMap(CborValue * map_iter, CborValue * value_iter, RecordData & record) {
   MapParserState next_state = MapParserState::Error;
-  if (map_data.name.isSet()) {
-    String propertyName;
-    int colonPos = map_data.name.get().indexOf(":");
-    if (colonPos != -1) {
-      propertyName = map_data.name.get().substring(0, colonPos);
-    } else {
-      propertyName = map_data.name.get();
-    }
-
-    if (current_property_name != "" && propertyName != current_property_name) {
-      /* Update the property containers depending on the parsed data */
-      updateProperty(property_container, current_property_name, current_property_base_time + current_property_time, is_sync_message, &map_data_list);
+  if (record.has_name) {
+    if (_has_current_property && record.property != _current_property) {
+      applyPropertyUpdate();
       /* Reset current property data */
-      map_data_list.clear();
-      current_property_base_time = 0;
-      current_property_time = 0;
+      _current_property_base_time = 0;
+      _current_property_time = 0;
+      _has_current_property_time = false;
+      /* The arena has been released, the attribute name needs to be copied again */
+      if (record.name_view.isSet()) {
+        CborValue name_end;
+        if (!copyName(record, &name_end)) {
+          return MapParserState::Error;
+        }
+      }
     }
     /* Compute the cloud change event baseTime and Time */
-    if (map_data.base_time.isSet()) {
-      current_property_base_time = (unsigned long)(map_data.base_time.get());
+    if (_base_time.isSet()) {
+      _current_property_base_time = (unsigned long)(_base_time.get());
     }
-    if (map_data.time.isSet() && (map_data.time.get() > current_property_time)) {
-      current_property_time = (unsigned long)map_data.time.get();
+    if (_time.isSet() && (!_has_current_property_time || _time.get() > _current_property_time)) {
+      _current_property_time = (long)_time.get();
+      _has_current_property_time = true;
     }
-    map_data_list.push_back(map_data);
-    current_property_name = propertyName;
+
+    /* Stage the record in the arena */
+    CborMapData * map_data = _arena.create<CborMapData>();
+    if (!map_data) {
+      return MapParserState::Error;
+    }
+    *map_data = record.map_data;
+    map_data->attribute_name.set(record.attribute_name);
+    if (record.str_val_view.isSet()) {
+      CborValue str_val = record.str_val_view.get(), str_end;
+      char const * str = copyString(&str_val, &str_end);
+      if (!str) {
+        return MapParserState::Error;
+      }
+      map_data->str_val.set(str);
+    }
+    _map_data_list.push_back(map_data);
+
+    _current_property = record.property;
+    _has_current_property = true;
   }
 
-  /* Transition into the next map if available, otherwise finish */
+  /* The record is complete, the next one is handled by the stream state machine */
   if (cbor_value_leave_container(map_iter, value_iter) == CborNoError) {
-    if (!cbor_value_at_end(map_iter)) {
-      next_state = MapParserState::EnterMap;
-    } else {
-      /* Update the property containers depending on the parsed data */
-      updateProperty(property_container, current_property_name, current_property_base_time + current_property_time, is_sync_message, &map_data_list);
-      /* Reset last property data */
-      map_data_list.clear();
-      next_state = MapParserState::Complete;
-    }
+    next_state = MapParserState::Complete;
   }
 
   return next_state;
@@ -375,3 +715,33 @@ double CBORDecoder::convertCborHalfFloatToDouble(uint16_t const half_val) {
   }
   return half_val & 0x8000 ? -val : val;
 }
+
+bool CBORDecoder::readItemHead(uint8_t const * const data, size_t const length, size_t & pos, uint8_t & major_type, uint64_t & argument) {
+  if (pos >= length) {
+    return false;
+  }
+
+  uint8_t const initial_byte = data[pos++];
+  uint8_t const additional_info = initial_byte & 0x1F;
+  major_type = initial_byte >> 5;
+
+  if (additional_info < 24) {
+    argument = additional_info;
+    return true;
+  }
+  /* Indefinite length items and reserved values */
+  if (additional_info > 27) {
+    return false;
+  }
+
+  size_t const argument_length = 1 << (additional_info - 24);
+  if (length - pos < argument_length) {
+    return false;
+  }
+
+  argument = 0;
+  for (size_t i = 0; i < argument_length; i++) {
+    argument = (argument << 8) | data[pos++];
+  }
+  return true;
+}
@@ -19,9 +19,11 @@
 
 #undef max
 #undef min
-#include <list>
+#include <vector>
 
+#include "../AIoTC_Config.h"
 #include "../property/PropertyContainer.h"
+#include "../utility/memory/BumpArena.h"
 
 /******************************************************************************
   CLASS DECLARATION
@@ -32,14 +34,51 @@ class CBORDecoder
 
 public:
 
-  /* decode a CBOR payload received from the cloud */
+  enum class Status {
+    InProgress,
+    Complete,
+    Error
+  };
+
+  CBORDecoder(PropertyContainer & property_container, bool const isSyncMessage = false);
+
+  /* Prepare the decoder for the next payload. The decoder embeds the arena
+   * staging the decoded records, long lived instances are reused this way
+   * instead of placing a new decoder on the stack for every payload.
+   */
+  void begin(PropertyContainer & property_container, bool const isSyncMessage = false);
+
+  /* push a fragment of a CBOR payload received from the cloud into the decoder,
+   * fragments can be split at any byte boundary. The records of a property are
+   * staged until a record of another property follows, the update of the staged
+   * property is then applied. The update of the last property is applied once
+   * the end of the SenML array has been decoded.
+   */
+  Status feed(uint8_t const * const data, size_t const length);
+  inline Status status() const { return _status; }
+
+  /* decode a CBOR payload received from the cloud into the given container, not
+   * reentrant. The decoder is shared between calls and bound to the container
+   * of each call by begin().
+   */
   static void decode(PropertyContainer & property_container, uint8_t const * const payload, size_t const length, bool isSyncMessage = false);
 
+  static double convertCborHalfFloatToDouble(uint16_t const half_val);
+
+  /* Commands carrying a SenML payload are encoded as tag(array[byte string, ...]).
+   * Locate the byte string within the first bytes of such a command, so that
+   * the SenML payload can be fed to the decoder while it is being received
+   * instead of buffering the whole command. Returns false if the header does
+   * not belong to a command with the given tag or the byte string does not
+   * have a definite length.
+   */
+  static size_t const COMMAND_HEADER_MAX_LENGTH = 19; /* tag, array and byte string heads */
+  static bool findCommandPayload(uint8_t const * const header, size_t const length, uint64_t const tag, size_t & payload_offset, size_t & payload_length);
+
 
 private:
 
-  CBORDecoder() { }
-  CBORDecoder(CBORDecoder const &) { }
+  CBORDecoder(CBORDecoder const &) = delete;
 
   enum class MapParserState {
     EnterMap,
@@ -48,6 +87,7 @@ private:
     BaseVersion,
     BaseName,
     BaseTime,
+    BaseValue,
     Name,
     Value,
     StringValue,
@@ -58,21 +98,95 @@ private:
     Error
   };
 
+  enum class StreamState {
+    ArrayHeader,
+    RecordStart,
+    Record
+  };
+
+  /* Byte level scanner keeping track of nested CBOR items, used to detect the
+   * end of a SenML record without requiring the whole record to be available.
+   */
+  enum class ScanResult {
+    NeedMoreData,
+    ItemComplete,
+    Error
+  };
+
+  static size_t const MAX_NESTING_DEPTH = 8;
+
+  struct NestingLevel {
+    uint64_t remaining;
+    bool     indefinite;
+  };
+
+  PropertyContainer * _property_container;
+  bool _is_sync_message;
+  Status _status;
+  StreamState _stream_state;
+  bool _array_indefinite;
+  uint64_t _records_remaining;
+
+  uint8_t _head[9];
+  uint8_t _head_length;
+  uint8_t _head_expected;
+  uint64_t _skip_remaining;
+  NestingLevel _nesting[MAX_NESTING_DEPTH];
+  size_t _nesting_depth;
+
+  std::vector<uint8_t> _record_buffer; /* Bytes of a record which is split across fragments */
+
+  /* Record which is currently being parsed, strings are kept as views into the record bytes */
+  struct RecordData {
+    CborMapData         map_data;
+    bool                has_name;
+    Property *          property;
+    MapEntry<CborValue> name_view;
+    char const *        attribute_name;
+    MapEntry<CborValue> str_val_view;
+  };
+
+  /* The records of the current property are staged in the arena, which is
+   * released every time the property updates have been applied.
+   */
+  BumpArena<AIOT_CONFIG_CBOR_DECODER_ARENA_SIZE> _arena;
+  CborMapDataList _map_data_list;
+  Property * _current_property;
+  bool _has_current_property;
+  MapEntry<double> _base_time, _base_value, _time;
+  unsigned long _current_property_base_time;
+  long _current_property_time; /* Relative to the base time, may be negative */
+  bool _has_current_property_time;
+
+  ScanResult readHead(uint8_t const * const data, size_t const length, size_t & pos);
+  uint64_t   headArgument() const;
+  void       resetScanner();
+  ScanResult scanRecord(uint8_t const * const data, size_t const length, size_t & pos);
+  bool       itemDone();
+  bool       decodeRecord(uint8_t const * const record, size_t const length);
+  void       applyPropertyUpdate();
+  void       finish();
+
+  char const * copyString(CborValue const * value_iter, CborValue * next);
+  bool         copyName(RecordData & record, CborValue * next);
+
+  MapParserState handle_BaseTime(CborValue * value_iter);
+  MapParserState handle_BaseValue(CborValue * value_iter);
+  MapParserState handle_Time(CborValue * value_iter);
+  MapParserState handle_Value(CborValue * value_iter, CborMapData & map_data);
+  MapParserState handle_Name(CborValue * value_iter, RecordData & record);
+  MapParserState handle_StringValue(CborValue * value_iter, RecordData & record);
+  MapParserState handle_LeaveMap(CborValue * map_iter, CborValue * value_iter, RecordData & record);
+
   static MapParserState handle_EnterMap(CborValue * map_iter, CborValue * value_iter);
   static MapParserState handle_MapKey(CborValue * value_iter);
   static MapParserState handle_UndefinedKey(CborValue * value_iter);
-  static MapParserState handle_BaseVersion(CborValue * value_iter, CborMapData & map_data);
-  static MapParserState handle_BaseName(CborValue * value_iter, CborMapData & map_data);
-  static MapParserState handle_BaseTime(CborValue * value_iter, CborMapData & map_data);
-  static MapParserState handle_Name(CborValue * value_iter, CborMapData & map_data, PropertyContainer & property_container);
-  static MapParserState handle_Value(CborValue * value_iter, CborMapData & map_data);
-  static MapParserState handle_StringValue(CborValue * value_iter, CborMapData & map_data);
+  static MapParserState handle_BaseVersion(CborValue * value_iter);
+  static MapParserState handle_BaseName(CborValue * value_iter);
   static MapParserState handle_BooleanValue(CborValue * value_iter, CborMapData & map_data);
-  static MapParserState handle_Time(CborValue * value_iter, CborMapData & map_data);
-  static MapParserState handle_LeaveMap(CborValue * map_iter, CborValue * value_iter, CborMapData & map_data, PropertyContainer & property_container, String & current_property_name, unsigned long & current_property_base_time, unsigned long & current_property_time, bool const is_sync_message, std::list<CborMapData> & map_data_list);
 
   static bool   ifNumericConvertToDouble(CborValue * value_iter, double * numeric_val);
-  static double convertCborHalfFloatToDouble(uint16_t const half_val);
+  static bool   readItemHead(uint8_t const * const data, size_t const length, size_t & pos, uint8_t & major_type, uint64_t & argument);
 
 };
 
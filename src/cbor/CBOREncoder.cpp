@@ -18,19 +18,30 @@
 #undef min
 #include <algorithm>
 #include <iterator>
+#include <math.h>
+#include <string.h>
 
 #include <Arduino_TinyCBOR.h>
 
+#include "CBORDecoder.h"
+
+#include "../utility/memory/HeapStats.h"
+
 /******************************************************************************
    PUBLIC MEMBER FUNCTIONS
  ******************************************************************************/
 
-CborError CBOREncoder::encode(PropertyContainer & property_container, uint8_t * data, size_t const size, int & bytes_encoded, unsigned int & current_property_index, bool lightPayload)
+CborError CBOREncoder::encode(PropertyContainer & property_container, uint8_t * data, size_t const size, int & bytes_encoded, unsigned int & current_property_index, bool lightPayload, bool compactPayload, unsigned long const baseTime)
 {
+  AIOT_HEAP_STATS_SCOPE(Cbor);
+
   EncoderState current_state = EncoderState::InitPropertyEncoder,
                next_state = EncoderState::InitPropertyEncoder;
 
   PropertyContainerEncoder propertyEncoder(property_container, current_property_index);
+  propertyEncoder.senml_pack.compact = compactPayload;
+  propertyEncoder.senml_pack.base_time_fixed = (baseTime != 0);
+  propertyEncoder.senml_pack.base_time = baseTime;
 
   while (current_state != EncoderState::SendMessage) {
 
@@ -59,12 +70,71 @@ CborError CBOREncoder::encode(PropertyContainer & property_container, uint8_t *
   return CborNoError;
 }
 
+CborError CBOREncoder::encodeCompactFloat(CborEncoder & encoder, float const value, float const min_delta, long const base_value)
+{
+  double const residual = static_cast<double>(value) - static_cast<double>(base_value);
+
+  uint16_t const half = convertFloatToHalf(static_cast<float>(residual));
+  float const half_decoded = static_cast<float>(base_value + CBORDecoder::convertCborHalfFloatToDouble(half));
+  if ((half_decoded == value) || (fabsf(half_decoded - value) <= min_delta) || (isnan(value) && isnan(half_decoded)))
+    return cbor_encode_half_float(&encoder, &half);
+
+  /* The residual of values far from the base value may need more precision than the value itself */
+  float const single = static_cast<float>(residual);
+  if (static_cast<float>(base_value + static_cast<double>(single)) == value)
+    return cbor_encode_float(&encoder, single);
+
+  return cbor_encode_double(&encoder, residual);
+}
+
+/* Round to nearest even, see IEEE 754 binary16 */
+uint16_t CBOREncoder::convertFloatToHalf(float const value)
+{
+  uint32_t bits = 0;
+  memcpy(&bits, &value, sizeof(bits));
+
+  uint16_t const sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+  int const exp = static_cast<int>((bits >> 23) & 0xff) - 127 + 15;
+  uint32_t mant = bits & 0x7fffff;
+
+  if (((bits >> 23) & 0xff) == 0xff)
+    return sign | 0x7c00 | (mant ? 0x200 : 0);  /* Infinity or NaN */
+  if (exp >= 31)
+    return sign | 0x7c00;                       /* Overflow to infinity */
+
+  uint32_t half = 0;
+  uint32_t rem = 0;
+  uint32_t halfway = 0;
+  if (exp > 0) {
+    half = (static_cast<uint32_t>(exp) << 10) | (mant >> 13);
+    rem = mant & 0x1fff;
+    halfway = 0x1000;
+  } else {
+    /* Subnormal half, the implicit leading bit becomes part of the mantissa */
+    int const shift = 14 - exp;
+    if (shift > 24)
+      return sign;
+    mant |= 0x800000;
+    half = mant >> shift;
+    rem = mant & ((1UL << shift) - 1);
+    halfway = 1UL << (shift - 1);
+  }
+
+  /* A carry out of the mantissa correctly increments the exponent */
+  if (rem > halfway || (rem == halfway && (half & 1)))
+    half++;
+
+  return sign | static_cast<uint16_t>(half);
+}
+
 /******************************************************************************
   PRIVATE MEMBER FUNCTIONS
  ******************************************************************************/
 
 CBOREncoder::EncoderState CBOREncoder::handle_InitPropertyEncoder(PropertyContainerEncoder & propertyEncoder)
 {
+  /* Mark the properties whose publishEvery interval or rate limit has elapsed */
+  propertyEncoder.property_container.processTimers();
   propertyEncoder.encoded_property_count = 0;
   propertyEncoder.checked_property_count = 0;
   propertyEncoder.encoded_property_limit = 0;
@@ -76,6 +146,8 @@ CBOREncoder::EncoderState CBOREncoder::handle_OpenCBORContainer(PropertyContaine
 {
   propertyEncoder.encoded_property_count = 0;
   propertyEncoder.checked_property_count = 0;
+  SenMLPackState const & pack = propertyEncoder.senml_pack;
+  propertyEncoder.senml_pack = SenMLPackState{pack.compact, false, false, 0, pack.base_time_fixed, pack.base_time_fixed, pack.base_time, false, pack.base_time_fixed};
   cbor_encoder_init(&propertyEncoder.encoder, data, size, 0);
   cbor_encoder_create_array(&propertyEncoder.encoder, &propertyEncoder.arrayEncoder, CborIndefiniteLength);
   return EncoderState::TryAppend;
@@ -84,32 +156,47 @@ CBOREncoder::EncoderState CBOREncoder::handle_OpenCBORContainer(PropertyContaine
 CBOREncoder::EncoderState CBOREncoder::handle_TryAppend(PropertyContainerEncoder & propertyEncoder, bool  & lightPayload)
 {
   /* Check if backing storage and cloud has diverged. Time interval may be elapsed or property may be changed
-   * and if that's the case encode the property into the CBOR.
+   * and if that's the case encode the property into the CBOR. Only the properties marked as pending by the
+   * container need to be checked, all the others are known to be in sync with the cloud.
    */
   CborError error = CborNoError;
-  PropertyContainer::iterator iter = propertyEncoder.property_container.begin();
-  std::advance(iter, propertyEncoder.current_property_index);
+  PropertyContainer & property_container = propertyEncoder.property_container;
+  size_t const first_index = propertyEncoder.current_property_index;
+  size_t const last_index = property_container.size();
+  size_t index = property_container.nextPending(first_index);
 
-  for(; iter != propertyEncoder.property_container.end(); iter++)
+  for(; index < last_index; index = property_container.nextPending(index + 1))
   {
-    Property * p = * iter;
+    Property * p = property_container[index];
 
     if (p->shouldBeUpdated() && p->isReadableByCloud())
     {
-      error = p->append(&propertyEncoder.arrayEncoder, lightPayload);
+      error = p->append(&propertyEncoder.arrayEncoder, lightPayload, &propertyEncoder.senml_pack);
       if(error == CborNoError)
         propertyEncoder.encoded_property_count++;
     }
-    if(error == CborNoError)
-      propertyEncoder.checked_property_count++;
+    else
+    {
+      property_container.settle(index);
+    }
+
+    if(error != CborNoError)
+    {
+      propertyEncoder.checked_property_count = index - first_index;
+      break;
+    }
+    propertyEncoder.checked_property_count = index - first_index + 1;
 
     bool const maximum_number_of_properties_reached = (propertyEncoder.encoded_property_count >= propertyEncoder.encoded_property_limit) && (propertyEncoder.property_limit_active == true);
-    bool const cbor_encoder_error = (error != CborNoError);
 
-    if (maximum_number_of_properties_reached || cbor_encoder_error)
+    if (maximum_number_of_properties_reached)
       break;
   }
 
+  /* All the remaining properties have been checked */
+  if (index >= last_index)
+    propertyEncoder.checked_property_count = last_index - first_index;
+
   if (CborErrorOutOfMemory == error)
     return EncoderState::OutOfMemory;
   else if (CborNoError == error)
@@ -176,18 +263,14 @@ CBOREncoder::EncoderState CBOREncoder::handle_FinishAppend(PropertyContainerEnco
   propertyEncoder.property_limit_active = false;
 
   /* The append process has been successful, so we don't need to try to send this properties set. Cleanup _has_been_appended_but_not_sended flag */
-  PropertyContainer::iterator iter = propertyEncoder.property_container.begin();
-  std::advance(iter, propertyEncoder.current_property_index);
-  int num_appended_properties = 0;
+  PropertyContainer & property_container = propertyEncoder.property_container;
+  size_t const first_index = propertyEncoder.current_property_index;
+  size_t const last_index = first_index + propertyEncoder.checked_property_count;
 
-  for(; iter != propertyEncoder.property_container.end(); iter++)
+  for(size_t index = property_container.nextPending(first_index); index < last_index; index = property_container.nextPending(index + 1))
   {
-    Property * p = * iter;
-    if (num_appended_properties >= propertyEncoder.checked_property_count)
-      break;
-
-    p->appendCompleted();
-    num_appended_properties++;
+    property_container[index]->appendCompleted();
+    property_container.settle(index);
   }
 
   /* Advance property index for the next message */
@@ -19,7 +19,6 @@
 
 #undef max
 #undef min
-#include <list>
 
 #include "../property/PropertyContainer.h"
 
@@ -33,7 +32,13 @@ class CBOREncoder
 public:
     /* encode return > 0 if a property has changed and encodes the changed properties in CBOR format into the provided buffer */
     /* if lightPayload is true the integer identifier of the property will be encoded in the message instead of the property name in order to reduce the size of the message payload*/
-    static CborError encode(PropertyContainer & property_container, uint8_t * data, size_t const size, int & bytes_encoded, unsigned int & current_property_index, bool lightPayload = false);
+    /* if compactPayload is true numeric values are encoded relative to a SenML base value and as half floats whenever they round-trip within the minimum delta of their property, timestamps are encoded relative to a SenML base time */
+    /* if baseTime is not 0 it is encoded as SenML base time of every message, records without a timestamp of their own are reported at that time */
+    static CborError encode(PropertyContainer & property_container, uint8_t * data, size_t const size, int & bytes_encoded, unsigned int & current_property_index, bool lightPayload = false, bool compactPayload = false, unsigned long const baseTime = 0);
+
+    /* encodes base_value + value using the smallest floating point type which keeps the value within min_delta */
+    static CborError encodeCompactFloat(CborEncoder & encoder, float const value, float const min_delta, long const base_value);
+    static uint16_t  convertFloatToHalf(float const value);
 
 private:
 
@@ -64,6 +69,7 @@ private:
     int checked_property_count;
     int encoded_property_limit;
     bool property_limit_active;
+    SenMLPackState senml_pack;
     CborEncoder encoder;
     CborEncoder arrayEncoder;
   };
@@ -12,7 +12,7 @@
 
 #include "AIoTC_Config.h"
 
-#if OTA_ENABLED
+#if OTA_ENABLED || defined(HOST)
 #include <stdint.h>
 
 namespace ota {
@@ -43,6 +43,7 @@ namespace ota {
     ErrorRename           = -23,
     CaStorageInit         = -24,
     CaStorageOpen         = -25,
+    OtaImageSha256        = -26,
   };
 
 #ifndef OFFLOADED_DOWNLOAD
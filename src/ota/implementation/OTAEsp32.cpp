@@ -18,10 +18,45 @@
   #endif
 #endif
 #include <Update.h>
+#include <Preferences.h>
+
+static const char DIGEST_NVS_NAMESPACE[] = "aiotc-ota";
+static const char DIGEST_NVS_KEY[]       = "fw-digest";
+
+bool ESP32OtaFirmwareDigestStorage::store(OtaFirmwareDigest const & digest) {
+  Preferences nvs;
+  if(!nvs.begin(DIGEST_NVS_NAMESPACE, false)) {
+    return false;
+  }
+
+  bool const stored = nvs.putBytes(DIGEST_NVS_KEY, &digest, sizeof(digest)) == sizeof(digest);
+  nvs.end();
+  return stored;
+}
+
+bool ESP32OtaFirmwareDigestStorage::load(OtaFirmwareDigest & digest) {
+  Preferences nvs;
+  if(!nvs.begin(DIGEST_NVS_NAMESPACE, true)) {
+    return false;
+  }
+
+  bool const loaded = nvs.getBytes(DIGEST_NVS_KEY, &digest, sizeof(digest)) == sizeof(digest);
+  nvs.end();
+  return loaded;
+}
+
+void ESP32OtaFirmwareDigestStorage::clear() {
+  Preferences nvs;
+  if(nvs.begin(DIGEST_NVS_NAMESPACE, false)) {
+    nvs.remove(DIGEST_NVS_KEY);
+    nvs.end();
+  }
+}
 
 ESP32OTACloudProcess::ESP32OTACloudProcess(MessageStream *ms, Client* client)
 : OTADefaultCloudProcessInterface(ms), rom_partition(nullptr) {
-
+  // the sha256 of the sketch is calculated only on the first boot after it has been flashed
+  setFirmwareDigestStorage(&digest_storage);
 }
 
 OTACloudProcessInterface::State ESP32OTACloudProcess::resume(Message* msg) {
@@ -114,4 +149,23 @@ void ESP32OTACloudProcess::calculateSHA256(SHA256& sha256_calc) {
   appFlashClose();
 }
 
+bool ESP32OTACloudProcess::appBuildId(uint8_t build_id[OtaFirmwareDigest::BUILD_ID_SIZE]) {
+  static_assert(sizeof(esp_app_desc_t::app_elf_sha256) == OtaFirmwareDigest::BUILD_ID_SIZE,
+    "the build id is the SHA-256 of the ELF file");
+
+  esp_app_desc_t app_desc;
+  if(!appFlashOpen() || esp_ota_get_partition_description(rom_partition, &app_desc) != ESP_OK) {
+    return false;
+  }
+
+  // the ELF SHA-256 is left zeroed by a build which does not embed it
+  bool embedded = false;
+  for(size_t i = 0; i < OtaFirmwareDigest::BUILD_ID_SIZE && !embedded; i++) {
+    embedded = (app_desc.app_elf_sha256[i] != 0);
+  }
+
+  memcpy(build_id, app_desc.app_elf_sha256, OtaFirmwareDigest::BUILD_ID_SIZE);
+  return embedded;
+}
+
 #endif // defined(ARDUINO_ARCH_ESP32) && OTA_ENABLED
@@ -12,6 +12,14 @@
 
 #include "ota/interface/OTAInterfaceDefault.h"
 
+/* Keeps the digest of the running application in NVS, where it survives a reboot */
+class ESP32OtaFirmwareDigestStorage: public OtaFirmwareDigestStorage {
+public:
+  virtual bool store(OtaFirmwareDigest const & digest) override;
+  virtual bool load(OtaFirmwareDigest & digest) override;
+  virtual void clear() override;
+};
+
 class ESP32OTACloudProcess: public OTADefaultCloudProcessInterface {
 public:
   ESP32OTACloudProcess(MessageStream *ms, Client* client=nullptr);
@@ -38,6 +46,14 @@ protected:
   bool appFlashClose() { return true; };
 
   void calculateSHA256(SHA256&) override;
+
+  // getSketchSize() is the length of the app image as written by writeFlash, which
+  // calculateSHA256() hashes from the start of the running partition
+  virtual bool imageSha256IsAppSha256() override { return true; }
+
+  // the SHA-256 of the ELF file, stored in the application descriptor at build time
+  virtual bool appBuildId(uint8_t build_id[OtaFirmwareDigest::BUILD_ID_SIZE]) override;
 private:
   const esp_partition_t *rom_partition;
+  ESP32OtaFirmwareDigestStorage digest_storage;
 };
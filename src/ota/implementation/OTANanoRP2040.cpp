@@ -19,14 +19,22 @@
 
 #define SD_MOUNT_PATH           "ota"
 #define FULL_UPDATE_FILE_PATH   "/ota/UPDATE.BIN"
+#define FULL_CHECKPOINT_FILE_PATH "/ota/UPDATE.CKP"
+#define FULL_DIGEST_FILE_PATH   "/ota/SKETCH.SHA"
 
 const char NANO_RP2040OTACloudProcess::UPDATE_FILE_NAME[] = FULL_UPDATE_FILE_PATH;
+const char NANO_RP2040OTACloudProcess::CHECKPOINT_FILE_NAME[] = FULL_CHECKPOINT_FILE_PATH;
+const char NANO_RP2040OTACloudProcess::DIGEST_FILE_NAME[] = FULL_DIGEST_FILE_PATH;
 
 NANO_RP2040OTACloudProcess::NANO_RP2040OTACloudProcess(MessageStream *ms, Client* client)
 : OTADefaultCloudProcessInterface(ms, client)
 , flash((uint32_t)appStartAddress() + 0xF00000, 0x100000) // TODO make this numbers a constant
 , decompressed(nullptr)
-, fs(nullptr) {
+, fs(nullptr)
+, checkpoint_storage(CHECKPOINT_FILE_NAME)
+, digest_storage(DIGEST_FILE_NAME) {
+  setCheckpointStorage(&checkpoint_storage);
+  setFirmwareDigestStorage(&digest_storage);
 }
 
 NANO_RP2040OTACloudProcess::~NANO_RP2040OTACloudProcess() {
@@ -37,6 +45,27 @@ OTACloudProcessInterface::State NANO_RP2040OTACloudProcess::resume(Message* msg)
   return OtaBegin;
 }
 
+OTACloudProcessInterface::State NANO_RP2040OTACloudProcess::otaBegin() {
+  bool mounted = false;
+  if(fs == nullptr && flash.init() >= 0) {
+    fs = new mbed::FATFileSystem(SD_MOUNT_PATH);
+    mounted = (fs->mount(&flash) == 0);
+  }
+
+  // without the file system the sketch is hashed, its sha256 is not cached
+  OTACloudProcessInterface::State const next = OTADefaultCloudProcessInterface::otaBegin();
+
+  if(mounted) {
+    close_fs();
+  } else if(fs != nullptr) {
+    delete fs;
+    fs = nullptr;
+  }
+  flash.deinit();
+
+  return next;
+}
+
 int NANO_RP2040OTACloudProcess::writeFlash(uint8_t* const buffer, size_t len) {
   if(decompressed == nullptr) {
     DEBUG_VERBOSE("writing on a file that is not open"); // FIXME change log message
@@ -45,6 +74,10 @@ int NANO_RP2040OTACloudProcess::writeFlash(uint8_t* const buffer, size_t len) {
   return fwrite(buffer, sizeof(uint8_t), len, decompressed);
 }
 
+bool NANO_RP2040OTACloudProcess::syncFlash() {
+  return decompressed != nullptr && fflush(decompressed) == 0;
+}
+
 OTACloudProcessInterface::State NANO_RP2040OTACloudProcess::startOTA() {
   int err = -1;
   if ((err = flash.init()) < 0) {
@@ -52,15 +85,45 @@ OTACloudProcessInterface::State NANO_RP2040OTACloudProcess::startOTA() {
     return OtaStorageInitFail;
   }
 
-  flash.erase((uint32_t)appStartAddress() + 0xF00000, 0x100000);
-
   fs = new mbed::FATFileSystem(SD_MOUNT_PATH); // FIXME can this be allocated in the stack?
-  if ((err = fs->reformat(&flash)) != 0) {
-    DEBUG_VERBOSE("%s: fs.reformat() failed with %d", __FUNCTION__, err);
-    return ErrorReformatFail;
+
+  // the checkpoint is stored next to the update file, the file system has to be mounted to load it
+  const bool mounted = (fs->mount(&flash) == 0);
+
+  // an interrupted download continues to write the file after its last checkpoint,
+  // provided that the file still holds all the bytes the checkpoint refers to
+  const uint32_t offset = mounted ? resumeOffset() : 0;
+  if(offset > 0) {
+    decompressed = fopen(UPDATE_FILE_NAME, "r+b");
+
+    if(decompressed != nullptr &&
+       (fseek(decompressed, 0, SEEK_END) != 0 || ftell(decompressed) < static_cast<long>(offset) ||
+        fseek(decompressed, offset, SEEK_SET) != 0)) {
+      fclose(decompressed);
+      decompressed = nullptr;
+    }
+
+    if(decompressed == nullptr) {
+      DEBUG_VERBOSE("%s: the update file does not match the checkpoint, the download can not be resumed", __FUNCTION__);
+      discardCheckpoint();
+    }
+  }
+
+  if(decompressed == nullptr) {
+    if(mounted) {
+      fs->unmount();
+    }
+
+    flash.erase((uint32_t)appStartAddress() + 0xF00000, 0x100000);
+
+    if ((err = fs->reformat(&flash)) != 0) {
+      DEBUG_VERBOSE("%s: fs.reformat() failed with %d", __FUNCTION__, err);
+      return ErrorReformatFail;
+    }
+
+    decompressed = fopen(UPDATE_FILE_NAME, "wb"); // TODO make this a constant
   }
 
-  decompressed = fopen(UPDATE_FILE_NAME, "wb"); // TODO make this a constant
   if (!decompressed) {
     DEBUG_VERBOSE("%s: fopen() failed", __FUNCTION__);
     fclose(decompressed);
@@ -130,6 +193,20 @@ void* NANO_RP2040OTACloudProcess::appStartAddress() {
   return (void*)XIP_BASE;
 #endif
 }
+bool NANO_RP2040OTACloudProcess::appBuildId(uint8_t build_id[OtaFirmwareDigest::BUILD_ID_SIZE]) {
+  mbed::MbedCRC<POLY_32BIT_ANSI, 32> crc32;
+  uint32_t const size = appSize();
+  uint32_t crc = 0;
+  if(crc32.compute(appStartAddress(), size, &crc) != 0) {
+    return false;
+  }
+
+  memset(build_id, 0, OtaFirmwareDigest::BUILD_ID_SIZE);
+  memcpy(build_id, &crc, sizeof(crc));
+  memcpy(build_id + sizeof(crc), &size, sizeof(size));
+  return true;
+}
+
 uint32_t NANO_RP2040OTACloudProcess::appSize() {
 #if defined(UNINITIALIZED_DATA_SECTION)
   return ((&__flash_binary_end - (uint32_t*)appStartAddress()) - (&__uninitialized_data_end__ - &__uninitialized_data_start__)) * sizeof(void*);
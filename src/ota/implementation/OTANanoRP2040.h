@@ -24,6 +24,9 @@ public:
 protected:
   virtual OTACloudProcessInterface::State resume(Message* msg=nullptr) override;
 
+  // the file system of the ota is mounted while the sha256 of the sketch is looked up in its cache
+  virtual OTACloudProcessInterface::State otaBegin() override;
+
   virtual OTACloudProcessInterface::State startOTA() override;
 
   // whene the download is correctly finished we set the mcu to use the newly downloaded binary
@@ -35,17 +38,32 @@ protected:
   // write the decompressed char buffer of the incoming ota
   virtual int writeFlash(uint8_t* const buffer, size_t len) override;
 
+  // flush the update file before a checkpoint of the download is committed
+  virtual bool syncFlash() override;
+
   virtual void reset() override;
 
+  // the application is measured with the linker symbols of the running sketch, without its
+  // uninitialized data section, which is not the length of the image. The image is therefore
+  // not verified against the finalSha256 of the OTA, see imageSha256IsAppSha256()
   void* appStartAddress();
   uint32_t appSize();
   bool appFlashOpen() { return true; };
   bool appFlashClose() { return true; };
+
+  // the CRC32 of the sketch together with its size, cheaper to compute than its sha256
+  virtual bool appBuildId(uint8_t build_id[OtaFirmwareDigest::BUILD_ID_SIZE]) override;
 private:
   FlashIAPBlockDevice flash;
   FILE* decompressed;
   mbed::FATFileSystem* fs;
+  // the checkpoint of the download is kept next to the update file, it survives a reboot
+  OtaCheckpointFileStorage checkpoint_storage;
+  // the sha256 of the sketch is cached in the same file system, it survives a reboot
+  OtaFirmwareDigestFileStorage digest_storage;
   static const char UPDATE_FILE_NAME[];
+  static const char CHECKPOINT_FILE_NAME[];
+  static const char DIGEST_FILE_NAME[];
 
   int close_fs();
 };
@@ -12,6 +12,7 @@
 #if defined(BOARD_STM32H7) && OTA_ENABLED
 #include "OTASTM32H7.h"
 #include <STM32H747_System.h>
+#include "mbed.h"
 
 STM32H7OTACloudProcess::STM32H7OTACloudProcess(MessageStream *ms, Client* client)
 : OTADefaultCloudProcessInterface(ms, client)
@@ -19,8 +20,13 @@ STM32H7OTACloudProcess::STM32H7OTACloudProcess(MessageStream *ms, Client* client
 , _bd_raw_qspi(nullptr)
 , _bd(nullptr)
 , _fs(nullptr)
-, _filename("/" + String(STM32H747OTA::FOLDER) + "/" + String(STM32H747OTA::NAME)) {
-
+, _filename("/" + String(STM32H747OTA::FOLDER) + "/" + String(STM32H747OTA::NAME))
+, _checkpoint_filename("/" + String(STM32H747OTA::FOLDER) + "/UPDATE.CKP")
+, _checkpoint_storage(_checkpoint_filename.c_str())
+, _digest_filename("/" + String(STM32H747OTA::FOLDER) + "/SKETCH.SHA")
+, _digest_storage(_digest_filename.c_str()) {
+  setCheckpointStorage(&_checkpoint_storage);
+  setFirmwareDigestStorage(&_digest_storage);
 }
 
 STM32H7OTACloudProcess::~STM32H7OTACloudProcess() {
@@ -36,6 +42,16 @@ OTACloudProcessInterface::State STM32H7OTACloudProcess::resume(Message* msg) {
   return OtaBegin;
 }
 
+OTACloudProcessInterface::State STM32H7OTACloudProcess::otaBegin() {
+  // without the file system the sketch is hashed, its sha256 is not cached
+  storageInit();
+
+  OTACloudProcessInterface::State const next = OTADefaultCloudProcessInterface::otaBegin();
+
+  storageClean();
+  return next;
+}
+
 void STM32H7OTACloudProcess::update() {
   OTADefaultCloudProcessInterface::update();
 }
@@ -47,6 +63,10 @@ int STM32H7OTACloudProcess::writeFlash(uint8_t* const buffer, size_t len) {
   return fwrite(buffer, sizeof(uint8_t), len, decompressed);
 }
 
+bool STM32H7OTACloudProcess::syncFlash() {
+  return decompressed != nullptr && fflush(decompressed) == 0;
+}
+
 OTACloudProcessInterface::State STM32H7OTACloudProcess::startOTA() {
   if (!isOtaCapable()) {
     return NoCapableBootloaderFail;
@@ -57,10 +77,31 @@ OTACloudProcessInterface::State STM32H7OTACloudProcess::startOTA() {
     return OtaStorageInitFail;
   }
 
-  // this could be useless, since we are writing over it
-  remove(_filename.c_str());
+  // an interrupted download continues to write the file after its last checkpoint,
+  // provided that the file still holds all the bytes the checkpoint refers to
+  const uint32_t offset = resumeOffset();
+  if(offset > 0) {
+    decompressed = fopen(_filename.c_str(), "r+b");
+
+    if(decompressed != nullptr &&
+       (fseek(decompressed, 0, SEEK_END) != 0 || ftell(decompressed) < static_cast<long>(offset) ||
+        fseek(decompressed, offset, SEEK_SET) != 0)) {
+      fclose(decompressed);
+      decompressed = nullptr;
+    }
 
-  decompressed = fopen(_filename.c_str(), "wb");
+    if(decompressed == nullptr) {
+      DEBUG_VERBOSE("%s: the update file does not match the checkpoint, the download can not be resumed", __FUNCTION__);
+      discardCheckpoint();
+    }
+  }
+
+  if(decompressed == nullptr) {
+    // this could be useless, since we are writing over it
+    remove(_filename.c_str());
+
+    decompressed = fopen(_filename.c_str(), "wb");
+  }
 
   if(decompressed == nullptr) {
     return ErrorOpenUpdateFileFail;
@@ -103,7 +144,10 @@ OTACloudProcessInterface::State STM32H7OTACloudProcess::reboot() {
 void STM32H7OTACloudProcess::reset() {
   OTADefaultCloudProcessInterface::reset();
 
-  remove(_filename.c_str());
+  // keep the partial download if it can be resumed
+  if(!checkpointStored()) {
+    remove(_filename.c_str());
+  }
 
   storageClean();
 }
@@ -198,4 +242,18 @@ uint32_t STM32H7OTACloudProcess::appSize() {
   return ((&__etext - (uint32_t*)appStartAddress()) + (&_edata - &_sdata))*sizeof(void*);
 }
 
+bool STM32H7OTACloudProcess::appBuildId(uint8_t build_id[OtaFirmwareDigest::BUILD_ID_SIZE]) {
+  mbed::MbedCRC<POLY_32BIT_ANSI, 32> crc32;
+  uint32_t const size = appSize();
+  uint32_t crc = 0;
+  if(crc32.compute(appStartAddress(), size, &crc) != 0) {
+    return false;
+  }
+
+  memset(build_id, 0, OtaFirmwareDigest::BUILD_ID_SIZE);
+  memcpy(build_id, &crc, sizeof(crc));
+  memcpy(build_id + sizeof(crc), &size, sizeof(size));
+  return true;
+}
+
 #endif // defined(BOARD_STM32H7) && OTA_ENABLED
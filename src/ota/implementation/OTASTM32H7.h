@@ -44,6 +44,9 @@ public:
 protected:
   virtual OTACloudProcessInterface::State resume(Message* msg=nullptr) override;
 
+  // the file system of the ota is mounted while the sha256 of the sketch is looked up in its cache
+  virtual OTACloudProcessInterface::State otaBegin() override;
+
   // we are overriding the method of startOTA in order to open the destination file for the ota download
   virtual OTACloudProcessInterface::State startOTA() override;
 
@@ -56,12 +59,21 @@ protected:
   // write the decompressed char buffer of the incoming ota
   virtual int writeFlash(uint8_t* const buffer, size_t len) override;
 
+  // flush the update file before a checkpoint of the download is committed
+  virtual bool syncFlash() override;
+
   virtual void reset() override;
 
+  // the application is measured with the linker symbols of the running sketch, text and data,
+  // which is not guaranteed to be the length of the image the bootloader copies. The image is
+  // therefore not verified against the finalSha256 of the OTA, see imageSha256IsAppSha256()
   void* appStartAddress();
   uint32_t appSize();
   bool appFlashOpen() { return true; };
   bool appFlashClose() { return true; };
+
+  // the CRC32 of the sketch together with its size, computed by the CRC unit of the mcu
+  virtual bool appBuildId(uint8_t build_id[OtaFirmwareDigest::BUILD_ID_SIZE]) override;
 private:
   bool storageInit();
   bool findProgramLength(uint32_t & program_length);
@@ -74,4 +86,12 @@ private:
   mbed::FATFileSystem* _fs;
 
   String _filename;
+
+  // the checkpoint of the download is kept next to the update file, it survives a reboot
+  String _checkpoint_filename;
+  OtaCheckpointFileStorage _checkpoint_storage;
+
+  // the sha256 of the sketch is cached in the same file system, it survives a reboot
+  String _digest_filename;
+  OtaFirmwareDigestFileStorage _digest_storage;
 };
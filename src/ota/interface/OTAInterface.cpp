@@ -14,9 +14,12 @@
 
 #include <AIoTC_Config.h>
 
-#if OTA_ENABLED
+#if OTA_ENABLED || defined(HOST)
 #include "OTAInterface.h"
 #include "../OTA.h"
+#include "../../utility/memory/HeapStats.h"
+#include <stdlib.h>
+#include <string.h>
 
 extern "C" unsigned long getTime();
 
@@ -35,6 +38,9 @@ const char* const OTACloudProcessInterface::STATE_NAMES[] = { // used only for d
   "FlashOTA",
   "Reboot",
   "Fail",
+  "OTAUnavailable",
+  "OtaAlreadyInstalled",
+  // the names of the error states follow the last state
   "NoCapableBootloaderFail",
   "NoOtaStorageFail",
   "OtaStorageInitFail",
@@ -58,6 +64,9 @@ const char* const OTACloudProcessInterface::STATE_NAMES[] = { // used only for d
   "ErrorReformatFail",
   "ErrorUnmountFail",
   "ErrorRenameFail",
+  "CaStorageInitFail",
+  "CaStorageOpenFail",
+  "OtaImageSha256Fail",
 };
 #endif // DEBUG_VERBOSE
 
@@ -76,6 +85,7 @@ OTACloudProcessInterface::~OTACloudProcessInterface() {
 }
 
 void OTACloudProcessInterface::handleMessage(Message* msg) {
+  AIOT_HEAP_STATS_SCOPE(Ota);
 
   if ((state >= OtaAvailable || state < 0) && previous_state != state) {
     reportStatus(static_cast<int32_t>(state<0? state : 0));
@@ -85,16 +95,17 @@ void OTACloudProcessInterface::handleMessage(Message* msg) {
   previous_state = state;
 
   switch(state) {
-  case Resume:         updateState(resume(msg));    break;
-  case OtaBegin:       updateState(otaBegin());     break;
-  case Idle:           updateState(idle(msg));      break;
-  case OtaAvailable:   updateState(otaAvailable()); break;
-  case StartOTA:       updateState(startOTA());     break;
-  case Fetch:          updateState(fetch());        break;
-  case FlashOTA:       updateState(flashOTA());     break;
-  case Reboot:         updateState(reboot());       break;
-  case OTAUnavailable: break;
-  default:             updateState(fail()); // all the states that are not defined are failures
+  case Resume:              updateState(resume(msg));    break;
+  case OtaBegin:            updateState(otaBegin());     break;
+  case Idle:                updateState(idle(msg));      break;
+  case OtaAvailable:        updateState(otaAvailable()); break;
+  case OtaAlreadyInstalled: updateState(otaAlreadyInstalled()); break;
+  case StartOTA:            updateState(startOTA());     break;
+  case Fetch:               updateState(fetch());        break;
+  case FlashOTA:            updateState(flashOTA());     break;
+  case Reboot:              updateState(reboot());       break;
+  case OTAUnavailable:      break;
+  default:                  updateState(fail()); // all the states that are not defined are failures
   }
 }
 
@@ -109,10 +120,19 @@ OTACloudProcessInterface::State OTACloudProcessInterface::otaBegin() {
     {}
   };
 
-  SHA256 sha256_calc;
-  calculateSHA256(sha256_calc);
-
-  sha256_calc.finalize(sha256);
+  // the whole application is hashed only if its build id changed since the sha256 has been cached
+  uint32_t const app_size = appSize();
+  uint8_t build_id[OtaFirmwareDigest::BUILD_ID_SIZE];
+  bool const has_build_id = appBuildId(build_id);
+  if(!has_build_id || !firmware_digest.lookup(app_size, build_id, sha256)) {
+    SHA256 sha256_calc;
+    calculateSHA256(sha256_calc);
+
+    sha256_calc.finalize(sha256);
+    if(has_build_id) {
+      firmware_digest.store(app_size, build_id, sha256);
+    }
+  }
   memcpy(msg.params.sha, sha256, SHA256::HASH_SIZE);
 
   DEBUG_VERBOSE("calculated SHA256: "
@@ -158,7 +178,13 @@ OTACloudProcessInterface::State OTACloudProcessInterface::idle(Message* msg) {
       );
 
     // TODO verify that initialSha256 is the sha256 on board
-    // TODO verify that final sha is not the current sha256 (?)
+
+    // the board is already running the firmware of this OTA, there is nothing to download
+    if(memcmp(context->finalSha256, sha256, SHA256::HASH_SIZE) == 0) {
+      DEBUG_VERBOSE("OTA firmware is already running on the board");
+      return OtaAlreadyInstalled;
+    }
+
     return OtaAvailable;
   }
 
@@ -176,6 +202,13 @@ OTACloudProcessInterface::State OTACloudProcessInterface::otaAvailable() {
   } // TODO add an abortOTA command? in this case delete the context
 }
 
+OTACloudProcessInterface::State OTACloudProcessInterface::otaAlreadyInstalled() {
+  // the ota has been reported in this state, which terminates it, report the sha256 again
+  clean();
+
+  return OtaBegin;
+}
+
 OTACloudProcessInterface::State OTACloudProcessInterface::fail() {
   reset();
   clean();
@@ -16,8 +16,9 @@
 
 #include <AIoTC_Config.h>
 
-#if OTA_ENABLED
+#if OTA_ENABLED || defined(HOST)
 #include "../OTATypes.h"
+#include "../utility/OtaFirmwareDigest.h"
 #include <Arduino_SHA256.h>
 
 #include <interfaces/CloudProcess.h>
@@ -44,6 +45,7 @@ public:
     Reboot                    = 7,
     Fail                      = 8,
     OTAUnavailable            = 9,
+    OtaAlreadyInstalled       = 10,
 
     // Error states that may generically happen on all board
     NoCapableBootloaderFail   = static_cast<State>(ota::OTAError::NoCapableBootloader),
@@ -71,6 +73,7 @@ public:
     ErrorRenameFail           = static_cast<State>(ota::OTAError::ErrorRename),
     CaStorageInitFail         = static_cast<State>(ota::OTAError::CaStorageInit),
     CaStorageOpenFail         = static_cast<State>(ota::OTAError::CaStorageOpen),
+    OtaImageSha256Fail        = static_cast<State>(ota::OTAError::OtaImageSha256),
   };
 
 #ifdef DEBUG_VERBOSE
@@ -81,7 +84,8 @@ public:
     None              = 0,
     ApprovalRequired  = 1,
     Approved          = 1<<1,
-    ChunkDownload     = 1<<2
+    ChunkDownload     = 1<<2,
+    PipelinedDownload = 1<<3
   };
 
   virtual void handleMessage(Message*);
@@ -98,6 +102,10 @@ public:
 
   inline State getState() { return state; }
 
+  // the sha256 of the application is looked up in this storage before it is calculated,
+  // on the boards which provide a build id of the application, see appBuildId()
+  inline void setFirmwareDigestStorage(OtaFirmwareDigestStorage* storage) { firmware_digest.setStorage(storage); }
+
   virtual bool isOtaCapable() = 0;
 protected:
   // The following methods represent the FSM actions performed in each state
@@ -118,6 +126,10 @@ protected:
   // start the ota or wait for an user interaction
   virtual State otaAvailable();
 
+  // we go in this state if the firmware of the ota is already running on the board, the ota is
+  // reported as completed without downloading it and the sha256 of the board fw is sent again
+  virtual State otaAlreadyInstalled();
+
   // we start the process of ota update and wait for the server to respond with the ota url and other info
   virtual State startOTA() = 0;
 
@@ -141,8 +153,8 @@ protected:
   inline void updateState(State s) {
     if(state!=s) {
       DEBUG_VERBOSE("OTAInterface: state change to %s from %s",
-        STATE_NAMES[s < 0? Fail - s : s],
-        STATE_NAMES[state < 0? Fail - state : state]);
+        STATE_NAMES[s < 0? OtaAlreadyInstalled - s : s],
+        STATE_NAMES[state < 0? OtaAlreadyInstalled - state : state]);
       previous_state = state; state = s;
     }
   }
@@ -165,6 +177,13 @@ protected:
 
   // calculateSHA256 method is overridable for platforms that do not support access through pointer to program memory
   virtual void calculateSHA256(SHA256&); // FIXME return error
+
+  // build id of the application, computed at link time over the whole image. Boards which
+  // can not provide one return false, their application is hashed at every boot
+  virtual bool appBuildId(uint8_t[OtaFirmwareDigest::BUILD_ID_SIZE]) { return false; }
+
+  // sha256 of the application calculated on a previous boot
+  OtaFirmwareDigestCache firmware_digest;
 private:
   void clean();
 
@@ -14,11 +14,20 @@
 #include "OTAInterfaceDefault.h"
 #include "../OTA.h"
 
+#include <new>
+
+static_assert(OtaCheckpoint::ID_SIZE == ID_SIZE, "OtaCheckpoint has to hold the id of the OTA");
+
 OTADefaultCloudProcessInterface::OTADefaultCloudProcessInterface(MessageStream *ms, Client* client)
 : OTACloudProcessInterface(ms)
 , client(client)
 , http_client(nullptr)
+, range_pipeline(nullptr)
 , username(nullptr), password(nullptr)
+, checkpoint_storage(&checkpoint_ram_storage)
+, checkpoint_ram_storage()
+, checkpoint(nullptr)
+, checkpoint_stored(false)
 , context(nullptr) {
 }
 
@@ -34,22 +43,54 @@ OTACloudProcessInterface::State OTADefaultCloudProcessInterface::startOTA() {
   context = new Context(
     OTACloudProcessInterface::context->url,
     [this](uint8_t c) {
-        if (this->writeFlash(&c, 1) != 1) {
+        if (!this->context->flashBuffer.put(c)) {
           this->context->writeError = true;
         }
+    },
+    [this](uint8_t* const buffer, size_t len) {
+        // the image is hashed while it is written, it never has to be read back
+        if (this->imageSha256IsAppSha256()) {
+          this->context->sha256.update(buffer, len);
+        }
+        return this->writeFlash(buffer, len);
     }
   );
 
-  // check url
-  if(strcmp(context->parsed_url.schema(), "https") == 0) {
-    http_client = new HttpClient(*client, context->parsed_url.host(), context->parsed_url.port());
+  // the implementation reopened the update storage at the offset of the checkpoint
+  if(checkpoint != nullptr) {
+    restoreCheckpoint();
   } else {
+    discardCheckpoint();
+    context->flashBuffer.begin(flashPageSize());
+  }
+
+  // check url
+  if(strcmp(context->parsed_url.schema(), "https") != 0) {
     return UrlParseErrorFail;
   }
 
+  if(getOtaPolicy(PipelinedDownload)) {
+    // the connection is opened by the first fetch, the length of the file is known with its first range
+    range_pipeline = new OtaHttpRangePipeline(maxChunkSize, AIOT_CONFIG_OTA_PIPELINE_DEPTH);
+    range_pipeline->begin(context->parsed_url.host(), context->parsed_url.port(), context->parsed_url.path(), context->downloadedSize);
+
+    if(username != nullptr && password != nullptr) {
+      range_pipeline->setAuthentication(username, password);
+    }
+
+    context->lastReportTime = millis();
+    return Fetch;
+  }
+
+  http_client = new HttpClient(*client, context->parsed_url.host(), context->parsed_url.port());
+
   // make the http get request
   OTACloudProcessInterface::State res = requestOta();
   if(res != Fetch) {
+    // the server does not allow to resume the download
+    if(res == HttpResponseFail) {
+      discardCheckpoint();
+    }
     return res;
   }
 
@@ -59,7 +100,15 @@ OTACloudProcessInterface::State OTADefaultCloudProcessInterface::startOTA() {
     return HttpHeaderErrorFail;
   }
 
-  context->contentLength = http_client->contentLength();
+  // a resumed download only receives the rest of the file
+  const uint32_t contentLength = context->downloadedSize + http_client->contentLength();
+  if(context->contentLength != 0 && context->contentLength != contentLength) {
+    DEBUG_VERBOSE("OTA ERROR: the file changed since its download has been interrupted");
+    discardCheckpoint();
+    return HttpResponseFail;
+  }
+
+  context->contentLength = contentLength;
   context->lastReportTime = millis();
   DEBUG_VERBOSE("OTA file length: %d", context->contentLength);
   return Fetch;
@@ -68,7 +117,7 @@ OTACloudProcessInterface::State OTADefaultCloudProcessInterface::startOTA() {
 OTACloudProcessInterface::State OTADefaultCloudProcessInterface::fetch() {
   OTACloudProcessInterface::State res = Fetch;
 
-  if(getOtaPolicy(ChunkDownload)) {
+  if(getOtaPolicy(ChunkDownload) && range_pipeline == nullptr) {
     res = requestOta(ChunkDownload);
   }
 
@@ -79,51 +128,79 @@ OTACloudProcessInterface::State OTADefaultCloudProcessInterface::fetch() {
     goto exit;
   }
 
-  /* download chunked or timed  */
-  do {
-    if(!http_client->connected()) {
-      res = OtaDownloadFail;
+  if(range_pipeline != nullptr) {
+    res = fetchRanges();
+
+    if(res != Fetch) {
       goto exit;
     }
+  } else {
+    /* download chunked or timed  */
+    do {
+      if(!http_client->connected()) {
+        res = OtaDownloadFail;
+        goto exit;
+      }
 
-    if(http_client->available() == 0) {
-      /* Avoid tight loop and allow yield */
-      delay(1);
-      continue;
-    }
+      if(http_client->available() == 0) {
+        /* Avoid tight loop and allow yield */
+        delay(1);
+        continue;
+      }
 
-    int http_res = http_client->read(context->buffer, context->bufLen);
+      int http_res = http_client->read(context->buffer, context->bufLen);
 
-    if(http_res < 0) {
-      DEBUG_VERBOSE("OTA ERROR: Download read error %d", http_res);
-      res = OtaDownloadFail;
-      goto exit;
-    }
+      if(http_res < 0) {
+        DEBUG_VERBOSE("OTA ERROR: Download read error %d", http_res);
+        res = OtaDownloadFail;
+        goto exit;
+      }
 
-    parseOta(context->buffer, http_res);
+      parseOta(context->buffer, http_res);
 
-    if(context->writeError) {
-      DEBUG_VERBOSE("OTA ERROR: File write error");
-      res = ErrorWriteUpdateFileFail;
-      goto exit;
-    }
+      if(context->writeError) {
+        DEBUG_VERBOSE("OTA ERROR: File write error");
+        res = ErrorWriteUpdateFileFail;
+        goto exit;
+      }
 
-    context->downloadedChunkSize += http_res;
+      context->downloadedChunkSize += http_res;
 
-  } while(context->downloadState < OtaDownloadCompleted && fetchMore());
+    } while(context->downloadState < OtaDownloadCompleted && fetchMore());
+  }
+
+  if(context->downloadState == OtaDownloadFile &&
+     context->downloadedSize - context->checkpointSize >= checkpointInterval &&
+     !commitCheckpoint()) {
+    DEBUG_VERBOSE("OTA ERROR: File write error");
+    res = ErrorWriteUpdateFileFail;
+    goto exit;
+  }
 
   // TODO verify that the information present in the ota header match the info in context
   if(context->downloadState == OtaDownloadCompleted) {
     // Verify that the downloaded file size is matching the expected size ??
     // this could distinguish between consistency of the downloaded bytes and filesize
 
+    // write the last, partially filled page
+    if(!context->flashBuffer.flush()) {
+      DEBUG_VERBOSE("OTA ERROR: File write error");
+      res = ErrorWriteUpdateFileFail;
+      goto exit;
+    }
+
     // validate CRC
     context->calculatedCrc32 = arduino::crc32::finalize(context->calculatedCrc32);
-    if(context->header.header.crc32 == context->calculatedCrc32) {
+    if(context->header.header.crc32 != context->calculatedCrc32) {
+      res = OtaHeaderCrcFail;
+    } else if(!verifySha256()) {
+      DEBUG_VERBOSE("OTA ERROR: the sha256 of the image does not match the one of the OTA");
+      res = OtaImageSha256Fail;
+    } else {
       DEBUG_VERBOSE("Ota download completed successfully");
+      // the board is going to run another application, its sha256 has to be calculated again
+      firmware_digest.invalidate();
       res = FlashOTA;
-    } else {
-      res = OtaHeaderCrcFail;
     }
   } else if(context->downloadState == OtaDownloadError) {
     DEBUG_VERBOSE("OTA ERROR: OtaDownloadError");
@@ -136,13 +213,67 @@ OTACloudProcessInterface::State OTADefaultCloudProcessInterface::fetch() {
 
 exit:
   if(res != Fetch) {
-    http_client->stop(); // close the connection
-    delete http_client;
-    http_client = nullptr;
+    if(http_client != nullptr) {
+      http_client->stop(); // close the connection
+      delete http_client;
+      http_client = nullptr;
+    }
+
+    if(range_pipeline != nullptr) {
+      client->stop(); // close the connection
+      delete range_pipeline;
+      range_pipeline = nullptr;
+    }
+
+    // a download interrupted by the connection is resumed from the last checkpoint by the next attempt
+    if(res != OtaDownloadFail && res != ServerConnectErrorFail && res != OtaHeaderTimeoutFail) {
+      discardCheckpoint();
+    }
   }
   return res;
 }
 
+OTACloudProcessInterface::State OTADefaultCloudProcessInterface::fetchRanges() {
+  /* download timed, the pipeline keeps the connection and the range requests going */
+  do {
+    int const bytes_read = range_pipeline->read(*client, context->buffer, context->bufLen);
+
+    if(bytes_read == OtaHttpRangePipeline::ConnectError) {
+      DEBUG_VERBOSE("OTA ERROR: http client error connecting to server \"%s:%d\"",
+        context->parsed_url.host(), context->parsed_url.port());
+      return ServerConnectErrorFail;
+    } else if(bytes_read == OtaHttpRangePipeline::ResponseError) {
+      DEBUG_VERBOSE("OTA ERROR: unexpected range response on \"%s\"", OTACloudProcessInterface::context->url);
+      return HttpResponseFail;
+    } else if(bytes_read < 0) {
+      DEBUG_VERBOSE("OTA ERROR: Download read error %d", bytes_read);
+      return OtaDownloadFail;
+    } else if(bytes_read == 0) {
+      /* Avoid tight loop and allow yield */
+      delay(1);
+      continue;
+    }
+
+    // known since the headers of the first range have been received
+    if(context->contentLength != 0 && context->contentLength != range_pipeline->contentLength()) {
+      DEBUG_VERBOSE("OTA ERROR: the file changed since its download has been interrupted");
+      return HttpResponseFail;
+    }
+    context->contentLength = range_pipeline->contentLength();
+    parseOta(context->buffer, bytes_read);
+
+    if(context->writeError) {
+      DEBUG_VERBOSE("OTA ERROR: File write error");
+      return ErrorWriteUpdateFileFail;
+    }
+
+    context->downloadedChunkSize += bytes_read;
+
+  } while(context->downloadState < OtaDownloadCompleted && fetchMore());
+
+  return Fetch;
+}
+
 OTACloudProcessInterface::State OTADefaultCloudProcessInterface::requestOta(OtaFlags mode) {
   int http_res = 0;
 
@@ -163,6 +294,12 @@ OTACloudProcessInterface::State OTADefaultCloudProcessInterface::requestOta(OtaF
     sprintf(range, "bytes=%" PRIu32 "-%" PRIu32, context->downloadedSize, context->downloadedSize + rangeSize);
     DEBUG_VERBOSE("OTA downloading range: %s", range);
     http_client->sendHeader("Range", range);
+  } else if(context->downloadedSize > 0) {
+    // resume the download after the last checkpoint
+    char range[128] = {0};
+    sprintf(range, "bytes=%" PRIu32 "-", context->downloadedSize);
+    DEBUG_VERBOSE("OTA resuming download: %s", range);
+    http_client->sendHeader("Range", range);
   }
 
   http_client->endRequest();
@@ -181,8 +318,8 @@ OTACloudProcessInterface::State OTADefaultCloudProcessInterface::requestOta(OtaF
 
   int statusCode = http_client->responseStatusCode();
 
-  if((((mode & ChunkDownload) == ChunkDownload) && (statusCode != 206)) ||
-     (((mode & ChunkDownload) != ChunkDownload) && (statusCode != 200))) {
+  const bool partial = ((mode & ChunkDownload) == ChunkDownload) || context->downloadedSize > 0;
+  if((partial && (statusCode != 206)) || (!partial && (statusCode != 200))) {
     DEBUG_VERBOSE("OTA ERROR: get response on \"%s\" returned status %d", OTACloudProcessInterface::context->url, statusCode);
     return HttpResponseFail;
   }
@@ -192,7 +329,7 @@ OTACloudProcessInterface::State OTADefaultCloudProcessInterface::requestOta(OtaF
 }
 
 bool OTADefaultCloudProcessInterface::fetchMore() {
-  if (getOtaPolicy(ChunkDownload)) {
+  if (getOtaPolicy(ChunkDownload) && range_pipeline == nullptr) {
     return context->downloadedChunkSize < maxChunkSize;
   } else {
     return (millis() - context->downloadedChunkStartTime) < downloadTime;
@@ -276,6 +413,11 @@ void OTADefaultCloudProcessInterface::reset() {
     http_client = nullptr;
   }
 
+  if(range_pipeline != nullptr) {
+    delete range_pipeline;
+    range_pipeline = nullptr;
+  }
+
   if(client!=nullptr && client->connected()) {
     client->stop();
   }
@@ -285,10 +427,105 @@ void OTADefaultCloudProcessInterface::reset() {
     delete context;
     context = nullptr;
   }
+
+  // loaded by an implementation which did not start the download
+  if(checkpoint != nullptr) {
+    delete checkpoint;
+    checkpoint = nullptr;
+  }
+}
+
+uint32_t OTADefaultCloudProcessInterface::resumeOffset() {
+  assert(OTACloudProcessInterface::context != nullptr);
+
+  if(checkpoint == nullptr) {
+    checkpoint = new (std::nothrow) OtaCheckpoint;
+  }
+
+  if(checkpoint == nullptr ||
+     !checkpoint_storage->load(*checkpoint) ||
+     !checkpoint->valid(OTACloudProcessInterface::context->id)) {
+    discardCheckpoint();
+    return 0;
+  }
+
+  DEBUG_VERBOSE("OTA resuming from checkpoint %d/%d", checkpoint->downloadedSize, checkpoint->contentLength);
+  checkpoint_stored = true;
+  return checkpoint->flashOffset;
+}
+
+void OTADefaultCloudProcessInterface::discardCheckpoint() {
+  if(checkpoint != nullptr) {
+    delete checkpoint;
+    checkpoint = nullptr;
+  }
+
+  checkpoint_storage->clear();
+  checkpoint_stored = false;
+}
+
+void OTADefaultCloudProcessInterface::restoreCheckpoint() {
+  memcpy(context->header.buf, checkpoint->header, sizeof(context->header.buf));
+  context->headerCopiedBytes  = sizeof(context->header.buf);
+  context->downloadState      = OtaDownloadFile;
+  context->contentLength      = checkpoint->contentLength;
+  context->downloadedSize     = checkpoint->downloadedSize;
+  context->checkpointSize     = checkpoint->downloadedSize;
+  context->calculatedCrc32    = checkpoint->calculatedCrc32;
+  context->decoder.restore(checkpoint->decoder);
+  context->sha256.restore(checkpoint->sha256);
+  context->flashBuffer.begin(flashPageSize(), checkpoint->flashOffset);
+
+  delete checkpoint;
+  checkpoint = nullptr;
+}
+
+bool OTADefaultCloudProcessInterface::commitCheckpoint() {
+  // the checkpoint can only refer to bytes which are in the update storage
+  if(!context->flashBuffer.flush() || !syncFlash()) {
+    context->writeError = true;
+    return false;
+  }
+
+  // not being able to store a checkpoint only means that the download can not be resumed from here
+  context->checkpointSize = context->downloadedSize;
+
+  OtaCheckpoint* record = new (std::nothrow) OtaCheckpoint;
+  if(record == nullptr) {
+    return true;
+  }
+
+  memcpy(record->id, OTACloudProcessInterface::context->id, sizeof(record->id));
+  memcpy(record->header, context->header.buf, sizeof(record->header));
+  record->contentLength   = context->contentLength;
+  record->downloadedSize  = context->downloadedSize;
+  record->calculatedCrc32 = context->calculatedCrc32;
+  record->flashOffset     = context->flashBuffer.offset();
+  record->decoder         = context->decoder.state();
+  record->sha256          = context->sha256.state();
+  record->seal();
+
+  if(checkpoint_storage->store(*record)) {
+    checkpoint_stored = true;
+  } else {
+    DEBUG_VERBOSE("OTA ERROR: checkpoint could not be stored");
+  }
+
+  delete record;
+  return true;
+}
+
+bool OTADefaultCloudProcessInterface::verifySha256() {
+  // the image can not be compared with a sha256 of another domain
+  if(!imageSha256IsAppSha256()) {
+    return true;
+  }
+
+  return context->sha256.verify(OTACloudProcessInterface::context->finalSha256);
 }
 
 OTADefaultCloudProcessInterface::Context::Context(
-  const char* url, std::function<void(uint8_t)> putc)
+  const char* url, std::function<void(uint8_t)> putc, OtaFlashWriteBuffer::WriteFunc write)
     : parsed_url(url)
     , downloadState(OtaDownloadHeader)
     , calculatedCrc32(arduino::crc32::begin())
@@ -298,6 +535,8 @@ OTADefaultCloudProcessInterface::Context::Context(
     , contentLength(0)
     , writeError(false)
     , downloadedChunkSize(0)
-    , decoder(putc) { }
+    , checkpointSize(0)
+    , decoder(putc)
+    , flashBuffer(write) { }
 
 #endif /* OTA_ENABLED && ! defined(OFFLOADED_DOWNLOAD) */
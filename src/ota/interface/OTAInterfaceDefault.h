@@ -16,8 +16,12 @@
 
 #include <ArduinoHttpClient.h>
 #include <URLParser.h>
-#include <Arduino_Lzss.h>
 #include "OTAInterface.h"
+#include "../utility/OtaHttpRangePipeline.h"
+#include "../utility/OtaFlashWriteBuffer.h"
+#include "../utility/OtaLzssDecoder.h"
+#include "../utility/OtaSha256.h"
+#include "../utility/OtaCheckpoint.h"
 
 /**
  * This class is the extension of the abstract class for OTA, with the addition that
@@ -35,22 +39,64 @@ public:
     this->password = password;
   }
 
+  // the checkpoints of the download are kept in RAM unless the implementation or the sketch
+  // sets a storage surviving a reboot, nullptr goes back to RAM
+  void setCheckpointStorage(OtaCheckpointStorage* storage) {
+    checkpoint_storage = storage != nullptr ? storage : &checkpoint_ram_storage;
+  }
+
 protected:
   State startOTA();
   State fetch();
   void reset();
   virtual int writeFlash(uint8_t* const buffer, size_t len) = 0;
 
+  // writeFlash is called with whole pages of this size, it should match the erase or program
+  // page of the storage holding the update, the default fits the 4KB sectors of the supported boards
+  virtual size_t flashPageSize() { return 4096; }
+
+  // makes the bytes written with writeFlash durable, called before a checkpoint is committed
+  virtual bool syncFlash() { return true; }
+
+  // true if calculateSHA256() hashes exactly the bytes of the decompressed image once it runs,
+  // the finalSha256 of the OTA is the sha256 the board reports then. Only in that case the
+  // image is hashed while it is written and rejected if it does not match the finalSha256
+  virtual bool imageSha256IsAppSha256() { return false; }
+
+  // Implementations able to reopen the update storage at an offset call resumeOffset() in
+  // startOTA(), before calling the base startOTA(). It returns the decompressed bytes already
+  // in the storage if the download of this OTA can be resumed from a checkpoint, 0 otherwise.
+  // If the storage can not be reopened at that offset the checkpoint has to be discarded.
+  uint32_t resumeOffset();
+  void discardCheckpoint();
+  // true while the update storage holds a download which can be resumed
+  inline bool checkpointStored() { return checkpoint_stored; }
+
 private:
   void parseOta(uint8_t* buffer, size_t bufLen);
   State requestOta(OtaFlags mode = None);
+  State fetchRanges();
   bool fetchMore();
+  void restoreCheckpoint();
+  bool commitCheckpoint();
+  bool verifySha256();
 
   Client*     client;
   HttpClient* http_client;
+  // used instead of http_client when the PipelinedDownload policy is enabled
+  OtaHttpRangePipeline* range_pipeline;
 
   const char *username, *password;
 
+  OtaCheckpointStorage*   checkpoint_storage;
+  OtaCheckpointRamStorage checkpoint_ram_storage;
+  // checkpoint loaded by resumeOffset(), restored by startOTA()
+  OtaCheckpoint*          checkpoint;
+  bool                    checkpoint_stored;
+
+  // A checkpoint is committed every time this amount of the file has been downloaded
+  static constexpr uint32_t checkpointInterval = AIOT_CONFIG_OTA_CHECKPOINT_INTERVAL;
+
   // The amount of time that each iteration of Fetch has to take at least
   // This mitigate the issues arising from tasks run in main loop that are using all the computing time
   static constexpr uint32_t downloadTime = 2000;
@@ -71,7 +117,8 @@ protected:
   struct Context {
     Context(
       const char* url,
-      std::function<void(uint8_t)> putc);
+      std::function<void(uint8_t)> putc,
+      OtaFlashWriteBuffer::WriteFunc write);
 
     ParsedUrl         parsed_url;
     ota::OTAHeader    header;
@@ -86,10 +133,19 @@ protected:
     uint32_t          downloadedChunkStartTime;
     uint32_t          downloadedChunkSize;
 
+    // downloadedSize at the last checkpoint
+    uint32_t          checkpointSize;
+
     // LZSS decoder
-    arduino::lzss::Decoder       decoder;
+    OtaLzssDecoder               decoder;
+
+    // collects the decompressed bytes into pages written with writeFlash
+    OtaFlashWriteBuffer          flashBuffer;
+
+    // SHA-256 of the decompressed bytes written with writeFlash
+    OtaSha256                    sha256;
 
-    static constexpr size_t bufLen = 64;
+    static constexpr size_t bufLen = AIOT_CONFIG_OTA_DOWNLOAD_BUFFER_SIZE;
     uint8_t buffer[bufLen];
   } *context;
 };
@@ -0,0 +1,120 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include "OtaCheckpoint.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <new>
+
+#include "../../utility/hash/Fnv1a.h"
+
+static_assert(sizeof(OtaLzssDecoder::State) == OtaLzssDecoder::N + 8,
+  "OtaLzssDecoder::State must not contain padding");
+static_assert(sizeof(OtaSha256::State) == 8 * sizeof(uint32_t) + OtaSha256::BLOCK_SIZE + 2 * sizeof(uint32_t),
+  "OtaSha256::State must not contain padding");
+static_assert(offsetof(OtaCheckpoint, checksum) ==
+  OtaCheckpoint::ID_SIZE + OtaCheckpoint::HEADER_SIZE + 4 * sizeof(uint32_t) +
+  sizeof(OtaLzssDecoder::State) + sizeof(OtaSha256::State),
+  "OtaCheckpoint must not contain padding, its checksum covers all the bytes in front of it");
+
+/******************************************************************************
+  INTERNAL FUNCTION DEFINITION
+ ******************************************************************************/
+
+// FNV-1a over the record, up to the checksum
+static uint32_t checksumOf(OtaCheckpoint const & checkpoint) {
+  return fnv1a(&checkpoint, offsetof(OtaCheckpoint, checksum));
+}
+
+/******************************************************************************
+  PUBLIC MEMBER FUNCTIONS
+ ******************************************************************************/
+
+void OtaCheckpoint::seal() {
+  checksum = checksumOf(*this);
+}
+
+bool OtaCheckpoint::valid(uint8_t const * ota_id) const {
+  return checksum == checksumOf(*this) &&
+    memcmp(id, ota_id, ID_SIZE) == 0 &&
+    downloadedSize >= HEADER_SIZE &&
+    downloadedSize <= contentLength;
+}
+
+OtaCheckpointRamStorage::OtaCheckpointRamStorage()
+: _checkpoint(nullptr) {
+}
+
+OtaCheckpointRamStorage::~OtaCheckpointRamStorage() {
+  clear();
+}
+
+bool OtaCheckpointRamStorage::store(OtaCheckpoint const & checkpoint) {
+  if(_checkpoint == nullptr) {
+    _checkpoint = new (std::nothrow) OtaCheckpoint;
+  }
+
+  if(_checkpoint == nullptr) {
+    return false;
+  }
+
+  memcpy(_checkpoint, &checkpoint, sizeof(OtaCheckpoint));
+  return true;
+}
+
+bool OtaCheckpointRamStorage::load(OtaCheckpoint & checkpoint) {
+  if(_checkpoint == nullptr) {
+    return false;
+  }
+
+  memcpy(&checkpoint, _checkpoint, sizeof(OtaCheckpoint));
+  return true;
+}
+
+void OtaCheckpointRamStorage::clear() {
+  delete _checkpoint;
+  _checkpoint = nullptr;
+}
+
+OtaCheckpointFileStorage::OtaCheckpointFileStorage(char const * path)
+: _path(path) {
+}
+
+bool OtaCheckpointFileStorage::store(OtaCheckpoint const & checkpoint) {
+  FILE* file = fopen(_path, "wb");
+  if(file == nullptr) {
+    return false;
+  }
+
+  bool const written = fwrite(&checkpoint, sizeof(OtaCheckpoint), 1, file) == 1;
+  // fclose flushes the record, it is only stored if that succeeds as well
+  return (fclose(file) == 0) && written;
+}
+
+bool OtaCheckpointFileStorage::load(OtaCheckpoint & checkpoint) {
+  FILE* file = fopen(_path, "rb");
+  if(file == nullptr) {
+    return false;
+  }
+
+  bool const read = fread(&checkpoint, sizeof(OtaCheckpoint), 1, file) == 1;
+  fclose(file);
+  return read;
+}
+
+void OtaCheckpointFileStorage::clear() {
+  remove(_path);
+}
@@ -0,0 +1,111 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "OtaLzssDecoder.h"
+#include "OtaSha256.h"
+
+/******************************************************************************
+  STRUCT DECLARATION
+ ******************************************************************************/
+
+/**
+ * Progress of an OTA download, committed once the decompressed bytes up to
+ * 'flashOffset' have been written to the update storage. The download can be
+ * resumed from 'downloadedSize' with a Range request, after the update storage
+ * has been reopened at 'flashOffset'.
+ */
+struct OtaCheckpoint {
+  static constexpr size_t ID_SIZE = 16;
+  static constexpr size_t HEADER_SIZE = 20;
+
+  uint8_t  id[ID_SIZE];           // id of the OTA the download belongs to
+  uint8_t  header[HEADER_SIZE];   // header of the .ota file
+  uint32_t contentLength;         // length of the .ota file
+  uint32_t downloadedSize;        // bytes of the .ota file processed, header included
+  uint32_t calculatedCrc32;       // running CRC32 of the file, not finalized
+  uint32_t flashOffset;           // decompressed bytes written to the update storage
+  OtaLzssDecoder::State decoder;  // decoder state after 'downloadedSize' bytes
+  OtaSha256::State sha256;        // SHA-256 of the first 'flashOffset' decompressed bytes
+
+  uint32_t checksum;              // detects a record which has only partially been stored
+
+  // computes the checksum of the record before it is stored
+  void seal();
+  // true if the record has been stored completely and belongs to the OTA 'ota_id'
+  bool valid(uint8_t const * ota_id) const;
+};
+
+/******************************************************************************
+  CLASS DECLARATION
+ ******************************************************************************/
+
+/**
+ * Storage of the last checkpoint of an OTA download. A storage in RAM allows to
+ * resume a download after the connection has been lost; implement this interface
+ * on a storage which survives a reset of the board, e.g. a file next to the update
+ * file or a key value store, to resume a download after a reboot.
+ */
+class OtaCheckpointStorage {
+public:
+  virtual ~OtaCheckpointStorage() { }
+
+  // replaces the stored checkpoint, returns false if it could not be stored
+  virtual bool store(OtaCheckpoint const & checkpoint) = 0;
+  // copies the stored checkpoint into 'checkpoint', returns false if there is none
+  virtual bool load(OtaCheckpoint & checkpoint) = 0;
+  virtual void clear() = 0;
+};
+
+/**
+ * Keeps the checkpoint in RAM, the record is allocated when the first checkpoint
+ * is stored and released once it is cleared.
+ */
+class OtaCheckpointRamStorage: public OtaCheckpointStorage {
+public:
+  OtaCheckpointRamStorage();
+  virtual ~OtaCheckpointRamStorage();
+
+  virtual bool store(OtaCheckpoint const & checkpoint) override;
+  virtual bool load(OtaCheckpoint & checkpoint) override;
+  virtual void clear() override;
+
+private:
+  OtaCheckpointRamStorage(OtaCheckpointRamStorage const &) = delete;
+  OtaCheckpointRamStorage & operator = (OtaCheckpointRamStorage const &) = delete;
+
+  OtaCheckpoint * _checkpoint;
+};
+
+/**
+ * Keeps the checkpoint in a file, for the boards which write the update to a file
+ * system: the checkpoint survives a reboot as the update file does. The record is
+ * rewritten as a whole, one which has only partially been written is detected by
+ * its checksum. 'path' is not copied and has to outlive the storage.
+ */
+class OtaCheckpointFileStorage: public OtaCheckpointStorage {
+public:
+  OtaCheckpointFileStorage(char const * path);
+
+  virtual bool store(OtaCheckpoint const & checkpoint) override;
+  virtual bool load(OtaCheckpoint & checkpoint) override;
+  virtual void clear() override;
+
+private:
+  char const * _path;
+};
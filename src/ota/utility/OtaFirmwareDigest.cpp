@@ -0,0 +1,100 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include "OtaFirmwareDigest.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "../../utility/hash/Fnv1a.h"
+
+static_assert(offsetof(OtaFirmwareDigest, checksum) == sizeof(uint32_t) + OtaFirmwareDigest::BUILD_ID_SIZE + OtaSha256::HASH_SIZE,
+  "OtaFirmwareDigest must not contain padding, its checksum covers all the bytes in front of it");
+
+/******************************************************************************
+  PUBLIC MEMBER FUNCTIONS
+ ******************************************************************************/
+
+void OtaFirmwareDigest::seal() {
+  checksum = fnv1a(this, offsetof(OtaFirmwareDigest, checksum));
+}
+
+bool OtaFirmwareDigest::valid(uint32_t app_size, uint8_t const build_id[BUILD_ID_SIZE]) const {
+  return checksum == fnv1a(this, offsetof(OtaFirmwareDigest, checksum)) &&
+    appSize == app_size &&
+    memcmp(buildId, build_id, BUILD_ID_SIZE) == 0;
+}
+
+OtaFirmwareDigestFileStorage::OtaFirmwareDigestFileStorage(char const * path)
+: _path(path) {
+}
+
+bool OtaFirmwareDigestFileStorage::store(OtaFirmwareDigest const & digest) {
+  FILE* file = fopen(_path, "wb");
+  if(file == nullptr) {
+    return false;
+  }
+
+  bool const written = fwrite(&digest, sizeof(OtaFirmwareDigest), 1, file) == 1;
+  return (fclose(file) == 0) && written;
+}
+
+bool OtaFirmwareDigestFileStorage::load(OtaFirmwareDigest & digest) {
+  FILE* file = fopen(_path, "rb");
+  if(file == nullptr) {
+    return false;
+  }
+
+  bool const read = fread(&digest, sizeof(OtaFirmwareDigest), 1, file) == 1;
+  fclose(file);
+  return read;
+}
+
+void OtaFirmwareDigestFileStorage::clear() {
+  remove(_path);
+}
+
+OtaFirmwareDigestCache::OtaFirmwareDigestCache()
+: _storage(nullptr) {
+}
+
+bool OtaFirmwareDigestCache::lookup(uint32_t size, uint8_t const build_id[OtaFirmwareDigest::BUILD_ID_SIZE], uint8_t sha256[OtaSha256::HASH_SIZE]) {
+  OtaFirmwareDigest digest;
+  if(_storage == nullptr || !_storage->load(digest) || !digest.valid(size, build_id)) {
+    return false;
+  }
+
+  memcpy(sha256, digest.sha256, sizeof(digest.sha256));
+  return true;
+}
+
+void OtaFirmwareDigestCache::store(uint32_t size, uint8_t const build_id[OtaFirmwareDigest::BUILD_ID_SIZE], uint8_t const sha256[OtaSha256::HASH_SIZE]) {
+  if(_storage == nullptr) {
+    return;
+  }
+
+  OtaFirmwareDigest digest;
+  digest.appSize = size;
+  memcpy(digest.buildId, build_id, sizeof(digest.buildId));
+  memcpy(digest.sha256, sha256, sizeof(digest.sha256));
+  digest.seal();
+
+  _storage->store(digest);
+}
+
+void OtaFirmwareDigestCache::invalidate() {
+  if(_storage != nullptr) {
+    _storage->clear();
+  }
+}
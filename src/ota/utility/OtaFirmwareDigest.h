@@ -0,0 +1,107 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "OtaSha256.h"
+
+/******************************************************************************
+  STRUCT DECLARATION
+ ******************************************************************************/
+
+/**
+ * SHA-256 of the application running on the board, together with the build id
+ * of the application: an id computed at link time over the whole image, e.g. the
+ * SHA-256 of the ELF file which ESP32 stores in the application descriptor. Any
+ * change of the application changes its build id, a digest is therefore never
+ * taken for the one of another application.
+ */
+struct OtaFirmwareDigest {
+  static constexpr size_t BUILD_ID_SIZE = 32;
+
+  uint32_t appSize;                       // size of the application
+  uint8_t  buildId[BUILD_ID_SIZE];        // build id of the application
+  uint8_t  sha256[OtaSha256::HASH_SIZE];  // SHA-256 of the application
+
+  uint32_t checksum;                      // detects a record which has only partially been stored
+
+  // computes the checksum of the record before it is stored
+  void seal();
+  // true if the record has been stored completely and belongs to the application
+  bool valid(uint32_t app_size, uint8_t const build_id[BUILD_ID_SIZE]) const;
+};
+
+/******************************************************************************
+  CLASS DECLARATION
+ ******************************************************************************/
+
+/**
+ * Storage of the digest of the running application. Implement this interface on
+ * a storage which survives a reset of the board, e.g. a key value store, so that
+ * the application is hashed only once after it has been flashed instead of at
+ * every boot.
+ */
+class OtaFirmwareDigestStorage {
+public:
+  virtual ~OtaFirmwareDigestStorage() { }
+
+  // replaces the stored digest, returns false if it could not be stored
+  virtual bool store(OtaFirmwareDigest const & digest) = 0;
+  // copies the stored digest into 'digest', returns false if there is none
+  virtual bool load(OtaFirmwareDigest & digest) = 0;
+  virtual void clear() = 0;
+};
+
+/**
+ * Keeps the digest in a file, for the boards which have a file system for the OTA
+ * updates. The file system has to be mounted while the digest is looked up or
+ * stored. 'path' is not copied and has to outlive the storage.
+ */
+class OtaFirmwareDigestFileStorage: public OtaFirmwareDigestStorage {
+public:
+  OtaFirmwareDigestFileStorage(char const * path);
+
+  virtual bool store(OtaFirmwareDigest const & digest) override;
+  virtual bool load(OtaFirmwareDigest & digest) override;
+  virtual void clear() override;
+
+private:
+  char const * _path;
+};
+
+/**
+ * Looks up and updates the digest of the running application in a storage, if
+ * one has been set. Only boards which provide a build id of the application use
+ * it, the others hash the application at every boot.
+ */
+class OtaFirmwareDigestCache {
+public:
+  OtaFirmwareDigestCache();
+
+  inline void setStorage(OtaFirmwareDigestStorage * storage) { _storage = storage; }
+
+  // copies the cached SHA-256 of the application into 'sha256', returns false if
+  // there is none for the application of 'size' bytes with 'build_id'
+  bool lookup(uint32_t size, uint8_t const build_id[OtaFirmwareDigest::BUILD_ID_SIZE], uint8_t sha256[OtaSha256::HASH_SIZE]);
+  // caches the SHA-256 of the application of 'size' bytes with 'build_id'
+  void store(uint32_t size, uint8_t const build_id[OtaFirmwareDigest::BUILD_ID_SIZE], uint8_t const sha256[OtaSha256::HASH_SIZE]);
+  // discards the cached SHA-256, e.g. once another application has been downloaded
+  void invalidate();
+
+private:
+  OtaFirmwareDigestStorage * _storage;
+};
@@ -0,0 +1,94 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include "OtaFlashWriteBuffer.h"
+
+#include <string.h>
+
+#include <new>
+
+/******************************************************************************
+  CTOR/DTOR
+ ******************************************************************************/
+
+OtaFlashWriteBuffer::OtaFlashWriteBuffer(WriteFunc write)
+: _write(write)
+, _page(&_byte)
+, _byte(0)
+, _page_size(1)
+, _page_end(1)
+, _offset(0)
+, _length(0)
+, _error(false) {
+}
+
+OtaFlashWriteBuffer::~OtaFlashWriteBuffer() {
+  if(_page != &_byte) {
+    delete[] _page;
+  }
+}
+
+/******************************************************************************
+  PUBLIC MEMBER FUNCTIONS
+ ******************************************************************************/
+
+void OtaFlashWriteBuffer::begin(size_t const page_size, uint32_t const offset) {
+  if(_page != &_byte) {
+    delete[] _page;
+    _page = &_byte;
+    _page_size = 1;
+  }
+
+  if(page_size > 1) {
+    uint8_t * page = new (std::nothrow) uint8_t[page_size];
+    if(page != nullptr) {
+      _page = page;
+      _page_size = page_size;
+    }
+  }
+
+  _offset = offset;
+  _page_end = _page_size - (_offset % _page_size);
+  _length = 0;
+  _error = false;
+}
+
+bool OtaFlashWriteBuffer::write(uint8_t const * data, size_t len) {
+  while(len > 0) {
+    size_t const chunk = (_page_end - _length) < len ? (_page_end - _length) : len;
+    memcpy(_page + _length, data, chunk);
+    _length += chunk;
+    data += chunk;
+    len -= chunk;
+
+    if(_length == _page_end && !flush()) {
+      return false;
+    }
+  }
+  return !_error;
+}
+
+bool OtaFlashWriteBuffer::flush() {
+  if(_length > 0) {
+    if(_write(_page, _length) != static_cast<int>(_length)) {
+      _error = true;
+    }
+
+    // the next write ends at the following page boundary
+    _offset += _length;
+    _page_end = _page_size - (_offset % _page_size);
+    _length = 0;
+  }
+  return !_error;
+}
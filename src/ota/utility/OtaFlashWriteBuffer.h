@@ -0,0 +1,72 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <functional>
+
+/******************************************************************************
+  CLASS DECLARATION
+ ******************************************************************************/
+
+/**
+ * Collects the bytes produced by the decompression of an OTA into pages of the
+ * update storage, so that the storage is written one page at a time instead of
+ * one byte at a time. Pages are aligned to the offset in the storage: after the
+ * download has been started, or the buffer flushed, in the middle of a page the
+ * next write only fills up that page.
+ *
+ * If the page can not be allocated every byte is written on its own.
+ */
+class OtaFlashWriteBuffer {
+public:
+  // writes 'len' bytes to the storage and returns the number of bytes written
+  using WriteFunc = std::function<int(uint8_t* const buffer, size_t len)>;
+
+  OtaFlashWriteBuffer(WriteFunc write);
+  ~OtaFlashWriteBuffer();
+
+  // 'offset' is the position in the storage of the next byte to be written
+  void begin(size_t const page_size, uint32_t const offset = 0);
+
+  // return false once a write to the storage has failed
+  inline bool put(uint8_t const c) {
+    _page[_length++] = c;
+    return (_length < _page_end) ? !_error : flush();
+  }
+  bool write(uint8_t const * data, size_t len);
+  // writes the bytes which have been buffered so far, e.g. at the end of the download
+  bool flush();
+
+  inline size_t   pageSize() const { return _page_size; }
+  // offset in the storage of the next byte to be written
+  inline uint32_t offset()   const { return _offset + _length; }
+  inline bool     error()    const { return _error; }
+
+private:
+  OtaFlashWriteBuffer(OtaFlashWriteBuffer const &) = delete;
+  OtaFlashWriteBuffer & operator = (OtaFlashWriteBuffer const &) = delete;
+
+  WriteFunc _write;
+  uint8_t * _page;
+  uint8_t   _byte; // page of a single byte if the page could not be allocated
+  size_t    _page_size;
+  size_t    _page_end;
+  uint32_t  _offset;
+  size_t    _length;
+  bool      _error;
+};
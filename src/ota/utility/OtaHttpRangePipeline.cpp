@@ -0,0 +1,279 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include "OtaHttpRangePipeline.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+/******************************************************************************
+  LOCAL FUNCTIONS
+ ******************************************************************************/
+
+// case insensitive match of the header name, returns the value without leading spaces
+static char const * headerValue(char const * line, char const * name) {
+  for(; *name != '\0'; line++, name++) {
+    if(tolower(static_cast<unsigned char>(*line)) != tolower(static_cast<unsigned char>(*name))) {
+      return nullptr;
+    }
+  }
+
+  while(*line == ' ' || *line == '\t') {
+    line++;
+  }
+  return line;
+}
+
+// base64 of "username:password", returns the number of characters written or 0 if it does not fit
+static size_t basicAuth(char * out, size_t const size, char const * username, char const * password) {
+  static char const alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+  size_t const username_length = strlen(username);
+  size_t const length = username_length + 1 + strlen(password);
+  size_t const encoded_length = 4 * ((length + 2) / 3);
+
+  if(encoded_length >= size) {
+    return 0;
+  }
+
+  auto at = [&](size_t const i) -> uint32_t {
+    if(i >= length)                     return 0;
+    if(i < username_length)             return static_cast<uint8_t>(username[i]);
+    if(i == username_length)            return ':';
+    return static_cast<uint8_t>(password[i - username_length - 1]);
+  };
+
+  for(size_t i = 0, o = 0; i < length; i += 3, o += 4) {
+    uint32_t const triple = (at(i) << 16) | (at(i + 1) << 8) | at(i + 2);
+    out[o]     = alphabet[(triple >> 18) & 0x3F];
+    out[o + 1] = alphabet[(triple >> 12) & 0x3F];
+    out[o + 2] = i + 1 < length ? alphabet[(triple >> 6) & 0x3F] : '=';
+    out[o + 3] = i + 2 < length ? alphabet[triple & 0x3F] : '=';
+  }
+  out[encoded_length] = '\0';
+  return encoded_length;
+}
+
+/******************************************************************************
+  CTOR/DTOR
+ ******************************************************************************/
+
+OtaHttpRangePipeline::OtaHttpRangePipeline(uint32_t const range_size, size_t const depth)
+: _host(nullptr)
+, _port(0)
+, _path(nullptr)
+, _username(nullptr)
+, _password(nullptr)
+, _range_size(range_size > 0 ? range_size : 1)
+, _depth(depth == 0 ? 1 : (depth < MAX_DEPTH ? depth : static_cast<size_t>(MAX_DEPTH)))
+, _offset(0)
+, _requested(0)
+, _content_length(0)
+, _pending(0)
+, _state(State::StatusLine)
+, _status_code(0)
+, _has_body_length(false)
+, _body_left(0)
+, _has_range(false)
+, _range_start(0)
+, _range_total(0)
+, _connection_close(false)
+, _reconnections(0)
+, _connections(0)
+, _requests(0)
+, _line{0}
+, _line_length(0)
+, _request{0} {
+}
+
+/******************************************************************************
+  PUBLIC MEMBER FUNCTIONS
+ ******************************************************************************/
+
+void OtaHttpRangePipeline::begin(char const * host, uint16_t const port, char const * path, uint32_t const offset) {
+  _host = host;
+  _port = port;
+  _path = path;
+  _offset = offset;
+  _requested = offset;
+  _content_length = 0;
+  _pending = 0;
+  _state = State::StatusLine;
+  _line_length = 0;
+  _reconnections = 0;
+  _connections = 0;
+  _requests = 0;
+}
+
+/******************************************************************************
+  PRIVATE MEMBER FUNCTIONS
+ ******************************************************************************/
+
+size_t OtaHttpRangePipeline::formatRequest() {
+  uint32_t end = _requested + _range_size;
+  if(_content_length > 0 && end > _content_length) {
+    end = _content_length;
+  }
+
+  int const res = snprintf(_request, REQUEST_SIZE,
+    "GET %s HTTP/1.1\r\n"
+    "Host: %s\r\n"
+    "Range: bytes=%lu-%lu\r\n",
+    _path, _host, static_cast<unsigned long>(_requested), static_cast<unsigned long>(end - 1));
+
+  if(res < 0 || static_cast<size_t>(res) >= REQUEST_SIZE) {
+    return 0;
+  }
+  size_t length = static_cast<size_t>(res);
+
+  if(_username != nullptr && _password != nullptr) {
+    static char const authorization[] = "Authorization: Basic ";
+    size_t const authorization_length = sizeof(authorization) - 1;
+
+    if(length + authorization_length >= REQUEST_SIZE) {
+      return 0;
+    }
+    memcpy(_request + length, authorization, authorization_length);
+    length += authorization_length;
+
+    size_t const credentials_length = basicAuth(_request + length, REQUEST_SIZE - length, _username, _password);
+    if(credentials_length == 0) {
+      return 0;
+    }
+    length += credentials_length;
+
+    if(length + 2 >= REQUEST_SIZE) {
+      return 0;
+    }
+    memcpy(_request + length, "\r\n", 2);
+    length += 2;
+  }
+
+  if(length + 2 > REQUEST_SIZE) {
+    return 0;
+  }
+  memcpy(_request + length, "\r\n", 2);
+  length += 2;
+
+  _requested = end;
+  return length;
+}
+
+bool OtaHttpRangePipeline::parse(char const c) {
+  if(c == '\r') {
+    return true;
+  }
+
+  if(c != '\n') {
+    // only the beginning of a line is of interest, the rest of a long header is dropped
+    if(_line_length < LINE_SIZE - 1) {
+      _line[_line_length++] = c;
+    }
+    return true;
+  }
+
+  _line[_line_length] = '\0';
+  bool const res = parseLine();
+  _line_length = 0;
+  return res;
+}
+
+bool OtaHttpRangePipeline::parseLine() {
+  if(_state == State::StatusLine) {
+    if(_line_length == 0) {
+      return true; // tolerate empty lines between responses
+    }
+
+    char const * code = strchr(_line, ' ');
+    if(strncmp(_line, "HTTP/", 5) != 0 || code == nullptr) {
+      return false;
+    }
+
+    _status_code = atoi(code + 1);
+    _has_body_length = false;
+    _has_range = false;
+    _connection_close = false;
+    _state = State::Headers;
+    return true;
+  }
+
+  if(_line_length == 0) {
+    return startBody();
+  }
+
+  return parseHeader();
+}
+
+bool OtaHttpRangePipeline::parseHeader() {
+  char const * value = nullptr;
+
+  if((value = headerValue(_line, "Content-Length:")) != nullptr) {
+    _body_left = strtoul(value, nullptr, 10);
+    _has_body_length = true;
+  } else if((value = headerValue(_line, "Content-Range:")) != nullptr) {
+    // bytes <first>-<last>/<total>
+    char * end = nullptr;
+    value = headerValue(value, "bytes");
+    if(value == nullptr) {
+      return false;
+    }
+    _range_start = strtoul(value, &end, 10);
+    end = strchr(end, '/');
+    if(end == nullptr) {
+      return false;
+    }
+    _range_total = strtoul(end + 1, nullptr, 10);
+    _has_range = true;
+  } else if((value = headerValue(_line, "Connection:")) != nullptr) {
+    _connection_close = headerValue(value, "close") != nullptr;
+  } else if((value = headerValue(_line, "Transfer-Encoding:")) != nullptr) {
+    // a range response always has a length, a chunked body can not be followed
+    return false;
+  }
+  return true;
+}
+
+bool OtaHttpRangePipeline::startBody() {
+  if(!_has_body_length || _body_left == 0) {
+    return false;
+  }
+
+  if(_status_code == 206) {
+    if(!_has_range || _range_start != _offset) {
+      return false;
+    }
+    if(_content_length == 0) {
+      _content_length = _range_total;
+    } else if(_range_total != _content_length) {
+      return false; // the file has changed on the server
+    }
+    if(_body_left > _content_length - _offset) {
+      return false;
+    }
+  } else if(_status_code == 200) {
+    // Range is not supported, the whole file is sent at once and nothing is left to request
+    if(_offset != 0 || _content_length != 0) {
+      return false;
+    }
+    _content_length = _body_left;
+    _requested = _content_length;
+  } else {
+    return false;
+  }
+
+  _state = State::Body;
+  return true;
+}
@@ -0,0 +1,204 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+
+/******************************************************************************
+  CLASS DECLARATION
+ ******************************************************************************/
+
+/**
+ * Downloads a file as a sequence of HTTP Range requests over a single keep-alive
+ * connection. As soon as the headers of a response have been parsed the next
+ * ranges are requested, so the server is already sending the following range
+ * while the body of the current one is being read and a range costs neither a
+ * handshake nor a round trip.
+ *
+ * If the server closes the connection, either with "Connection: close" or by
+ * dropping it, the responses in flight are discarded and the file is requested
+ * again from the first byte which has not been read yet.
+ */
+class OtaHttpRangePipeline {
+public:
+  enum Error: int {
+    ConnectError  = -1, // the server can not be reached or keeps dropping the connection
+    RequestError  = -2, // the request does not fit into the buffer or can not be sent
+    ResponseError = -3, // unexpected status code, range or missing content length
+  };
+
+  // 'range_size' bytes are requested at a time, with at most 'depth' requests in flight
+  OtaHttpRangePipeline(uint32_t const range_size, size_t const depth);
+
+  // 'host' and 'path' have to outlive the download, the file is read from 'offset' on
+  void begin(char const * host, uint16_t const port, char const * path, uint32_t const offset = 0);
+
+  void setAuthentication(char const * const username, char const * const password) {
+    _username = username;
+    _password = password;
+  }
+
+  /**
+   * Reads up to 'size' bytes of the file, (re)connecting and sending requests as needed.
+   * ClientType needs to provide the methods of an Arduino Client: connect(host, port),
+   * connected(), stop(), write(buf, size), available(), read() and read(buf, size).
+   * Returns the number of bytes read, 0 if there are none available yet, or an Error.
+   */
+  template <typename ClientType>
+  int read(ClientType & client, uint8_t * buffer, size_t const size) {
+    if(completed()) {
+      return 0;
+    }
+
+    if(!client.connected()) {
+      client.stop();
+
+      if(_reconnections >= MAX_RECONNECTIONS || !client.connect(_host, _port)) {
+        return ConnectError;
+      }
+
+      // the responses in flight have been lost together with the connection
+      _connections++;
+      _reconnections++;
+      _requested = _offset;
+      _pending = 0;
+      _state = State::StatusLine;
+      _line_length = 0;
+    }
+
+    if(!request(client)) {
+      return RequestError;
+    }
+
+    while(_state != State::Body) {
+      if(client.available() <= 0) {
+        return 0;
+      }
+
+      int const c = client.read();
+      if(c < 0) {
+        return 0;
+      }
+
+      if(!parse(static_cast<char>(c))) {
+        client.stop();
+        return ResponseError;
+      }
+
+      // request the following ranges while the body of this one is in transit
+      if(_state == State::Body && !request(client)) {
+        return RequestError;
+      }
+    }
+
+    if(client.available() <= 0) {
+      return 0;
+    }
+
+    int const bytes_read = client.read(buffer, size < _body_left ? size : _body_left);
+    if(bytes_read <= 0) {
+      return 0;
+    }
+
+    _offset += bytes_read;
+    _body_left -= bytes_read;
+    _reconnections = 0;
+
+    if(_body_left == 0) {
+      _pending--;
+      _state = State::StatusLine;
+
+      if(_connection_close) {
+        client.stop();
+      }
+    }
+
+    return bytes_read;
+  }
+
+  inline bool     completed()     const { return _content_length > 0 && _offset >= _content_length; }
+  // 0 until the headers of the first response have been received
+  inline uint32_t contentLength() const { return _content_length; }
+  inline uint32_t offset()        const { return _offset; }
+  inline uint32_t connections()   const { return _connections; }
+  inline uint32_t requests()      const { return _requests; }
+
+private:
+  static constexpr size_t MAX_DEPTH = 4;
+  static constexpr size_t LINE_SIZE = 96;
+  static constexpr size_t REQUEST_SIZE = 512;
+  // connection attempts in a row which are allowed to fail without receiving any data
+  static constexpr uint8_t MAX_RECONNECTIONS = 3;
+
+  enum class State: uint8_t {
+    StatusLine,
+    Headers,
+    Body
+  };
+
+  template <typename ClientType>
+  bool request(ClientType & client) {
+    // the range of the first request decides the length of the following ones
+    while(_content_length > 0 ? (_pending < _depth && _requested < _content_length) : (_pending == 0)) {
+      size_t const length = formatRequest();
+
+      if(length == 0 || client.write(reinterpret_cast<uint8_t const *>(_request), length) != length) {
+        return false;
+      }
+
+      _pending++;
+      _requests++;
+    }
+    return true;
+  }
+
+  size_t formatRequest();
+  bool parse(char const c);
+  bool parseLine();
+  bool parseHeader();
+  bool startBody();
+
+  char const * _host;
+  uint16_t     _port;
+  char const * _path;
+  char const * _username;
+  char const * _password;
+
+  uint32_t const _range_size;
+  size_t const   _depth;
+
+  uint32_t _offset;
+  uint32_t _requested;
+  uint32_t _content_length;
+  size_t   _pending;
+
+  State    _state;
+  int      _status_code;
+  bool     _has_body_length;
+  uint32_t _body_left;
+  bool     _has_range;
+  uint32_t _range_start;
+  uint32_t _range_total;
+  bool     _connection_close;
+
+  uint8_t  _reconnections;
+  uint32_t _connections;
+  uint32_t _requests;
+
+  char   _line[LINE_SIZE];
+  size_t _line_length;
+  char   _request[REQUEST_SIZE];
+};
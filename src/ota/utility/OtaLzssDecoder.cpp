@@ -0,0 +1,87 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include "OtaLzssDecoder.h"
+
+#include <string.h>
+
+/******************************************************************************
+  CTOR/DTOR
+ ******************************************************************************/
+
+OtaLzssDecoder::OtaLzssDecoder(std::function<void(uint8_t)> putc)
+: _putc(putc) {
+  begin();
+}
+
+/******************************************************************************
+  PUBLIC MEMBER FUNCTIONS
+ ******************************************************************************/
+
+void OtaLzssDecoder::begin() {
+  // the encoder starts with a window filled with spaces
+  memset(_state.window, ' ', N - F);
+  memset(_state.window + N - F, 0, F);
+  _state.r = N - F;
+  _state.code = 0;
+  _state.code_bits = 0;
+  _state.step = Flag;
+  _state.offset = 0;
+}
+
+void OtaLzssDecoder::decompress(uint8_t const * data, size_t len) {
+  for(size_t i = 0; i < len; i++) {
+    for(uint8_t mask = 0x80; mask != 0; mask >>= 1) {
+      uint8_t const bit = (data[i] & mask) ? 1 : 0;
+
+      if(_state.step == Flag) {
+        _state.step = bit ? Literal : Offset;
+        _state.code = 0;
+        _state.code_bits = 0;
+        continue;
+      }
+
+      _state.code = (_state.code << 1) | bit;
+      _state.code_bits++;
+
+      switch(_state.step) {
+      case Literal:
+        if(_state.code_bits == 8) {
+          out(static_cast<uint8_t>(_state.code));
+          _state.step = Flag;
+        }
+        break;
+      case Offset:
+        if(_state.code_bits == EI) {
+          _state.offset = _state.code;
+          _state.code = 0;
+          _state.code_bits = 0;
+          _state.step = Length;
+        }
+        break;
+      case Length:
+        if(_state.code_bits == EJ) {
+          // the reference is copied byte by byte, it may overlap the bytes it produces
+          for(size_t k = 0; k <= static_cast<size_t>(_state.code) + 1; k++) {
+            out(_state.window[(_state.offset + k) & (N - 1)]);
+          }
+          _state.step = Flag;
+        }
+        break;
+      default:
+        break;
+      }
+    }
+  }
+}
@@ -0,0 +1,75 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <functional>
+
+/******************************************************************************
+  CLASS DECLARATION
+ ******************************************************************************/
+
+/**
+ * Streaming decoder of the LZSS compressed payload of an .ota file, see
+ * extras/tools/lzss.c for the encoder. The whole state of the decoder is kept
+ * in a plain struct which can be saved between two calls to decompress() and
+ * restored later on, so that a download can be resumed without decompressing
+ * the file again from its first byte.
+ */
+class OtaLzssDecoder {
+public:
+  static constexpr size_t EI = 11;            // bits of the offset of a reference
+  static constexpr size_t EJ = 4;             // bits of the length of a reference
+  static constexpr size_t N  = 1 << EI;       // size of the window
+  static constexpr size_t F  = (1 << EJ) + 1; // size of the lookahead buffer
+
+  struct State {
+    uint8_t  window[N];  // the last N decompressed bytes
+    uint16_t r;          // position of the next byte in the window
+    uint16_t code;       // bits of the token read so far
+    uint8_t  code_bits;  // number of bits in 'code'
+    uint8_t  step;       // part of the token being read
+    uint16_t offset;     // offset of the reference being read
+  };
+
+  OtaLzssDecoder(std::function<void(uint8_t)> putc);
+
+  // starts a new stream
+  void begin();
+  // decompresses 'len' bytes of the stream, calling putc for every decompressed byte
+  void decompress(uint8_t const * data, size_t len);
+
+  inline State const & state() const { return _state; }
+  inline void restore(State const & state) { _state = state; }
+
+private:
+  enum Step: uint8_t {
+    Flag,
+    Literal,
+    Offset,
+    Length
+  };
+
+  std::function<void(uint8_t)> _putc;
+  State _state;
+
+  inline void out(uint8_t const c) {
+    _putc(c);
+    _state.window[_state.r] = c;
+    _state.r = (_state.r + 1) & (N - 1);
+  }
+};
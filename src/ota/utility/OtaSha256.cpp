@@ -0,0 +1,172 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include "OtaSha256.h"
+
+#include <string.h>
+
+/******************************************************************************
+  CONSTANTS
+ ******************************************************************************/
+
+static uint32_t const K[64] = {
+  0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+  0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+  0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+  0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+  0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+  0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+  0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+  0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+/******************************************************************************
+  INTERNAL FUNCTION DEFINITION
+ ******************************************************************************/
+
+static inline uint32_t rotr(uint32_t const x, unsigned int const n) {
+  return (x >> n) | (x << (32 - n));
+}
+
+/******************************************************************************
+  CTOR/DTOR
+ ******************************************************************************/
+
+OtaSha256::OtaSha256() {
+  begin();
+}
+
+/******************************************************************************
+  PUBLIC MEMBER FUNCTIONS
+ ******************************************************************************/
+
+void OtaSha256::begin() {
+  static uint32_t const H0[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+  };
+  memcpy(_state.h, H0, sizeof(H0));
+  memset(_state.block, 0, sizeof(_state.block));
+  _state.block_length = 0;
+  _state.length = 0;
+}
+
+void OtaSha256::update(uint8_t const * data, size_t len) {
+  // data may be nullptr for an empty update, which memcpy does not accept
+  if(len == 0) {
+    return;
+  }
+  _state.length += len;
+
+  // complete the block started by the previous update
+  if(_state.block_length > 0) {
+    size_t const chunk = (BLOCK_SIZE - _state.block_length) < len ? (BLOCK_SIZE - _state.block_length) : len;
+    memcpy(_state.block + _state.block_length, data, chunk);
+    _state.block_length += chunk;
+    data += chunk;
+    len -= chunk;
+
+    if(_state.block_length < BLOCK_SIZE) {
+      return;
+    }
+    transform(_state.block);
+    _state.block_length = 0;
+  }
+
+  // whole blocks are hashed in place
+  for(; len >= BLOCK_SIZE; data += BLOCK_SIZE, len -= BLOCK_SIZE) {
+    transform(data);
+  }
+
+  memcpy(_state.block, data, len);
+  _state.block_length = len;
+}
+
+void OtaSha256::finalize(uint8_t hash[HASH_SIZE]) {
+  uint64_t const bits = static_cast<uint64_t>(_state.length) * 8;
+
+  // append the bit '1', pad with zeros and end the last block with the length in bits
+  _state.block[_state.block_length++] = 0x80;
+  if(_state.block_length > BLOCK_SIZE - 8) {
+    memset(_state.block + _state.block_length, 0, BLOCK_SIZE - _state.block_length);
+    transform(_state.block);
+    _state.block_length = 0;
+  }
+  memset(_state.block + _state.block_length, 0, BLOCK_SIZE - 8 - _state.block_length);
+  for(size_t i = 0; i < 8; i++) {
+    _state.block[BLOCK_SIZE - 1 - i] = static_cast<uint8_t>(bits >> (8 * i));
+  }
+  transform(_state.block);
+
+  for(size_t i = 0; i < 8; i++) {
+    hash[4 * i + 0] = static_cast<uint8_t>(_state.h[i] >> 24);
+    hash[4 * i + 1] = static_cast<uint8_t>(_state.h[i] >> 16);
+    hash[4 * i + 2] = static_cast<uint8_t>(_state.h[i] >> 8);
+    hash[4 * i + 3] = static_cast<uint8_t>(_state.h[i]);
+  }
+
+  begin();
+}
+
+bool OtaSha256::verify(uint8_t const expected[HASH_SIZE]) {
+  uint8_t hash[HASH_SIZE];
+  finalize(hash);
+
+  bool known = false;
+  for(size_t i = 0; i < HASH_SIZE && !known; i++) {
+    known = (expected[i] != 0);
+  }
+  return !known || memcmp(hash, expected, HASH_SIZE) == 0;
+}
+
+/******************************************************************************
+  PRIVATE MEMBER FUNCTIONS
+ ******************************************************************************/
+
+void OtaSha256::transform(uint8_t const * block) {
+  uint32_t w[64];
+  for(size_t i = 0; i < 16; i++) {
+    w[i] = (static_cast<uint32_t>(block[4 * i]) << 24) | (static_cast<uint32_t>(block[4 * i + 1]) << 16) |
+           (static_cast<uint32_t>(block[4 * i + 2]) << 8) | static_cast<uint32_t>(block[4 * i + 3]);
+  }
+  for(size_t i = 16; i < 64; i++) {
+    uint32_t const s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+    uint32_t const s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+    w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+  }
+
+  uint32_t a = _state.h[0], b = _state.h[1], c = _state.h[2], d = _state.h[3];
+  uint32_t e = _state.h[4], f = _state.h[5], g = _state.h[6], h = _state.h[7];
+
+  for(size_t i = 0; i < 64; i++) {
+    uint32_t const t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + K[i] + w[i];
+    uint32_t const t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+    h = g;
+    g = f;
+    f = e;
+    e = d + t1;
+    d = c;
+    c = b;
+    b = a;
+    a = t1 + t2;
+  }
+
+  _state.h[0] += a;
+  _state.h[1] += b;
+  _state.h[2] += c;
+  _state.h[3] += d;
+  _state.h[4] += e;
+  _state.h[5] += f;
+  _state.h[6] += g;
+  _state.h[7] += h;
+}
@@ -0,0 +1,63 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#pragma once
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+
+/******************************************************************************
+  CLASS DECLARATION
+ ******************************************************************************/
+
+/**
+ * Streaming SHA-256 (FIPS 180-4) of the decompressed OTA image, computed while
+ * the image is written to the update storage. Like OtaLzssDecoder its state is
+ * a plain struct, so that it can be part of the checkpoint of a download.
+ *
+ * The digest covers the decompressed image only, neither the .ota header nor
+ * the LZSS stream, and it is compared with the finalSha256 of the OTA, i.e. the
+ * sha256 the board is going to report once it runs the image. That is only
+ * meaningful on boards whose calculateSHA256() hashes exactly the bytes of the
+ * image, see OTADefaultCloudProcessInterface::imageSha256IsAppSha256().
+ */
+class OtaSha256 {
+public:
+  static constexpr size_t HASH_SIZE = 32;
+  static constexpr size_t BLOCK_SIZE = 64;
+
+  struct State {
+    uint32_t h[8];               // intermediate hash
+    uint8_t  block[BLOCK_SIZE];  // bytes of the block which is not complete yet
+    uint32_t block_length;       // number of bytes in 'block'
+    uint32_t length;             // number of bytes hashed
+  };
+
+  OtaSha256();
+
+  void begin();
+  void update(uint8_t const * data, size_t len);
+  void finalize(uint8_t hash[HASH_SIZE]);
+  // finalizes the digest and compares it with 'expected'. An all zero 'expected' is
+  // a sha256 which is not known, the image is accepted then
+  bool verify(uint8_t const expected[HASH_SIZE]);
+
+  inline State const & state() const { return _state; }
+  inline void restore(State const & state) { _state = state; }
+
+private:
+  State _state;
+
+  void transform(uint8_t const * block);
+};
@@ -0,0 +1,36 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include "CloudWrapperPool.h"
+
+/******************************************************************************
+  STATIC MEMBER DEFINITION
+ ******************************************************************************/
+
+constexpr size_t CloudWrapperPool::SLOT_SIZE;
+ObjectPool<CloudWrapperPool::SLOT_SIZE, AIOT_CONFIG_CLOUD_WRAPPER_POOL_SIZE> CloudWrapperPool::_pool;
+
+/******************************************************************************
+  PUBLIC MEMBER FUNCTIONS
+ ******************************************************************************/
+
+size_t CloudWrapperPool::size()
+{
+  return _pool.size();
+}
+
+size_t CloudWrapperPool::capacity()
+{
+  return _pool.capacity();
+}
@@ -0,0 +1,68 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#ifndef ARDUINO_CLOUD_WRAPPER_POOL_H_
+#define ARDUINO_CLOUD_WRAPPER_POOL_H_
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include "../AIoTC_Config.h"
+#include "../utility/memory/ObjectPool.h"
+
+#include "types/CloudWrapperBool.h"
+#include "types/CloudWrapperFloat.h"
+#include "types/CloudWrapperInt.h"
+#include "types/CloudWrapperUnsignedInt.h"
+#include "types/CloudWrapperString.h"
+
+/******************************************************************************
+  CLASS DECLARATION
+ ******************************************************************************/
+
+/* Storage of the wrappers ArduinoCloud creates for properties bound to
+ * primitive variables. Wrappers are never released, instead of allocating
+ * them one by one they are placed into a pool of
+ * AIOT_CONFIG_CLOUD_WRAPPER_POOL_SIZE slots, which is allocated as a whole
+ * when the first wrapper is created. Once the pool is full further wrappers
+ * are allocated from the heap.
+ */
+class CloudWrapperPool
+{
+public:
+  template <typename T, typename V>
+  static Property * create(V & value)
+  {
+    T * p = _pool.create<T>(value);
+    return p ? p : new T(value);
+  }
+
+  /* Number of wrappers stored in the pool and number of slots of the pool */
+  static size_t size();
+  static size_t capacity();
+
+private:
+  /* Sized to hold the largest of the wrappers */
+  union Slot
+  {
+    uint8_t bool_wrapper[sizeof(CloudWrapperBool)];
+    uint8_t float_wrapper[sizeof(CloudWrapperFloat)];
+    uint8_t int_wrapper[sizeof(CloudWrapperInt)];
+    uint8_t unsigned_int_wrapper[sizeof(CloudWrapperUnsignedInt)];
+    uint8_t string_wrapper[sizeof(CloudWrapperString)];
+  };
+
+  static constexpr size_t SLOT_SIZE = sizeof(Slot);
+
+  static ObjectPool<SLOT_SIZE, AIOT_CONFIG_CLOUD_WRAPPER_POOL_SIZE> _pool;
+};
+
+#endif /* ARDUINO_CLOUD_WRAPPER_POOL_H_ */
@@ -9,10 +9,62 @@
 */
 
 #include "Property.h"
+#include "PropertyContainer.h"
+#include "PropertyNameTable.h"
+#include "../cbor/CBOREncoder.h"
+#include "../utility/memory/HeapStats.h"
+#include "../utility/hash/Fnv1a.h"
 
 #undef max
 #undef min
 #include <algorithm>
+#include <math.h>
+
+/******************************************************************************
+  INTERNAL FUNCTION DEFINITION
+ ******************************************************************************/
+
+/* The first numeric record of a compact message defines the base value, it is
+ * only encoded if it saves more than the bytes it takes itself.
+ */
+static void takeBaseValue(SenMLPackState * pack, double const value)
+{
+  if (pack == nullptr || !pack->compact || pack->base_value_set) {
+    return;
+  }
+  pack->base_value_set = true;
+  pack->base_value = 0;
+  if (!(fabs(value) < 2147483647.0)) {
+    return;
+  }
+  long const base_value = lround(value);
+  if (base_value >= -24 && base_value <= 23) {
+    return;
+  }
+  pack->base_value = base_value;
+  pack->base_value_pending = true;
+}
+
+static long baseValue(SenMLPackState const * pack)
+{
+  return pack ? pack->base_value : 0;
+}
+
+/* Encodes the BaseValue and BaseTime which have been defined by the record being encoded */
+static CborError appendBaseFields(SenMLPackState & pack, CborEncoder & mapEncoder)
+{
+  if (pack.base_value_pending) {
+    CHECK_CBOR(cbor_encode_int(&mapEncoder, static_cast<int>(CborIntegerMapKey::BaseValue)));
+    CHECK_CBOR(cbor_encode_int(&mapEncoder, pack.base_value));
+    pack.base_value_pending = false;
+  }
+  if (pack.base_time_pending) {
+    CHECK_CBOR(cbor_encode_int(&mapEncoder, static_cast<int>(CborIntegerMapKey::BaseTime)));
+    CHECK_CBOR(cbor_encode_uint(&mapEncoder, pack.base_time));
+    pack.base_time_pending = false;
+  }
+  return CborNoError;
+}
 
 /******************************************************************************
   CTOR/DTOR
@@ -21,26 +73,31 @@ Property::Property()
 : _name{""}
 , _min_delta_property{0.0f}
 , _min_time_between_updates_millis{DEFAULT_MIN_TIME_BETWEEN_UPDATES_MILLIS}
-, _permission{Permission::Read}
-, _write_policy{WritePolicy::Auto}
 , _get_time_func{nullptr}
 , _update_callback_func{nullptr}
-, _on_sync_callback_func{nullptr}
-, _update_policy{UpdatePolicy::OnChange}
-, _has_been_updated_once{false}
-, _has_been_modified_in_callback{false}
-, _has_been_appended_but_not_sended{false}
 , _last_updated_millis{0}
 , _update_interval_millis{0}
 , _last_local_change_timestamp{0}
-, _last_cloud_change_timestamp{0}
+, _context{nullptr}
+, _side_table{}
+, _container{nullptr}
+, _container_index{0}
 , _identifier{0}
+, _name_length{0}
+, _name_token_count{0}
 , _attributeIdentifier{0}
+, _permission{static_cast<uint8_t>(Permission::Read)}
+, _write_policy{static_cast<uint8_t>(WritePolicy::Auto)}
+, _update_policy{static_cast<uint8_t>(UpdatePolicy::OnChange)}
+, _has_been_updated_once{false}
+, _has_been_modified_in_callback{false}
+, _has_been_appended_but_not_sended{false}
 , _lightPayload{false}
 , _update_requested{false}
 , _encode_timestamp{false}
 , _echo_requested{false}
-, _timestamp{0}
+, _recording_name_tokens{false}
+, _encoding{false}
 {
 
 }
@@ -53,13 +110,26 @@ namespace PropertyActions
   const String CLEAR = "\x1b";
 }
 
+/* Size budget of the Property base class, 64 bytes on 32 bit MCUs. Fields
+ * which are not needed by every property belong to PropertySideData.
+ */
+static_assert(sizeof(Property) <= 8 * sizeof(void *) + 4 * sizeof(unsigned long) + 4 * sizeof(int), "Property exceeds its size budget");
+
 /******************************************************************************
   PUBLIC MEMBER FUNCTIONS
  ******************************************************************************/
-void Property::init(String const name, Permission const permission, GetTimeCallbackFunc func) {
+bool Property::init(char const * name, Permission const permission, GetTimeCallbackFunc func) {
+  std::vector<char> name_buffer;
+  return init(name, permission, func, name_buffer);
+}
+
+bool Property::init(char const * name, Permission const permission, GetTimeCallbackFunc func, std::vector<char> & name_buffer) {
+  _name_length = strlen(name);
   _name = name;
-  _permission = permission;
+  _permission = static_cast<uint8_t>(permission);
   _get_time_func = func;
+  /* Stores the name, followed by the attribute names, in the PropertyNameTable */
+  return prepareNameTokens(name_buffer);
 }
 
 Property & Property::onUpdate(UpdateCallbackFunc func) {
@@ -68,49 +138,74 @@ Property & Property::onUpdate(UpdateCallbackFunc func) {
 }
 
 Property & Property::onSync(OnSyncCallbackFunc func) {
-  _on_sync_callback_func = func;
+  _side_table.getOrCreate().on_sync_callback_func = func;
   return (*this);
 }
 
 Property & Property::publishOnChange(float const min_delta_property, unsigned long const min_time_between_updates_millis) {
-  _update_policy = UpdatePolicy::OnChange;
+  _update_policy = static_cast<uint8_t>(UpdatePolicy::OnChange);
   _min_delta_property = min_delta_property;
   _min_time_between_updates_millis = min_time_between_updates_millis;
+  markPending();
   return (*this);
 }
 
 Property & Property::publishEvery(unsigned long const seconds) {
-  _update_policy = UpdatePolicy::TimeInterval;
+  _update_policy = static_cast<uint8_t>(UpdatePolicy::TimeInterval);
   _update_interval_millis = (seconds * 1000);
+  markPending();
   return (*this);
 }
 
 Property & Property::publishOnDemand() {
-  _update_policy = UpdatePolicy::OnDemand;
+  _update_policy = static_cast<uint8_t>(UpdatePolicy::OnDemand);
+  markPending();
   return (*this);
 }
 
 Property & Property::encodeTimestamp()
 {
+  _side_table.getOrCreate();
   _encode_timestamp = true;
   return (*this);
 }
 
 Property & Property::writeOnChange()
 {
-  _write_policy = WritePolicy::Auto;
+  _write_policy = static_cast<uint8_t>(WritePolicy::Auto);
   return (*this);
 }
 
 Property & Property::writeOnDemand()
 {
-  _write_policy = WritePolicy::Manual;
+  _write_policy = static_cast<uint8_t>(WritePolicy::Manual);
+  return (*this);
+}
+
+Property & Property::bufferSamples(size_t const capacity)
+{
+  AIOT_HEAP_STATS_SCOPE(Property);
+  _side_table.getOrCreate().series.reserve(capacity);
   return (*this);
 }
 
 void Property::setTimestamp(unsigned long const timestamp)
 {
-  _timestamp = timestamp;
+  _side_table.getOrCreate().timestamp = timestamp;
+}
+
+void Property::recordSample()
+{
+  PropertySideData * side_data = _side_table.get();
+  float value = 0.0f;
+  if (side_data && side_data->series.capacity() > 0 && sampleValue(value)) {
+    side_data->series.push(millis(), value);
+  }
+}
+
+PropertySeries const * Property::series() const
+{
+  return _side_table.get() ? &_side_table.get()->series : nullptr;
 }
 
 bool Property::shouldBeUpdated() {
@@ -130,11 +225,20 @@ bool Property::shouldBeUpdated() {
     return true;
   }
 
-  if (_update_policy == UpdatePolicy::OnChange) {
-    return (isDifferentFromCloud() && ((millis() - _last_updated_millis) >= (_min_time_between_updates_millis)));
-  } else if (_update_policy == UpdatePolicy::TimeInterval) {
-    return ((millis() - _last_updated_millis) >= _update_interval_millis);
-  } else if (_update_policy == UpdatePolicy::OnDemand) {
+  /* The previous message could only hold part of the samples */
+  PropertySideData const * side_data = _side_table.get();
+  if (side_data && side_data->series.backlog()) {
+    return true;
+  }
+
+  /* Elapsed time is computed modulo 2^32 to survive the millis() rollover */
+  uint32_t const elapsed_millis = static_cast<uint32_t>(millis() - _last_updated_millis);
+
+  if (updatePolicy() == UpdatePolicy::OnChange) {
+    return (isDifferentFromCloud() && (elapsed_millis >= (_min_time_between_updates_millis)));
+  } else if (updatePolicy() == UpdatePolicy::TimeInterval) {
+    return (elapsed_millis >= _update_interval_millis);
+  } else if (updatePolicy() == UpdatePolicy::OnDemand) {
     return _update_requested;
   } else {
     return false;
@@ -144,11 +248,13 @@ bool Property::shouldBeUpdated() {
 void Property::requestUpdate()
 {
   _update_requested = true;
+  markPending();
 }
 
 void Property::provideEcho()
 {
   _echo_requested = true;
+  markPending();
 }
 
 void Property::appendCompleted()
@@ -156,6 +262,10 @@ void Property::appendCompleted()
   if (_has_been_appended_but_not_sended) {
     _has_been_appended_but_not_sended = false;
   }
+  PropertySideData * side_data = _side_table.get();
+  if (side_data) {
+    side_data->series.appendCompleted();
+  }
 }
 
 void Property::execCallbackOnChange() {
@@ -164,19 +274,30 @@ void Property::execCallbackOnChange() {
   }
   if (isDifferentFromCloud()) {
     _has_been_modified_in_callback = true;
+    markPending();
   }
 }
 
 void Property::execCallbackOnSync() {
-  if (_on_sync_callback_func != nullptr) {
-    _on_sync_callback_func(*this);
+  PropertySideData const * side_data = _side_table.get();
+  if (side_data && side_data->on_sync_callback_func != nullptr) {
+    side_data->on_sync_callback_func(*this);
   }
 }
 
-CborError Property::append(CborEncoder *encoder, bool lightPayload) {
+CborError Property::append(CborEncoder *encoder, bool lightPayload, SenMLPackState * pack) {
+  AIOT_HEAP_STATS_SCOPE(Property);
   _lightPayload = lightPayload;
   _attributeIdentifier = 0;
-  CHECK_CBOR(appendAttributesToCloud(encoder));
+  SenMLPackState single_property_pack{false, false, false, 0, false, false, 0, false, false};
+  _context.senml_pack = pack ? pack : &single_property_pack;
+  _encoding = true;
+  PropertySideData * side_data = _side_table.get();
+  CborError const append_error = (side_data && !side_data->series.empty()) ? appendSeries(encoder, side_data->series)
+                                                                            : appendAttributesToCloud(encoder);
+  _encoding = false;
+  _context.senml_pack = nullptr;
+  CHECK_CBOR(append_error);
   fromLocalToCloud();
   _has_been_updated_once = true;
   _has_been_modified_in_callback = false;
@@ -187,7 +308,7 @@ CborError Property::append(CborEncoder *encoder, bool lightPayload) {
   return CborNoError;
 }
 
-CborError Property::appendAttribute(bool value, String attributeName, CborEncoder *encoder) {
+CborError Property::appendAttribute(bool value, char const * attributeName, CborEncoder *encoder) {
   return appendAttributeName(attributeName, [value](CborEncoder & mapEncoder)
   {
     CHECK_CBOR(cbor_encode_int(&mapEncoder, static_cast<int>(CborIntegerMapKey::BooleanValue)));
@@ -196,25 +317,41 @@ CborError Property::appendAttribute(bool value, String attributeName, CborEncode
   }, encoder);
 }
 
-CborError Property::appendAttribute(int value, String attributeName, CborEncoder *encoder) {
-  return appendAttributeName(attributeName, [value](CborEncoder & mapEncoder)
+CborError Property::appendAttribute(int value, char const * attributeName, CborEncoder *encoder) {
+  takeBaseValue(senmlPack(), value);
+  int64_t const base_value = baseValue(senmlPack());
+  return appendAttributeName(attributeName, [value, base_value](CborEncoder & mapEncoder)
   {
     CHECK_CBOR(cbor_encode_int(&mapEncoder, static_cast<int>(CborIntegerMapKey::Value)));
-    CHECK_CBOR(cbor_encode_int(&mapEncoder, value));
+    CHECK_CBOR(cbor_encode_int(&mapEncoder, value - base_value));
     return CborNoError;
   }, encoder);
 }
 
-CborError Property::appendAttribute(unsigned int value, String attributeName, CborEncoder *encoder) {
-  return appendAttributeName(attributeName, [value](CborEncoder & mapEncoder)
+CborError Property::appendAttribute(unsigned int value, char const * attributeName, CborEncoder *encoder) {
+  takeBaseValue(senmlPack(), value);
+  int64_t const base_value = baseValue(senmlPack());
+  return appendAttributeName(attributeName, [value, base_value](CborEncoder & mapEncoder)
   {
     CHECK_CBOR(cbor_encode_int(&mapEncoder, static_cast<int>(CborIntegerMapKey::Value)));
-    CHECK_CBOR(cbor_encode_int(&mapEncoder, value));
+    CHECK_CBOR(cbor_encode_int(&mapEncoder, value - base_value));
     return CborNoError;
   }, encoder);
 }
 
-CborError Property::appendAttribute(float value, String attributeName, CborEncoder *encoder) {
+CborError Property::appendAttribute(float value, char const * attributeName, CborEncoder *encoder) {
+  SenMLPackState * const senml_pack = senmlPack();
+  if (senml_pack && senml_pack->compact) {
+    takeBaseValue(senml_pack, value);
+    long const base_value = baseValue(senml_pack);
+    float const min_delta = _min_delta_property;
+    return appendAttributeName(attributeName, [value, base_value, min_delta](CborEncoder & mapEncoder)
+    {
+      CHECK_CBOR(cbor_encode_int(&mapEncoder, static_cast<int>(CborIntegerMapKey::Value)));
+      CHECK_CBOR(CBOREncoder::encodeCompactFloat(mapEncoder, value, min_delta, base_value));
+      return CborNoError;
+    }, encoder);
+  }
   return appendAttributeName(attributeName, [value](CborEncoder & mapEncoder)
   {
     CHECK_CBOR(cbor_encode_int(&mapEncoder, static_cast<int>(CborIntegerMapKey::Value)));
@@ -223,8 +360,8 @@ CborError Property::appendAttribute(float value, String attributeName, CborEncod
   }, encoder);
 }
 
-CborError Property::appendAttribute(String value, String attributeName, CborEncoder *encoder) {
-  return appendAttributeName(attributeName, [value](CborEncoder & mapEncoder)
+CborError Property::appendAttribute(String const & value, char const * attributeName, CborEncoder *encoder) {
+  return appendAttributeName(attributeName, [&value](CborEncoder & mapEncoder)
   {
     CHECK_CBOR(cbor_encode_int(&mapEncoder, static_cast<int>(CborIntegerMapKey::StringValue)));
     CHECK_CBOR(cbor_encode_text_stringz(&mapEncoder, value.c_str()));
@@ -232,15 +369,66 @@ CborError Property::appendAttribute(String value, String attributeName, CborEnco
   }, encoder);
 }
 
-CborError Property::appendAttributeName(String attributeName, std::function<CborError (CborEncoder& mapEncoder)>appendValue, CborEncoder *encoder)
+CborError Property::appendAttributeBegin(char const * attributeName, CborEncoder * encoder, CborEncoder & mapEncoder)
 {
-  if (attributeName != "") {
+  size_t const attributeNameLength = strlen(attributeName);
+  if (attributeNameLength > 0) {
     // when the attribute name string is not empty, the attribute identifier is incremented in order to be encoded in the message if the _lightPayload flag is set
     _attributeIdentifier++;
   }
-  CborEncoder mapEncoder;
+
+  if (_recording_name_tokens)
+  {
+    /* Identifiers which are skipped get an empty name */
+    while (_name_token_count < _attributeIdentifier) {
+      _context.name_token_recording->push_back(0);
+      _name_token_count++;
+    }
+    size_t const length = _name_length + ((attributeNameLength > 0) ? (attributeNameLength + 1) : 0);
+    if (length > UINT8_MAX || _name_token_count == UINT8_MAX) {
+      /* Too long to be recorded, the name is built when the attribute is encoded */
+      return CborNoError;
+    }
+    _context.name_token_recording->push_back(static_cast<char>(length));
+    _context.name_token_recording->insert(_context.name_token_recording->end(), _name, _name + _name_length);
+    if (attributeNameLength > 0) {
+      _context.name_token_recording->push_back(':');
+      _context.name_token_recording->insert(_context.name_token_recording->end(), attributeName, attributeName + attributeNameLength);
+    }
+    _name_token_count++;
+    return CborNoError;
+  }
+
   unsigned int num_map_properties = _encode_timestamp ? 3 : 2;
+  bool reset_base_name = false;
+  SenMLPackState * const senml_pack = senmlPack();
+  if (senml_pack)
+  {
+    if (_encode_timestamp && senml_pack->compact && !senml_pack->base_time_set) {
+      senml_pack->base_time_set = true;
+      senml_pack->base_time_pending = true;
+      senml_pack->base_time = _side_table.get() ? _side_table.get()->timestamp : 0;
+    } else if (!_encode_timestamp && senml_pack->base_time_set && !senml_pack->base_time_fixed) {
+      /* A record without a Time would otherwise be reported at the base time */
+      senml_pack->base_time_set = false;
+      senml_pack->base_time_pending = true;
+      senml_pack->base_time = 0;
+    }
+    reset_base_name = senml_pack->base_name_set;
+    senml_pack->base_name_set = false;
+    num_map_properties += senml_pack->base_value_pending ? 1 : 0;
+    num_map_properties += senml_pack->base_time_pending ? 1 : 0;
+    num_map_properties += reset_base_name ? 1 : 0;
+  }
   CHECK_CBOR(cbor_encoder_create_map(encoder, &mapEncoder, num_map_properties));
+  if (senml_pack)
+  {
+    if (reset_base_name) {
+      CHECK_CBOR(cbor_encode_int(&mapEncoder, static_cast<int>(CborIntegerMapKey::BaseName)));
+      CHECK_CBOR(cbor_encode_text_string(&mapEncoder, "", 0));
+    }
+    CHECK_CBOR(appendBaseFields(*senml_pack, mapEncoder));
+  }
   CHECK_CBOR(cbor_encode_int(&mapEncoder, static_cast<int>(CborIntegerMapKey::Name)));
 
   // if _lightPayload is true, the property and attribute identifiers will be encoded instead of the property name
@@ -254,34 +442,215 @@ CborError Property::appendAttributeName(String attributeName, std::function<Cbor
   }
   else
   {
-    String completeName = _name;
-    if (attributeName != "") {
-      completeName += ":" + attributeName;
+    /* Use the precomputed name as long as it matches the attribute, the attribute
+     * list of a property may depend on its value and differ from the one recorded.
+     */
+    size_t const length = _name_length + ((attributeNameLength > 0) ? (attributeNameLength + 1) : 0);
+    uint8_t const * token = nameToken(_attributeIdentifier);
+    bool const has_token = (token != nullptr) &&
+                           (token[0] == length) &&
+                           (memcmp(token + 1 + length - attributeNameLength, attributeName, attributeNameLength) == 0);
+    if (has_token)
+    {
+      CHECK_CBOR(cbor_encode_text_string(&mapEncoder, reinterpret_cast<char const *>(token + 1), length));
+    }
+    else
+    {
+      String completeName = _name;
+      if (attributeNameLength > 0) {
+        completeName += ":";
+        completeName += attributeName;
+      }
+      CHECK_CBOR(cbor_encode_text_stringz(&mapEncoder, completeName.c_str()));
     }
-    CHECK_CBOR(cbor_encode_text_stringz(&mapEncoder, completeName.c_str()));
   }
-  /* Encode the value */
-  CHECK_CBOR(appendValue(mapEncoder));
+  return CborNoError;
+}
 
+CborError Property::appendAttributeEnd(CborEncoder * encoder, CborEncoder & mapEncoder)
+{
   /* Encode the timestamp if that has been required. */
   if(_encode_timestamp)
   {
+    unsigned long const timestamp = _side_table.get() ? _side_table.get()->timestamp : 0;
     CHECK_CBOR(cbor_encode_int (&mapEncoder, static_cast<int>(CborIntegerMapKey::Time)));
-    CHECK_CBOR(cbor_encode_uint(&mapEncoder, _timestamp));
+    SenMLPackState const * const senml_pack = senmlPack();
+    if (senml_pack && senml_pack->base_time_set) {
+      /* Relative to the base time of the message */
+      CHECK_CBOR(cbor_encode_int(&mapEncoder, static_cast<int64_t>(timestamp) - static_cast<int64_t>(senml_pack->base_time)));
+    } else {
+      CHECK_CBOR(cbor_encode_uint(&mapEncoder, timestamp));
+    }
   }
   /* Close the container */
   CHECK_CBOR(cbor_encoder_close_container(encoder, &mapEncoder));
   return CborNoError;
 }
 
-void Property::setAttributesFromCloud(std::list<CborMapData> * map_data_list) {
-  _map_data_list = map_data_list;
+CborError Property::appendSeries(CborEncoder * encoder, PropertySeries & series)
+{
+  /* Samples are taken with millis(), their time is computed relative to the
+   * current time. Without a valid time no BaseTime is encoded and the Time of
+   * the records is relative to the time the message is received at.
+   */
+  uint32_t const now_millis = millis();
+  uint32_t const oldest_age_millis = now_millis - series[0].millis;
+  unsigned long now = _get_time_func ? _get_time_func() : 0;
+  unsigned long base_time = (now != 0) ? (now - (oldest_age_millis + 999) / 1000) : 0;
+  SenMLPackState * const senml_pack = senmlPack();
+  if (senml_pack->base_time_fixed) {
+    /* The message is reported at the time it is encoded */
+    now = base_time = senml_pack->base_time;
+  }
+
+  size_t count = 0;
+  for (; count < series.size(); count++)
+  {
+    PropertySeries::Sample const & sample = series[count];
+    double const time = static_cast<double>(now - base_time) - static_cast<uint32_t>(now_millis - sample.millis) / 1000.0;
+
+    /* The samples which do not fit into the message are left for the next one */
+    CborEncoder const encoder_before_sample = *encoder;
+    SenMLPackState const pack_before_sample = *senml_pack;
+    CborError error = appendSample(encoder, sample, count == 0, base_time, time);
+    if (error == CborNoError) {
+      /* Leave room to close the message */
+      CborEncoder probe = *encoder;
+      error = cbor_encode_null(&probe);
+    }
+    if (error != CborNoError) {
+      *encoder = encoder_before_sample;
+      *senml_pack = pack_before_sample;
+      if (error != CborErrorOutOfMemory) {
+        return error;
+      }
+      break;
+    }
+  }
+
+  if (count == 0) {
+    return CborErrorOutOfMemory;
+  }
+  series.markAppended(count);
+  return CborNoError;
+}
+
+CborError Property::appendSample(CborEncoder * encoder, PropertySeries::Sample const & sample, bool const first, unsigned long const base_time, double const time)
+{
+  /* The first record names the series through the BaseName and defines its
+   * BaseTime, the following ones only carry a value and a relative time.
+   */
+  SenMLPackState * const senml_pack = senmlPack();
+  bool const encode_name = _lightPayload || first;
+  bool const encode_base_time = first && !senml_pack->base_time_fixed && (base_time != 0 || senml_pack->base_time_set);
+  takeBaseValue(senml_pack, sample.value);
+
+  unsigned int num_map_properties = 2;
+  num_map_properties += encode_name ? 1 : 0;
+  num_map_properties += encode_base_time ? 1 : 0;
+  num_map_properties += senml_pack->base_value_pending ? 1 : 0;
+  num_map_properties += senml_pack->base_time_pending ? 1 : 0;
+
+  CborEncoder mapEncoder;
+  CHECK_CBOR(cbor_encoder_create_map(encoder, &mapEncoder, num_map_properties));
+  if (encode_name) {
+    if (_lightPayload) {
+      CHECK_CBOR(cbor_encode_int(&mapEncoder, static_cast<int>(CborIntegerMapKey::Name)));
+      CHECK_CBOR(cbor_encode_int(&mapEncoder, _identifier));
+    } else {
+      CHECK_CBOR(cbor_encode_int(&mapEncoder, static_cast<int>(CborIntegerMapKey::BaseName)));
+      CHECK_CBOR(cbor_encode_text_string(&mapEncoder, _name, _name_length));
+    }
+  }
+  if (encode_base_time) {
+    CHECK_CBOR(cbor_encode_int(&mapEncoder, static_cast<int>(CborIntegerMapKey::BaseTime)));
+    CHECK_CBOR(cbor_encode_uint(&mapEncoder, base_time));
+  }
+  CHECK_CBOR(appendBaseFields(*senml_pack, mapEncoder));
+
+  /* Integral samples, e.g. the ones of a CloudInt, are encoded as integers */
+  long const base_value = baseValue(senml_pack);
+  CHECK_CBOR(cbor_encode_int(&mapEncoder, static_cast<int>(CborIntegerMapKey::Value)));
+  if (sample.value == floorf(sample.value) && fabsf(sample.value) < 2147483647.0f) {
+    CHECK_CBOR(cbor_encode_int(&mapEncoder, static_cast<int64_t>(sample.value) - base_value));
+  } else if (senml_pack->compact) {
+    CHECK_CBOR(CBOREncoder::encodeCompactFloat(mapEncoder, sample.value, _min_delta_property, base_value));
+  } else {
+    CHECK_CBOR(cbor_encode_float(&mapEncoder, sample.value));
+  }
+
+  CHECK_CBOR(cbor_encode_int(&mapEncoder, static_cast<int>(CborIntegerMapKey::Time)));
+  if (time == floor(time)) {
+    CHECK_CBOR(cbor_encode_int(&mapEncoder, static_cast<int64_t>(time)));
+  } else if (senml_pack->compact) {
+    /* Millisecond resolution */
+    CHECK_CBOR(CBOREncoder::encodeCompactFloat(mapEncoder, static_cast<float>(time), 0.0005f, 0));
+  } else {
+    CHECK_CBOR(cbor_encode_float(&mapEncoder, static_cast<float>(time)));
+  }
+  CHECK_CBOR(cbor_encoder_close_container(encoder, &mapEncoder));
+
+  if (first) {
+    senml_pack->base_name_set = !_lightPayload;
+    if (!senml_pack->base_time_fixed) {
+      senml_pack->base_time_set = (base_time != 0);
+      senml_pack->base_time = base_time;
+    }
+  }
+  return CborNoError;
+}
+
+bool Property::prepareNameTokens(std::vector<char> & recording)
+{
+  /* Dry run of appendAttributesToCloud() which records the names instead of encoding them */
+  recording.assign(_name, _name + _name_length);
+  recording.push_back('\0');
+  _context.name_token_recording = &recording;
+  _name_token_count = 0;
+  _attributeIdentifier = 0;
+  _recording_name_tokens = true;
+  appendAttributesToCloud(nullptr);
+  _recording_name_tokens = false;
+  _attributeIdentifier = 0;
+  _context.name_token_recording = nullptr;
+
+  char const * stored = PropertyNameTable::store(recording.data(), recording.size());
+  if (stored == nullptr) {
+    /* The caller's string may not outlive the property */
+    _name = "";
+    _name_length = 0;
+    _name_token_count = 0;
+    return false;
+  }
+  _name = stored;
+  return true;
+}
+
+uint8_t const * Property::nameToken(unsigned int const attribute_identifier) const
+{
+  if (attribute_identifier >= _name_token_count) {
+    return nullptr;
+  }
+  /* The tokens follow the zero terminated name, each one is prefixed by its length */
+  uint8_t const * token = reinterpret_cast<uint8_t const *>(_name) + _name_length + 1;
+  for (unsigned int i = 0; i < attribute_identifier; i++) {
+    token += 1 + token[0];
+  }
+  return token;
+}
+
+void Property::setAttributesFromCloud(CborMapDataList const * map_data_list) {
+  AIOT_HEAP_STATS_SCOPE(Property);
+  _context.map_data_list = map_data_list;
   _attributeIdentifier = 0;
   setAttributesFromCloud();
+  _context.map_data_list = nullptr;
+  /* The cloud value may now differ from the local one */
+  markPending();
 }
 
-void Property::setAttribute(bool& value, String attributeName) {
-  setAttribute(attributeName, [&value](CborMapData & md) {
+void Property::setAttribute(bool& value, char const * attributeName) {
+  setAttribute(attributeName, [&value](CborMapData const & md) {
     // Manage the case to have boolean values received as integers 0/1
     if (md.bool_val.isSet()) {
       value = md.bool_val.get();
@@ -297,62 +666,44 @@ void Property::setAttribute(bool& value, String attributeName) {
   });
 }
 
-void Property::setAttribute(int& value, String attributeName) {
-  setAttribute(attributeName, [&value](CborMapData & md) {
+void Property::setAttribute(int& value, char const * attributeName) {
+  setAttribute(attributeName, [&value](CborMapData const & md) {
     value = md.val.get();
   });
 }
 
-void Property::setAttribute(unsigned int& value, String attributeName) {
-  setAttribute(attributeName, [&value](CborMapData & md) {
+void Property::setAttribute(unsigned int& value, char const * attributeName) {
+  setAttribute(attributeName, [&value](CborMapData const & md) {
     value = md.val.get();
   });
 }
 
-void Property::setAttribute(float& value, String attributeName) {
-  setAttribute(attributeName, [&value](CborMapData & md) {
+void Property::setAttribute(float& value, char const * attributeName) {
+  setAttribute(attributeName, [&value](CborMapData const & md) {
     value = md.val.get();
   });
 }
 
-void Property::setAttribute(String& value, String attributeName) {
-  setAttribute(attributeName, [&value](CborMapData & md) {
+void Property::setAttribute(String& value, char const * attributeName) {
+  setAttribute(attributeName, [&value](CborMapData const & md) {
     value = md.str_val.get();
   });
 }
 
-void Property::setAttribute(String attributeName, std::function<void (CborMapData & md)>setValue)
+CborMapData const * Property::findAttribute(char const * attributeName)
 {
-  if (attributeName != "") {
+  size_t const attributeNameLength = strlen(attributeName);
+  if (attributeNameLength > 0) {
     _attributeIdentifier++;
   }
 
-  std::for_each(_map_data_list->begin(),
-                _map_data_list->end(),
-                [this, attributeName, setValue](CborMapData & map)
-                {
-                  if (map.light_payload.isSet() && map.light_payload.get())
-                  {
-                    // if a light payload is detected, the attribute identifier is retrieved from the cbor map and the corresponding attribute is updated
-                    int attid = map.attribute_identifier.get();
-                    if (attid == _attributeIdentifier) {
-                      setValue(map);
-                      return;
-                    }
-                  }
-                  else
-                  {
-                    // if a normal payload is detected, the name of the attribute to be updated is extracted directly from the cbor map
-                    String an = map.attribute_name.get();
-                    if (an == attributeName) {
-                      setValue(map);
-                      return;
-                    }
-                  }
-                });
+  // a light payload record is matched on the attribute identifier, a normal payload record on the attribute name
+  return _context.map_data_list->find(_attributeIdentifier, attributeName, attributeNameLength);
 }
 
 void Property::updateLocalTimestamp() {
+  markPending();
+  recordSample();
   if (isReadableByCloud()) {
     if (_get_time_func) {
       _last_local_change_timestamp = _get_time_func();
@@ -361,7 +712,9 @@ void Property::updateLocalTimestamp() {
 }
 
 void Property::setLastCloudChangeTimestamp(unsigned long cloudChangeEventTime) {
-  _last_cloud_change_timestamp = cloudChangeEventTime;
+  if (_side_table.get()) {
+    _side_table.get()->last_cloud_change_timestamp = cloudChangeEventTime;
+  }
 }
 
 void Property::setLastLocalChangeTimestamp(unsigned long localChangeTime) {
@@ -369,7 +722,7 @@ void Property::setLastLocalChangeTimestamp(unsigned long localChangeTime) {
 }
 
 unsigned long Property::getLastCloudChangeTimestamp() {
-  return _last_cloud_change_timestamp;
+  return _side_table.get() ? _side_table.get()->last_cloud_change_timestamp : 0;
 }
 
 unsigned long Property::getLastLocalChangeTimestamp() {
@@ -380,6 +733,38 @@ void Property::setIdentifier(int identifier) {
   _identifier = identifier;
 }
 
+void Property::attachToContainer(PropertyContainer * container, unsigned int const index) {
+  _container = container;
+  _container_index = index;
+}
+
+bool Property::getUpdateDeadline(unsigned long & deadline) {
+  if (!isReadableByCloud()) {
+    return false;
+  }
+
+  if (updatePolicy() == UpdatePolicy::TimeInterval) {
+    deadline = _last_updated_millis + _update_interval_millis;
+    return true;
+  } else if (updatePolicy() == UpdatePolicy::OnChange && isDifferentFromCloud()) {
+    /* The value has changed but the minimum time between updates has not elapsed yet */
+    deadline = _last_updated_millis + _min_time_between_updates_millis;
+    return true;
+  } else {
+    return false;
+  }
+}
+
+/******************************************************************************
+  PROTECTED MEMBER FUNCTIONS
+ ******************************************************************************/
+
+void Property::markPending() {
+  if (_container) {
+    _container->markPending(_container_index);
+  }
+}
+
 /******************************************************************************
   SYNCHRONIZATION CALLBACKS
  ******************************************************************************/
@@ -401,3 +786,63 @@ void onForceCloudSync(Property & property) {
 void onForceDeviceSync(Property & /* property */) {
 
 }
+
+/******************************************************************************
+  CborMapDataList
+ ******************************************************************************/
+
+CborMapDataList::CborMapDataList()
+: _index{nullptr}
+, _size{0}
+{
+
+}
+
+void CborMapDataList::push_back(CborMapData * map_data) {
+  size_t const b = (map_data->light_payload.isSet() && map_data->light_payload.get())
+                 ? bucket(map_data->attribute_identifier.get())
+                 : bucket(map_data->attribute_name.get(), strlen(map_data->attribute_name.get()));
+
+  /* Newer records are prepended, a lookup therefore finds the last one received first */
+  map_data->sequence = _size++;
+  map_data->next_in_bucket = _index[b];
+  _index[b] = map_data;
+}
+
+void CborMapDataList::clear() {
+  for (size_t i = 0; i < INDEX_SIZE; i++) {
+    _index[i] = nullptr;
+  }
+  _size = 0;
+}
+
+CborMapData const * CborMapDataList::find(int const attribute_identifier, char const * attribute_name, size_t const attribute_name_length) const {
+  CborMapData const * light_match = nullptr;
+  for (CborMapData const * m = _index[bucket(attribute_identifier)]; m && !light_match; m = m->next_in_bucket) {
+    if (m->light_payload.isSet() && m->light_payload.get() && m->attribute_identifier.get() == attribute_identifier) {
+      light_match = m;
+    }
+  }
+
+  CborMapData const * name_match = nullptr;
+  for (CborMapData const * m = _index[bucket(attribute_name, attribute_name_length)]; m && !name_match; m = m->next_in_bucket) {
+    if (!(m->light_payload.isSet() && m->light_payload.get()) &&
+        strlen(m->attribute_name.get()) == attribute_name_length &&
+        memcmp(m->attribute_name.get(), attribute_name, attribute_name_length) == 0) {
+      name_match = m;
+    }
+  }
+
+  if (light_match && name_match) {
+    return (light_match->sequence > name_match->sequence) ? light_match : name_match;
+  }
+  return light_match ? light_match : name_match;
+}
+
+size_t CborMapDataList::bucket(char const * attribute_name, size_t const attribute_name_length) {
+  return fnv1a(attribute_name, attribute_name_length) & (INDEX_SIZE - 1);
+}
+
+size_t CborMapDataList::bucket(int const attribute_identifier) {
+  return static_cast<unsigned int>(attribute_identifier) & (INDEX_SIZE - 1);
+}
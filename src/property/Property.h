@@ -26,10 +26,12 @@
 #undef min
 
 # include <functional>
-#include <list>
+#include <vector>
 
 #include <Arduino_TinyCBOR.h>
 
+#include "PropertySeries.h"
+
 /******************************************************************************
   CONST
  ******************************************************************************/
@@ -88,22 +90,71 @@ class MapEntry {
 
 };
 
+/* Values of a single SenML record, staged by the CBORDecoder until the record
+ * is applied to its property. Instances are placed in the decoder arena and
+ * the strings point into the same arena.
+ */
 class CborMapData {
 
   public:
-    MapEntry<int>    base_version;
-    MapEntry<String> base_name;
-    MapEntry<double> base_time;
-    MapEntry<String> name;
-    MapEntry<int>    name_identifier;
-    MapEntry<bool>   light_payload;
-    MapEntry<String> attribute_name;
-    MapEntry<int>    attribute_identifier;
-    MapEntry<int>    property_identifier;
-    MapEntry<double> val;
-    MapEntry<String> str_val;
-    MapEntry<bool>   bool_val;
-    MapEntry<double> time;
+    MapEntry<bool>         light_payload;
+    MapEntry<char const *> attribute_name;
+    MapEntry<int>          attribute_identifier;
+    MapEntry<double>       val;
+    MapEntry<char const *> str_val;
+    MapEntry<bool>         bool_val;
+
+    /* Bookkeeping of the CborMapDataList index */
+    CborMapData *          next_in_bucket;
+    unsigned int           sequence;
+};
+
+/* Records received for a single property, indexed by attribute identifier
+ * (light payload) and by attribute name so that each attribute is found
+ * without scanning all records. If an attribute is received more than once
+ * the last record wins.
+ */
+class CborMapDataList {
+
+  public:
+    CborMapDataList();
+
+    void push_back(CborMapData * map_data);
+    void clear();
+    inline unsigned int size() const {
+      return _size;
+    }
+
+    CborMapData const * find(int const attribute_identifier, char const * attribute_name, size_t const attribute_name_length) const;
+
+  private:
+    static size_t const INDEX_SIZE = 8;
+
+    CborMapData * _index[INDEX_SIZE];
+    unsigned int  _size;
+
+    static size_t bucket(char const * attribute_name, size_t const attribute_name_length);
+    static size_t bucket(int const attribute_identifier);
+};
+
+/* SenML base fields in effect in the message which is being encoded, see
+ * CBOREncoder::encode(). In compact mode the first numeric record of a message
+ * carries a BaseValue and the first timestamped record carries a BaseTime, the
+ * Value and Time of the following records are relative to them. Time series
+ * set the BaseName and BaseTime, records which follow them reset both. A fixed
+ * BaseTime is the time of the whole message, records without a Time are
+ * reported at it.
+ */
+struct SenMLPackState {
+  bool          compact;
+  bool          base_value_set;
+  bool          base_value_pending;
+  long          base_value;
+  bool          base_time_set;
+  bool          base_time_pending;
+  unsigned long base_time;
+  bool          base_name_set;
+  bool          base_time_fixed;
 };
 
 enum class Permission {
@@ -125,8 +176,54 @@ enum class WritePolicy {
 typedef void(*UpdateCallbackFunc)(void);
 typedef unsigned long(*GetTimeCallbackFunc)();
 class Property;
+class PropertyContainer;
 typedef void(*OnSyncCallbackFunc)(Property &);
 
+/* Fields which are only used by some properties, kept out of the Property
+ * object and allocated the first time one of them is needed.
+ */
+struct PropertySideData
+{
+  /* Variables used for the reconnection sync */
+  OnSyncCallbackFunc on_sync_callback_func;
+  unsigned long      last_cloud_change_timestamp;
+  /* Variable used when the timestamp is encoded along with the value */
+  unsigned long      timestamp;
+  /* Samples taken since the property has last been published, see Property::bufferSamples() */
+  PropertySeries     series;
+};
+
+/* Owner of the PropertySideData of a Property, copies of the property get their own copy */
+class PropertySideTable
+{
+  public:
+    PropertySideTable() : _data{nullptr} { }
+    PropertySideTable(PropertySideTable const & other) : _data{other._data ? new PropertySideData(*other._data) : nullptr} { }
+    ~PropertySideTable() {
+      delete _data;
+    }
+    PropertySideTable & operator = (PropertySideTable const & other) {
+      if (this != &other) {
+        delete _data;
+        _data = other._data ? new PropertySideData(*other._data) : nullptr;
+      }
+      return *this;
+    }
+
+    inline PropertySideData * get() const {
+      return _data;
+    }
+    inline PropertySideData & getOrCreate() {
+      if (_data == nullptr) {
+        _data = new PropertySideData{nullptr, 0, 0, PropertySeries()};
+      }
+      return *_data;
+    }
+
+  private:
+    PropertySideData * _data;
+};
+
 /******************************************************************************
   CLASS DECLARATION
  ******************************************************************************/
@@ -136,7 +233,10 @@ class Property
   public:
     Property();
     virtual ~Property() {}
-    void init(String const name, Permission const permission, GetTimeCallbackFunc func);
+    /* Returns false if the name could not be stored, the property is left without a name and shall not be registered */
+    bool init(char const * name, Permission const permission, GetTimeCallbackFunc func);
+    /* Same as above, the attribute names are recorded into 'name_buffer' which can be shared when registering many properties */
+    bool init(char const * name, Permission const permission, GetTimeCallbackFunc func, std::vector<char> & name_buffer);
 
     /* Composable configuration of the Property class */
     Property & onUpdate(UpdateCallbackFunc func);
@@ -145,26 +245,40 @@ class Property
     Property & publishEvery(unsigned long const seconds);
     Property & publishOnDemand();
     Property & encodeTimestamp();
+    /* Keeps up to 'capacity' samples of the value, each assignment takes one,
+     * and publishes all of them at once as a SenML pack of timestamped records.
+     */
+    Property & bufferSamples(size_t const capacity);
     Property & writeOnChange();
     Property & writeOnDemand();
 
     inline String name() const {
+      return String(_name);
+    }
+    /* Same as name() without the copy, the string is owned by the PropertyNameTable */
+    inline char const * nameCStr() const {
       return _name;
     }
+    inline size_t nameLength() const {
+      return _name_length;
+    }
     inline int identifier() const {
       return _identifier;
     }
     inline bool   isReadableByCloud() const {
-      return (_permission == Permission::Read) || (_permission == Permission::ReadWrite);
+      return (permission() == Permission::Read) || (permission() == Permission::ReadWrite);
     }
     inline bool   isWriteableByCloud() const {
-      return (_permission == Permission::Write) || (_permission == Permission::ReadWrite);
+      return (permission() == Permission::Write) || (permission() == Permission::ReadWrite);
     }
     inline bool   isWritableOnChange() const {
-      return _write_policy == WritePolicy::Auto;
+      return static_cast<WritePolicy>(_write_policy) == WritePolicy::Auto;
     }
 
     void setTimestamp(unsigned long const timestamp);
+    /* Adds the current value to the samples, properties bound to a variable need to call it explicitly */
+    void recordSample();
+    PropertySeries const * series() const;
     bool shouldBeUpdated();
     void requestUpdate();
     void appendCompleted();
@@ -176,22 +290,42 @@ class Property
     unsigned long getLastCloudChangeTimestamp();
     unsigned long getLastLocalChangeTimestamp();
     void setIdentifier(int identifier);
+    void attachToContainer(PropertyContainer * container, unsigned int const index);
+    bool getUpdateDeadline(unsigned long & deadline);
 
     void updateLocalTimestamp();
-    CborError append(CborEncoder * encoder, bool lightPayload);
-    CborError appendAttribute(bool value, String attributeName = "", CborEncoder *encoder = nullptr);
-    CborError appendAttribute(int value, String attributeName = "", CborEncoder *encoder = nullptr);
-    CborError appendAttribute(unsigned int value, String attributeName = "", CborEncoder *encoder = nullptr);
-    CborError appendAttribute(float value, String attributeName = "", CborEncoder *encoder = nullptr);
-    CborError appendAttribute(String value, String attributeName = "", CborEncoder *encoder = nullptr);
-    CborError appendAttributeName(String attributeName, std::function<CborError (CborEncoder& mapEncoder)>f, CborEncoder *encoder);
-    void setAttribute(String attributeName, std::function<void (CborMapData & md)>setValue);
-    void setAttributesFromCloud(std::list<CborMapData> * map_data_list);
-    void setAttribute(bool& value, String attributeName = "");
-    void setAttribute(int& value, String attributeName = "");
-    void setAttribute(unsigned int& value, String attributeName = "");
-    void setAttribute(float& value, String attributeName = "");
-    void setAttribute(String& value, String attributeName = "");
+    CborError append(CborEncoder * encoder, bool lightPayload, SenMLPackState * pack = nullptr);
+    CborError appendAttribute(bool value, char const * attributeName = "", CborEncoder *encoder = nullptr);
+    CborError appendAttribute(int value, char const * attributeName = "", CborEncoder *encoder = nullptr);
+    CborError appendAttribute(unsigned int value, char const * attributeName = "", CborEncoder *encoder = nullptr);
+    CborError appendAttribute(float value, char const * attributeName = "", CborEncoder *encoder = nullptr);
+    CborError appendAttribute(String const & value, char const * attributeName = "", CborEncoder *encoder = nullptr);
+    /* Appends the map of a single attribute, appendValue(CborEncoder & mapEncoder) encodes its value */
+    template <typename AppendValueFunc>
+    CborError appendAttributeName(char const * attributeName, AppendValueFunc appendValue, CborEncoder *encoder) {
+      CborEncoder mapEncoder;
+      CHECK_CBOR(appendAttributeBegin(attributeName, encoder, mapEncoder));
+      if (_recording_name_tokens) {
+        return CborNoError;
+      }
+      CHECK_CBOR(appendValue(mapEncoder));
+      return appendAttributeEnd(encoder, mapEncoder);
+    }
+    bool prepareNameTokens(std::vector<char> & recording);
+    /* Calls setValue(CborMapData const & md) if the attribute has been received from the cloud */
+    template <typename SetValueFunc>
+    void setAttribute(char const * attributeName, SetValueFunc setValue) {
+      CborMapData const * map = findAttribute(attributeName);
+      if (map) {
+        setValue(*map);
+      }
+    }
+    void setAttributesFromCloud(CborMapDataList const * map_data_list);
+    void setAttribute(bool& value, char const * attributeName = "");
+    void setAttribute(int& value, char const * attributeName = "");
+    void setAttribute(unsigned int& value, char const * attributeName = "");
+    void setAttribute(float& value, char const * attributeName = "");
+    void setAttribute(String& value, char const * attributeName = "");
 
     virtual bool isDifferentFromCloud() = 0;
     virtual void fromCloudToLocal() = 0;
@@ -201,45 +335,100 @@ class Property
     virtual bool isPrimitive() {
       return false;
     };
+    /* Properties which report every change of their value through updateLocalTimestamp()
+     * return true, the others are polled by the encoder on every run
+     */
+    virtual bool marksPending() const {
+      return false;
+    }
+    /* Polled properties may report a local change of their value, its time is then recorded */
+    virtual bool isChangedLocally() {
+      return false;
+    }
+    /* Numeric properties provide the value a sample of the property is taken of */
+    virtual bool sampleValue(float & /* value */) {
+      return false;
+    }
 
     static unsigned long const DEFAULT_MIN_TIME_BETWEEN_UPDATES_MILLIS = 500; /* Data rate throttled to 2 Hz */
 
   protected:
+    /* Notifies the owning container that this property may need to be sent to the cloud */
+    void markPending();
+
+    /* Name of the property, stored in the PropertyNameTable */
+    char const *       _name;
     /* Variables used for UpdatePolicy::OnChange */
-    String             _name;
     float              _min_delta_property;
     unsigned long      _min_time_between_updates_millis;
 
   private:
-    Permission         _permission;
-    WritePolicy        _write_policy;
+    CborError appendAttributeBegin(char const * attributeName, CborEncoder * encoder, CborEncoder & mapEncoder);
+    CborError appendAttributeEnd(CborEncoder * encoder, CborEncoder & mapEncoder);
+    CborError appendSeries(CborEncoder * encoder, PropertySeries & series);
+    CborError appendSample(CborEncoder * encoder, PropertySeries::Sample const & sample, bool const first, unsigned long const base_time, double const time);
+    CborMapData const * findAttribute(char const * attributeName);
+    uint8_t const * nameToken(unsigned int const attribute_identifier) const;
+    inline SenMLPackState * senmlPack() const {
+      return _encoding ? _context.senml_pack : nullptr;
+    }
+    inline Permission permission() const {
+      return static_cast<Permission>(_permission);
+    }
+    inline UpdatePolicy updatePolicy() const {
+      return static_cast<UpdatePolicy>(_update_policy);
+    }
+
     GetTimeCallbackFunc _get_time_func;
     UpdateCallbackFunc _update_callback_func;
-    OnSyncCallbackFunc _on_sync_callback_func;
-
-    UpdatePolicy       _update_policy;
-    bool               _has_been_updated_once,
-                       _has_been_modified_in_callback,
-                       _has_been_appended_but_not_sended;
     /* Variables used for UpdatePolicy::TimeInterval */
     unsigned long      _last_updated_millis,
                        _update_interval_millis;
-    /* Variables used for reconnection sync*/
+    /* Time of the last local change, kept for every property so that it is known to the
+     * reconnection sync whenever a sync callback is set
+     */
     unsigned long      _last_local_change_timestamp;
-    unsigned long      _last_cloud_change_timestamp;
-    std::list<CborMapData> * _map_data_list;
+    /* State of the operation in progress, so that encoding and decoding do not depend on globals:
+     * the records received within setAttributesFromCloud(), the base fields of the message being
+     * encoded within append() or the buffer the attribute names are recorded into by prepareNameTokens().
+     */
+    union {
+      CborMapDataList const * map_data_list;
+      SenMLPackState *        senml_pack;
+      std::vector<char> *     name_token_recording;
+    } _context;
+    /* Sync callback and timestamps, only allocated for the properties using them */
+    PropertySideTable  _side_table;
+    /* Container this property belongs to and its position within it, used to track pending updates */
+    PropertyContainer * _container;
+    unsigned int       _container_index;
     /* Store the identifier of the property in the array list */
     int                _identifier;
-    int                _attributeIdentifier;
+    uint16_t           _name_length;
+    /* Complete names ("name:attribute") of the attributes indexed by attribute identifier, see
+     * prepareNameTokens(). They follow the name in the PropertyNameTable, each one prefixed by its length.
+     */
+    uint8_t            _name_token_count;
+    uint8_t            _attributeIdentifier;
+    /* Policies and flags, packed into bitfields */
+    uint8_t            _permission : 2;
+    uint8_t            _write_policy : 1;
+    uint8_t            _update_policy : 2;
+    bool               _has_been_updated_once : 1;
+    bool               _has_been_modified_in_callback : 1;
+    bool               _has_been_appended_but_not_sended : 1;
     /* Indicates if the property shall be encoded using the identifier instead of the name */
-    bool               _lightPayload;
+    bool               _lightPayload : 1;
     /* Indicates whether a property update has been requested in case of the OnDemand update policy. */
-    bool               _update_requested;
+    bool               _update_requested : 1;
     /* Indicates whether the timestamp shall be encoded in the property or not */
-    bool               _encode_timestamp;
+    bool               _encode_timestamp : 1;
     /* Indicates if the property shall be echoed back to the cloud even if unchanged */
-    bool               _echo_requested;
-    unsigned long      _timestamp;
+    bool               _echo_requested : 1;
+    /* Set while prepareNameTokens() records the attribute names */
+    bool               _recording_name_tokens : 1;
+    /* Set while append() encodes the property */
+    bool               _encoding : 1;
 };
 
 /******************************************************************************
@@ -247,7 +436,7 @@ class Property
  ******************************************************************************/
 
 inline bool operator == (Property const & lhs, Property const & rhs) {
-  return (lhs.name() == rhs.name());
+  return (strcmp(lhs.nameCStr(), rhs.nameCStr()) == 0);
 }
 
 /******************************************************************************
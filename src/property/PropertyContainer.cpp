@@ -14,7 +14,12 @@
 
 #include "PropertyContainer.h"
 #include <algorithm>
+#include <string.h>
+#include <Arduino_DebugUtils.h>
+#include "../AIoTC_Config.h"
 #include "types/CloudWrapperBase.h"
+#include "../utility/memory/HeapStats.h"
+#include "../utility/hash/Fnv1a.h"
 
 /******************************************************************************
   INTERNAL FUNCTION DECLARATION
@@ -22,56 +27,287 @@
 
 void addProperty(PropertyContainer & prop_cont, Property * property_obj, int propertyIdentifier);
 
+/******************************************************************************
+  CTOR/DTOR
+ ******************************************************************************/
+
+PropertyContainer::PropertyContainer()
+: _has_indirect_identifier{false}
+{
+
+}
+
+/******************************************************************************
+  PUBLIC MEMBER FUNCTIONS
+ ******************************************************************************/
+
+void PropertyContainer::add(Property * property)
+{
+  /* The first property registered with a given identifier wins, mirroring
+   * the behaviour of the former linear search.
+   */
+  int const id = property->identifier();
+  bool const is_known_identifier = (find(id) != nullptr);
+
+  size_t const index = _property_list.size();
+  _property_list.push_back(property);
+  property->attachToContainer(this, index);
+
+  /* Pending update tracking, a newly added property has never been sent */
+  if ((index / 32) >= _pending.size())
+  {
+    _pending.push_back(0);
+    _polled.push_back(0);
+  }
+  _timer_wheel.resize(_property_list.size());
+  markPending(index);
+  if (!property->marksPending())
+    _polled[index / 32] |= (1UL << (index % 32));
+
+  /* Keep the load factor of the name index at or below 50% */
+  if ((_property_list.size() * 2) > _name_index.size())
+    growNameIndex(_property_list.size());
+  else
+    insertIntoNameIndex(fnv1a(property->nameCStr(), property->nameLength()), property);
+
+  /* The direct table is bounded by twice the number of properties, so that a
+   * single sparse identifier does not allocate a table up to its value.
+   */
+  if (is_known_identifier)
+    return;
+  if (id >= 0 && static_cast<size_t>(id) < (_property_list.size() * 2))
+  {
+    if (static_cast<size_t>(id) >= _identifier_index.size())
+      _identifier_index.resize(id + 1, nullptr);
+    _identifier_index[id] = property;
+  }
+  else
+  {
+    _has_indirect_identifier = true;
+  }
+}
+
+void PropertyContainer::clear()
+{
+  for (Property * p : _property_list)
+    p->attachToContainer(nullptr, 0);
+  _property_list.clear();
+  _name_index.clear();
+  _identifier_index.clear();
+  _has_indirect_identifier = false;
+  _pending.clear();
+  _polled.clear();
+  _timer_wheel.clear();
+}
+
+void PropertyContainer::reserve(size_t const num_properties)
+{
+  _property_list.reserve(num_properties);
+  _pending.reserve((num_properties + 31) / 32);
+  _polled.reserve((num_properties + 31) / 32);
+  _timer_wheel.reserve(num_properties);
+  /* Identifiers are assigned from 1 onwards when not given explicitly */
+  _identifier_index.reserve(num_properties + 1);
+  if ((num_properties * 2) > _name_index.size())
+    growNameIndex(num_properties);
+}
+
+Property * PropertyContainer::find(String const & name) const
+{
+  return find(name.c_str(), name.length());
+}
+
+Property * PropertyContainer::find(char const * name, size_t const length) const
+{
+  if (_name_index.empty())
+    return nullptr;
+
+  uint32_t const h    = fnv1a(name, length);
+  size_t   const mask = _name_index.size() - 1;
+
+  for (size_t i = h & mask; _name_index[i].property != nullptr; i = (i + 1) & mask)
+  {
+    Property const * p = _name_index[i].property;
+    if (_name_index[i].hash == h && p->nameLength() == length && memcmp(p->nameCStr(), name, length) == 0)
+      return _name_index[i].property;
+  }
+  return nullptr;
+}
+
+Property * PropertyContainer::find(int const identifier) const
+{
+  if (identifier >= 0 && static_cast<size_t>(identifier) < _identifier_index.size() && _identifier_index[identifier] != nullptr)
+    return _identifier_index[identifier];
+
+  /* Identifiers which did not fit into the direct table when they were added
+   * may lie within its bounds by now, so they are scanned for as well.
+   */
+  if (!_has_indirect_identifier)
+    return nullptr;
+
+  for (Property * p : _property_list)
+  {
+    if (p->identifier() == identifier)
+      return p;
+  }
+  return nullptr;
+}
+
+void PropertyContainer::markPending(size_t const index)
+{
+  if (index < _property_list.size())
+    _pending[index / 32] |= (1UL << (index % 32));
+}
+
+void PropertyContainer::processTimers()
+{
+  _timer_wheel.expire(static_cast<uint32_t>(millis()), [this](size_t const index)
+                                {
+                                  markPending(index);
+                                });
+}
+
+void PropertyContainer::settle(size_t const index)
+{
+  /* Called by the encoder once a pending property has been processed: keep it
+   * pending as long as it still needs to be sent, otherwise clear it and
+   * register the next point in time at which it may need to be sent.
+   */
+  Property * p = _property_list[index];
+  if (p->isReadableByCloud() && p->shouldBeUpdated())
+    return;
+
+  _pending[index / 32] &= ~(1UL << (index % 32));
+
+  unsigned long deadline = 0;
+  if (p->getUpdateDeadline(deadline))
+    _timer_wheel.schedule(index, static_cast<uint32_t>(deadline));
+  else
+    _timer_wheel.cancel(index);
+}
+
+size_t PropertyContainer::nextPending(size_t const index) const
+{
+  return nextSetBit(_pending, &_polled, index, _property_list.size());
+}
+
+size_t PropertyContainer::nextPolled(size_t const index) const
+{
+  return nextSetBit(_polled, nullptr, index, _property_list.size());
+}
+
+/******************************************************************************
+  PRIVATE MEMBER FUNCTIONS
+ ******************************************************************************/
+
+void PropertyContainer::insertIntoNameIndex(uint32_t const name_hash, Property * property)
+{
+  size_t const mask = _name_index.size() - 1;
+  size_t i = name_hash & mask;
+  while (_name_index[i].property != nullptr)
+    i = (i + 1) & mask;
+  _name_index[i].hash = name_hash;
+  _name_index[i].property = property;
+}
+
+void PropertyContainer::growNameIndex(size_t const num_properties)
+{
+  size_t capacity = _name_index.empty() ? 8 : _name_index.size();
+  while (capacity < (num_properties * 2))
+    capacity *= 2;
+
+  _name_index.assign(capacity, NameIndexEntry{0, nullptr});
+
+  /* Rehash from the property list so that the insertion order of colliding
+   * entries is preserved. */
+  for (Property * p : _property_list)
+    insertIntoNameIndex(fnv1a(p->nameCStr(), p->nameLength()), p);
+}
+
+size_t PropertyContainer::nextSetBit(std::vector<uint32_t> const & bitmap, std::vector<uint32_t> const * other, size_t index, size_t const size)
+{
+  while (index < size)
+  {
+    size_t const word_index = index / 32;
+    uint32_t word = bitmap[word_index];
+    if (other)
+      word |= (*other)[word_index];
+    word >>= (index % 32);
+
+    if (word)
+    {
+      index += __builtin_ctz(word);
+      return (index < size) ? index : size;
+    }
+    index = (word_index + 1) * 32;
+  }
+  return size;
+}
+
 /******************************************************************************
   PUBLIC FUNCTION DEFINITION
  ******************************************************************************/
 
 Property & addPropertyToContainer(PropertyContainer & prop_cont, Property & property, String const & name, Permission const permission, int propertyIdentifier, GetTimeCallbackFunc func)
 {
+  AIOT_HEAP_STATS_SCOPE(Property);
+
   /* Check whether or not the property already has been added to the container */
   Property * p = getProperty(prop_cont, name);
   if(p != nullptr) return (*p);
 
   /* Initialize property and add it to the container */
-  property.init(name, permission, func);
+  if (!property.init(name.c_str(), permission, func))
+  {
+    DEBUG_ERROR("addPropertyToContainer: no memory left to store the name of property %s, not added", name.c_str());
+    return property;
+  }
 
   addProperty(prop_cont, &property, propertyIdentifier);
   return property;
 }
 
 
-Property * getProperty(PropertyContainer & prop_cont, String const & name)
+void addPropertiesToContainer(PropertyContainer & prop_cont, PropertyDescriptor const * descriptors, size_t const num_descriptors, GetTimeCallbackFunc func)
 {
-  std::list<Property *>::iterator iter;
+  AIOT_HEAP_STATS_SCOPE(Property);
 
-  iter = std::find_if(prop_cont.begin(),
-                      prop_cont.end(),
-                      [name](Property * p) -> bool
-                      {
-                        return (p->name() == name);
-                      });
+  prop_cont.reserve(prop_cont.size() + num_descriptors);
+  /* Shared by the properties of the table, released once they have been registered */
+  std::vector<char> name_buffer;
 
-  if (iter == prop_cont.end())
-    return nullptr;
-  else
-    return (*iter);
+  for (size_t i = 0; i < num_descriptors; i++)
+  {
+    PropertyDescriptor const & d = descriptors[i];
+    if (prop_cont.find(d.name, strlen(d.name)) != nullptr)
+    {
+      DEBUG_ERROR("addPropertiesToContainer: property %s has already been added, skipped", d.name);
+      continue;
+    }
+    if (!d.property->init(d.name, d.permission, func, name_buffer))
+    {
+      DEBUG_ERROR("addPropertiesToContainer: no memory left to store the name of property %s, skipped", d.name);
+      continue;
+    }
+    d.property->onUpdate(d.on_update);
+    switch (d.update_policy)
+    {
+      case UpdatePolicy::OnChange:     d.property->publishOnChange(d.min_delta_property, d.update_interval); break;
+      case UpdatePolicy::TimeInterval: d.property->publishEvery(d.update_interval); break;
+      case UpdatePolicy::OnDemand:     d.property->publishOnDemand(); break;
+    }
+    addProperty(prop_cont, d.property, d.identifier);
+  }
 }
 
-Property * getProperty(PropertyContainer & prop_cont, int const identifier)
+Property * getProperty(PropertyContainer & prop_cont, String const & name)
 {
-  std::list<Property *>::iterator iter;
-
-  iter = std::find_if(prop_cont.begin(),
-                      prop_cont.end(),
-                      [identifier](Property * p) -> bool
-                      {
-                        return (p->identifier() == identifier);
-                      });
+  return prop_cont.find(name);
+}
 
-  if (iter == prop_cont.end())
-    return nullptr;
-  else
-    return (*iter);
+Property * getProperty(PropertyContainer & prop_cont, int const identifier)
+{
+  return prop_cont.find(identifier);
 }
 
 void requestUpdateForAllProperties(PropertyContainer & prop_cont)
@@ -86,25 +322,24 @@ void requestUpdateForAllProperties(PropertyContainer & prop_cont)
 
 void updateTimestampOnLocallyChangedProperties(PropertyContainer & prop_cont)
 {
-  /* This function updates the timestamps on the primitive properties
-   * that have been modified locally since last cloud synchronization
+  /* This function updates the timestamps on the properties that have
+   * been modified locally since last cloud synchronization. Only the
+   * polled properties (wrappers and properties which do not mark
+   * themselves pending) need to be visited since the others record
+   * their local changes by themselves.
    */
-  std::for_each(prop_cont.begin(),
-                prop_cont.end(),
-                [](Property * p)
-                {
-                  CloudWrapperBase * pbase = reinterpret_cast<CloudWrapperBase *>(p);
-                  if (pbase->isPrimitive() && pbase->isChangedLocally() && pbase->isReadableByCloud())
-                  {
-                    p->updateLocalTimestamp();
-                  }
-                });
+  for (size_t i = prop_cont.nextPolled(0); i < prop_cont.size(); i = prop_cont.nextPolled(i + 1))
+  {
+    Property * p = prop_cont[i];
+    if (p->isChangedLocally() && p->isReadableByCloud())
+    {
+      p->updateLocalTimestamp();
+    }
+  }
 }
 
-void updateProperty(PropertyContainer & prop_cont, String propertyName, unsigned long cloudChangeEventTime, bool const is_sync_message, std::list<CborMapData> * map_data_list)
+void updateProperty(Property * property, unsigned long cloudChangeEventTime, bool const is_sync_message, CborMapDataList const * map_data_list)
 {
-  Property * property = getProperty(prop_cont, propertyName);
-
   if (property && property->isWriteableByCloud())
   {
     property->setLastCloudChangeTimestamp(cloudChangeEventTime);
@@ -151,5 +386,5 @@ void addProperty(PropertyContainer & prop_cont, Property * property_obj, int pro
   {
     property_obj->setIdentifier(prop_cont.size() + 1); /* This is in order to stay compatible to the old system of first increasing _numProperties and then assigning it here. */
   }
-  prop_cont.push_back(property_obj);
+  prop_cont.add(property_obj);
 }
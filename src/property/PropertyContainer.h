@@ -18,10 +18,12 @@
 #include <Arduino.h>
 
 #include "Property.h"
+#include "PropertyDescriptor.h"
+#include "../utility/time/TimerWheel.h"
 
 #undef max
 #undef min
-#include <list>
+#include <vector>
 
 #include "types/CloudBool.h"
 #include "types/CloudFloat.h"
@@ -50,10 +52,89 @@
 extern "C" unsigned long getTime();
 
 /******************************************************************************
-  TYPEDEF
+  CLASS DECLARATION
  ******************************************************************************/
 
-typedef std::list<Property *> PropertyContainer;
+/* The PropertyContainer keeps the properties in insertion order within a
+ * contiguous array (the order determines the round-robin encoding sequence)
+ * and maintains two lookup indices on top of it:
+ *  - an open-addressing hash table (linear probing) keyed on the property
+ *    name, storing the precomputed name hash next to the property pointer;
+ *  - a direct-indexed table keyed on the property identifier, bounded by
+ *    twice the number of properties.
+ * Both lookups are O(1) on average. Identifiers too large for the direct
+ * table fall back to a linear scan.
+ *
+ * The container also tracks which properties may need to be sent to the
+ * cloud so that the encoder does not have to poll every property:
+ *  - a property is marked pending whenever it is modified, an update or echo
+ *    is requested, or a value is received from the cloud;
+ *  - deadlines of the publishEvery interval and of the publishOnChange rate
+ *    limit are kept in a hierarchical timer wheel, the property is marked pending again
+ *    once the deadline expires;
+ *  - wrapper properties (CloudWrapperBase) cannot notify changes of the
+ *    wrapped primitive and are therefore polled on every encoder run, as are
+ *    all properties which do not state that they mark themselves pending
+ *    (Property::marksPending()), e.g. user defined property types.
+ */
+class PropertyContainer
+{
+public:
+
+  typedef std::vector<Property *>::iterator iterator;
+  typedef std::vector<Property *>::const_iterator const_iterator;
+
+  PropertyContainer();
+
+  inline iterator       begin()       { return _property_list.begin(); }
+  inline iterator       end()         { return _property_list.end(); }
+  inline const_iterator begin() const { return _property_list.begin(); }
+  inline const_iterator end()   const { return _property_list.end(); }
+  inline size_t         size()  const { return _property_list.size(); }
+  inline bool           empty() const { return _property_list.empty(); }
+  inline Property *     operator[](size_t const index) const { return _property_list[index]; }
+
+  /* The property needs to be fully initialised (name, identifier) before being added */
+  void add(Property * property);
+  void clear();
+  /* Allocates the storage of 'num_properties' properties up front */
+  void reserve(size_t const num_properties);
+
+  Property * find(String const & name) const;
+  Property * find(char const * name, size_t const length) const;
+  Property * find(int const identifier) const;
+
+  /* Pending update tracking */
+  void   markPending(size_t const index);
+  void   processTimers();
+  void   settle(size_t const index);
+  size_t nextPending(size_t const index) const;
+  size_t nextPolled(size_t const index) const;
+
+private:
+
+  struct NameIndexEntry
+  {
+    uint32_t   hash;
+    Property * property;
+  };
+
+  std::vector<Property *>     _property_list;
+  std::vector<NameIndexEntry> _name_index;
+  std::vector<Property *>     _identifier_index;
+  bool                        _has_indirect_identifier;
+  std::vector<uint32_t>       _pending;
+  std::vector<uint32_t>       _polled;
+  TimerWheel                  _timer_wheel;
+
+  void insertIntoNameIndex(uint32_t const name_hash, Property * property);
+  void growNameIndex(size_t const num_properties);
+  static size_t nextSetBit(std::vector<uint32_t> const & bitmap, std::vector<uint32_t> const * other, size_t index, size_t const size);
+};
+
+/******************************************************************************
+  TYPEDEF
+ ******************************************************************************/
 
 typedef CloudFloat CloudEnergy;
 typedef CloudFloat CloudForce;
@@ -90,6 +171,9 @@ typedef CloudFloat CloudRelativeHumidity;
   FUNCTION DECLARATION
  ******************************************************************************/
 
+/* A property whose name cannot be stored for lack of memory is reported with
+ * DEBUG_ERROR and returned without being added to the container.
+ */
 Property & addPropertyToContainer(PropertyContainer & prop_cont,
                                   Property & property,
                                   String const & name,
@@ -98,13 +182,28 @@ Property & addPropertyToContainer(PropertyContainer & prop_cont,
                                   GetTimeCallbackFunc func = getTime);
 
 
+/* Registers a table of property descriptors in a single pass. Every descriptor
+ * shall refer to a different property with a unique name, a descriptor whose
+ * name has already been added is reported with DEBUG_ERROR and skipped, as is
+ * a descriptor whose name cannot be stored for lack of memory.
+ */
+void addPropertiesToContainer(PropertyContainer & prop_cont,
+                              PropertyDescriptor const * descriptors,
+                              size_t const num_descriptors,
+                              GetTimeCallbackFunc func = getTime);
+
+template <size_t N>
+inline void addPropertiesToContainer(PropertyContainer & prop_cont, PropertyDescriptor const (&descriptors)[N], GetTimeCallbackFunc func = getTime) {
+  addPropertiesToContainer(prop_cont, descriptors, N, func);
+}
+
 Property * getProperty(PropertyContainer & prop_cont, String const & name);
 Property * getProperty(PropertyContainer & prop_cont, int const identifier);
 
 
 void updateTimestampOnLocallyChangedProperties(PropertyContainer & prop_cont);
 void requestUpdateForAllProperties(PropertyContainer & prop_cont);
-void updateProperty(PropertyContainer & prop_cont, String propertyName, unsigned long cloudChangeEventTime, bool const is_sync_message, std::list<CborMapData> * map_data_list);
+void updateProperty(Property * property, unsigned long cloudChangeEventTime, bool const is_sync_message, CborMapDataList const * map_data_list);
 String getPropertyNameByIdentifier(PropertyContainer & prop_cont, int propertyIdentifier);
 
 #endif /* ARDUINO_PROPERTY_CONTAINER_H_ */
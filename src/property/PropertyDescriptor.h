@@ -0,0 +1,74 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#ifndef ARDUINO_PROPERTY_DESCRIPTOR_H_
+#define ARDUINO_PROPERTY_DESCRIPTOR_H_
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include "Property.h"
+
+/******************************************************************************
+  TYPEDEF
+ ******************************************************************************/
+
+/* Compile time description of a property, tables of descriptors are
+ * registered in a single pass by addPropertiesToContainer(). Primitive
+ * variables are described through a statically allocated CloudWrapper:
+ *
+ *   int counter;
+ *   CloudWrapperInt counter_property(counter);
+ *   CloudTemperature temperature;
+ *
+ *   constexpr PropertyDescriptor properties[] = {
+ *     propertyDescriptor(counter_property, "counter", Permission::ReadWrite).onUpdate(onCounterChange),
+ *     propertyDescriptor(temperature, "temperature", Permission::Read).publishEvery(10),
+ *   };
+ *
+ *   ArduinoCloud.addProperties(properties);
+ */
+struct PropertyDescriptor
+{
+  Property *         property;
+  char const *       name;
+  Permission         permission;
+  int                identifier;
+  UpdatePolicy       update_policy;
+  float              min_delta_property;
+  /* Minimum time between updates in ms (OnChange) or update interval in s (TimeInterval) */
+  unsigned long      update_interval;
+  UpdateCallbackFunc on_update;
+
+  constexpr PropertyDescriptor publishOnChange(float const min_delta, unsigned long const min_time_between_updates_millis = Property::DEFAULT_MIN_TIME_BETWEEN_UPDATES_MILLIS) const {
+    return PropertyDescriptor{property, name, permission, identifier, UpdatePolicy::OnChange, min_delta, min_time_between_updates_millis, on_update};
+  }
+  constexpr PropertyDescriptor publishEvery(unsigned long const seconds) const {
+    return PropertyDescriptor{property, name, permission, identifier, UpdatePolicy::TimeInterval, 0.0f, seconds, on_update};
+  }
+  constexpr PropertyDescriptor publishOnDemand() const {
+    return PropertyDescriptor{property, name, permission, identifier, UpdatePolicy::OnDemand, 0.0f, 0, on_update};
+  }
+  constexpr PropertyDescriptor onUpdate(UpdateCallbackFunc const func) const {
+    return PropertyDescriptor{property, name, permission, identifier, update_policy, min_delta_property, update_interval, func};
+  }
+};
+
+/******************************************************************************
+  FUNCTION DEFINITION
+ ******************************************************************************/
+
+/* An identifier of -1 assigns the position of the property within the container, as addPropertyToContainer() does */
+constexpr PropertyDescriptor propertyDescriptor(Property & property, char const * name, Permission const permission, int const identifier = -1) {
+  return PropertyDescriptor{&property, name, permission, identifier, UpdatePolicy::OnChange, 0.0f, Property::DEFAULT_MIN_TIME_BETWEEN_UPDATES_MILLIS, nullptr};
+}
+
+#endif /* ARDUINO_PROPERTY_DESCRIPTOR_H_ */
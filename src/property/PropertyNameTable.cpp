@@ -0,0 +1,72 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include "PropertyNameTable.h"
+#include "../AIoTC_Config.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <new>
+
+/******************************************************************************
+  STATIC MEMBER DEFINITION
+ ******************************************************************************/
+
+PropertyNameTable::Chunk * PropertyNameTable::_head = nullptr;
+size_t PropertyNameTable::_size = 0;
+size_t PropertyNameTable::_capacity = 0;
+
+/******************************************************************************
+  PUBLIC MEMBER FUNCTIONS
+ ******************************************************************************/
+
+char const * PropertyNameTable::store(char const * str, size_t const length)
+{
+  size_t const required = length + 1;
+
+  /* Only the most recent chunk is filled, strings which do not fit start a new
+   * one. Strings larger than a chunk get a chunk of their own.
+   */
+  if (_head == nullptr || (_head->capacity - _head->size) < required)
+  {
+    size_t const capacity = (required > AIOT_CONFIG_PROPERTY_NAME_TABLE_CHUNK_SIZE) ? required : AIOT_CONFIG_PROPERTY_NAME_TABLE_CHUNK_SIZE;
+    uint8_t * mem = new (std::nothrow) uint8_t[sizeof(Chunk) + capacity];
+    if (mem == nullptr)
+      return nullptr;
+
+    Chunk * chunk = reinterpret_cast<Chunk *>(mem);
+    chunk->next = _head;
+    chunk->size = 0;
+    chunk->capacity = capacity;
+    _head = chunk;
+    _capacity += capacity;
+  }
+
+  char * dst = reinterpret_cast<char *>(_head + 1) + _head->size;
+  memcpy(dst, str, length);
+  dst[length] = '\0';
+  _head->size += required;
+  _size += required;
+  return dst;
+}
+
+size_t PropertyNameTable::size()
+{
+  return _size;
+}
+
+size_t PropertyNameTable::capacity()
+{
+  return _capacity;
+}
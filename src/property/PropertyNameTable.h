@@ -0,0 +1,56 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#ifndef ARDUINO_PROPERTY_NAME_TABLE_H_
+#define ARDUINO_PROPERTY_NAME_TABLE_H_
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include <stddef.h>
+
+/******************************************************************************
+  CLASS DECLARATION
+ ******************************************************************************/
+
+/* Append-only table shared by all the properties which stores their names and
+ * precomputed attribute names. Strings are packed into blocks of
+ * AIOT_CONFIG_PROPERTY_NAME_TABLE_CHUNK_SIZE bytes instead of being allocated
+ * one by one, which saves the String object and the allocator overhead of
+ * every name. Stored strings are never released and never move.
+ */
+class PropertyNameTable
+{
+public:
+  /* Copies 'length' bytes of 'str' followed by a terminating zero into the
+   * table, returns nullptr if the memory could not be allocated.
+   */
+  static char const * store(char const * str, size_t const length);
+
+  /* Number of bytes stored and number of bytes allocated for the table */
+  static size_t size();
+  static size_t capacity();
+
+private:
+  struct Chunk
+  {
+    Chunk * next;
+    size_t  size;
+    size_t  capacity;
+    /* The string data follows the header */
+  };
+
+  static Chunk * _head;
+  static size_t  _size;
+  static size_t  _capacity;
+};
+
+#endif /* ARDUINO_PROPERTY_NAME_TABLE_H_ */
@@ -0,0 +1,105 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include "PropertySeries.h"
+
+#include <new>
+
+/******************************************************************************
+  CTOR/DTOR
+ ******************************************************************************/
+
+PropertySeries::PropertySeries()
+: _samples{nullptr}
+, _capacity{0}
+, _head{0}
+, _size{0}
+, _appended{0}
+, _overwritten{0}
+, _backlog{false}
+{
+
+}
+
+PropertySeries::PropertySeries(PropertySeries const & other)
+: PropertySeries()
+{
+  *this = other;
+}
+
+PropertySeries & PropertySeries::operator = (PropertySeries const & other)
+{
+  if (this != &other)
+  {
+    reserve(other._capacity);
+    for (size_t i = 0; i < other._size && _capacity > 0; i++)
+      push(other[i].millis, other[i].value);
+  }
+  return *this;
+}
+
+PropertySeries::~PropertySeries()
+{
+  delete [] _samples;
+}
+
+/******************************************************************************
+  PUBLIC MEMBER FUNCTIONS
+ ******************************************************************************/
+
+bool PropertySeries::reserve(size_t const capacity)
+{
+  delete [] _samples;
+  _samples = (capacity > 0) ? new (std::nothrow) Sample[capacity] : nullptr;
+  _capacity = _samples ? capacity : 0;
+  _head = 0;
+  _size = 0;
+  _appended = 0;
+  _overwritten = 0;
+  _backlog = false;
+  return _samples != nullptr;
+}
+
+void PropertySeries::push(uint32_t const millis, float const value)
+{
+  if (_capacity == 0)
+    return;
+
+  if (_size == _capacity)
+  {
+    /* Overwrite the oldest sample, which may be part of a message being built */
+    _head = (_head + 1) % _capacity;
+    _size--;
+    _overwritten++;
+    if (_appended > 0)
+      _appended--;
+  }
+
+  _samples[(_head + _size) % _capacity] = Sample{millis, value};
+  _size++;
+}
+
+void PropertySeries::markAppended(size_t const count)
+{
+  _appended = (count < _size) ? count : _size;
+}
+
+void PropertySeries::appendCompleted()
+{
+  /* Samples taken after the message has been built are kept for the next one */
+  _backlog = (_appended > 0) && (_appended < _size);
+  _head = (_capacity > 0) ? ((_head + _appended) % _capacity) : 0;
+  _size -= _appended;
+  _appended = 0;
+}
@@ -0,0 +1,75 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#ifndef ARDUINO_PROPERTY_SERIES_H_
+#define ARDUINO_PROPERTY_SERIES_H_
+
+/******************************************************************************
+  INCLUDE
+ ******************************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+
+/******************************************************************************
+  CLASS DECLARATION
+ ******************************************************************************/
+
+/* Ring buffer of the samples a property has taken since it has last been
+ * published. Once the buffer is full the oldest sample is overwritten.
+ *
+ * Samples are encoded in one go but the encoder may only manage to fit part
+ * of them into a message: markAppended() records how many samples went into
+ * the message and appendCompleted() releases them once the message is done.
+ */
+class PropertySeries
+{
+public:
+  struct Sample
+  {
+    uint32_t millis;
+    float    value;
+  };
+
+  PropertySeries();
+  PropertySeries(PropertySeries const & other);
+  PropertySeries & operator = (PropertySeries const & other);
+  ~PropertySeries();
+
+  /* Allocates room for 'capacity' samples, any sample taken so far is dropped */
+  bool reserve(size_t const capacity);
+
+  void push(uint32_t const millis, float const value);
+
+  inline size_t size()     const { return _size; }
+  inline size_t capacity() const { return _capacity; }
+  inline bool   empty()    const { return _size == 0; }
+  /* Number of samples which have been overwritten before being published */
+  inline size_t overwritten() const { return _overwritten; }
+  /* Samples left over from a message which could only hold part of the series */
+  inline bool   backlog()  const { return _backlog; }
+
+  /* Sample 0 is the oldest one */
+  inline Sample const & operator [] (size_t const index) const { return _samples[(_head + index) % _capacity]; }
+
+  void markAppended(size_t const count);
+  void appendCompleted();
+
+private:
+  Sample * _samples;
+  size_t   _capacity;
+  size_t   _head;
+  size_t   _size;
+  size_t   _appended;
+  size_t   _overwritten;
+  bool     _backlog;
+};
+
+#endif /* ARDUINO_PROPERTY_SERIES_H_ */
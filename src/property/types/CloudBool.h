@@ -34,6 +34,9 @@ class CloudBool : public Property {
     operator bool() const {
       return _value;
     }
+    virtual bool marksPending() const {
+      return true;
+    }
     virtual bool isDifferentFromCloud() {
       return _value != _cloud_value;
     }
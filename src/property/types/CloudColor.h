@@ -154,6 +154,9 @@ class CloudColor : public Property {
     CloudColor() : _value(0, 0, 0), _cloud_value(0, 0, 0) {}
     CloudColor(float hue, float saturation, float brightness) : _value(hue, saturation, brightness), _cloud_value(hue, saturation, brightness) {}
 
+    virtual bool marksPending() const {
+      return true;
+    }
     virtual bool isDifferentFromCloud() {
       return _value != _cloud_value;
     }
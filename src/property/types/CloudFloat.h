@@ -37,6 +37,9 @@ class CloudFloat : public Property {
     operator float() const {
       return _value;
     }
+    virtual bool marksPending() const {
+      return true;
+    }
     virtual bool isDifferentFromCloud() {
       return arduino::math::ieee754_different(_value, _cloud_value, Property::_min_delta_property);
     }
@@ -52,6 +55,10 @@ class CloudFloat : public Property {
     virtual void setAttributesFromCloud() {
       setAttribute(_cloud_value, "");
     }
+    virtual bool sampleValue(float & value) {
+      value = _value;
+      return true;
+    }
     //modifiers
     CloudFloat& operator=(float v) {
       _value = v;
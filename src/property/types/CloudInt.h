@@ -34,6 +34,9 @@ class CloudInt : public Property {
     operator int() const {
       return _value;
     }
+    virtual bool marksPending() const {
+      return true;
+    }
     virtual bool isDifferentFromCloud() {
       return _value != _cloud_value && (abs(_value - _cloud_value) >= Property::_min_delta_property);
     }
@@ -49,6 +52,10 @@ class CloudInt : public Property {
     virtual void setAttributesFromCloud() {
       setAttribute(_cloud_value, "");
     }
+    virtual bool sampleValue(float & value) {
+      value = static_cast<float>(_value);
+      return true;
+    }
     //modifiers
     CloudInt& operator=(int v) {
       _value = v;
@@ -54,6 +54,9 @@ class CloudLocation : public Property {
   public:
     CloudLocation() : _value(0, 0), _cloud_value(0, 0) {}
     CloudLocation(float lat, float lon) : _value(lat, lon), _cloud_value(lat, lon) {}
+    virtual bool marksPending() const {
+      return true;
+    }
     virtual bool isDifferentFromCloud() {
       float const distance = Location::distance(_value, _cloud_value);
       return _value != _cloud_value && (abs(distance) >= Property::_min_delta_property);
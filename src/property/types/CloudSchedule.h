@@ -377,6 +377,9 @@ class CloudSchedule : public Property {
     CloudSchedule() : _value(0, 0, 0, 0), _cloud_value(0, 0, 0, 0) {}
     CloudSchedule(unsigned int frm, unsigned int to, unsigned int len, unsigned int msk) : _value(frm, to, len, msk), _cloud_value(frm, to, len, msk) {}
 
+    virtual bool marksPending() const {
+      return true;
+    }
     virtual bool isDifferentFromCloud() {
 
       return _value != _cloud_value;
@@ -39,6 +39,10 @@ class CloudString : public Property {
     }
     void clear() {
       _value = PropertyActions::CLEAR;
+      updateLocalTimestamp();
+    }
+    virtual bool marksPending() const {
+      return true;
     }
     virtual bool isDifferentFromCloud() {
       return _value != _cloud_value;
@@ -34,6 +34,9 @@ class CloudUnsignedInt : public Property {
     operator unsigned int() const {
       return _value;
     }
+    virtual bool marksPending() const {
+      return true;
+    }
     virtual bool isDifferentFromCloud() {
       return _value != _cloud_value && ((std::max(_value , _cloud_value) - std::min(_value , _cloud_value)) >= Property::_min_delta_property);
     }
@@ -49,6 +52,10 @@ class CloudUnsignedInt : public Property {
     virtual void setAttributesFromCloud() {
       setAttribute(_cloud_value, "");
     }
+    virtual bool sampleValue(float & value) {
+      value = static_cast<float>(_value);
+      return true;
+    }
     //modifiers
     CloudUnsignedInt& operator=(unsigned int v) {
       _value = v;
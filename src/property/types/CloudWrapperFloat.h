@@ -47,6 +47,10 @@ class CloudWrapperFloat : public CloudWrapperBase {
     virtual void setAttributesFromCloud() {
       setAttribute(_cloud_value, "");
     }
+    virtual bool sampleValue(float & value) {
+      value = _primitive_value;
+      return true;
+    }
     virtual bool isPrimitive() {
       return true;
     }
@@ -44,6 +44,10 @@ class CloudWrapperUnsignedInt : public CloudWrapperBase {
     virtual void setAttributesFromCloud() {
       setAttribute(_cloud_value, "");
     }
+    virtual bool sampleValue(float & value) {
+      value = static_cast<float>(_primitive_value);
+      return true;
+    }
     virtual bool isPrimitive() {
       return true;
     }
@@ -48,6 +48,9 @@ class CloudDimmedLight : public Property {
     CloudDimmedLight() : _value(false, 0), _cloud_value(false, 0) {}
     CloudDimmedLight(bool swi, float brightness) : _value(swi, brightness), _cloud_value(swi, brightness) {}
 
+    virtual bool marksPending() const {
+      return true;
+    }
     virtual bool isDifferentFromCloud() {
 
       return _value != _cloud_value;
@@ -74,6 +77,7 @@ class CloudDimmedLight : public Property {
 
     void setBrightness(float const bri) {
       _value.bri = bri;
+      updateLocalTimestamp();
     }
 
     bool getSwitch() {
@@ -82,6 +86,7 @@ class CloudDimmedLight : public Property {
 
     void setSwitch(bool const swi) {
       _value.swi = swi;
+      updateLocalTimestamp();
     }
 
     virtual void fromCloudToLocal() {
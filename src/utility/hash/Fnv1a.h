@@ -0,0 +1,52 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#ifndef ARDUINO_IOT_CLOUD_FNV1A_H_
+#define ARDUINO_IOT_CLOUD_FNV1A_H_
+
+/******************************************************************************
+ * INCLUDE
+ ******************************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+
+/******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+static uint32_t const FNV1A_OFFSET_BASIS = 2166136261UL;
+static uint32_t const FNV1A_PRIME        = 16777619UL;
+
+/******************************************************************************
+ * FUNCTION DEFINITION
+ ******************************************************************************/
+
+/* 32 bit FNV-1a of 'len' bytes, pass the hash of the preceding bytes as 'hash'
+ * to continue it over data which is not contiguous.
+ */
+inline uint32_t fnv1a(void const * data, size_t const len, uint32_t hash = FNV1A_OFFSET_BASIS)
+{
+  uint8_t const * bytes = static_cast<uint8_t const *>(data);
+  for (size_t i = 0; i < len; i++)
+    hash = (hash ^ bytes[i]) * FNV1A_PRIME;
+  return hash;
+}
+
+/* 32 bit FNV-1a of a null terminated string, terminator excluded */
+inline uint32_t fnv1a(char const * str)
+{
+  uint32_t hash = FNV1A_OFFSET_BASIS;
+  for (; *str != '\0'; str++)
+    hash = (hash ^ static_cast<uint8_t>(*str)) * FNV1A_PRIME;
+  return hash;
+}
+
+#endif /* ARDUINO_IOT_CLOUD_FNV1A_H_ */
@@ -0,0 +1,119 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#ifndef ARDUINO_IOT_CLOUD_BUMP_ARENA_H_
+#define ARDUINO_IOT_CLOUD_BUMP_ARENA_H_
+
+/******************************************************************************
+ * INCLUDE
+ ******************************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <new>
+
+/******************************************************************************
+ * CLASS DECLARATION
+ ******************************************************************************/
+
+/* Bump allocator with SIZE bytes of inline storage. Memory is handed out
+ * sequentially and released all at once with reset() or back to a previously
+ * taken mark with rewind(). Allocations which do not fit into the inline
+ * storage are served from dedicated heap blocks so that oversize data is still
+ * handled, those blocks are released by reset()/rewind() as well.
+ *
+ * No destructors are run, only trivially destructible objects may be placed
+ * into the arena.
+ */
+template <size_t SIZE>
+class BumpArena
+{
+
+private:
+
+  union OverflowBlock
+  {
+    OverflowBlock * next;
+    double          align_double;
+    long long       align_long_long;
+  };
+
+public:
+
+  struct Mark
+  {
+    size_t          used;
+    OverflowBlock * overflow;
+  };
+
+  BumpArena() : _used{0}, _overflow{nullptr}, _overflow_allocations{0} { }
+  ~BumpArena() { reset(); }
+
+  void * allocate(size_t const size, size_t const alignment)
+  {
+    size_t const offset = (_used + alignment - 1) & ~(alignment - 1);
+    if (offset + size <= SIZE) {
+      _used = offset + size;
+      return _buf.bytes + offset;
+    }
+
+    /* Spill over into a heap block, the payload follows the block header */
+    uint8_t * mem = new (std::nothrow) uint8_t[sizeof(OverflowBlock) + size];
+    if (!mem)
+      return nullptr;
+    OverflowBlock * block = reinterpret_cast<OverflowBlock *>(mem);
+    block->next = _overflow;
+    _overflow = block;
+    _overflow_allocations++;
+    return mem + sizeof(OverflowBlock);
+  }
+
+  template <typename T>
+  T * create()
+  {
+    void * mem = allocate(sizeof(T), alignof(T));
+    return mem ? new (mem) T() : nullptr;
+  }
+
+  inline Mark mark() const { return Mark{_used, _overflow}; }
+
+  void rewind(Mark const & m)
+  {
+    while (_overflow && _overflow != m.overflow) {
+      OverflowBlock * next = _overflow->next;
+      delete [] reinterpret_cast<uint8_t *>(_overflow);
+      _overflow = next;
+    }
+    _used = m.used;
+  }
+
+  inline void reset() { rewind(Mark{0, nullptr}); }
+
+  inline size_t used()                const { return _used; }
+  inline size_t capacity()            const { return SIZE; }
+  /* Number of allocations which did not fit into the inline storage so far */
+  inline size_t overflowAllocations() const { return _overflow_allocations; }
+
+private:
+
+  union
+  {
+    uint8_t         bytes[SIZE];
+    double          align_double;
+    long long       align_long_long;
+    void *          align_pointer;
+  } _buf;
+  size_t          _used;
+  OverflowBlock * _overflow;
+  size_t          _overflow_allocations;
+
+};
+
+#endif /* ARDUINO_IOT_CLOUD_BUMP_ARENA_H_ */
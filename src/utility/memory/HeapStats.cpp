@@ -0,0 +1,312 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+ * INCLUDE
+ ******************************************************************************/
+
+#include "HeapStats.h"
+
+#if AIOT_CONFIG_HEAP_STATS
+
+#include <stdlib.h>
+#include <new>
+
+/* In the host build malloc() and friends are hooked as well, the hooks forward
+ * to the glibc implementation. Sanitizers provide their own allocator, only
+ * operator new is hooked in that case.
+ */
+#if defined(HOST) && defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__)
+  #define AIOT_HEAP_STATS_HOOK_MALLOC (1)
+  extern "C" void * __libc_malloc(size_t size);
+  extern "C" void * __libc_calloc(size_t num, size_t size);
+  extern "C" void * __libc_realloc(void * ptr, size_t size);
+  extern "C" void   __libc_free(void * ptr);
+#else
+  #define AIOT_HEAP_STATS_HOOK_MALLOC (0)
+#endif
+
+/******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+static HeapStats heap_stats;
+static HeapSubsystem current_subsystem = HeapSubsystem::Other;
+
+/******************************************************************************
+ * CTOR/DTOR
+ ******************************************************************************/
+
+HeapStatsScope::HeapStatsScope(HeapSubsystem const subsystem)
+: _previous{current_subsystem}
+{
+  current_subsystem = subsystem;
+}
+
+HeapStatsScope::~HeapStatsScope()
+{
+  current_subsystem = _previous;
+}
+
+/******************************************************************************
+ * INTERNAL FUNCTION DEFINITION
+ ******************************************************************************/
+
+static void charge(HeapCounters & counters, size_t const size)
+{
+  counters.allocations++;
+  counters.allocated_bytes += size;
+  counters.current_bytes += size;
+  if (counters.current_bytes > counters.peak_bytes)
+    counters.peak_bytes = counters.current_bytes;
+}
+
+static void discharge(HeapCounters & counters, size_t const size)
+{
+  counters.deallocations++;
+  counters.current_bytes -= (size < counters.current_bytes) ? size : counters.current_bytes;
+}
+
+static void restart(HeapCounters & counters)
+{
+  counters.allocations = 0;
+  counters.deallocations = 0;
+  counters.allocated_bytes = 0;
+  counters.peak_bytes = counters.current_bytes;
+}
+
+/******************************************************************************
+ * FUNCTION DEFINITION
+ ******************************************************************************/
+
+HeapStats heap_stats_get()
+{
+  return heap_stats;
+}
+
+void heap_stats_reset()
+{
+  for (HeapCounters & counters : heap_stats.subsystem)
+    restart(counters);
+  restart(heap_stats.total);
+}
+
+HeapSubsystem heap_stats_allocated(size_t const size)
+{
+  HeapSubsystem const subsystem = current_subsystem;
+  charge(heap_stats.subsystem[static_cast<size_t>(subsystem)], size);
+  charge(heap_stats.total, size);
+  return subsystem;
+}
+
+void heap_stats_released(HeapSubsystem const subsystem, size_t const size)
+{
+  discharge(heap_stats.subsystem[static_cast<size_t>(subsystem)], size);
+  discharge(heap_stats.total, size);
+}
+
+/******************************************************************************
+ * OPERATOR NEW/DELETE
+ ******************************************************************************/
+
+/* Every block allocated through operator new is prefixed with its size and
+ * the subsystem it has been charged to.
+ */
+union AllocationHeader
+{
+  struct
+  {
+    size_t        size;
+    HeapSubsystem subsystem;
+  } info;
+  long double alignment;
+  void *      pointer;
+};
+
+static void * allocate(size_t const size)
+{
+#if AIOT_HEAP_STATS_HOOK_MALLOC
+  AllocationHeader * header = static_cast<AllocationHeader *>(__libc_malloc(sizeof(AllocationHeader) + size));
+#else
+  AllocationHeader * header = static_cast<AllocationHeader *>(malloc(sizeof(AllocationHeader) + size));
+#endif
+  if (header == nullptr)
+    return nullptr;
+
+  header->info.size = size;
+  header->info.subsystem = heap_stats_allocated(size);
+  return header + 1;
+}
+
+static void release(void * ptr)
+{
+  if (ptr == nullptr)
+    return;
+
+  AllocationHeader * header = static_cast<AllocationHeader *>(ptr) - 1;
+  heap_stats_released(header->info.subsystem, header->info.size);
+#if AIOT_HEAP_STATS_HOOK_MALLOC
+  __libc_free(header);
+#else
+  free(header);
+#endif
+}
+
+static void * allocate_or_throw(size_t const size)
+{
+  void * ptr = allocate(size);
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS)
+  if (ptr == nullptr)
+    throw std::bad_alloc();
+#endif
+  return ptr;
+}
+
+void * operator new  (size_t size)                         { return allocate_or_throw(size); }
+void * operator new[](size_t size)                         { return allocate_or_throw(size); }
+void * operator new  (size_t size, std::nothrow_t const &) noexcept { return allocate(size); }
+void * operator new[](size_t size, std::nothrow_t const &) noexcept { return allocate(size); }
+
+void operator delete  (void * ptr) noexcept                         { release(ptr); }
+void operator delete[](void * ptr) noexcept                         { release(ptr); }
+void operator delete  (void * ptr, std::nothrow_t const &) noexcept { release(ptr); }
+void operator delete[](void * ptr, std::nothrow_t const &) noexcept { release(ptr); }
+#if defined(__cpp_sized_deallocation)
+void operator delete  (void * ptr, size_t) noexcept                 { release(ptr); }
+void operator delete[](void * ptr, size_t) noexcept                 { release(ptr); }
+#endif
+
+/******************************************************************************
+ * MALLOC HOOKS
+ ******************************************************************************/
+
+#if AIOT_HEAP_STATS_HOOK_MALLOC
+
+/* malloc() blocks can not be prefixed with a header because memory obtained
+ * through allocators which are not hooked (e.g. posix_memalign) is released
+ * with free() as well. The blocks are kept in an open addressing table instead,
+ * free() ignores blocks which are not in the table.
+ */
+struct TrackedBlock
+{
+  void *        ptr;
+  size_t        size;
+  HeapSubsystem subsystem;
+};
+
+static size_t const TRACKED_BLOCKS_BITS = 18;
+static size_t const TRACKED_BLOCKS = static_cast<size_t>(1) << TRACKED_BLOCKS_BITS;
+static size_t const TRACKED_BLOCKS_MASK = TRACKED_BLOCKS - 1;
+
+static TrackedBlock tracked_blocks[TRACKED_BLOCKS];
+static size_t tracked_blocks_count = 0;
+
+static size_t tracked_block_slot(void const * ptr)
+{
+  uint64_t const h = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(ptr) >> 4) * 0x9E3779B97F4A7C15ULL;
+  return static_cast<size_t>(h >> (64 - TRACKED_BLOCKS_BITS));
+}
+
+static void track(void * ptr, size_t const size)
+{
+  /* Keep the load factor low, blocks which do not fit are not accounted */
+  if (tracked_blocks_count >= (TRACKED_BLOCKS / 4) * 3)
+    return;
+
+  size_t slot = tracked_block_slot(ptr);
+  while (tracked_blocks[slot].ptr != nullptr)
+    slot = (slot + 1) & TRACKED_BLOCKS_MASK;
+
+  tracked_blocks[slot].ptr = ptr;
+  tracked_blocks[slot].size = size;
+  tracked_blocks[slot].subsystem = heap_stats_allocated(size);
+  tracked_blocks_count++;
+}
+
+static bool untrack(void * ptr, TrackedBlock & block)
+{
+  size_t slot = tracked_block_slot(ptr);
+  while (tracked_blocks[slot].ptr != ptr)
+  {
+    if (tracked_blocks[slot].ptr == nullptr)
+      return false;
+    slot = (slot + 1) & TRACKED_BLOCKS_MASK;
+  }
+
+  block = tracked_blocks[slot];
+  heap_stats_released(block.subsystem, block.size);
+  tracked_blocks_count--;
+
+  /* Backward shift deletion, keeps the probe sequences intact without tombstones */
+  size_t hole = slot;
+  size_t next = slot;
+  for (;;)
+  {
+    next = (next + 1) & TRACKED_BLOCKS_MASK;
+    if (tracked_blocks[next].ptr == nullptr)
+      break;
+    size_t const home = tracked_block_slot(tracked_blocks[next].ptr);
+    bool const stays = (hole <= next) ? ((hole < home) && (home <= next)) : ((hole < home) || (home <= next));
+    if (stays)
+      continue;
+    tracked_blocks[hole] = tracked_blocks[next];
+    hole = next;
+  }
+  tracked_blocks[hole].ptr = nullptr;
+  return true;
+}
+
+extern "C" void * malloc(size_t size) __THROW
+{
+  void * ptr = __libc_malloc(size);
+  if (ptr != nullptr)
+    track(ptr, size);
+  return ptr;
+}
+
+extern "C" void * calloc(size_t num, size_t size) __THROW
+{
+  void * ptr = __libc_calloc(num, size);
+  if (ptr != nullptr)
+    track(ptr, num * size);
+  return ptr;
+}
+
+extern "C" void * realloc(void * ptr, size_t size) __THROW
+{
+  TrackedBlock block{nullptr, 0, HeapSubsystem::Other};
+  bool const was_tracked = (ptr != nullptr) && untrack(ptr, block);
+
+  void * new_ptr = __libc_realloc(ptr, size);
+  if (new_ptr != nullptr)
+  {
+    track(new_ptr, size);
+  }
+  else if (was_tracked && size != 0)
+  {
+    /* The original block is still valid */
+    HeapStatsScope const scope(block.subsystem);
+    track(ptr, block.size);
+  }
+  return new_ptr;
+}
+
+extern "C" void free(void * ptr) __THROW
+{
+  if (ptr == nullptr)
+    return;
+  TrackedBlock block;
+  untrack(ptr, block);
+  __libc_free(ptr);
+}
+
+#endif /* AIOT_HEAP_STATS_HOOK_MALLOC */
+
+#endif /* AIOT_CONFIG_HEAP_STATS */
@@ -0,0 +1,101 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#ifndef ARDUINO_AIOTC_UTILITY_HEAP_STATS_H_
+#define ARDUINO_AIOTC_UTILITY_HEAP_STATS_H_
+
+/******************************************************************************
+ * INCLUDE
+ ******************************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "../../AIoTC_Config.h"
+
+/******************************************************************************
+ * TYPEDEF
+ ******************************************************************************/
+
+/* Part of the library a heap allocation is charged to. Allocations are charged
+ * to the innermost AIOT_HEAP_STATS_SCOPE active when they are done, allocations
+ * done outside of any scope (e.g. by the sketch) are charged to Other.
+ */
+enum class HeapSubsystem : uint8_t
+{
+  Other,
+  Property,
+  Cbor,
+  Mqtt,
+  Ota,
+  Count
+};
+
+struct HeapCounters
+{
+  size_t allocations;
+  size_t deallocations;
+  size_t allocated_bytes;
+  size_t current_bytes;
+  size_t peak_bytes;
+};
+
+struct HeapStats
+{
+  HeapCounters subsystem[static_cast<size_t>(HeapSubsystem::Count)];
+  HeapCounters total;
+
+  inline HeapCounters const & operator [] (HeapSubsystem const s) const { return subsystem[static_cast<size_t>(s)]; }
+};
+
+#if AIOT_CONFIG_HEAP_STATS
+
+/******************************************************************************
+ * CLASS DECLARATION
+ ******************************************************************************/
+
+class HeapStatsScope
+{
+public:
+  explicit HeapStatsScope(HeapSubsystem const subsystem);
+  ~HeapStatsScope();
+
+private:
+  HeapStatsScope(HeapStatsScope const &) = delete;
+  HeapSubsystem _previous;
+};
+
+/******************************************************************************
+ * FUNCTION DECLARATION
+ ******************************************************************************/
+
+/* Snapshot of the counters. Allocation counts and bytes are cumulative since
+ * startup or the last heap_stats_reset(), which also sets the peak to the
+ * number of bytes currently allocated.
+ */
+HeapStats heap_stats_get();
+void      heap_stats_reset();
+
+/* Entry points of the allocation hooks. The allocation is charged to the
+ * current subsystem, which is returned so that the hook can charge the
+ * release of the memory to the same subsystem.
+ */
+HeapSubsystem heap_stats_allocated(size_t const size);
+void          heap_stats_released(HeapSubsystem const subsystem, size_t const size);
+
+#define AIOT_HEAP_STATS_SCOPE(subsystem) HeapStatsScope const heap_stats_scope(HeapSubsystem::subsystem)
+
+#else
+
+#define AIOT_HEAP_STATS_SCOPE(subsystem)
+
+#endif /* AIOT_CONFIG_HEAP_STATS */
+
+#endif /* ARDUINO_AIOTC_UTILITY_HEAP_STATS_H_ */
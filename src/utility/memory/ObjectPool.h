@@ -0,0 +1,91 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#ifndef ARDUINO_IOT_CLOUD_OBJECT_POOL_H_
+#define ARDUINO_IOT_CLOUD_OBJECT_POOL_H_
+
+/******************************************************************************
+ * INCLUDE
+ ******************************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <new>
+#include <utility>
+
+/******************************************************************************
+ * CLASS DECLARATION
+ ******************************************************************************/
+
+/* Fixed capacity pool of CAPACITY slots of SLOT_SIZE bytes each. All the slots
+ * are allocated in one contiguous block the first time an object is created,
+ * objects of any type fitting a slot are then placement constructed into the
+ * next free slot. create() returns nullptr once the pool is exhausted so the
+ * caller can fall back to the heap.
+ *
+ * Objects live for the lifetime of the pool, slots are never handed back and
+ * no destructors are run.
+ */
+template <size_t SLOT_SIZE, size_t CAPACITY>
+class ObjectPool
+{
+
+private:
+
+  union Slot
+  {
+    uint8_t         bytes[SLOT_SIZE];
+    double          align_double;
+    long long       align_long_long;
+    void *          align_pointer;
+  };
+
+public:
+
+  constexpr ObjectPool() : _slots{nullptr}, _used{0} { }
+  ~ObjectPool() { delete [] _slots; }
+
+  template <typename T, typename... Args>
+  T * create(Args &&... args)
+  {
+    static_assert(sizeof(T) <= SLOT_SIZE, "The object does not fit into a slot of the pool");
+    static_assert(alignof(Slot) % alignof(T) == 0, "The object requires a stricter alignment than the slots of the pool");
+
+    if (_used >= CAPACITY)
+      return nullptr;
+
+    if (_slots == nullptr) {
+      _slots = new (std::nothrow) Slot[CAPACITY];
+      if (_slots == nullptr)
+        return nullptr;
+    }
+
+    return new (_slots[_used++].bytes) T(std::forward<Args>(args)...);
+  }
+
+  inline bool owns(void const * p) const
+  {
+    return _slots != nullptr && p >= static_cast<void const *>(_slots) && p < static_cast<void const *>(_slots + _used);
+  }
+
+  inline size_t size()     const { return _used; }
+  inline size_t capacity() const { return CAPACITY; }
+
+private:
+
+  ObjectPool(ObjectPool const &) = delete;
+  ObjectPool & operator = (ObjectPool const &) = delete;
+
+  Slot * _slots;
+  size_t _used;
+
+};
+
+#endif /* ARDUINO_IOT_CLOUD_OBJECT_POOL_H_ */
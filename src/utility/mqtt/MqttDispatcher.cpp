@@ -0,0 +1,146 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+ * INCLUDE
+ ******************************************************************************/
+
+#include "MqttDispatcher.h"
+
+#include <string.h>
+
+#include "../hash/Fnv1a.h"
+
+/******************************************************************************
+ * CTOR/DTOR
+ ******************************************************************************/
+
+MqttDispatcher::MqttDispatcher()
+: _topic{}
+, _subscription{}
+, _subscription_count{0}
+{
+  clear();
+}
+
+/******************************************************************************
+ * PUBLIC MEMBER FUNCTIONS
+ ******************************************************************************/
+
+bool MqttDispatcher::addTopic(char const * topic, TopicHandler handler)
+{
+  if (!handler)
+    return false;
+
+  uint32_t const topic_hash = fnv1a(topic);
+  if (findTopic(topic, topic_hash) != nullptr)
+    return false;
+
+  for (size_t i = 0; i < TOPIC_SLOTS; i++)
+  {
+    TopicEntry & entry = _topic[(topic_hash + i) & (TOPIC_SLOTS - 1)];
+    if (!entry.handler)
+    {
+      entry.hash = topic_hash;
+      entry.topic = topic;
+      entry.handler = handler;
+      return true;
+    }
+  }
+  return false;
+}
+
+void MqttDispatcher::removeTopic(char const * topic)
+{
+  TopicEntry * entry = findTopic(topic, fnv1a(topic));
+  if (entry != nullptr)
+  {
+    entry->topic = nullptr;
+    entry->handler = nullptr;
+  }
+}
+
+void MqttDispatcher::clear()
+{
+  for (TopicEntry & entry : _topic)
+  {
+    entry.topic = nullptr;
+    entry.handler = nullptr;
+  }
+  for (Subscription & subscription : _subscription)
+    subscription.handler = nullptr;
+  _subscription_count = 0;
+  memset(_first_subscription, NO_SUBSCRIPTION, sizeof(_first_subscription));
+}
+
+bool MqttDispatcher::dispatch(char const * topic, int const length)
+{
+  TopicEntry * entry = findTopic(topic, fnv1a(topic));
+  if (entry == nullptr)
+    return false;
+
+  entry->handler(length);
+  return true;
+}
+
+bool MqttDispatcher::subscribe(CommandId const id, CloudProcess & process)
+{
+  CloudProcess * subscriber = &process;
+  return subscribe(id, [subscriber](Command * command) { subscriber->handleMessage(command); });
+}
+
+bool MqttDispatcher::subscribe(CommandId const id, CommandHandler handler)
+{
+  if (id < DeviceBeginCmdId || id >= UnknownCmdId || !handler || _subscription_count >= MAX_SUBSCRIPTIONS)
+    return false;
+
+  uint8_t const subscription = static_cast<uint8_t>(_subscription_count++);
+  _subscription[subscription].handler = handler;
+  _subscription[subscription].next = NO_SUBSCRIPTION;
+
+  /* Append, subscribers are called in the order they have subscribed in */
+  uint8_t * link = &_first_subscription[id - DeviceBeginCmdId];
+  while (*link != NO_SUBSCRIPTION)
+    link = &_subscription[*link].next;
+  *link = subscription;
+  return true;
+}
+
+size_t MqttDispatcher::dispatch(Command * command)
+{
+  if (command->id < DeviceBeginCmdId || command->id >= UnknownCmdId)
+    return 0;
+
+  size_t delivered = 0;
+  for (uint8_t s = _first_subscription[command->id - DeviceBeginCmdId]; s != NO_SUBSCRIPTION; s = _subscription[s].next)
+  {
+    _subscription[s].handler(command);
+    delivered++;
+  }
+  return delivered;
+}
+
+/******************************************************************************
+ * PRIVATE MEMBER FUNCTIONS
+ ******************************************************************************/
+
+MqttDispatcher::TopicEntry * MqttDispatcher::findTopic(char const * topic, uint32_t const topic_hash)
+{
+  /* Slots are freed in place when a topic is removed, so the probe does not
+   * stop at the first free slot. The table is small enough to bound it.
+   */
+  for (size_t i = 0; i < TOPIC_SLOTS; i++)
+  {
+    TopicEntry & entry = _topic[(topic_hash + i) & (TOPIC_SLOTS - 1)];
+    if (entry.handler && entry.hash == topic_hash && strcmp(entry.topic, topic) == 0)
+      return &entry;
+  }
+  return nullptr;
+}
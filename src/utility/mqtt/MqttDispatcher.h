@@ -0,0 +1,99 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#ifndef ARDUINO_IOT_CLOUD_MQTT_DISPATCHER_H_
+#define ARDUINO_IOT_CLOUD_MQTT_DISPATCHER_H_
+
+/******************************************************************************
+ * INCLUDE
+ ******************************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <functional>
+
+#include <message/Commands.h>
+#include <interfaces/CloudProcess.h>
+
+/******************************************************************************
+ * CLASS DECLARATION
+ ******************************************************************************/
+
+/* Routes incoming MQTT messages to their handlers.
+ *
+ * Topics are registered by the FNV-1a hash of their name in a small open
+ * addressing table, an incoming topic is hashed once and looked up in place.
+ * The name is only compared with the registered one when the hashes match,
+ * so that a topic which merely collides with a registered one is not routed
+ * to its handler. The registered names are not copied, they shall outlive
+ * their registration.
+ *
+ * Decoded commands are routed by their id, which indexes a table holding the
+ * first subscriber of each command. Subscribers of the same command are called
+ * in the order they have subscribed in.
+ */
+class MqttDispatcher
+{
+
+public:
+
+  /* Called with the length of the payload, which is still to be read from the client */
+  using TopicHandler = std::function<void(int length)>;
+  using CommandHandler = std::function<void(Command * command)>;
+
+  MqttDispatcher();
+
+  /* Return false if the table is full or the topic is already registered */
+  bool addTopic(char const * topic, TopicHandler handler);
+  void removeTopic(char const * topic);
+  /* Removes all the topics and command subscriptions */
+  void clear();
+  /* Returns false if no handler is registered for the topic */
+  bool dispatch(char const * topic, int const length);
+
+  /* Return false if the command id is unknown or all subscription slots are taken */
+  bool subscribe(CommandId const id, CloudProcess & process);
+  bool subscribe(CommandId const id, CommandHandler handler);
+  /* Returns the number of subscribers the command has been delivered to */
+  size_t dispatch(Command * command);
+
+
+private:
+
+  /* Message in, data in and room for additional command topics, a power of 2 */
+  static size_t const TOPIC_SLOTS = 8;
+  static size_t const COMMAND_COUNT = UnknownCmdId - DeviceBeginCmdId;
+  static size_t const MAX_SUBSCRIPTIONS = 8;
+  static uint8_t const NO_SUBSCRIPTION = 0xFF;
+
+  struct TopicEntry
+  {
+    uint32_t hash;
+    char const * topic;
+    TopicHandler handler;
+  };
+
+  struct Subscription
+  {
+    CommandHandler handler;
+    uint8_t next;
+  };
+
+  TopicEntry _topic[TOPIC_SLOTS];
+  uint8_t _first_subscription[COMMAND_COUNT];
+  Subscription _subscription[MAX_SUBSCRIPTIONS];
+  size_t _subscription_count;
+
+  TopicEntry * findTopic(char const * topic, uint32_t const topic_hash);
+
+};
+
+#endif /* ARDUINO_IOT_CLOUD_MQTT_DISPATCHER_H_ */
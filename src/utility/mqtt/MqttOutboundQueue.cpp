@@ -0,0 +1,169 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+ * INCLUDE
+ ******************************************************************************/
+
+#include "MqttOutboundQueue.h"
+
+#include <string.h>
+#include <new>
+
+/******************************************************************************
+ * CTOR/DTOR
+ ******************************************************************************/
+
+MqttOutboundQueue::MqttOutboundQueue()
+: _slots{nullptr}
+, _frames{nullptr}
+, _capacity{0}
+, _frame_size{0}
+, _policy{Policy::OverwriteOldest}
+, _head{0}
+, _count{0}
+, _queued{0}
+, _in_flight{0}
+, _overwritten{0}
+, _next_packet_id{1}
+{
+
+}
+
+MqttOutboundQueue::~MqttOutboundQueue()
+{
+  delete[] _slots;
+  delete[] _frames;
+}
+
+/******************************************************************************
+ * PUBLIC MEMBER FUNCTIONS
+ ******************************************************************************/
+
+bool MqttOutboundQueue::begin(size_t const capacity, size_t const frame_size, Policy const policy)
+{
+  _policy = policy;
+  clear();
+
+  if (capacity == 0 || frame_size == 0)
+    return false;
+
+  if (_slots != nullptr && _capacity == capacity && _frame_size == frame_size)
+    return true;
+
+  delete[] _slots;
+  delete[] _frames;
+  _slots  = new (std::nothrow) Slot[capacity];
+  _frames = new (std::nothrow) uint8_t[capacity * frame_size];
+
+  if (_slots == nullptr || _frames == nullptr)
+  {
+    delete[] _slots;
+    delete[] _frames;
+    _slots = nullptr;
+    _frames = nullptr;
+    _capacity = 0;
+    _frame_size = 0;
+    return false;
+  }
+
+  _capacity = capacity;
+  _frame_size = frame_size;
+  return true;
+}
+
+bool MqttOutboundQueue::push(uint8_t const * frame, size_t const length)
+{
+  if (_slots == nullptr || length > _frame_size)
+    return false;
+
+  if (full())
+  {
+    if (_policy == Policy::Block)
+      return false;
+    popHead();
+    _overwritten++;
+  }
+
+  size_t const slot_index = (_head + _count) % _capacity;
+  Slot & slot = _slots[slot_index];
+  memcpy(_frames + slot_index * _frame_size, frame, length);
+  slot.length = length;
+  slot.packet_id = _next_packet_id;
+  slot.state = SlotState::Queued;
+  slot.dup = false;
+
+  /* Packet id 0 is not allowed by MQTT */
+  _next_packet_id = (_next_packet_id == 0xFFFF) ? 1 : (_next_packet_id + 1);
+  _count++;
+  _queued++;
+  return true;
+}
+
+bool MqttOutboundQueue::acknowledge(uint16_t const packet_id)
+{
+  for (size_t i = 0; i < _count; i++)
+  {
+    Slot & slot = _slots[(_head + i) % _capacity];
+    if (slot.state == SlotState::InFlight && slot.packet_id == packet_id)
+    {
+      slot.state = SlotState::Acknowledged;
+      _in_flight--;
+      releaseAcknowledged();
+      return true;
+    }
+  }
+  return false;
+}
+
+void MqttOutboundQueue::requeue()
+{
+  for (size_t i = 0; i < _count; i++)
+  {
+    Slot & slot = _slots[(_head + i) % _capacity];
+    if (slot.state == SlotState::InFlight)
+      slot.state = SlotState::Queued;
+  }
+  _queued += _in_flight;
+  _in_flight = 0;
+}
+
+void MqttOutboundQueue::clear()
+{
+  _head = 0;
+  _count = 0;
+  _queued = 0;
+  _in_flight = 0;
+}
+
+/******************************************************************************
+ * PRIVATE MEMBER FUNCTIONS
+ ******************************************************************************/
+
+void MqttOutboundQueue::popHead()
+{
+  Slot const & slot = _slots[_head];
+  if (slot.state == SlotState::Queued)
+    _queued--;
+  else if (slot.state == SlotState::InFlight)
+    _in_flight--;
+
+  _head = (_head + 1) % _capacity;
+  _count--;
+}
+
+/* Acknowledgements can arrive out of order, a slot is only reused once all
+ * the frames queued before it have been acknowledged as well.
+ */
+void MqttOutboundQueue::releaseAcknowledged()
+{
+  while (_count > 0 && _slots[_head].state == SlotState::Acknowledged)
+    popHead();
+}
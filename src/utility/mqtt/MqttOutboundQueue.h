@@ -0,0 +1,170 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#ifndef ARDUINO_IOT_CLOUD_MQTT_OUTBOUND_QUEUE_H_
+#define ARDUINO_IOT_CLOUD_MQTT_OUTBOUND_QUEUE_H_
+
+/******************************************************************************
+ * INCLUDE
+ ******************************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+
+/******************************************************************************
+ * CLASS DECLARATION
+ ******************************************************************************/
+
+/* Bounded ring of outbound MQTT frames. A frame is assigned a packet id when
+ * it is queued. Frames sent with transmit() keep their slot until acknowledge()
+ * is called with their packet id, which requires a client reporting PUBACKs,
+ * so that frames lost together with the connection can be replayed in their
+ * original order once the broker connection has been re-established. Frames
+ * sent with deliver() are released as soon as the client accepted them.
+ * When the ring is full the oldest frame is either overwritten or the new
+ * frame is rejected, depending on the policy.
+ */
+class MqttOutboundQueue
+{
+
+public:
+
+  enum class Policy
+  {
+    OverwriteOldest,
+    Block
+  };
+
+  MqttOutboundQueue();
+  ~MqttOutboundQueue();
+
+  bool begin(size_t const capacity, size_t const frame_size, Policy const policy);
+
+  /* Copies the frame into the queue, returns false if the frame is larger than
+   * a slot or if the queue is full and the policy is Block.
+   */
+  bool push(uint8_t const * frame, size_t const length);
+
+  /* Publishes the queued frames oldest-first until publish fails. PublishFunc
+   * needs to provide bool publish(uint8_t const * frame, size_t length, uint16_t packet_id, bool dup),
+   * returns the number of frames which have been published.
+   */
+  template <typename PublishFunc>
+  size_t transmit(PublishFunc publish)
+  {
+    size_t frames_sent = 0;
+    for (size_t i = 0; i < _count; i++)
+    {
+      size_t const slot_index = (_head + i) % _capacity;
+      Slot & slot = _slots[slot_index];
+      if (slot.state != SlotState::Queued)
+        continue;
+      if (!publish(_frames + slot_index * _frame_size, slot.length, slot.packet_id, slot.dup))
+        break;
+      slot.state = SlotState::InFlight;
+      slot.dup = true;
+      _queued--;
+      _in_flight++;
+      frames_sent++;
+    }
+    return frames_sent;
+  }
+
+  /* Publishes the queued frames oldest-first with a client which does not
+   * report PUBACKs, such as ArduinoMqttClient. A frame is released as soon as
+   * its publish succeeds, i.e. once it has been written to the connection at
+   * any QoS, the frames from the first failed one on stay queued and are
+   * retransmitted with the dup flag set. A released frame which is lost with
+   * the connection is not retransmitted, delivery is not at-least-once.
+   * Returns the number of frames written.
+   */
+  template <typename PublishFunc>
+  size_t deliver(PublishFunc publish)
+  {
+    size_t frames_sent = 0;
+    size_t i = 0;
+    while (i < _count)
+    {
+      size_t const slot_index = (_head + i) % _capacity;
+      Slot & slot = _slots[slot_index];
+      if (slot.state != SlotState::Queued)
+      {
+        i++;
+        continue;
+      }
+      if (!publish(_frames + slot_index * _frame_size, slot.length, slot.packet_id, slot.dup))
+        break;
+      slot.state = SlotState::Acknowledged;
+      _queued--;
+      frames_sent++;
+      /* Releasing the slot moves the head past it */
+      size_t const count = _count;
+      releaseAcknowledged();
+      i = i + 1 - (count - _count);
+    }
+    return frames_sent;
+  }
+
+  /* Releases the slot of an in-flight frame, returns false if no in-flight
+   * frame has this packet id (e.g. it has already been overwritten).
+   */
+  bool acknowledge(uint16_t const packet_id);
+  /* Marks all in-flight frames for retransmission after a link drop */
+  void requeue();
+  void clear();
+
+  inline size_t capacity()    const { return _capacity; }
+  inline size_t size()        const { return _count; }
+  inline bool   empty()       const { return _count == 0; }
+  inline bool   full()        const { return _count == _capacity; }
+  inline bool   blocked()     const { return full() && _policy == Policy::Block; }
+  inline size_t queued()      const { return _queued; }
+  inline size_t inFlight()    const { return _in_flight; }
+  inline size_t overwritten() const { return _overwritten; }
+
+
+private:
+
+  MqttOutboundQueue(MqttOutboundQueue const &) = delete;
+  MqttOutboundQueue & operator = (MqttOutboundQueue const &) = delete;
+
+  enum class SlotState : uint8_t
+  {
+    Queued,
+    InFlight,
+    Acknowledged
+  };
+
+  struct Slot
+  {
+    size_t    length;
+    uint16_t  packet_id;
+    SlotState state;
+    bool      dup;
+  };
+
+  Slot * _slots;
+  uint8_t * _frames;
+  size_t _capacity;
+  size_t _frame_size;
+  Policy _policy;
+  size_t _head;
+  size_t _count;
+  size_t _queued;
+  size_t _in_flight;
+  size_t _overwritten;
+  uint16_t _next_packet_id;
+
+  void popHead();
+  void releaseAcknowledged();
+
+};
+
+#endif /* ARDUINO_IOT_CLOUD_MQTT_OUTBOUND_QUEUE_H_ */
@@ -0,0 +1,57 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+ * INCLUDE
+ ******************************************************************************/
+
+#include "MqttPropertyUplink.h"
+
+#include <new>
+
+/******************************************************************************
+ * CTOR/DTOR
+ ******************************************************************************/
+
+MqttPropertyUplink::MqttPropertyUplink()
+: _buffer{nullptr}
+, _frame_size{0}
+, _bytes_per_tick{0}
+, _time_per_tick_ms{0}
+{
+
+}
+
+MqttPropertyUplink::~MqttPropertyUplink()
+{
+  delete[] _buffer;
+}
+
+/******************************************************************************
+ * PUBLIC MEMBER FUNCTIONS
+ ******************************************************************************/
+
+bool MqttPropertyUplink::begin(size_t const frame_size, size_t const bytes_per_tick, unsigned long const time_per_tick_ms)
+{
+  _bytes_per_tick = bytes_per_tick;
+  _time_per_tick_ms = time_per_tick_ms;
+
+  if (frame_size == 0)
+    return false;
+
+  if (_buffer != nullptr && _frame_size == frame_size)
+    return true;
+
+  delete[] _buffer;
+  _buffer = new (std::nothrow) uint8_t[frame_size];
+  _frame_size = (_buffer != nullptr) ? frame_size : 0;
+
+  return (_buffer != nullptr);
+}
@@ -0,0 +1,109 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#ifndef ARDUINO_IOT_CLOUD_MQTT_PROPERTY_UPLINK_H_
+#define ARDUINO_IOT_CLOUD_MQTT_PROPERTY_UPLINK_H_
+
+/******************************************************************************
+ * INCLUDE
+ ******************************************************************************/
+
+#include <Arduino.h>
+
+#include "../../AIoTC_Config.h"
+#include "../../cbor/CBOREncoder.h"
+#include "../../property/PropertyContainer.h"
+
+/******************************************************************************
+ * CLASS DECLARATION
+ ******************************************************************************/
+
+/* Encodes the pending properties of a container into MQTT frames of a size
+ * configured at runtime. Every call to send() publishes frames until all the
+ * pending properties have been sent or the per-tick byte/time budget has been
+ * used up, the round-robin position is kept in 'current_property_index' so the
+ * next call resumes where the previous one stopped. A single frame buffer is
+ * used, publish needs to copy the frame if it is kept for retransmission (see
+ * MqttOutboundQueue).
+ */
+class MqttPropertyUplink
+{
+
+public:
+
+  MqttPropertyUplink();
+  ~MqttPropertyUplink();
+
+  /* Allocates the frame buffer. A 'bytes_per_tick' budget of 0 publishes a
+   * single frame per call to send().
+   */
+  bool begin(size_t const frame_size, size_t const bytes_per_tick, unsigned long const time_per_tick_ms);
+
+  /* PublishFunc needs to provide bool publish(uint8_t const * frame, size_t length),
+   * returns the number of frames which have been published.
+   */
+  template <typename PublishFunc>
+  size_t send(PropertyContainer & property_container, unsigned int & current_property_index, PublishFunc publish)
+  {
+    if (_buffer == nullptr)
+      return 0;
+
+    unsigned long const start_ms = millis();
+    size_t bytes_sent = 0;
+    size_t frames_sent = 0;
+
+    for (;;)
+    {
+      unsigned int const start_index = current_property_index;
+      int bytes_encoded = 0;
+
+      if (CBOREncoder::encode(property_container, _buffer, _frame_size, bytes_encoded, current_property_index, false, AIOT_CONFIG_COMPACT_PAYLOAD) != CborNoError)
+        break;
+
+      if (bytes_encoded <= 0)
+      {
+        /* Nothing pending between 'start_index' and the end of the container,
+         * the index has wrapped around so look at the beginning once more.
+         */
+        if (start_index == 0)
+          break;
+        continue;
+      }
+
+      size_t const frame_length = static_cast<size_t>(bytes_encoded);
+      if (!publish(_buffer, frame_length))
+        break;
+
+      frames_sent++;
+      bytes_sent += frame_length;
+
+      if (bytes_sent >= _bytes_per_tick || (millis() - start_ms) >= _time_per_tick_ms)
+        break;
+    }
+
+    return frames_sent;
+  }
+
+  inline size_t frameSize() const { return _frame_size; }
+
+
+private:
+
+  MqttPropertyUplink(MqttPropertyUplink const &) = delete;
+  MqttPropertyUplink & operator = (MqttPropertyUplink const &) = delete;
+
+  uint8_t * _buffer;
+  size_t _frame_size;
+  size_t _bytes_per_tick;
+  unsigned long _time_per_tick_ms;
+
+};
+
+#endif /* ARDUINO_IOT_CLOUD_MQTT_PROPERTY_UPLINK_H_ */
@@ -0,0 +1,116 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#ifndef ARDUINO_IOT_CLOUD_MQTT_RECEIVE_BUFFER_H_
+#define ARDUINO_IOT_CLOUD_MQTT_RECEIVE_BUFFER_H_
+
+/******************************************************************************
+ * INCLUDE
+ ******************************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+
+/******************************************************************************
+ * CLASS DECLARATION
+ ******************************************************************************/
+
+/* Statically allocated buffer holding the payload of the MQTT message which is
+ * currently being processed. The payload is read from the client with bulk
+ * reads and parsed in place. Messages which do not fit into the buffer are
+ * drained from the client and rejected, leaving the MQTT stream in sync.
+ */
+template <size_t SIZE>
+class MqttReceiveBuffer
+{
+
+public:
+
+  enum class Status
+  {
+    Complete,   /* The whole payload has been stored in the buffer */
+    Oversize,   /* The payload does not fit into the buffer and has been discarded */
+    Incomplete  /* The client ran out of data before the end of the payload */
+  };
+
+  MqttReceiveBuffer() : _length{0} { }
+
+  /* MqttClientType needs to provide int read(uint8_t * buf, size_t size) */
+  template <typename MqttClientType>
+  Status receive(MqttClientType & client, size_t const length)
+  {
+    _length = 0;
+    return append(client, length);
+  }
+
+  /* Read the next length bytes of the payload behind the ones which are
+   * already stored in the buffer, e.g. once the header of the payload has
+   * been received and inspected.
+   */
+  template <typename MqttClientType>
+  Status append(MqttClientType & client, size_t const length)
+  {
+    if (length > SIZE - _length) {
+      /* Use the buffer as scratch space to drain the payload */
+      _length = 0;
+      size_t remaining = length;
+      while (remaining > 0) {
+        size_t const chunk = (remaining < SIZE) ? remaining : SIZE;
+        int const bytes_read = client.read(_buf, chunk);
+        if (bytes_read <= 0)
+          break;
+        remaining -= static_cast<size_t>(bytes_read);
+      }
+      return Status::Oversize;
+    }
+
+    size_t const end = _length + length;
+    while (_length < end) {
+      int const bytes_read = client.read(_buf + _length, end - _length);
+      if (bytes_read <= 0)
+        return Status::Incomplete;
+      _length += static_cast<size_t>(bytes_read);
+    }
+    return Status::Complete;
+  }
+
+  /* Read the payload chunk by chunk, each chunk is passed to the sink as
+   * on_chunk(uint8_t const * chunk, size_t length) while it is stored in the
+   * buffer. Used by incremental parsers which are not limited by SIZE.
+   */
+  template <typename MqttClientType, typename ChunkSink>
+  Status stream(MqttClientType & client, size_t const length, ChunkSink on_chunk)
+  {
+    size_t remaining = length;
+    while (remaining > 0) {
+      size_t const chunk = (remaining < SIZE) ? remaining : SIZE;
+      int const bytes_read = client.read(_buf, chunk);
+      if (bytes_read <= 0)
+        return Status::Incomplete;
+      _length = static_cast<size_t>(bytes_read);
+      on_chunk(static_cast<uint8_t const *>(_buf), _length);
+      remaining -= _length;
+    }
+    return Status::Complete;
+  }
+
+  inline uint8_t *        data()           { return _buf; }
+  inline uint8_t const *  data()     const { return _buf; }
+  inline size_t           length()   const { return _length; }
+  inline size_t           capacity() const { return SIZE; }
+
+private:
+
+  uint8_t _buf[SIZE];
+  size_t  _length;
+
+};
+
+#endif /* ARDUINO_IOT_CLOUD_MQTT_RECEIVE_BUFFER_H_ */
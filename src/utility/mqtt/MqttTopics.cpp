@@ -0,0 +1,79 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+ * INCLUDE
+ ******************************************************************************/
+
+#include "MqttTopics.h"
+
+#include <string.h>
+
+/******************************************************************************
+ * CTOR/DTOR
+ ******************************************************************************/
+
+MqttTopics::MqttTopics()
+: _message_out{0}
+, _message_in{0}
+, _data_out{0}
+, _data_in{0}
+{
+
+}
+
+/******************************************************************************
+ * PUBLIC MEMBER FUNCTIONS
+ ******************************************************************************/
+
+bool MqttTopics::begin(char const * device_id)
+{
+  detachThing();
+  return build(_message_out, "/a/d/", device_id, "/c/up") &&
+         build(_message_in,  "/a/d/", device_id, "/c/dw");
+}
+
+bool MqttTopics::attachThing(char const * thing_id)
+{
+  if (build(_data_out, "/a/t/", thing_id, "/e/o") &&
+      build(_data_in,  "/a/t/", thing_id, "/e/i"))
+    return true;
+
+  detachThing();
+  return false;
+}
+
+void MqttTopics::detachThing()
+{
+  _data_out[0] = '\0';
+  _data_in[0] = '\0';
+}
+
+/******************************************************************************
+ * PRIVATE MEMBER FUNCTIONS
+ ******************************************************************************/
+
+bool MqttTopics::build(char * topic, char const * prefix, char const * id, char const * suffix)
+{
+  size_t const prefix_length = strlen(prefix);
+  size_t const id_length = strlen(id);
+  size_t const suffix_length = strlen(suffix);
+
+  if (id_length == 0 || prefix_length + id_length + suffix_length >= TOPIC_SIZE)
+  {
+    topic[0] = '\0';
+    return false;
+  }
+
+  memcpy(topic, prefix, prefix_length);
+  memcpy(topic + prefix_length, id, id_length);
+  memcpy(topic + prefix_length + id_length, suffix, suffix_length + 1);
+  return true;
+}
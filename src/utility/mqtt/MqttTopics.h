@@ -0,0 +1,62 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#ifndef ARDUINO_IOT_CLOUD_MQTT_TOPICS_H_
+#define ARDUINO_IOT_CLOUD_MQTT_TOPICS_H_
+
+/******************************************************************************
+ * INCLUDE
+ ******************************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+
+/******************************************************************************
+ * CLASS DECLARATION
+ ******************************************************************************/
+
+/* MQTT topics of a device and of the thing it is attached to. The topics are
+ * built once into fixed buffers, when the device id is known and whenever a
+ * thing is attached, and are then handed out by pointer to every publish and
+ * to the MqttDispatcher which routes the incoming messages.
+ */
+class MqttTopics
+{
+
+public:
+
+  MqttTopics();
+
+  /* Return false if the resulting topic does not fit into a buffer */
+  bool begin(char const * device_id);
+  bool attachThing(char const * thing_id);
+  void detachThing();
+
+  inline char const * messageOut() const { return _message_out; }
+  inline char const * messageIn()  const { return _message_in; }
+  inline char const * dataOut()    const { return _data_out; }
+  inline char const * dataIn()     const { return _data_in; }
+
+
+private:
+
+  /* "/a/d/" + 36 characters UUID + "/c/up" takes 46 characters */
+  static size_t const TOPIC_SIZE = 64;
+
+  char _message_out[TOPIC_SIZE];
+  char _message_in[TOPIC_SIZE];
+  char _data_out[TOPIC_SIZE];
+  char _data_in[TOPIC_SIZE];
+
+  static bool build(char * topic, char const * prefix, char const * id, char const * suffix);
+
+};
+
+#endif /* ARDUINO_IOT_CLOUD_MQTT_TOPICS_H_ */
@@ -0,0 +1,96 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+ * INCLUDE
+ ******************************************************************************/
+
+#include "OfflineLog.h"
+
+#include <new>
+
+#include "../../cbor/CBOREncoder.h"
+
+/******************************************************************************
+ * CTOR/DTOR
+ ******************************************************************************/
+
+OfflineLog::OfflineLog()
+: _storage{nullptr}
+, _buffer{nullptr}
+, _frame_size{0}
+, _bytes_per_tick{0}
+, _dropped{0}
+{
+
+}
+
+OfflineLog::~OfflineLog()
+{
+  delete[] _buffer;
+}
+
+/******************************************************************************
+ * PUBLIC MEMBER FUNCTIONS
+ ******************************************************************************/
+
+bool OfflineLog::begin(size_t const frame_size, size_t const bytes_per_tick)
+{
+  _bytes_per_tick = bytes_per_tick;
+
+  if (frame_size == 0)
+    return false;
+
+  if (_buffer != nullptr && _frame_size == frame_size)
+    return true;
+
+  delete[] _buffer;
+  _buffer = new (std::nothrow) uint8_t[frame_size];
+  _frame_size = (_buffer != nullptr) ? frame_size : 0;
+
+  return (_buffer != nullptr);
+}
+
+size_t OfflineLog::record(PropertyContainer & property_container, unsigned int & current_property_index, unsigned long const time)
+{
+  if (_buffer == nullptr || _storage == nullptr)
+    return 0;
+
+  size_t frames_stored = 0;
+
+  /* Encoding a property marks it as sent, stop as soon as a full frame may not fit */
+  while (_storage->available() >= _frame_size)
+  {
+    unsigned int const start_index = current_property_index;
+    int bytes_encoded = 0;
+
+    if (CBOREncoder::encode(property_container, _buffer, _frame_size, bytes_encoded, current_property_index, false, AIOT_CONFIG_COMPACT_PAYLOAD, time) != CborNoError)
+      break;
+
+    if (bytes_encoded <= 0)
+    {
+      /* Nothing pending between 'start_index' and the end of the container,
+       * the index has wrapped around so look at the beginning once more.
+       */
+      if (start_index == 0)
+        break;
+      continue;
+    }
+
+    if (!_storage->append(_buffer, static_cast<size_t>(bytes_encoded)))
+    {
+      _dropped++;
+      break;
+    }
+    frames_stored++;
+  }
+
+  return frames_stored;
+}
@@ -0,0 +1,113 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#ifndef ARDUINO_IOT_CLOUD_OFFLINE_LOG_H_
+#define ARDUINO_IOT_CLOUD_OFFLINE_LOG_H_
+
+/******************************************************************************
+ * INCLUDE
+ ******************************************************************************/
+
+#include "../../AIoTC_Config.h"
+#include "../../property/PropertyContainer.h"
+#include "OfflineLogStorage.h"
+
+/******************************************************************************
+ * CLASS DECLARATION
+ ******************************************************************************/
+
+/* Store-and-forward of property updates while the thing is not connected.
+ * record() encodes the pending properties into SenML messages carrying the
+ * time they have been recorded at and appends them to the storage, replay()
+ * publishes them oldest-first once the connection has been re-established.
+ *
+ * Properties are only recorded as long as the storage can hold a full frame,
+ * afterwards they stay pending and only their latest value is published once
+ * connected, as if there was no log.
+ */
+class OfflineLog
+{
+
+public:
+
+  OfflineLog();
+  ~OfflineLog();
+
+  /* Allocates the frame buffer. A 'bytes_per_tick' budget of 0 replays a
+   * single frame per call to replay().
+   */
+  bool begin(size_t const frame_size, size_t const bytes_per_tick);
+  inline void setStorage(OfflineLogStorage * storage) { _storage = storage; }
+  inline OfflineLogStorage * storage() const { return _storage; }
+
+  /* Appends the pending properties to the log as if they have been published
+   * at 'time', returns the number of frames which have been stored.
+   */
+  size_t record(PropertyContainer & property_container, unsigned int & current_property_index, unsigned long const time);
+
+  /* PublishFunc needs to provide bool publish(uint8_t const * frame, size_t length),
+   * a frame is removed from the log once it has been published. Returns the
+   * number of frames which have been published.
+   */
+  template <typename PublishFunc>
+  size_t replay(PublishFunc publish)
+  {
+    if (_buffer == nullptr || _storage == nullptr)
+      return 0;
+
+    size_t bytes_sent = 0;
+    size_t frames_sent = 0;
+
+    while (_storage->count() > 0)
+    {
+      size_t const length = _storage->front(_buffer, _frame_size);
+      if (length == 0 || length > _frame_size)
+      {
+        /* Unreadable or recorded with a larger frame size, e.g. before a reset */
+        _storage->pop();
+        _dropped++;
+        continue;
+      }
+
+      if (!publish(_buffer, length))
+        break;
+
+      _storage->pop();
+      frames_sent++;
+      bytes_sent += length;
+
+      if (bytes_sent >= _bytes_per_tick)
+        break;
+    }
+
+    return frames_sent;
+  }
+
+  inline void   clear()         { if (_storage) _storage->clear(); }
+  inline bool   empty()   const { return _storage == nullptr || _storage->count() == 0; }
+  inline size_t size()    const { return _storage ? _storage->count() : 0; }
+  /* Frames which could not be replayed */
+  inline size_t dropped() const { return _dropped; }
+
+
+private:
+
+  OfflineLog(OfflineLog const &) = delete;
+  OfflineLog & operator = (OfflineLog const &) = delete;
+
+  OfflineLogStorage * _storage;
+  uint8_t * _buffer;
+  size_t _frame_size;
+  size_t _bytes_per_tick;
+  size_t _dropped;
+
+};
+
+#endif /* ARDUINO_IOT_CLOUD_OFFLINE_LOG_H_ */
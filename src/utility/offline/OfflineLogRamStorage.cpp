@@ -0,0 +1,136 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+ * INCLUDE
+ ******************************************************************************/
+
+#include "OfflineLogRamStorage.h"
+
+#include <string.h>
+#include <new>
+
+/******************************************************************************
+ * CTOR/DTOR
+ ******************************************************************************/
+
+OfflineLogRamStorage::OfflineLogRamStorage()
+: _buffer{nullptr}
+, _capacity{0}
+, _head{0}
+, _used{0}
+, _count{0}
+{
+
+}
+
+OfflineLogRamStorage::~OfflineLogRamStorage()
+{
+  delete[] _buffer;
+}
+
+/******************************************************************************
+ * PUBLIC MEMBER FUNCTIONS
+ ******************************************************************************/
+
+bool OfflineLogRamStorage::begin(size_t const capacity)
+{
+  clear();
+
+  if (capacity <= HEADER_SIZE)
+    return false;
+
+  if (_buffer != nullptr && _capacity == capacity)
+    return true;
+
+  delete[] _buffer;
+  _buffer = new (std::nothrow) uint8_t[capacity];
+  _capacity = (_buffer != nullptr) ? capacity : 0;
+
+  return (_buffer != nullptr);
+}
+
+bool OfflineLogRamStorage::append(uint8_t const * record, size_t const length)
+{
+  if (length == 0 || length > 0xFFFF || length > available())
+    return false;
+
+  uint8_t const header[HEADER_SIZE] = {static_cast<uint8_t>(length & 0xFF), static_cast<uint8_t>(length >> 8)};
+  size_t const tail = (_head + _used) % _capacity;
+  write(tail, header, HEADER_SIZE);
+  write((tail + HEADER_SIZE) % _capacity, record, length);
+
+  _used += HEADER_SIZE + length;
+  _count++;
+  return true;
+}
+
+size_t OfflineLogRamStorage::front(uint8_t * buffer, size_t const size)
+{
+  size_t const length = frontLength();
+  if (length > 0 && length <= size)
+    read((_head + HEADER_SIZE) % _capacity, buffer, length);
+  return length;
+}
+
+void OfflineLogRamStorage::pop()
+{
+  if (_count == 0)
+    return;
+
+  size_t const length = HEADER_SIZE + frontLength();
+  _head = (_head + length) % _capacity;
+  _used -= length;
+  _count--;
+
+  if (_count == 0)
+    _head = _used = 0;
+}
+
+void OfflineLogRamStorage::clear()
+{
+  _head = 0;
+  _used = 0;
+  _count = 0;
+}
+
+size_t OfflineLogRamStorage::available() const
+{
+  size_t const free_bytes = _capacity - _used;
+  return (free_bytes > HEADER_SIZE) ? (free_bytes - HEADER_SIZE) : 0;
+}
+
+/******************************************************************************
+ * PRIVATE MEMBER FUNCTIONS
+ ******************************************************************************/
+
+void OfflineLogRamStorage::write(size_t const offset, uint8_t const * data, size_t const length)
+{
+  size_t const first = (length < _capacity - offset) ? length : (_capacity - offset);
+  memcpy(_buffer + offset, data, first);
+  memcpy(_buffer, data + first, length - first);
+}
+
+void OfflineLogRamStorage::read(size_t const offset, uint8_t * data, size_t const length) const
+{
+  size_t const first = (length < _capacity - offset) ? length : (_capacity - offset);
+  memcpy(data, _buffer + offset, first);
+  memcpy(data + first, _buffer, length - first);
+}
+
+size_t OfflineLogRamStorage::frontLength() const
+{
+  if (_count == 0)
+    return 0;
+
+  uint8_t header[HEADER_SIZE];
+  read(_head, header, HEADER_SIZE);
+  return static_cast<size_t>(header[0]) | (static_cast<size_t>(header[1]) << 8);
+}
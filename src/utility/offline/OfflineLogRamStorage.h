@@ -0,0 +1,68 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#ifndef ARDUINO_IOT_CLOUD_OFFLINE_LOG_RAM_STORAGE_H_
+#define ARDUINO_IOT_CLOUD_OFFLINE_LOG_RAM_STORAGE_H_
+
+/******************************************************************************
+ * INCLUDE
+ ******************************************************************************/
+
+#include "OfflineLogStorage.h"
+
+/******************************************************************************
+ * CLASS DECLARATION
+ ******************************************************************************/
+
+/* Keeps the records of an OfflineLog in a ring of 'capacity' bytes allocated
+ * by begin(). Every record is stored behind a 2 byte length header and may
+ * wrap around the end of the ring.
+ */
+class OfflineLogRamStorage : public OfflineLogStorage
+{
+
+public:
+
+  OfflineLogRamStorage();
+  virtual ~OfflineLogRamStorage();
+
+  bool begin(size_t const capacity);
+
+  virtual bool   append(uint8_t const * record, size_t const length) override;
+  virtual size_t front(uint8_t * buffer, size_t const size) override;
+  virtual void   pop() override;
+  virtual void   clear() override;
+
+  virtual size_t count() const override { return _count; }
+  virtual size_t available() const override;
+
+  inline size_t capacity() const { return _capacity; }
+
+
+private:
+
+  OfflineLogRamStorage(OfflineLogRamStorage const &) = delete;
+  OfflineLogRamStorage & operator = (OfflineLogRamStorage const &) = delete;
+
+  static size_t const HEADER_SIZE = 2;
+
+  uint8_t * _buffer;
+  size_t _capacity;
+  size_t _head;
+  size_t _used;
+  size_t _count;
+
+  void write(size_t const offset, uint8_t const * data, size_t const length);
+  void read(size_t const offset, uint8_t * data, size_t const length) const;
+  size_t frontLength() const;
+
+};
+
+#endif /* ARDUINO_IOT_CLOUD_OFFLINE_LOG_RAM_STORAGE_H_ */
@@ -0,0 +1,54 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#ifndef ARDUINO_IOT_CLOUD_OFFLINE_LOG_STORAGE_H_
+#define ARDUINO_IOT_CLOUD_OFFLINE_LOG_STORAGE_H_
+
+/******************************************************************************
+ * INCLUDE
+ ******************************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+
+/******************************************************************************
+ * CLASS DECLARATION
+ ******************************************************************************/
+
+/* Bounded append-only storage of the records of an OfflineLog. Records are
+ * read back oldest-first and removed once they have been replayed. Implement
+ * this interface to keep the log in flash, on an SD card or in any other
+ * storage which survives a reset of the board.
+ */
+class OfflineLogStorage
+{
+
+public:
+
+  virtual ~OfflineLogStorage() { }
+
+  /* Appends a record after the newest one, returns false if it does not fit */
+  virtual bool   append(uint8_t const * record, size_t const length) = 0;
+  /* Returns the length of the oldest record, 0 if the storage is empty. The
+   * record is copied into 'buffer' only if it is at most 'size' bytes long.
+   */
+  virtual size_t front(uint8_t * buffer, size_t const size) = 0;
+  /* Removes the oldest record */
+  virtual void   pop() = 0;
+  virtual void   clear() = 0;
+
+  /* Number of records stored */
+  virtual size_t count() const = 0;
+  /* Length of the largest record which can still be appended */
+  virtual size_t available() const = 0;
+
+};
+
+#endif /* ARDUINO_IOT_CLOUD_OFFLINE_LOG_STORAGE_H_ */
@@ -0,0 +1,169 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+/******************************************************************************
+ * INCLUDE
+ ******************************************************************************/
+
+#include "TimerWheel.h"
+
+/******************************************************************************
+ * STATIC MEMBER DEFINITION
+ ******************************************************************************/
+
+size_t   const TimerWheel::NUM_LEVELS;
+size_t   const TimerWheel::SLOT_BITS;
+size_t   const TimerWheel::NUM_SLOTS;
+uint32_t const TimerWheel::RANGE;
+size_t   const TimerWheel::NONE;
+uint16_t const TimerWheel::DUE_LIST;
+uint16_t const TimerWheel::NO_LIST;
+
+/******************************************************************************
+ * CTOR/DTOR
+ ******************************************************************************/
+
+TimerWheel::TimerWheel()
+: _scheduled_count{0}
+, _now{0}
+{
+  clear();
+}
+
+/******************************************************************************
+ * PUBLIC MEMBER FUNCTIONS
+ ******************************************************************************/
+
+void TimerWheel::resize(size_t const num_timers)
+{
+  for (size_t id = num_timers; id < _timer.size(); id++)
+    cancel(id);
+  _timer.resize(num_timers, Timer{0, NONE, NONE, NO_LIST});
+}
+
+void TimerWheel::reserve(size_t const num_timers)
+{
+  _timer.reserve(num_timers);
+}
+
+void TimerWheel::clear()
+{
+  _timer.clear();
+  for (size_t l = 0; l <= DUE_LIST; l++)
+    _list_head[l] = NONE;
+  for (size_t level = 0; level < NUM_LEVELS; level++)
+    _level_count[level] = 0;
+  _scheduled_count = 0;
+}
+
+void TimerWheel::schedule(size_t const id, uint32_t const deadline)
+{
+  if (id >= _timer.size())
+    return;
+
+  cancel(id);
+  _timer[id].deadline = deadline;
+
+  /* The tick _now has already been processed, deadlines which are not after
+   * it are collected separately and expired by the next call to expire().
+   */
+  if (isDue(deadline, _now))
+    link(id, DUE_LIST);
+  else
+    insert(id);
+}
+
+void TimerWheel::cancel(size_t const id)
+{
+  if (isScheduled(id))
+    unlink(id);
+}
+
+/******************************************************************************
+ * PRIVATE MEMBER FUNCTIONS
+ ******************************************************************************/
+
+void TimerWheel::insert(size_t const id)
+{
+  /* The deadline is strictly after _now: select the lowest level whose range
+   * covers the remaining time. Deadlines beyond the range of the wheel are
+   * parked in the farthest slot and get re-inserted once it is reached.
+   */
+  uint32_t const delta = _timer[id].deadline - _now;
+  uint32_t const tick = (delta < RANGE) ? _timer[id].deadline : (_now + RANGE - 1);
+  uint32_t const distance = tick - _now;
+
+  size_t level = 0;
+  while ((level < (NUM_LEVELS - 1)) && (distance >= (1UL << ((level + 1) * SLOT_BITS))))
+    level++;
+
+  link(id, listIndex(level, tick));
+}
+
+void TimerWheel::link(size_t const id, uint16_t const list)
+{
+  Timer & t = _timer[id];
+  t.list = list;
+  t.prev = NONE;
+  t.next = _list_head[list];
+  if (t.next != NONE)
+    _timer[t.next].prev = id;
+  _list_head[list] = id;
+  if (list < DUE_LIST)
+    _level_count[list / NUM_SLOTS]++;
+  _scheduled_count++;
+}
+
+void TimerWheel::unlink(size_t const id)
+{
+  Timer & t = _timer[id];
+  if (t.prev != NONE)
+    _timer[t.prev].next = t.next;
+  else
+    _list_head[t.list] = t.next;
+  if (t.next != NONE)
+    _timer[t.next].prev = t.prev;
+  if (t.list < DUE_LIST)
+    _level_count[t.list / NUM_SLOTS]--;
+  t.prev = NONE;
+  t.next = NONE;
+  t.list = NO_LIST;
+  _scheduled_count--;
+}
+
+void TimerWheel::cascade(size_t const level, uint32_t const tick)
+{
+  uint16_t const list = listIndex(level, tick);
+  size_t id = _list_head[list];
+  while (id != NONE)
+  {
+    size_t const next = _timer[id].next;
+    unlink(id);
+    /* A deadline matching the boundary tick lands in the level 0 slot which
+     * is processed right after cascading.
+     */
+    if (_timer[id].deadline == tick)
+      link(id, listIndex(0, tick));
+    else
+      insert(id);
+    id = next;
+  }
+}
+
+uint32_t TimerWheel::nextTick(uint32_t const tick) const
+{
+  /* Skip ahead to the next slot boundary of the lowest populated level */
+  for (size_t level = 0; level < NUM_LEVELS; level++)
+  {
+    if (_level_count[level] > 0)
+      return (tick | ((1UL << (level * SLOT_BITS)) - 1)) + 1;
+  }
+  return tick + 1;
+}
@@ -0,0 +1,185 @@
+/*
+  This file is part of the ArduinoIoTCloud library.
+
+  Copyright (c) 2024 Arduino SA
+
+  This Source Code Form is subject to the terms of the Mozilla Public
+  License, v. 2.0. If a copy of the MPL was not distributed with this
+  file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*/
+
+#ifndef ARDUINO_IOT_CLOUD_TIMER_WHEEL_H_
+#define ARDUINO_IOT_CLOUD_TIMER_WHEEL_H_
+
+/******************************************************************************
+ * INCLUDE
+ ******************************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+
+#undef max
+#undef min
+#include <vector>
+
+/******************************************************************************
+ * CLASS DECLARATION
+ ******************************************************************************/
+
+/* Hierarchical timer wheel with a resolution of 1 ms.
+ *
+ * Each timer is identified by a small integer id (e.g. the index of a property
+ * within its container) and holds at most one deadline at a time. The wheel
+ * consists of NUM_LEVELS levels of NUM_SLOTS slots each: level 0 covers the
+ * next 64 ms with a 1 ms granularity, level 1 the next 4 s with a 64 ms
+ * granularity and so on up to ~4.6 h for level 3. Timers of the upper levels
+ * are moved (cascaded) down one level whenever the wheel crosses the slot
+ * boundary of their level, deadlines beyond the range of the wheel are parked
+ * in the last slot of the upper level and cascaded again until they fit.
+ *
+ * expire() skips over empty levels, so its cost depends on the number of due
+ * and cascaded timers rather than on the elapsed time or the number of timers.
+ *
+ * All time arithmetic is done modulo 2^32 so that the millis() rollover after
+ * ~49.7 days is handled transparently, provided deadlines are scheduled less
+ * than ~24.8 days ahead.
+ */
+class TimerWheel
+{
+
+public:
+
+  TimerWheel();
+
+  void resize(size_t const num_timers);
+  void reserve(size_t const num_timers);
+  void clear();
+
+  void schedule(size_t const id, uint32_t const deadline);
+  void cancel  (size_t const id);
+
+  inline bool     isScheduled   (size_t const id) const { return (id < _timer.size()) && (_timer[id].list != NO_LIST); }
+  inline uint32_t deadline      (size_t const id) const { return _timer[id].deadline; }
+  inline size_t   scheduledCount()                const { return _scheduled_count; }
+
+  /* Invokes on_expired(id) for every timer whose deadline is not after 'now'.
+   * An expired timer is removed from the wheel before its callback is invoked,
+   * hence the callback may schedule it again (but must not touch other timers).
+   */
+  template <typename Func>
+  void expire(uint32_t const now, Func on_expired);
+
+  static size_t   const NUM_LEVELS = 4;
+  static size_t   const SLOT_BITS  = 6;
+  static size_t   const NUM_SLOTS  = (1 << SLOT_BITS);
+  static uint32_t const RANGE      = (1UL << (NUM_LEVELS * SLOT_BITS));
+  static size_t   const NONE       = static_cast<size_t>(-1);
+
+private:
+
+  /* List of the timers which were already due when scheduled */
+  static uint16_t const DUE_LIST   = NUM_LEVELS * NUM_SLOTS;
+  static uint16_t const NO_LIST    = 0xFFFF;
+
+  struct Timer
+  {
+    uint32_t deadline;
+    size_t   prev;
+    size_t   next;
+    uint16_t list;
+  };
+
+  std::vector<Timer> _timer;
+  size_t             _list_head[NUM_LEVELS * NUM_SLOTS + 1];
+  size_t             _level_count[NUM_LEVELS];
+  size_t             _scheduled_count;
+  /* Last tick processed by the wheel */
+  uint32_t           _now;
+
+  void     insert  (size_t const id);
+  void     link    (size_t const id, uint16_t const list);
+  void     unlink  (size_t const id);
+  void     cascade (size_t const level, uint32_t const tick);
+  uint32_t nextTick(uint32_t const tick) const;
+
+  template <typename Func>
+  void     expireList(uint16_t const list, Func & on_expired);
+  template <typename Func>
+  void     rebuild(uint32_t const now, Func & on_expired);
+
+  static inline bool isDue(uint32_t const deadline, uint32_t const now) {
+    return static_cast<int32_t>(now - deadline) >= 0;
+  }
+  static inline uint16_t listIndex(size_t const level, uint32_t const tick) {
+    return static_cast<uint16_t>(level * NUM_SLOTS + ((tick >> (level * SLOT_BITS)) & (NUM_SLOTS - 1)));
+  }
+};
+
+/******************************************************************************
+ * TEMPLATE MEMBER FUNCTIONS
+ ******************************************************************************/
+
+template <typename Func>
+void TimerWheel::expire(uint32_t const now, Func on_expired)
+{
+  expireList(DUE_LIST, on_expired);
+
+  if (_scheduled_count == 0) {
+    _now = now;
+    return;
+  }
+
+  /* If the wheel has not been serviced for a full revolution (or time went
+   * backwards) the slot positions are meaningless, start over from scratch.
+   */
+  if ((now - _now) >= RANGE) {
+    rebuild(now, on_expired);
+    return;
+  }
+
+  for (uint32_t tick = nextTick(_now); (_scheduled_count > 0) && isDue(tick, now); tick = nextTick(tick))
+  {
+    _now = tick;
+
+    /* Move the timers of the upper levels whose slot boundary has been reached */
+    for (size_t level = NUM_LEVELS - 1; level > 0; level--) {
+      if ((tick & ((1UL << (level * SLOT_BITS)) - 1)) == 0)
+        cascade(level, tick);
+    }
+
+    expireList(listIndex(0, tick), on_expired);
+  }
+
+  _now = now;
+}
+
+template <typename Func>
+void TimerWheel::expireList(uint16_t const list, Func & on_expired)
+{
+  size_t id = _list_head[list];
+  while (id != NONE)
+  {
+    size_t const next = _timer[id].next;
+    unlink(id);
+    on_expired(id);
+    id = next;
+  }
+}
+
+template <typename Func>
+void TimerWheel::rebuild(uint32_t const now, Func & on_expired)
+{
+  _now = now;
+  for (size_t id = 0; id < _timer.size(); id++)
+  {
+    if (!isScheduled(id))
+      continue;
+    unlink(id);
+    if (isDue(_timer[id].deadline, now))
+      on_expired(id);
+    else
+      insert(id);
+  }
+}
+
+#endif /* ARDUINO_IOT_CLOUD_TIMER_WHEEL_H_ */